@@ -0,0 +1,113 @@
+#include "../dependencias_nivel.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Análisis de dependencias de los niveles - DuoMaze Dev Tool
+// Imprime el grafo de dependencias de cada nivel del juego y mide el análisis completo,
+// que el creador de niveles ejecuta en cada edición (objetivo: menos de 1 ms).
+
+static void imprimirBotones(uint8_t botones) {
+    if (botones == 0) {
+        printf("-");
+        return;
+    }
+    for (int k = 0; k < 3; k++) {
+        if (botones & (1u << k)) printf("B%d ", k + 1);
+    }
+}
+
+static bool imprimirInforme(const char* nombre, const InformeDependencias& inf) {
+    printf("\n  %s: %s\n", nombre, inf.completable ? "✅ completable" : "❌ no completable");
+    for (int e = 0; e < NUM_EVENTOS; e++) {
+        const auto& ev = inf.eventos[e];
+        if (!ev.existe) continue;
+        printf("    %-4s requiere [", AnalizadorDependencias::nombreEvento(static_cast<EventoNivel>(e)));
+        imprimirBotones(ev.requiere);
+        if (ev.alcanzable) {
+            printf("] alcanzable en %d tiles\n", ev.tiempo);
+        } else {
+            printf("] inalcanzable\n");
+        }
+    }
+    for (int rol = 1; rol >= 0; rol--) {
+        const auto& r = inf.roles[rol];
+        printf("    %-6s %d regiones, %d alcanzables; requisitos:", rol == 1 ? "master" : "slave", r.regiones,
+               r.regionesAlcanzables);
+        for (int g = 0; g < r.regiones; g++) {
+            printf(" R%d[", g);
+            imprimirBotones(r.requiereRegion[g]);
+            printf("]");
+        }
+        printf("\n");
+    }
+    if (inf.largoCadena > 0) {
+        printf("    Ruta crítica: ");
+        for (int i = inf.largoCadena - 1; i >= 0; i--) {
+            printf("%s%s", AnalizadorDependencias::nombreEvento(inf.cadenaCritica[i]), i > 0 ? " → " : "");
+        }
+        printf(" (%d tiles, ~%.1f s)\n", inf.longitudCritica,
+               inf.longitudCritica * DependenciasConstants::SEGUNDOS_POR_TILE);
+    }
+    for (const auto& aviso : inf.avisos) printf("    ⚠️  %s\n", aviso.c_str());
+    return inf.completable && !inf.bloqueo;
+}
+
+int main(int argc, char** argv) {
+    int repeticiones = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    if (repeticiones <= 0) repeticiones = 1000;
+    printf("🔗 Dependencias entre regiones, botones y puertas\n");
+
+    bool ok = true;
+    std::vector<double> tiempos;
+    for (int n = 0; n < GameConstants::TOTAL_LEVELS; n++) {
+        MapaNivel mapa;
+        SimEstado sim;
+        SimulacionFija::cargarNivel(n, mapa, sim);
+        InformeDependencias inf = AnalizadorDependencias::analizar(mapa);
+        char nombre[32];
+        snprintf(nombre, sizeof(nombre), "Nivel %d", n + 1);
+        ok = imprimirInforme(nombre, inf) && ok;
+        for (int i = 0; i < repeticiones; i++) tiempos.push_back(AnalizadorDependencias::analizar(mapa).ms);
+    }
+
+    // Casos que el análisis tiene que detectar, construidos sobre el nivel 1
+    MapaNivel base;
+    SimEstado sim;
+    SimulacionFija::cargarNivel(0, base, sim);
+    bool detecta = true;
+
+    // Botón 1 encerrado por su propia puerta
+    MapaNivel encerrado = base;
+    for (int y = 1; y < GameConstants::MAP_HEIGHT - 1; y++) {
+        for (int x = 1; x < GameConstants::MAP_WIDTH - 1; x++) {
+            if (base[y][x] != BOTON_1) continue;
+            const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+            for (int k = 0; k < 4; k++) {
+                int& t = encerrado[y + dy[k]][x + dx[k]];
+                if (t != PARED) t = PUERTA_1;
+            }
+        }
+    }
+    InformeDependencias infEncerrado = AnalizadorDependencias::analizar(encerrado);
+    imprimirInforme("Nivel 1 con el botón 1 tras su puerta", infEncerrado);
+    detecta = detecta && infEncerrado.bloqueo && !infEncerrado.completable;
+
+    // Sin meta
+    MapaNivel sinMeta = base;
+    for (auto& fila : sinMeta) for (int& t : fila) if (t == META) t = VACIO;
+    InformeDependencias infSinMeta = AnalizadorDependencias::analizar(sinMeta);
+    imprimirInforme("Nivel 1 sin meta", infSinMeta);
+    detecta = detecta && !infSinMeta.completable;
+
+    printf("\n  %s los niveles del juego no tienen bloqueos\n", ok ? "✅" : "❌");
+    printf("  %s bloqueos y niveles imposibles detectados\n", detecta ? "✅" : "❌");
+    // Percentil 99: el máximo lo marcan las expulsiones del planificador, no el análisis
+    std::sort(tiempos.begin(), tiempos.end());
+    double mediana = tiempos[tiempos.size() / 2];
+    double p99 = tiempos[tiempos.size() * 99 / 100];
+    printf("  %s análisis: mediana %.3f ms, p99 %.3f ms, máximo %.3f ms (límite 1 ms)\n", p99 < 1.0 ? "✅" : "❌",
+           mediana, p99, tiempos.back());
+    return (ok && detecta && p99 < 1.0) ? 0 : 1;
+}
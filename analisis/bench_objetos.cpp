@@ -0,0 +1,189 @@
+#include "../objetos_dinamicos.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Benchmark de los objetos dinámicos - DuoMaze Dev Tool
+// Miles de peligros, cajas y puertas correderas en un mapa de ANCHO x ALTO tiles con ocho
+// jugadores empujando al azar. Compara la rejilla espacial con la fase ancha por fuerza
+// bruta: tienen que dar exactamente el mismo resultado tick a tick, y el coste por objeto
+// de la rejilla tiene que mantenerse plano al crecer el número de objetos.
+
+static double ahoraMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t aleatorio(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+static constexpr int JUGADORES = ObjetosConstants::MAX_EMPUJONES_POR_TICK;
+static constexpr int TICKS_POR_CANAL = 100;     // Cada cuánto se conmutan los canales de las puertas
+
+// Campo abierto con pilares sueltos: los objetos se mueven de verdad y se cruzan a menudo
+static std::vector<int> mapaPilares(int ancho, int alto, uint32_t semilla) {
+    std::vector<int> t(static_cast<size_t>(ancho) * alto, VACIO);
+    for (int y = 0; y < alto; y++) {
+        for (int x = 0; x < ancho; x++) {
+            bool borde = x == 0 || y == 0 || x == ancho - 1 || y == alto - 1;
+            if (borde || aleatorio(semilla) % 100 < 8) t[y * ancho + x] = PARED;
+        }
+    }
+    return t;
+}
+
+// n objetos en tiles libres distintas: 70% peligros, 20% cajas y 10% puertas
+static std::vector<DefinicionObjeto> repartir(std::vector<int>& t, int ancho, int n, uint32_t semilla) {
+    std::vector<uint8_t> ocupada(t.size(), 0);
+    std::vector<DefinicionObjeto> defs;
+    while (static_cast<int>(defs.size()) < n) {
+        int c = static_cast<int>(aleatorio(semilla) % t.size());
+        if (t[c] != VACIO || ocupada[c]) continue;
+        ocupada[c] = 1;
+        int16_t x = static_cast<int16_t>(c % ancho), y = static_cast<int16_t>(c / ancho);
+        uint32_t r = aleatorio(semilla) % 10;
+        int16_t largo = static_cast<int16_t>(2 + aleatorio(semilla) % 7);
+        bool horizontal = aleatorio(semilla) & 1;
+        if (r < 7) {
+            defs.push_back({OBJETO_PELIGRO, x, y, horizontal ? largo : int16_t(0), horizontal ? int16_t(0) : largo, 0,
+                            static_cast<uint8_t>(1 + aleatorio(semilla) % ObjetosConstants::VELOCIDAD_MAXIMA)});
+        } else if (r < 9) {
+            defs.push_back({OBJETO_CAJA, x, y, 0, 0, 0, 0});
+        } else {
+            defs.push_back({OBJETO_PUERTA_CORREDIZA, x, y, horizontal ? int16_t(1) : int16_t(0),
+                            horizontal ? int16_t(0) : int16_t(1), static_cast<uint8_t>(aleatorio(semilla) % 3), 2});
+        }
+    }
+    return defs;
+}
+
+struct Resultado {
+    double msTick;
+    std::vector<uint64_t> checksums;    // Uno por tick: objetos + jugadores
+};
+
+static Resultado simular(const std::vector<int>& t, int ancho, int alto, const std::vector<DefinicionObjeto>& defs,
+                         int ticks, bool rejilla) {
+    MundoObjetos mundo;
+    mundo.cargar(defs.data(), defs.size(), t.data(), ancho, alto, METADATOS_BASICOS);
+    mundo.setUsarRejilla(rejilla);
+
+    // Jugadores en las primeras tiles libres del centro del mapa, donde están los objetos
+    Vector2 jugadores[JUGADORES];
+    int colocados = 0;
+    for (size_t c = t.size() / 2; c < t.size() && colocados < JUGADORES; c++) {
+        if (t[c] != VACIO) continue;
+        jugadores[colocados++] = {static_cast<float>((c % ancho) * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2),
+                                  static_cast<float>((c / ancho) * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2)};
+    }
+
+    Resultado r;
+    r.checksums.reserve(ticks);
+    uint32_t semilla = 0x0B1E7051u;
+    uint8_t direccion[JUGADORES] = {};
+    double total = 0.0;
+    for (int tick = 0; tick < ticks; tick++) {
+        Canales canales = (tick / TICKS_POR_CANAL) & 1 ? 0x5 : 0x2;
+        for (int j = 0; j < JUGADORES; j++) {
+            if (aleatorio(semilla) % 30 == 0) direccion[j] = static_cast<uint8_t>(aleatorio(semilla) & 0xF);
+        }
+
+        double t0 = ahoraMs();
+        mundo.avanzar(canales);
+        for (int j = 0; j < colocados; j++) {
+            Vector2 p = SimulacionFija::aplicarInput(jugadores[j], direccion[j]);
+            int32_t cx = static_cast<int32_t>(p.x), cy = static_cast<int32_t>(p.y), rad = GameConstants::PLAYER_RADIUS;
+            if (!mundo.libreDeTiles({cx - rad, cy - rad, cx + rad + 1, cy + rad + 1})) continue;
+            jugadores[j] = mundo.moverJugador(jugadores[j], p);
+            if (mundo.tocaPeligro(jugadores[j])) direccion[j] ^= 0xF;
+        }
+        total += ahoraMs() - t0;
+
+        uint64_t h = mundo.checksum();
+        for (int j = 0; j < colocados; j++) h = h * 31 + static_cast<uint64_t>(jugadores[j].x * 4096 + jugadores[j].y);
+        r.checksums.push_back(h);
+    }
+    r.msTick = total / ticks;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int ancho = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    int alto = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    int ticks = (argc > 3) ? std::atoi(argv[3]) : 300;
+    if (ancho < 64 || alto < 64) ancho = alto = 1000;
+    if (ticks <= 0) ticks = 300;
+
+    printf("📦 Objetos dinámicos: rejilla espacial frente a fuerza bruta (%dx%d tiles, %d ticks)\n", ancho, alto, ticks);
+    std::vector<int> mapa = mapaPilares(ancho, alto, 0xFACADEu);
+    const int cantidades[] = {1024, 2048, 4096, 8192, 16384, 32768};
+    const int MAX_FUERZA_BRUTA = 4096;
+    const int REPETICIONES = 7;
+
+    std::vector<std::vector<DefinicionObjeto>> defs;
+    for (int n : cantidades) {
+        if (static_cast<size_t>(n) * 4 > mapa.size()) break;
+        defs.push_back(repartir(mapa, ancho, n, 0xC0DEu + n));
+    }
+
+    // Las repeticiones recorren todos los tamaños por turnos, para que los cambios de
+    // frecuencia o de carga de la máquina afecten a todos por igual, y se queda la mediana
+    std::vector<Resultado> conRejilla(defs.size());
+    std::vector<std::vector<double>> tiempos(defs.size());
+    for (int rep = 0; rep < REPETICIONES; rep++) {
+        for (size_t k = 0; k < defs.size(); k++) {
+            Resultado r = simular(mapa, ancho, alto, defs[k], ticks, true);
+            tiempos[k].push_back(r.msTick);
+            if (rep == 0) conRejilla[k] = std::move(r);
+        }
+    }
+
+    bool iguales = true;
+    std::vector<double> logN, logMs;         // Para la pendiente log-log del coste por tick
+    printf("  Objetos | rejilla (ms/tick) | ns/objeto | bruta (ms/tick) | x bruta\n");
+    for (size_t k = 0; k < defs.size(); k++) {
+        int n = static_cast<int>(defs[k].size());
+        std::nth_element(tiempos[k].begin(), tiempos[k].begin() + REPETICIONES / 2, tiempos[k].end());
+        double msTick = tiempos[k][REPETICIONES / 2];
+        double ns = msTick * 1e6 / n;
+        logN.push_back(std::log(static_cast<double>(n)));
+        logMs.push_back(std::log(msTick));
+        if (n <= MAX_FUERZA_BRUTA) {
+            Resultado bruta = simular(mapa, ancho, alto, defs[k], ticks, false);
+            bool igual = bruta.checksums == conRejilla[k].checksums;
+            iguales = iguales && igual;
+            printf("  %7d | %17.3f | %9.1f | %15.3f | %7.1f %s\n", n, msTick, ns, bruta.msTick, bruta.msTick / msTick,
+                   igual ? "✅" : "❌");
+        } else {
+            printf("  %7d | %17.3f | %9.1f | %15s | %7s\n", n, msTick, ns, "-", "-");
+        }
+    }
+
+    // Coste por objeto plano: cada consulta mira solo su vecindad, no el total, así que el tick
+    // crece lineal con los objetos (pendiente 1 en log-log; la fuerza bruta daría 2). La recta
+    // por mínimos cuadrados usa todos los tamaños y no depende de que uno salga ruidoso.
+    const double MAX_PENDIENTE = 1.15;
+    double mediaX = 0.0, mediaY = 0.0;
+    for (size_t k = 0; k < logN.size(); k++) {
+        mediaX += logN[k] / logN.size();
+        mediaY += logMs[k] / logN.size();
+    }
+    double cov = 0.0, var = 0.0;
+    for (size_t k = 0; k < logN.size(); k++) {
+        cov += (logN[k] - mediaX) * (logMs[k] - mediaY);
+        var += (logN[k] - mediaX) * (logN[k] - mediaX);
+    }
+    double pendiente = var > 0.0 ? cov / var : 0.0;
+    bool plano = pendiente <= MAX_PENDIENTE;
+    printf("\n  %s resultados idénticos a la fuerza bruta tick a tick\n", iguales ? "✅" : "❌");
+    printf("  %s coste por tick frente a objetos con pendiente log-log %.3f (máximo %.2f)\n", plano ? "✅" : "❌",
+           pendiente, MAX_PENDIENTE);
+    return (iguales && plano) ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#!/bin/bash
+echo "🧪 Compilando Análisis de Laberintos - DuoMaze Dev Tool..."
+
+# Benchmark de los bitboards (AVX2 se elige en tiempo de ejecución, no hace falta -mavx2)
+# y análisis de dependencias de los niveles. Usan las cabeceras de raylib pero no enlazan
+# la librería
+g++ -o bench_bitboard bench_bitboard.cpp -std=c++17 -O2 && \
+g++ -o bench_objetos bench_objetos.cpp -std=c++17 -O2 && \
+g++ -o analizar_niveles analizar_niveles.cpp -std=c++17 -O2
+
+if [ $? -eq 0 ]; then
+    echo "✅ ¡Compilación exitosa!"
+    echo "🚀 Benchmark: ./bench_bitboard [ancho=1000] [alto=1000] [repeticiones=20]"
+    echo "📦 Objetos dinámicos: ./bench_objetos [ancho=1000] [alto=1000] [ticks=300]"
+    echo "🔗 Dependencias de los niveles: ./analizar_niveles [repeticiones=1000]"
+else
+    echo "❌ Error en la compilación"
+    exit 1
+fi
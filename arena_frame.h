@@ -0,0 +1,88 @@
+#ifndef DUOMAZE_ARENA_FRAME_H
+#define DUOMAZE_ARENA_FRAME_H
+
+// Arena por frame: memoria para lo que solo vive un frame (textos del HUD, formateos). Reservar
+// es avanzar un puntero dentro de un bloque que se pide una sola vez al crearla, y después de
+// EndDrawing se reinicia entera, así que un frame normal no toca el heap.
+//
+// Si un frame pide más de lo que cabe no se crece: reservar() devuelve nullptr, formatear()
+// corta el texto y se cuenta un desborde (getMaximo() dice cuánto hace falta). Solo para el
+// hilo principal; los hilos de trabajo formatean en la pila.
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+class ArenaFrame {
+private:
+    std::unique_ptr<unsigned char[]> bloque;
+    size_t capacidad;
+    size_t usado = 0;
+    size_t maximo = 0;          // Mayor uso de un frame
+    long desbordes = 0;
+
+public:
+    explicit ArenaFrame(size_t bytes) : bloque(new unsigned char[bytes]), capacidad(bytes) {}
+
+    void* reservar(size_t bytes, size_t alineacion = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(bloque.get());
+        size_t inicio = ((base + usado + alineacion - 1) & ~(static_cast<uintptr_t>(alineacion) - 1)) - base;
+        if (inicio + bytes > capacidad) {
+            desbordes++;
+            return nullptr;
+        }
+        usado = inicio + bytes;
+        return bloque.get() + inicio;
+    }
+
+    template <typename T>
+    T* reservarArray(size_t n) { return static_cast<T*>(reservar(n * sizeof(T), alignof(T))); }
+
+    // printf en la arena; la cadena vale hasta el próximo reiniciar()
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    const char* formatear(const char* formato, ...) {
+        size_t libre = capacidad - usado;
+        if (libre == 0) {
+            desbordes++;
+            return "";
+        }
+        char* destino = reinterpret_cast<char*>(bloque.get() + usado);
+        va_list args;
+        va_start(args, formato);
+        int n = std::vsnprintf(destino, libre, formato, args);
+        va_end(args);
+        if (n < 0) return "";
+        if (static_cast<size_t>(n) >= libre) {
+            desbordes++;
+            usado = capacidad;
+        } else {
+            usado += static_cast<size_t>(n) + 1;
+        }
+        return destino;
+    }
+
+    // "mm:ss:cc" con centésimas, precedido de prefijo
+    const char* tiempo(double segundos, const char* prefijo = "") {
+        int total = static_cast<int>(segundos);
+        int centesimas = static_cast<int>((segundos - total) * 100);
+        return formatear("%s%02d:%02d:%02d", prefijo, total / 60, total % 60, centesimas);
+    }
+
+    // Tras EndDrawing: todo lo reservado en el frame deja de valer
+    void reiniciar() {
+        maximo = std::max(maximo, usado);
+        usado = 0;
+    }
+
+    size_t getUsado() const { return usado; }
+    size_t getMaximo() const { return std::max(maximo, usado); }
+    size_t getCapacidad() const { return capacidad; }
+    long getDesbordes() const { return desbordes; }
+};
+
+#endif
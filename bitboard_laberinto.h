@@ -0,0 +1,452 @@
+#ifndef DUOMAZE_BITBOARD_LABERINTO_H
+#define DUOMAZE_BITBOARD_LABERINTO_H
+
+// Laberinto en forma de bitboards para análisis (alcance, componentes conexas, qué
+// puerta desbloquea qué): un bit por tile y un tablero por TileType.
+//
+// Cada fila ocupa un número de palabras de 64 bits múltiplo de 4, así una fila se
+// recorre en bloques de 256 bits con AVX2 y los bits de relleno siempre valen 0. El bit
+// x % 64 de la palabra x / 64 es la tile x de la fila.
+//
+// Relleno por inundación: dentro de una palabra se expande por los tramos pasables hacia
+// los bits altos con una suma (el acarreo recorre el tramo) y hacia los bajos con el
+// relleno de Kogge-Stone (6 desplazamientos); el acarreo entre palabras se propaga en una
+// pasada hacia cada lado. Entre filas se hacen barridos alternos solo por las filas
+// sucias: una fila se vuelve a procesar únicamente si una vecina le aporta bits nuevos, y
+// solo en las palabras que cambiaron.
+// AVX2 se elige en tiempo de ejecución, y aun con él cada fila va por bloques solo si su
+// tramo sucio es ancho (salas abiertas); los tramos de hasta cuatro palabras van por la
+// versión de 64 bits, que es la única sin AVX2 (u otra arquitectura).
+
+#include "simulacion.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define DUOMAZE_BITBOARD_AVX2 1
+#endif
+
+class Bitboard {
+private:
+    int ancho = 0, alto = 0, palabras = 0;     // palabras por fila (múltiplo de 4)
+    std::vector<uint64_t> datos;
+
+public:
+    Bitboard() = default;
+    Bitboard(int ancho_, int alto_)
+        : ancho(ancho_), alto(alto_), palabras(((ancho_ + 255) / 256) * 4),
+          datos(static_cast<size_t>(palabras) * alto_, 0) {}
+
+    int getAncho() const { return ancho; }
+    int getAlto() const { return alto; }
+    int getPalabras() const { return palabras; }
+
+    uint64_t* fila(int y) { return datos.data() + static_cast<size_t>(y) * palabras; }
+    const uint64_t* fila(int y) const { return datos.data() + static_cast<size_t>(y) * palabras; }
+
+    bool get(int x, int y) const { return (fila(y)[x >> 6] >> (x & 63)) & 1; }
+    void set(int x, int y) { fila(y)[x >> 6] |= 1ull << (x & 63); }
+    void clear(int x, int y) { fila(y)[x >> 6] &= ~(1ull << (x & 63)); }
+    void limpiar() { std::fill(datos.begin(), datos.end(), 0); }
+
+    Bitboard& operator|=(const Bitboard& o) {
+        for (size_t i = 0; i < datos.size(); i++) datos[i] |= o.datos[i];
+        return *this;
+    }
+    Bitboard& operator&=(const Bitboard& o) {
+        for (size_t i = 0; i < datos.size(); i++) datos[i] &= o.datos[i];
+        return *this;
+    }
+    Bitboard& quitar(const Bitboard& o) {
+        for (size_t i = 0; i < datos.size(); i++) datos[i] &= ~o.datos[i];
+        return *this;
+    }
+    bool operator==(const Bitboard& o) const { return datos == o.datos; }
+
+    bool intersecta(const Bitboard& o) const {
+        for (size_t i = 0; i < datos.size(); i++) if (datos[i] & o.datos[i]) return true;
+        return false;
+    }
+
+    bool vacio() const {
+        for (uint64_t w : datos) if (w != 0) return false;
+        return true;
+    }
+
+    int contar() const {
+        int n = 0;
+        for (uint64_t w : datos) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    // Primera tile activa en orden de filas; false si el tablero está vacío
+    bool primera(int& x, int& y) const {
+        for (int fy = 0; fy < alto; fy++) {
+            const uint64_t* f = fila(fy);
+            for (int w = 0; w < palabras; w++) {
+                if (f[w] != 0) {
+                    x = w * 64 + __builtin_ctzll(f[w]);
+                    y = fy;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+namespace BitboardOps {
+    // --- Versión de 64 bits ---
+
+    // Relleno de las semillas g (dentro de p) por los bits de p hacia bits más altos: al
+    // sumar g a p el acarreo de cada semilla borra su tramo hasta el final y lo que cambió
+    // es justo lo rellenado (las semillas que quedan dentro del tramo se recuperan con g)
+    inline uint64_t llenarArriba(uint64_t g, uint64_t p) {
+        return g | (((p + g) ^ p) & p);
+    }
+
+    // Hacia bits más bajos no hay acarreo que ayude: Kogge-Stone
+    inline uint64_t llenarAbajo(uint64_t g, uint64_t p) {
+        g |= p & (g >> 1);  p &= p >> 1;
+        g |= p & (g >> 2);  p &= p >> 2;
+        g |= p & (g >> 4);  p &= p >> 4;
+        g |= p & (g >> 8);  p &= p >> 8;
+        g |= p & (g >> 16); p &= p >> 16;
+        g |= p & (g >> 32);
+        return g;
+    }
+
+    // Acarreo entre palabras tras rellenar [lo, hi]: una pasada hacia cada lado basta,
+    // porque lo que entra por un extremo de una palabra solo crece hacia el otro. Fuera
+    // del rango se sigue mientras haya acarreo y el rango se amplía con lo que cambió.
+    inline void acarreoFila(uint64_t* r, const uint64_t* p, int palabras, int& lo, int& hi) {
+        for (int w = lo + 1; w < palabras; w++) {
+            if ((r[w - 1] >> 63) & p[w] & ~r[w] & 1) {
+                r[w] = llenarArriba(r[w] | 1, p[w]);
+                hi = std::max(hi, w);
+            } else if (w > hi) {
+                break;
+            }
+        }
+        for (int w = hi - 1; w >= 0; w--) {
+            if ((r[w + 1] << 63) & p[w] & ~r[w]) {
+                r[w] = llenarAbajo(r[w] | (1ull << 63), p[w]);
+                lo = std::min(lo, w);
+            } else if (w < lo) {
+                break;
+            }
+        }
+    }
+
+    inline void llenarPalabrasEscalar(uint64_t* r, const uint64_t* p, int lo, int hi) {
+        for (int w = lo; w <= hi; w++) {
+            uint64_t g = r[w] & p[w];
+            r[w] = llenarArriba(g, p[w]) | llenarAbajo(g, p[w]);
+        }
+    }
+
+    // r |= (a | b) & p en las palabras [lo, hi]; deja en lo/hi las que recibieron bits
+    // nuevos (lo > hi si ninguna)
+    inline void importarEscalar(uint64_t* r, const uint64_t* a, const uint64_t* b, const uint64_t* p, int& lo, int& hi) {
+        int nlo = hi + 1, nhi = lo - 1;
+        for (int w = lo; w <= hi; w++) {
+            uint64_t v = (a[w] | b[w]) & p[w];
+            if (v & ~r[w]) {
+                r[w] |= v;
+                nlo = std::min(nlo, w);
+                nhi = w;
+            }
+        }
+        lo = nlo;
+        hi = nhi;
+    }
+
+    // Un paso de dilatación 4-conexa: d = (s | izq | der | arriba | abajo) & mascara
+    inline void dilatarFilaEscalar(uint64_t* d, const uint64_t* s, const uint64_t* arriba, const uint64_t* abajo,
+                                   const uint64_t* mascara, int palabras) {
+        for (int w = 0; w < palabras; w++) {
+            uint64_t izq = (s[w] << 1) | (w > 0 ? s[w - 1] >> 63 : 0);
+            uint64_t der = (s[w] >> 1) | (w + 1 < palabras ? s[w + 1] << 63 : 0);
+            d[w] = (s[w] | izq | der | arriba[w] | abajo[w]) & mascara[w];
+        }
+    }
+
+#ifdef DUOMAZE_BITBOARD_AVX2
+    // --- Versión AVX2: las mismas operaciones sobre 4 palabras a la vez ---
+
+    __attribute__((target("avx2")))
+    inline __m256i llenarArriba4(__m256i g, __m256i p) {
+        // La suma es por carriles: el acarreo que sale de cada palabra lo recoge acarreoFila
+        return _mm256_or_si256(g, _mm256_and_si256(_mm256_xor_si256(_mm256_add_epi64(p, g), p), p));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i llenarAbajo4(__m256i g, __m256i p) {
+        g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 1)));  p = _mm256_and_si256(p, _mm256_srli_epi64(p, 1));
+        g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 2)));  p = _mm256_and_si256(p, _mm256_srli_epi64(p, 2));
+        g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 4)));  p = _mm256_and_si256(p, _mm256_srli_epi64(p, 4));
+        g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 8)));  p = _mm256_and_si256(p, _mm256_srli_epi64(p, 8));
+        g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 16))); p = _mm256_and_si256(p, _mm256_srli_epi64(p, 16));
+        return _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 32)));
+    }
+
+    // [lo, hi] alineado a bloques de 4 palabras
+    __attribute__((target("avx2")))
+    inline void llenarPalabrasAVX2(uint64_t* r, const uint64_t* p, int lo, int hi) {
+        for (int w = lo & ~3; w <= hi; w += 4) {
+            __m256i vp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + w));
+            __m256i g = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + w)), vp);
+            __m256i lleno = _mm256_or_si256(llenarArriba4(g, vp), llenarAbajo4(g, vp));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + w), lleno);
+        }
+    }
+
+    // Igual que importarEscalar pero por bloques: lo/hi quedan alineados a 4 palabras
+    __attribute__((target("avx2")))
+    inline void importarAVX2(uint64_t* r, const uint64_t* a, const uint64_t* b, const uint64_t* p, int& lo, int& hi) {
+        int nlo = hi + 1, nhi = lo - 1;
+        for (int w = lo & ~3; w <= hi; w += 4) {
+            __m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + w));
+            __m256i v = _mm256_and_si256(_mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w)),
+                                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w))),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + w)));
+            __m256i nuevos = _mm256_andnot_si256(vr, v);
+            if (!_mm256_testz_si256(nuevos, nuevos)) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + w), _mm256_or_si256(vr, v));
+                nlo = std::min(nlo, w);
+                nhi = w + 3;
+            }
+        }
+        lo = nlo;
+        hi = nhi;
+    }
+
+    // El desplazamiento de 1 bit entre palabras se hace rotando los carriles del acarreo
+    // y metiendo en el carril 0 el del bloque anterior
+    __attribute__((target("avx2")))
+    inline void dilatarFilaAVX2(uint64_t* d, const uint64_t* s, const uint64_t* arriba, const uint64_t* abajo,
+                                const uint64_t* mascara, int palabras) {
+        uint64_t acarreoIzq = 0;
+        for (int w = 0; w < palabras; w += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + w));
+            __m256i altos = _mm256_srli_epi64(v, 63);
+            __m256i bajos = _mm256_slli_epi64(v, 63);
+            // Carril i recibe el bit 63 del carril i-1 / el bit 0 del carril i+1
+            __m256i entranIzq = _mm256_permute4x64_epi64(altos, _MM_SHUFFLE(2, 1, 0, 3));
+            entranIzq = _mm256_blend_epi32(entranIzq, _mm256_set_epi64x(0, 0, 0, static_cast<long long>(acarreoIzq)), 0x03);
+            __m256i entranDer = _mm256_permute4x64_epi64(bajos, _MM_SHUFFLE(0, 3, 2, 1));
+            uint64_t siguiente = (w + 4 < palabras) ? (s[w + 4] << 63) : 0;
+            entranDer = _mm256_blend_epi32(entranDer, _mm256_set_epi64x(static_cast<long long>(siguiente), 0, 0, 0), 0xC0);
+            acarreoIzq = s[w + 3] >> 63;
+
+            __m256i izq = _mm256_or_si256(_mm256_slli_epi64(v, 1), entranIzq);
+            __m256i der = _mm256_or_si256(_mm256_srli_epi64(v, 1), entranDer);
+            __m256i vert = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(arriba + w)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(abajo + w)));
+            __m256i res = _mm256_or_si256(_mm256_or_si256(v, izq), _mm256_or_si256(der, vert));
+            res = _mm256_and_si256(res, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mascara + w)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + w), res);
+        }
+    }
+
+    inline bool hayAVX2() {
+        static const bool disponible = __builtin_cpu_supports("avx2");
+        return disponible;
+    }
+#else
+    inline bool hayAVX2() { return false; }
+#endif
+
+    // Tramo sucio mínimo (hi - lo) para ir por bloques de AVX2: con menos, los bloques
+    // alineados tocan el doble de palabras de las necesarias y en un laberinto perfecto el
+    // relleno salía un 20% más lento que con la versión de 64 bits
+    constexpr int MIN_TRAMO_AVX2 = 4;
+
+    // Palabras de una fila pendientes de importar de sus vecinas; con `semilla` se
+    // rellenan aunque no reciban nada (tienen bits propios todavía sin expandir)
+    struct RangoFila {
+        int lo = 1 << 30, hi = -1;
+        bool semilla = false;
+
+        bool sucia() const { return lo <= hi; }
+        void ampliar(int l, int h) { lo = std::min(lo, l); hi = std::max(hi, h); }
+    };
+
+    // Expande r dentro de p a partir de las filas sucias de `rangos` (que quedan limpias).
+    // Barridos alternos hacia abajo y hacia arriba solo por las filas sucias y solo por las
+    // palabras que cambiaron en sus vecinas; una fila que cambia ensucia esas palabras en
+    // las de al lado, así un pasillo vertical se recorre entero en un barrido.
+    inline void expandir(Bitboard& r, const Bitboard& p, std::vector<RangoFila>& rangos, int desde, int hasta,
+                         bool usarAVX2) {
+        const int alto = p.getAlto();
+        const int palabras = p.getPalabras();
+        const std::vector<uint64_t> cero(palabras, 0);
+
+        auto procesar = [&](int y) {
+            RangoFila rango = rangos[y];
+            rangos[y] = RangoFila{};
+            uint64_t* f = r.fila(y);
+            const uint64_t* fp = p.fila(y);
+            const uint64_t* a = y > 0 ? r.fila(y - 1) : cero.data();
+            const uint64_t* b = y + 1 < alto ? r.fila(y + 1) : cero.data();
+            int lo = rango.lo, hi = rango.hi;
+#ifdef DUOMAZE_BITBOARD_AVX2
+            // Con pocas palabras sucias (pasillos estrechos) no compensa ir por bloques
+            if (usarAVX2 && rango.hi - rango.lo >= MIN_TRAMO_AVX2) {
+                importarAVX2(f, a, b, fp, lo, hi);
+                if (rango.semilla) { lo = rango.lo & ~3; hi = rango.hi | 3; }
+                if (lo > hi) return;
+                llenarPalabrasAVX2(f, fp, lo, hi);
+            } else
+#endif
+            {
+                importarEscalar(f, a, b, fp, lo, hi);
+                if (rango.semilla) { lo = rango.lo; hi = rango.hi; }
+                if (lo > hi) return;
+                llenarPalabrasEscalar(f, fp, lo, hi);
+            }
+            acarreoFila(f, fp, palabras, lo, hi);
+            if (y > 0) rangos[y - 1].ampliar(lo, hi);
+            if (y + 1 < alto) rangos[y + 1].ampliar(lo, hi);
+            desde = std::min(desde, std::max(0, y - 1));
+            hasta = std::max(hasta, std::min(alto - 1, y + 1));
+        };
+
+        while (desde <= hasta) {
+            // Hacia abajo: lo que se ensucia por debajo se procesa en esta misma pasada
+            int ini = desde, fin = hasta;
+            desde = alto;
+            hasta = -1;
+            for (int y = ini; y < alto && (y <= fin || rangos[y].sucia()); y++) {
+                if (rangos[y].sucia()) procesar(y);
+            }
+            if (desde > hasta) break;
+
+            // Hacia arriba
+            ini = desde;
+            fin = hasta;
+            desde = alto;
+            hasta = -1;
+            for (int y = fin; y >= 0 && (y >= ini || rangos[y].sucia()); y--) {
+                if (rangos[y].sucia()) procesar(y);
+            }
+        }
+    }
+
+    // Relleno por inundación: todas las tiles de `pasable` conectadas (4-conexo) a las semillas
+    inline Bitboard rellenar(const Bitboard& semillas, const Bitboard& pasable, bool usarAVX2 = hayAVX2()) {
+        const int alto = pasable.getAlto();
+        const int palabras = pasable.getPalabras();
+        Bitboard r = semillas;
+        r &= pasable;
+
+        std::vector<RangoFila> rangos(alto);
+        int desde = alto, hasta = -1;
+        for (int y = 0; y < alto; y++) {
+            const uint64_t* f = r.fila(y);
+            for (int w = 0; w < palabras; w++) {
+                if (f[w] != 0) {
+                    rangos[y].ampliar(w, w);
+                    rangos[y].semilla = true;
+                }
+            }
+            if (rangos[y].sucia()) {
+                desde = std::min(desde, y);
+                hasta = y;
+            }
+        }
+        expandir(r, pasable, rangos, desde, hasta, usarAVX2);
+        return r;
+    }
+
+    // Número de componentes 4-conexas de `pasable`. Se rellenan sobre el mismo tablero: las
+    // componentes ya cerradas no aportan bits nuevos a la siguiente.
+    inline int componentes(const Bitboard& pasable, bool usarAVX2 = hayAVX2()) {
+        const int alto = pasable.getAlto();
+        const int palabras = pasable.getPalabras();
+        Bitboard r(pasable.getAncho(), alto);
+        std::vector<RangoFila> rangos(alto);
+        int n = 0;
+        for (int y = 0; y < alto; y++) {
+            for (int w = 0; w < palabras; w++) {
+                uint64_t libres;
+                while ((libres = pasable.fila(y)[w] & ~r.fila(y)[w]) != 0) {
+                    r.fila(y)[w] |= libres & (~libres + 1);
+                    rangos[y].ampliar(w, w);
+                    rangos[y].semilla = true;
+                    expandir(r, pasable, rangos, y, y, usarAVX2);
+                    n++;
+                }
+            }
+        }
+        return n;
+    }
+
+    // Un paso de dilatación 4-conexa limitado a `mascara`
+    inline Bitboard dilatar(const Bitboard& b, const Bitboard& mascara, bool usarAVX2 = hayAVX2()) {
+        const int alto = b.getAlto();
+        const int palabras = b.getPalabras();
+        Bitboard d(b.getAncho(), alto);
+        const std::vector<uint64_t> cero(palabras, 0);
+        for (int y = 0; y < alto; y++) {
+            const uint64_t* arriba = y > 0 ? b.fila(y - 1) : cero.data();
+            const uint64_t* abajo = y + 1 < alto ? b.fila(y + 1) : cero.data();
+#ifdef DUOMAZE_BITBOARD_AVX2
+            if (usarAVX2) { dilatarFilaAVX2(d.fila(y), b.fila(y), arriba, abajo, mascara.fila(y), palabras); continue; }
+#endif
+            dilatarFilaEscalar(d.fila(y), b.fila(y), arriba, abajo, mascara.fila(y), palabras);
+        }
+        return d;
+    }
+}
+
+// Un tablero por TileType a partir de una rejilla de tiles de cualquier tamaño
+class LaberintoBits {
+private:
+    int ancho, alto;
+    Bitboard tableros[NUM_TIPOS_TILE];
+
+public:
+    LaberintoBits(const int* tiles, int ancho_, int alto_) : ancho(ancho_), alto(alto_) {
+        for (auto& t : tableros) t = Bitboard(ancho, alto);
+        for (int y = 0; y < alto; y++) {
+            for (int x = 0; x < ancho; x++) {
+                int t = tiles[y * ancho + x];
+                if (t >= 0 && t < NUM_TIPOS_TILE) tableros[t].set(x, y);
+            }
+        }
+    }
+
+    explicit LaberintoBits(const MapaNivel& mapa)
+        : LaberintoBits(&mapa[0][0], GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT) {}
+
+    const Bitboard& de(TileType t) const { return tableros[t]; }
+
+    // Tiles por las que puede pasar un rol: la unión de los tableros de los tipos que
+    // CollisionSystem::canPassTile deja pasar
+    Bitboard pasable(bool esMaster, uint8_t botones) const {
+        Bitboard p(ancho, alto);
+        for (int t = 0; t < NUM_TIPOS_TILE; t++) {
+            if (CollisionSystem::canPassTile(t, esMaster, botones)) p |= tableros[t];
+        }
+        return p;
+    }
+
+    // Tiles alcanzables por un rol desde su inicio (START_MASTER / START_SLAVE)
+    Bitboard alcanzable(bool esMaster, uint8_t botones, bool usarAVX2 = BitboardOps::hayAVX2()) const {
+        return BitboardOps::rellenar(tableros[esMaster ? START_MASTER : START_SLAVE], pasable(esMaster, botones), usarAVX2);
+    }
+
+    // Puertas que tocan la zona (o están dentro si ya se abrieron): lo que desbloquea cada botón
+    Bitboard puertasEnFrontera(const Bitboard& zona) const {
+        Bitboard puertas(ancho, alto);
+        for (int t = 0; t < NUM_TIPOS_TILE; t++) {
+            if (METADATOS_BASICOS.rasgos(t).tipo == TRIGGER_PUERTA) puertas |= tableros[t];
+        }
+        return BitboardOps::dilatar(zona, puertas);
+    }
+};
+
+#endif
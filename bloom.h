@@ -0,0 +1,287 @@
+#ifndef DUOMAZE_BLOOM_H
+#define DUOMAZE_BLOOM_H
+
+// Bloom como posproceso: la escena se dibuja en una textura de render, se extraen los píxeles
+// brillantes a media resolución, se desenfocan por separado en horizontal y en vertical a
+// media (y en calidad alta también a cuarto de) resolución y se suman sobre la escena.
+// Cualquiera puede añadir "emisivos" (confeti, meta, botones y puertas activos) directamente
+// a la capa de brillo sin depender del umbral. El coste depende de la resolución, no de
+// cuántas cosas brillen.
+//
+// La escena tiene el tamaño interno del lienzo virtual y se dibuja con su misma escala como
+// cámara: con --escala 2 el juego se rasteriza a 1600x1200 también con bloom.
+//
+// GLSL 330 con el vertex shader por defecto de raylib, como el resto de shaders del juego.
+
+#include "raylib.h"
+#include "memoria.h"
+#include <algorithm>
+
+enum CalidadBloom {
+    BLOOM_APAGADO = 0,
+    BLOOM_BAJA,         // Media resolución, desenfoque de 5 muestras
+    BLOOM_ALTA,         // Media y cuarto de resolución, desenfoque de 9 muestras
+    BLOOM_TOTAL
+};
+
+namespace BloomGLSL {
+    // Brillo = canal máximo, con rodilla suave alrededor del umbral
+    constexpr const char* UMBRAL_FS = R"(#version 330
+in vec2 fragTexCoord;
+uniform sampler2D texture0;
+uniform float umbral;
+uniform float rodilla;
+out vec4 finalColor;
+
+void main() {
+    vec3 c = texture(texture0, fragTexCoord).rgb;
+    float brillo = max(c.r, max(c.g, c.b));
+    finalColor = vec4(c * smoothstep(umbral - rodilla, umbral + rodilla, brillo), 1.0);
+}
+)";
+
+    // Gaussiana separable; muestras = 3 o 5 por lado (incluido el centro)
+    constexpr const char* DESENFOQUE_FS = R"(#version 330
+in vec2 fragTexCoord;
+uniform sampler2D texture0;
+uniform vec2 paso;
+uniform int muestras;
+out vec4 finalColor;
+
+const float PESOS[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+
+void main() {
+    vec3 suma = texture(texture0, fragTexCoord).rgb * PESOS[0];
+    float total = PESOS[0];
+    for (int i = 1; i < muestras; i++) {
+        vec2 d = paso * float(i);
+        suma += (texture(texture0, fragTexCoord + d).rgb + texture(texture0, fragTexCoord - d).rgb) * PESOS[i];
+        total += 2.0 * PESOS[i];
+    }
+    finalColor = vec4(suma / total, 1.0);
+}
+)";
+
+    constexpr const char* COMPOSICION_FS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;     // Escena
+uniform sampler2D mitad;
+uniform sampler2D cuarto;
+uniform float intensidad;
+uniform float pesoCuarto;
+out vec4 finalColor;
+
+void main() {
+    vec4 escena = texture(texture0, fragTexCoord);
+    vec3 brillo = texture(mitad, fragTexCoord).rgb + pesoCuarto * texture(cuarto, fragTexCoord).rgb;
+    finalColor = vec4(escena.rgb + brillo * intensidad, escena.a) * fragColor;
+}
+)";
+}
+
+class CadenaBloom {
+private:
+    Shader umbral{};
+    Shader desenfoque{};
+    Shader composicion{};
+    int locUmbral = -1, locRodilla = -1;
+    int locPaso = -1, locMuestras = -1;
+    int locMitad = -1, locCuarto = -1, locIntensidad = -1, locPesoCuarto = -1;
+
+    RenderTexture2D escena{};
+    RenderTexture2D mitad[2]{};
+    RenderTexture2D cuarto[2]{};
+    int ancho = 0, alto = 0;            // Píxeles de la escena
+    float escala = 1.0f;                // Píxeles de la escena por unidad de dibujo
+
+    CalidadBloom calidad = BLOOM_ALTA;
+    float valorUmbral = 0.8f;
+    float valorRodilla = 0.1f;
+    float intensidad = 0.9f;
+
+    // Las texturas de render se guardan invertidas en Y: fuente con alto negativo
+    static Rectangle fuente(const RenderTexture2D& rt) {
+        return {0, 0, static_cast<float>(rt.texture.width), -static_cast<float>(rt.texture.height)};
+    }
+
+    static Rectangle completo(const RenderTexture2D& rt) {
+        return {0, 0, static_cast<float>(rt.texture.width), static_cast<float>(rt.texture.height)};
+    }
+
+    static RenderTexture2D crear(int w, int h) {
+        RenderTexture2D rt = LoadRenderTexture(std::max(1, w), std::max(1, h));
+        SetTextureFilter(rt.texture, TEXTURE_FILTER_BILINEAR);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(rt));
+        return rt;
+    }
+
+    void crearTexturas() {
+        escena = crear(ancho, alto);
+        for (int i = 0; i < 2; i++) {
+            mitad[i] = crear(ancho / 2, alto / 2);
+            cuarto[i] = crear(ancho / 4, alto / 4);
+        }
+    }
+
+    void liberarTexturas() {
+        for (RenderTexture2D* rt : {&escena, &mitad[0], &mitad[1], &cuarto[0], &cuarto[1]}) {
+            if (rt->id != 0) {
+                ContabilidadMemoria::liberaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(*rt));
+                UnloadRenderTexture(*rt);
+            }
+            *rt = RenderTexture2D{};
+        }
+    }
+
+    // Horizontal de par[0] a par[1] y vertical de vuelta a par[0]
+    void desenfocar(RenderTexture2D* par, int muestras) {
+        float texelX = 1.0f / par[0].texture.width, texelY = 1.0f / par[0].texture.height;
+        const float pasos[2][2] = {{texelX, 0.0f}, {0.0f, texelY}};
+        for (int i = 0; i < 2; i++) {
+            const RenderTexture2D& origen = par[i];
+            RenderTexture2D& destino = par[1 - i];
+            BeginTextureMode(destino);
+            BeginShaderMode(desenfoque);
+            SetShaderValue(desenfoque, locPaso, pasos[i], SHADER_UNIFORM_VEC2);
+            SetShaderValue(desenfoque, locMuestras, &muestras, SHADER_UNIFORM_INT);
+            DrawTexturePro(origen.texture, fuente(origen), completo(destino), {0, 0}, 0, WHITE);
+            EndShaderMode();
+            EndTextureMode();
+        }
+    }
+
+public:
+    // Con la ventana ya abierta. La escena mide anchoEscena x altoEscena píxeles y se dibuja
+    // con escalaEscena como zoom (el tamaño interno y la escala del lienzo). false si algún
+    // shader no compila (se dibuja sin bloom).
+    bool cargar(int anchoEscena, int altoEscena, float escalaEscena = 1.0f) {
+        descargar();
+        umbral = LoadShaderFromMemory(nullptr, BloomGLSL::UMBRAL_FS);
+        desenfoque = LoadShaderFromMemory(nullptr, BloomGLSL::DESENFOQUE_FS);
+        composicion = LoadShaderFromMemory(nullptr, BloomGLSL::COMPOSICION_FS);
+        if (umbral.id == 0 || desenfoque.id == 0 || composicion.id == 0) {
+            descargar();
+            return false;
+        }
+        locUmbral = GetShaderLocation(umbral, "umbral");
+        locRodilla = GetShaderLocation(umbral, "rodilla");
+        locPaso = GetShaderLocation(desenfoque, "paso");
+        locMuestras = GetShaderLocation(desenfoque, "muestras");
+        locMitad = GetShaderLocation(composicion, "mitad");
+        locCuarto = GetShaderLocation(composicion, "cuarto");
+        locIntensidad = GetShaderLocation(composicion, "intensidad");
+        locPesoCuarto = GetShaderLocation(composicion, "pesoCuarto");
+
+        ancho = anchoEscena;
+        alto = altoEscena;
+        escala = escalaEscena;
+        crearTexturas();
+        return escena.id != 0;
+    }
+
+    // Rehace las texturas si cambió el tamaño o la escala del lienzo (los shaders se quedan)
+    void ajustar(int anchoEscena, int altoEscena, float escalaEscena) {
+        if (!listo() || (anchoEscena == ancho && altoEscena == alto && escalaEscena == escala)) return;
+        liberarTexturas();
+        ancho = anchoEscena;
+        alto = altoEscena;
+        escala = escalaEscena;
+        crearTexturas();
+    }
+
+    bool listo() const { return escena.id != 0; }
+    bool activo() const { return listo() && calidad != BLOOM_APAGADO; }
+
+    void setCalidad(CalidadBloom c) { calidad = c; }
+    CalidadBloom getCalidad() const { return calidad; }
+    void setUmbral(float valor) { valorUmbral = valor; }
+    void setIntensidad(float valor) { intensidad = valor; }
+
+    static const char* nombreCalidad(CalidadBloom c) {
+        switch (c) {
+            case BLOOM_APAGADO: return "apagado";
+            case BLOOM_BAJA: return "baja";
+            default: return "alta";
+        }
+    }
+
+    // Entre comenzar y terminar se dibuja la escena, en las mismas coordenadas que el lienzo
+    // (el que llama la limpia)
+    void comenzar() {
+        BeginTextureMode(escena);
+        Camera2D camara = {};
+        camara.zoom = escala;
+        BeginMode2D(camara);
+    }
+
+    void terminar() {
+        EndMode2D();
+        EndTextureMode();
+    }
+
+    // Extrae los brillos, añade los emisivos (en coordenadas de la escena, con mezcla aditiva)
+    // y desenfoca. Después, componer().
+    template <typename F>
+    void procesar(F&& emisivos) {
+        if (!activo()) return;
+        BeginTextureMode(mitad[0]);
+        ClearBackground(BLACK);
+        BeginShaderMode(umbral);
+        SetShaderValue(umbral, locUmbral, &valorUmbral, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(umbral, locRodilla, &valorRodilla, SHADER_UNIFORM_FLOAT);
+        DrawTexturePro(escena.texture, fuente(escena), completo(mitad[0]), {0, 0}, 0, WHITE);
+        EndShaderMode();
+
+        Camera2D aMitad = {};
+        aMitad.zoom = escala * mitad[0].texture.width / ancho;
+        BeginMode2D(aMitad);
+        BeginBlendMode(BLEND_ADDITIVE);
+        emisivos();
+        EndBlendMode();
+        EndMode2D();
+        EndTextureMode();
+
+        bool alta = calidad == BLOOM_ALTA;
+        desenfocar(mitad, alta ? 5 : 3);
+        if (alta) {
+            BeginTextureMode(cuarto[0]);
+            ClearBackground(BLACK);
+            DrawTexturePro(mitad[0].texture, fuente(mitad[0]), completo(cuarto[0]), {0, 0}, 0, WHITE);
+            EndTextureMode();
+            desenfocar(cuarto, 5);
+        }
+    }
+
+    void procesar() { procesar([]() {}); }
+
+    // Escena más brillo sobre el destino actual (en coordenadas de dibujo: con el lienzo, su
+    // rectángulo virtual); sin bloom activo, solo la escena
+    void componer(Rectangle destino) {
+        if (!listo()) return;
+        if (!activo()) {
+            DrawTexturePro(escena.texture, fuente(escena), destino, {0, 0}, 0, WHITE);
+            return;
+        }
+        float pesoCuarto = calidad == BLOOM_ALTA ? 1.0f : 0.0f;
+        BeginShaderMode(composicion);
+        SetShaderValueTexture(composicion, locMitad, mitad[0].texture);
+        SetShaderValueTexture(composicion, locCuarto, cuarto[0].texture);
+        SetShaderValue(composicion, locIntensidad, &intensidad, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(composicion, locPesoCuarto, &pesoCuarto, SHADER_UNIFORM_FLOAT);
+        DrawTexturePro(escena.texture, fuente(escena), destino, {0, 0}, 0, WHITE);
+        EndShaderMode();
+    }
+
+    void descargar() {
+        for (Shader* s : {&umbral, &desenfoque, &composicion}) {
+            if (s->id != 0) UnloadShader(*s);
+            *s = Shader{};
+        }
+        liberarTexturas();
+        ancho = alto = 0;
+        escala = 1.0f;
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef DUOMAZE_CAMPOS_DISTANCIA_H
+#define DUOMAZE_CAMPOS_DISTANCIA_H
+
+// Campos de distancia precalculados por nivel para las pistas del jugador.
+//
+// Para cada objetivo (botón 1, 2, 3 y meta), cada rol y cada combinación de puertas
+// abiertas (3 botones = 8 estados) se guarda la distancia en tiles desde cualquier tile
+// hasta la más cercana del objetivo: un BFS multiorigen con la misma regla de paso que
+// la colisión (CollisionSystem::canPassTile). Son 4 x 2 x 8 rejillas de uint16 = 37.5 KB
+// por nivel, y con ellas la dirección óptima de cada jugador sale mirando sus 4 vecinos.
+
+#include "simulacion.h"
+#include <array>
+#include <cstdint>
+
+namespace CamposConstants {
+    constexpr uint16_t SIN_CAMINO = 0xFFFF;
+    constexpr int ESTADOS_PUERTAS = 8;
+    constexpr int CELDAS = GameConstants::MAP_WIDTH * GameConstants::MAP_HEIGHT;
+}
+
+// Dirección hacia la siguiente tile del camino óptimo
+enum DireccionPista : uint8_t { PISTA_NINGUNA, PISTA_IZQ, PISTA_DER, PISTA_ARR, PISTA_ABA };
+
+class CamposDistancia {
+public:
+    enum Objetivo { OBJ_BOTON_1, OBJ_BOTON_2, OBJ_BOTON_3, OBJ_META, NUM_OBJETIVOS };
+
+    using Campo = std::array<uint16_t, CamposConstants::CELDAS>;
+
+private:
+    // [objetivo][rol: 0 slave, 1 master][puertas abiertas]
+    Campo campos[NUM_OBJETIVOS][2][CamposConstants::ESTADOS_PUERTAS];
+    bool existe[NUM_OBJETIVOS] = {};
+
+    static int tileObjetivo(Objetivo o) {
+        switch (o) {
+            case OBJ_BOTON_1: return BOTON_1;
+            case OBJ_BOTON_2: return BOTON_2;
+            case OBJ_BOTON_3: return BOTON_3;
+            default:          return META;
+        }
+    }
+
+    // BFS multiorigen desde todas las tiles del objetivo. Cola fija: cada celda entra una vez.
+    static void bfs(const MapaNivel& mapa, int tileMeta, bool esMaster, uint8_t puertas, Campo& campo) {
+        using namespace GameConstants;
+        std::array<uint16_t, CamposConstants::CELDAS> cola;
+        int cabeza = 0, fin = 0;
+
+        campo.fill(CamposConstants::SIN_CAMINO);
+        for (int y = 0; y < MAP_HEIGHT; y++) {
+            for (int x = 0; x < MAP_WIDTH; x++) {
+                if (mapa[y][x] == tileMeta) {
+                    int c = y * MAP_WIDTH + x;
+                    campo[c] = 0;
+                    cola[fin++] = static_cast<uint16_t>(c);
+                }
+            }
+        }
+
+        while (cabeza < fin) {
+            int c = cola[cabeza++];
+            int x = c % MAP_WIDTH, y = c / MAP_WIDTH;
+            const int vx[4] = { x - 1, x + 1, x, x };
+            const int vy[4] = { y, y, y - 1, y + 1 };
+            for (int k = 0; k < 4; k++) {
+                if (vx[k] < 0 || vx[k] >= MAP_WIDTH || vy[k] < 0 || vy[k] >= MAP_HEIGHT) continue;
+                int v = vy[k] * MAP_WIDTH + vx[k];
+                if (campo[v] != CamposConstants::SIN_CAMINO) continue;
+                if (!CollisionSystem::canPassTile(mapa[vy[k]][vx[k]], esMaster, puertas)) continue;
+                campo[v] = static_cast<uint16_t>(campo[c] + 1);
+                cola[fin++] = static_cast<uint16_t>(v);
+            }
+        }
+    }
+
+public:
+    void calcular(const MapaNivel& mapa) {
+        for (int o = 0; o < NUM_OBJETIVOS; o++) {
+            existe[o] = false;
+            for (const auto& fila : mapa) {
+                for (int t : fila) existe[o] = existe[o] || t == tileObjetivo(static_cast<Objetivo>(o));
+            }
+            for (int rol = 0; rol < 2; rol++) {
+                for (int p = 0; p < CamposConstants::ESTADOS_PUERTAS; p++) {
+                    bfs(mapa, tileObjetivo(static_cast<Objetivo>(o)), rol == 1, static_cast<uint8_t>(p), campos[o][rol][p]);
+                }
+            }
+        }
+    }
+
+    static int celdaDe(Vector2 pos) {
+        using namespace GameConstants;
+        int x = static_cast<int>(pos.x) / TILE_SIZE;
+        int y = static_cast<int>(pos.y) / TILE_SIZE;
+        x = x < 0 ? 0 : (x >= MAP_WIDTH ? MAP_WIDTH - 1 : x);
+        y = y < 0 ? 0 : (y >= MAP_HEIGHT ? MAP_HEIGHT - 1 : y);
+        return y * MAP_WIDTH + x;
+    }
+
+    uint16_t distancia(Objetivo o, bool esMaster, uint8_t botones, int celda) const {
+        return campos[o][esMaster ? 1 : 0][botones & (CamposConstants::ESTADOS_PUERTAS - 1)][celda];
+    }
+
+    bool alcanzable(Objetivo o, bool esMaster, uint8_t botones, int celda) const {
+        return existe[o] && distancia(o, esMaster, botones, celda) != CamposConstants::SIN_CAMINO;
+    }
+
+    // Vecino con menor distancia; PISTA_NINGUNA si ya está en el objetivo o no hay camino
+    DireccionPista direccion(Objetivo o, bool esMaster, uint8_t botones, int celda) const {
+        using namespace GameConstants;
+        const Campo& campo = campos[o][esMaster ? 1 : 0][botones & (CamposConstants::ESTADOS_PUERTAS - 1)];
+        uint16_t actual = campo[celda];
+        if (actual == 0 || actual == CamposConstants::SIN_CAMINO) return PISTA_NINGUNA;
+
+        int x = celda % MAP_WIDTH, y = celda / MAP_WIDTH;
+        DireccionPista mejor = PISTA_NINGUNA;
+        uint16_t minimo = actual;
+        auto probar = [&](int vx, int vy, DireccionPista d) {
+            if (vx < 0 || vx >= MAP_WIDTH || vy < 0 || vy >= MAP_HEIGHT) return;
+            uint16_t dv = campo[vy * MAP_WIDTH + vx];
+            if (dv < minimo) { minimo = dv; mejor = d; }
+        };
+        probar(x - 1, y, PISTA_IZQ);
+        probar(x + 1, y, PISTA_DER);
+        probar(x, y - 1, PISTA_ARR);
+        probar(x, y + 1, PISTA_ABA);
+        return mejor;
+    }
+
+    // Objetivo que se le sugiere a un jugador, con las mismas prioridades que el compañero IA:
+    // meta si los dos llegan; si no, su botón; si no, el botón 3; si no, adelantarse a la meta.
+    // Devuelve NUM_OBJETIVOS si no hay ninguno alcanzable.
+    Objetivo objetivoPara(bool esMaster, int celdaPropia, int celdaOtro, uint8_t botones) const {
+        const Objetivo botonPropio = esMaster ? OBJ_BOTON_1 : OBJ_BOTON_2;
+        const uint8_t bitPropio = esMaster ? BIT_BOTON_1 : BIT_BOTON_2;
+
+        if (alcanzable(OBJ_META, esMaster, botones, celdaPropia) && alcanzable(OBJ_META, !esMaster, botones, celdaOtro)) {
+            return OBJ_META;
+        }
+        if (!(botones & bitPropio) && alcanzable(botonPropio, esMaster, botones, celdaPropia)) return botonPropio;
+        if (!(botones & BIT_BOTON_3) && alcanzable(OBJ_BOTON_3, esMaster, botones, celdaPropia)) return OBJ_BOTON_3;
+        if (alcanzable(OBJ_META, esMaster, botones, celdaPropia)) return OBJ_META;
+        return NUM_OBJETIVOS;
+    }
+};
+
+#endif
@@ -0,0 +1,440 @@
+#ifndef DUOMAZE_COMPANERO_IA_H
+#define DUOMAZE_COMPANERO_IA_H
+
+// Compañero controlado por la IA para jugar solo: maneja al master o al slave.
+//
+// Planificación: el grafo conjunto (tile del master, tile del slave) es el producto de
+// los grafos de cada rol, porque los jugadores no se bloquean entre sí y se mueven a la
+// vez. El camino más corto conjunto hacia un objetivo de la forma "master en A y slave
+// en B" es el máximo de los dos caminos individuales, así que en vez de buscar sobre
+// ancho*alto al cuadrado estados se mantiene un D* Lite por (rol, objetivo) sobre la
+// rejilla de ese rol. Eso es lo que deja escalar a mapas 100 veces mayores.
+//
+// Cada D* Lite busca hacia atrás desde las tiles objetivo. Cuando se abre una puerta solo
+// se actualizan esas tiles y sus vecinas y la búsqueda se repara desde ahí; el inicio que
+// se mueve se absorbe con el término km. Las expansiones por tick tienen un presupuesto:
+// si una búsqueda no termina, continúa en el tick siguiente con la última decisión.
+//
+// Botones, puertas y canales salen de los metadatos del nivel (RasgosTile), así que los
+// disparadores propios de un nivel se planifican igual que los básicos. Un botón enclavado
+// deja de ser objetivo cuando su canal se activa.
+
+#include "simulacion.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace CompaneroConstants {
+    constexpr int PRESUPUESTO_EXPANSIONES = 1000;   // Por tick, entre todas las búsquedas (~0.25 ms)
+    constexpr int ZONA_MUERTA = 2;                  // px: menos que PLAYER_SPEED, evita oscilar
+}
+
+// Rejilla de tiles de cualquier tamaño (el juego usa MAP_WIDTH x MAP_HEIGHT)
+struct RejillaTiles {
+    const int* tiles;
+    int ancho;
+    int alto;
+
+    int en(int celda) const { return tiles[celda]; }
+};
+
+// D* Lite (Koenig y Likhachev) sobre una rejilla 4-conexa de coste 1 y varias celdas objetivo
+class DStarLite {
+public:
+    static constexpr uint32_t INF = 1u << 30;
+
+private:
+    struct Clave {
+        uint32_t k1, k2;
+        bool operator<(const Clave& o) const { return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2); }
+    };
+
+    struct Entrada {
+        Clave clave;
+        int celda;
+        bool operator<(const Entrada& o) const { return o.clave < clave; }  // Montículo de mínimos
+    };
+
+    int ancho, alto;
+    const std::vector<uint8_t>& pasable;
+    std::vector<uint32_t> g, rhs;
+    std::vector<uint8_t> esObjetivo;
+    std::vector<Clave> claveEnCola;     // Cola con borrado perezoso: vale la entrada cuya clave coincide
+    std::vector<uint8_t> enCola;
+    std::priority_queue<Entrada> cola;
+    int inicio = -1;
+    int ultimoInicio = -1;
+    uint32_t km = 0;
+    bool hayObjetivos = false;
+
+    uint32_t h(int a, int b) const {
+        return static_cast<uint32_t>(std::abs(a % ancho - b % ancho) + std::abs(a / ancho - b / ancho));
+    }
+
+    Clave calcularClave(int u) const {
+        uint32_t m = std::min(g[u], rhs[u]);
+        if (m >= INF) return {INF, INF};
+        return {m + h(inicio, u) + km, m};
+    }
+
+    template <typename F>
+    void vecinos(int u, F&& f) const {
+        int x = u % ancho, y = u / ancho;
+        if (x > 0) f(u - 1);
+        if (x + 1 < ancho) f(u + 1);
+        if (y > 0) f(u - ancho);
+        if (y + 1 < alto) f(u + ancho);
+    }
+
+    void actualizarVertice(int u) {
+        if (!esObjetivo[u]) {
+            uint32_t mejor = INF;
+            if (pasable[u]) {
+                vecinos(u, [&](int v) {
+                    if (pasable[v] && g[v] < INF) mejor = std::min(mejor, g[v] + 1);
+                });
+            }
+            rhs[u] = mejor;
+        }
+        if (g[u] != rhs[u]) {
+            Clave k = calcularClave(u);
+            claveEnCola[u] = k;
+            enCola[u] = 1;
+            cola.push({k, u});
+        } else {
+            enCola[u] = 0;
+        }
+    }
+
+public:
+    int expansiones = 0;                // Acumuladas (para las métricas)
+
+    DStarLite(int ancho, int alto, const std::vector<uint8_t>& pasable)
+        : ancho(ancho), alto(alto), pasable(pasable),
+          g(ancho * alto, INF), rhs(ancho * alto, INF), esObjetivo(ancho * alto, 0),
+          claveEnCola(ancho * alto), enCola(ancho * alto, 0) {}
+
+    void agregarObjetivo(int celda) {
+        esObjetivo[celda] = 1;
+        hayObjetivos = true;
+    }
+
+    // La celda deja de ser objetivo (su botón ya está activo): se repara como un cambio de arista
+    void quitarObjetivo(int celda) {
+        if (!esObjetivo[celda]) return;
+        esObjetivo[celda] = 0;
+        if (inicio < 0) return;
+        km += h(ultimoInicio, inicio);
+        ultimoInicio = inicio;
+        actualizarVertice(celda);
+    }
+
+    bool tieneObjetivos() const { return hayObjetivos; }
+
+    void fijarInicio(int celda) {
+        if (inicio < 0) {
+            // Primera vez: siembra la cola con los objetivos
+            inicio = ultimoInicio = celda;
+            for (int u = 0; u < ancho * alto; u++) {
+                if (esObjetivo[u]) {
+                    rhs[u] = pasable[u] ? 0 : INF;
+                    actualizarVertice(u);
+                }
+            }
+            return;
+        }
+        inicio = celda;
+    }
+
+    // La pasabilidad de la celda cambió (puerta abierta): repara sus aristas
+    void celdaCambiada(int u) {
+        km += h(ultimoInicio, inicio);
+        ultimoInicio = inicio;
+        if (esObjetivo[u]) rhs[u] = pasable[u] ? 0 : INF;
+        actualizarVertice(u);
+        vecinos(u, [&](int v) { actualizarVertice(v); });
+    }
+
+    // Devuelve true si la distancia del inicio ya es exacta; false si se agotó el presupuesto
+    bool calcular(int& presupuesto) {
+        while (true) {
+            // Descartar entradas obsoletas
+            while (!cola.empty()) {
+                const Entrada& e = cola.top();
+                if (enCola[e.celda] && !(e.clave < claveEnCola[e.celda]) && !(claveEnCola[e.celda] < e.clave)) break;
+                cola.pop();
+            }
+            Clave kInicio = calcularClave(inicio);
+            if (cola.empty() || !(cola.top().clave < kInicio)) {
+                if (rhs[inicio] == g[inicio] || cola.empty()) return true;
+            }
+            if (presupuesto <= 0) return false;
+            presupuesto--;
+            expansiones++;
+
+            Entrada e = cola.top();
+            cola.pop();
+            int u = e.celda;
+            enCola[u] = 0;
+            Clave nueva = calcularClave(u);
+            if (e.clave < nueva) {
+                claveEnCola[u] = nueva;
+                enCola[u] = 1;
+                cola.push({nueva, u});
+            } else if (g[u] > rhs[u]) {
+                g[u] = rhs[u];
+                vecinos(u, [&](int v) { actualizarVertice(v); });
+            } else {
+                g[u] = INF;
+                actualizarVertice(u);
+                vecinos(u, [&](int v) { actualizarVertice(v); });
+            }
+        }
+    }
+
+    uint32_t distancia() const { return inicio < 0 ? INF : std::min(g[inicio], rhs[inicio]); }
+
+    // Vecina por la que seguir (-1 si ya está en un objetivo o no hay camino)
+    int siguiente() const {
+        if (inicio < 0 || esObjetivo[inicio] || distancia() >= INF) return -1;
+        int mejor = -1;
+        uint32_t mejorCoste = INF;
+        vecinos(inicio, [&](int v) {
+            if (pasable[v] && g[v] + 1 < mejorCoste) {
+                mejorCoste = g[v] + 1;
+                mejor = v;
+            }
+        });
+        return mejor;
+    }
+};
+
+class CompaneroIA {
+public:
+    // Por rol: botones que pulsa él solo y botones que necesitan a los dos (MODO_AMBOS)
+    enum Objetivo { OBJ_META, OBJ_BOTON_PROPIO, OBJ_BOTON_CONJUNTO, NUM_OBJETIVOS };
+
+    struct Estadisticas {
+        uint32_t ticks = 0;
+        double msTotal = 0.0;
+        double msMaximo = 0.0;
+        uint32_t ticksSinTerminar = 0;      // Ticks en que se agotó el presupuesto
+    };
+
+private:
+    RejillaTiles rejilla;
+    bool esMaster;
+    const MetadatosNivel& meta;
+    Canales canales = 0;
+    std::vector<uint8_t> pasable[2];    // [0] slave, [1] master
+    std::unique_ptr<DStarLite> busquedas[2][NUM_OBJETIVOS];
+    std::vector<int> puertas[TriggerConstants::MAX_CANALES];    // Celdas de las puertas de cada canal
+    std::vector<int> botones[TriggerConstants::MAX_CANALES];    // Celdas de los botones de cada canal
+    uint8_t ultimaDecision = 0;
+    Objetivo objetivoActual = OBJ_META;
+    Estadisticas stats;
+
+    // Qué objetivo de la búsqueda del rol es la tile (NUM_OBJETIVOS si ninguno)
+    Objetivo objetivoDe(const RasgosTile& r, int rol) const {
+        if (r.meta) return OBJ_META;
+        if (r.tipo != TRIGGER_BOTON || !(r.roles & (rol == 1 ? ROL_MASTER : ROL_SLAVE))) return NUM_OBJETIVOS;
+        return (r.modo & MODO_AMBOS) ? OBJ_BOTON_CONJUNTO : OBJ_BOTON_PROPIO;
+    }
+
+    bool enclavadoActivo(int canal) const { return (meta.enclavados & canales & bitCanal(canal)) != 0; }
+
+    int celdaDe(Vector2 pos) const {
+        int x = std::max(0, std::min(rejilla.ancho - 1, static_cast<int>(pos.x / GameConstants::TILE_SIZE)));
+        int y = std::max(0, std::min(rejilla.alto - 1, static_cast<int>(pos.y / GameConstants::TILE_SIZE)));
+        return y * rejilla.ancho + x;
+    }
+
+    void calcularPasable(int rol) {
+        std::vector<uint8_t>& p = pasable[rol];
+        for (int c = 0; c < rejilla.ancho * rejilla.alto; c++) {
+            p[c] = CollisionSystem::canPassTile(rejilla.en(c), rol == 1, canales, meta) ? 1 : 0;
+        }
+    }
+
+    // Distancia exacta del rol a un objetivo (INF si no hay camino, -1 si aún sin terminar)
+    int64_t distancia(int rol, Objetivo o, int celda, int& presupuesto) {
+        DStarLite* b = busquedas[rol][o].get();
+        if (b == nullptr || !b->tieneObjetivos()) return DStarLite::INF;
+        b->fijarInicio(celda);
+        if (!b->calcular(presupuesto)) return -1;
+        return b->distancia();
+    }
+
+    // Canales que cambian: abren o cierran sus puertas y se reparan solo esas aristas; los
+    // botones enclavados que se activan dejan de ser objetivo
+    void actualizarCanales(Canales nuevos) {
+        Canales cambiados = nuevos ^ canales;
+        if (cambiados == 0) return;
+        canales = nuevos;
+        for (int k = 0; k < TriggerConstants::MAX_CANALES; k++) {
+            if ((cambiados & bitCanal(k)) == 0) continue;
+            for (int rol = 0; rol < 2; rol++) {
+                for (int celda : puertas[k]) {
+                    pasable[rol][celda] = CollisionSystem::canPassTile(rejilla.en(celda), rol == 1, canales, meta) ? 1 : 0;
+                    for (auto& b : busquedas[rol]) {
+                        if (b) b->celdaCambiada(celda);
+                    }
+                }
+                if (!enclavadoActivo(k)) continue;
+                for (int celda : botones[k]) {
+                    for (auto& b : busquedas[rol]) {
+                        if (b) b->quitarObjetivo(celda);
+                    }
+                }
+            }
+        }
+    }
+
+    uint8_t dirigirHacia(Vector2 pos, int celdaActual, int celdaSiguiente) const {
+        const float mitad = GameConstants::TILE_SIZE / 2.0f;
+        auto centro = [&](int c) {
+            return Vector2{(c % rejilla.ancho) * static_cast<float>(GameConstants::TILE_SIZE) + mitad,
+                           (c / rejilla.ancho) * static_cast<float>(GameConstants::TILE_SIZE) + mitad};
+        };
+        Vector2 objetivo = centro(celdaSiguiente >= 0 ? celdaSiguiente : celdaActual);
+        // Al cambiar de tile se mantiene el eje perpendicular centrado para no rozar esquinas
+        Vector2 actual = centro(celdaActual);
+        if (celdaSiguiente >= 0) {
+            if (celdaSiguiente / rejilla.ancho == celdaActual / rejilla.ancho) objetivo.y = actual.y;
+            else objetivo.x = actual.x;
+        }
+        uint8_t input = 0;
+        float dx = objetivo.x - pos.x;
+        float dy = objetivo.y - pos.y;
+        // Primero se alinea el eje perpendicular: en diagonal junto a una esquina la
+        // colisión rechazaría el movimiento entero y el jugador se quedaría atascado
+        if (celdaSiguiente >= 0) {
+            bool horizontal = celdaSiguiente / rejilla.ancho == celdaActual / rejilla.ancho;
+            float perpendicular = horizontal ? dy : dx;
+            if (std::fabs(perpendicular) > CompaneroConstants::ZONA_MUERTA) {
+                if (horizontal) dx = 0.0f;
+                else dy = 0.0f;
+            }
+        }
+        if (dx < -CompaneroConstants::ZONA_MUERTA) input |= INPUT_IZQ;
+        if (dx > CompaneroConstants::ZONA_MUERTA) input |= INPUT_DER;
+        if (dy < -CompaneroConstants::ZONA_MUERTA) input |= INPUT_ARR;
+        if (dy > CompaneroConstants::ZONA_MUERTA) input |= INPUT_ABA;
+        return input;
+    }
+
+public:
+    // meta tiene que vivir tanto como la IA (las tablas de metadatosNivel son estáticas)
+    CompaneroIA(const RejillaTiles& rejilla, bool esMaster, Canales canalesIniciales = 0,
+                const MetadatosNivel& meta = METADATOS_BASICOS)
+        : rejilla(rejilla), esMaster(esMaster), meta(meta), canales(canalesIniciales) {
+        const int n = rejilla.ancho * rejilla.alto;
+        for (int rol = 0; rol < 2; rol++) {
+            pasable[rol].resize(n);
+            calcularPasable(rol);
+        }
+        for (int c = 0; c < n; c++) {
+            const RasgosTile& r = meta.rasgos(rejilla.en(c));
+            if (r.tipo == TRIGGER_PUERTA) puertas[r.canal].push_back(c);
+            if (r.tipo == TRIGGER_BOTON) botones[r.canal].push_back(c);
+        }
+        // Una búsqueda por rol y objetivo, con las tiles que ese rol puede usar para él
+        for (int rol = 0; rol < 2; rol++) {
+            for (int o = 0; o < NUM_OBJETIVOS; o++) {
+                auto b = std::make_unique<DStarLite>(rejilla.ancho, rejilla.alto, pasable[rol]);
+                for (int c = 0; c < n; c++) {
+                    const RasgosTile& r = meta.rasgos(rejilla.en(c));
+                    if (objetivoDe(r, rol) != o || (r.tipo == TRIGGER_BOTON && enclavadoActivo(r.canal))) continue;
+                    b->agregarObjetivo(c);
+                }
+                busquedas[rol][o] = std::move(b);
+            }
+        }
+    }
+
+    static RejillaTiles rejillaDe(const MapaNivel& mapa) {
+        return {&mapa[0][0], GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT};
+    }
+
+    // Un tick: input del jugador de la IA a partir de las posiciones y los canales activos
+    uint8_t decidir(Vector2 propia, Vector2 companero, Canales canalesActuales) {
+        auto inicio = std::chrono::steady_clock::now();
+        actualizarCanales(canalesActuales);
+
+        const int rolPropio = esMaster ? 1 : 0;
+        const int rolOtro = 1 - rolPropio;
+        const int celdaPropia = celdaDe(propia);
+        const int celdaOtro = celdaDe(companero);
+        int presupuesto = CompaneroConstants::PRESUPUESTO_EXPANSIONES;
+        bool terminado = true;
+
+        auto alcanzable = [&](int rol, Objetivo o, int celda) {
+            int64_t d = distancia(rol, o, celda, presupuesto);
+            if (d < 0) terminado = false;
+            return d >= 0 && d < DStarLite::INF;
+        };
+
+        // Prioridades: meta si los dos llegan; si no, un botón propio sin activar; si no,
+        // esperar en un botón conjunto (se activa cuando llegue el otro); si no, adelantarse
+        // hacia la meta. Los botones enclavados ya activos no son objetivo.
+        Objetivo elegido = objetivoActual;
+        bool hayEleccion = false;
+        if (alcanzable(rolPropio, OBJ_META, celdaPropia) && alcanzable(rolOtro, OBJ_META, celdaOtro)) {
+            elegido = OBJ_META;
+            hayEleccion = true;
+        } else if (alcanzable(rolPropio, OBJ_BOTON_PROPIO, celdaPropia)) {
+            elegido = OBJ_BOTON_PROPIO;
+            hayEleccion = true;
+        } else if (alcanzable(rolPropio, OBJ_BOTON_CONJUNTO, celdaPropia)) {
+            elegido = OBJ_BOTON_CONJUNTO;
+            hayEleccion = true;
+        } else if (alcanzable(rolPropio, OBJ_META, celdaPropia)) {
+            elegido = OBJ_META;
+            hayEleccion = true;
+        }
+
+        uint8_t input = 0;
+        if (hayEleccion || !terminado) {
+            if (hayEleccion) objetivoActual = elegido;
+            DStarLite* b = busquedas[rolPropio][objetivoActual].get();
+            if (b != nullptr && b->tieneObjetivos()) {
+                b->fijarInicio(celdaPropia);
+                if (b->calcular(presupuesto)) {
+                    input = dirigirHacia(propia, celdaPropia, b->siguiente());
+                } else {
+                    terminado = false;
+                    input = ultimaDecision;
+                }
+            }
+        }
+        ultimaDecision = input;
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+        stats.ticks++;
+        stats.msTotal += ms;
+        stats.msMaximo = std::max(stats.msMaximo, ms);
+        if (!terminado) stats.ticksSinTerminar++;
+        return input;
+    }
+
+    // Expansiones acumuladas por todas las búsquedas (para comparar reparación y búsqueda nueva)
+    int getExpansiones() const {
+        int total = 0;
+        for (auto& rol : busquedas) {
+            for (auto& b : rol) {
+                if (b) total += b->expansiones;
+            }
+        }
+        return total;
+    }
+
+    Objetivo getObjetivo() const { return objetivoActual; }
+    const Estadisticas& getEstadisticas() const { return stats; }
+};
+
+#endif
@@ -5,6 +5,13 @@ g++ -o DuoMaze main_a.cpp -lraylib -lm -lpthread -ldl -lX11 -O2 -Wno-narrowing
 
 if [ $? -eq 0 ]; then
     echo "✅ ¡Compilación exitosa!"
+    
+    # Archivo de recursos preprocesados (opcional, el juego usa los sueltos si falta)
+    if [ -f "empaquetador/empaquetador.cpp" ]; then
+        (cd empaquetador && ./compile_empaquetador.sh > /dev/null) && \
+            ./empaquetador/empaquetador resources/duomaze.pak > /dev/null && \
+            echo "📦 resources/duomaze.pak generado"
+    fi
     echo "🎮 Ejecuta: ./DuoMaze"
 else
     echo "❌ Error en la compilación"
@@ -30,7 +30,7 @@ echo "🔨 Compilando $OUTPUT_EXE..."
 x86_64-w64-mingw32-g++ -o "$OUTPUT_EXE" "$MAIN_FILE" \
     -I"$RAYLIB_DIR/include" \
     -L"$RAYLIB_DIR/lib" \
-    -lraylib -lopengl32 -lgdi32 -lwinmm \
+    -lraylib -lopengl32 -lgdi32 -lwinmm -lws2_32 \
     -static -lpthread -std=c++17 -O2 \
     -DWIN32_LEAN_AND_MEAN -DNOGDI -DNOUSER -DNOMINMAX
 
@@ -54,6 +54,13 @@ if [ $? -eq 0 ] && [ -f "$OUTPUT_EXE" ]; then
     # Copiar ejecutable al directorio raíz del paquete
     cp "$OUTPUT_EXE" "$TEMP_DIR/"
     
+    # Empaquetar sprites reescalados y atlas de fuentes en un solo archivo
+    if [ -f "empaquetador/empaquetador.cpp" ]; then
+        echo "📦 Generando resources/duomaze.pak..."
+        (cd empaquetador && ./compile_empaquetador.sh > /dev/null) && \
+            ./empaquetador/empaquetador resources/duomaze.pak
+    fi
+    
     # Copiar archivos de recursos manteniendo estructura
     if [ -d "resources" ]; then
         echo "📁 Copiando recursos..."
@@ -132,6 +139,32 @@ CONTROLES:
 - Audio: P (pausar), M (mutear), U (volumen alto), H (volumen bajo)
 - Controles audio: V (mostrar/ocultar)
 - Niveles: ENTER (avanzar al siguiente nivel)
+- Pistas: I (flecha hacia el siguiente paso de cada personaje)
+
+MODO ONLINE (UDP, puerto 27960 por defecto):
+- Anfitrión (jugador ROJO): DuoMaze.exe --host [puerto]
+- Invitado (jugador AZUL): DuoMaze.exe --unir <ip> [puerto]
+- Cada jugador puede usar WASD o flechas; solo el anfitrión avanza de nivel con ENTER
+- Opcional: añadir --rollback en ambos para jugar entre pares con rollback
+
+UN JUGADOR CON COMPAÑERO IA:
+- DuoMaze.exe --companero slave   (tú llevas al ROJO con WASD, la IA al AZUL)
+- DuoMaze.exe --companero master  (tú llevas al AZUL con flechas, la IA al ROJO)
+
+MODO FIESTA (2 a 8 jugadores en el mismo equipo):
+- DuoMaze.exe --jugadores <2-8>
+- Jugador 1 (ROJO): WASD, jugador 2 (AZUL): flechas, del 3 en adelante un mando cada uno
+- Los impares son del equipo ROJO y los pares del AZUL; el nivel se completa con todos en la meta
+- Objetos móviles: peligros que patrullan (te devuelven al inicio), cajas que se empujan
+  y puertas correderas que se abren con el canal de su botón
+
+OPCIONES DE RENDER:
+- DuoMaze.exe --tilemap-gpu   (el mapa en una sola pasada de shader, OpenGL 3.3)
+- DuoMaze.exe --bloom alta|baja|no   (brillo en posproceso; tecla B para cambiarlo en juego)
+- DuoMaze.exe --menu-eventos   (el menú quieto espera al ratón o al teclado en vez de ir a 10 FPS)
+- DuoMaze.exe --ritmo libre|fijo|adaptativo --hz 144 --hz-menu 30 --vsync   (ritmo de frames; F3 muestra el jitter)
+- DuoMaze.exe --escala 1 --escalado cercano|nitido --pantalla-completa   (lienzo interno de 800x600 por la escala, ampliado a la ventana; F11 pantalla completa)
+- F4 en juego: memoria por subsistema (actual y pico, CPU y GPU); al cerrar se vuelca en debug_log.txt con las fugas
 
 OBJETIVO:
 Llevar a ambos personajes a la meta cooperando en cada nivel.
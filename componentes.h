@@ -0,0 +1,269 @@
+#ifndef DUOMAZE_COMPONENTES_H
+#define DUOMAZE_COMPONENTES_H
+
+// Almacén de componentes para partidas de N jugadores (2-8, modo fiesta). Los objetos
+// dinámicos de los niveles van aparte, en MundoObjetos (objetos_dinamicos.h).
+//
+// Cada componente es un array denso (struct-of-arrays): los sistemas recorren
+// [0, tamano()) en orden sobre memoria contigua, así que el coste por tick es lineal en
+// el número de entidades. Fuera se usan handles estables (Entidad): índice de slot más
+// generación, que siguen valiendo aunque otras entidades se borren y los arrays densos
+// se reordenen (el borrado mueve la última entidad al hueco).
+
+#include "objetos_dinamicos.h"
+#include "simulacion.h"
+#include <vector>
+
+namespace ComponentesConstants {
+    constexpr int MIN_JUGADORES = 2;
+    constexpr int MAX_JUGADORES = 8;
+    constexpr int BITS_INDICE = 16;
+    constexpr uint32_t MASCARA_INDICE = (1u << BITS_INDICE) - 1;
+    constexpr size_t MAX_ENTIDADES = MASCARA_INDICE;   // El índice 0xFFFF queda para ENTIDAD_NULA
+}
+
+static_assert(ComponentesConstants::MAX_JUGADORES <= ObjetosConstants::MAX_EMPUJONES_POR_TICK,
+              "El margen de la rejilla espacial cubre un empujón por jugador y tick");
+
+// Handle estable: bits 0-15 slot, bits 16-31 generación del slot
+using Entidad = uint32_t;
+constexpr Entidad ENTIDAD_NULA = 0xFFFFFFFFu;
+
+enum TipoEntidad : uint8_t { ENTIDAD_JUGADOR = 0 };
+
+class AlmacenComponentes {
+public:
+    // Componentes: arrays paralelos, válidos en [0, tamano())
+    std::vector<float> posX, posY;      // Centro en píxeles (siempre enteros, como SimEstado)
+    std::vector<uint8_t> rol;           // RolJugador: ROL_MASTER o ROL_SLAVE
+    std::vector<uint8_t> input;         // InputBits del tick
+    std::vector<int16_t> tile;          // Tile bajo la entidad tras moverse (-1 fuera del mapa)
+    std::vector<uint8_t> tipo;          // TipoEntidad
+    std::vector<uint8_t> jugador;       // Número de jugador: color e input
+
+private:
+    std::vector<Entidad> entidadDe;     // Denso -> handle
+    std::vector<uint16_t> densoDe;      // Slot -> índice denso
+    std::vector<uint16_t> generacion;   // Slot -> generación actual
+    std::vector<uint16_t> libres;       // Slots libres (pila)
+    size_t n = 0;
+
+    void moverDenso(size_t desde, size_t hasta) {
+        posX[hasta] = posX[desde];
+        posY[hasta] = posY[desde];
+        rol[hasta] = rol[desde];
+        input[hasta] = input[desde];
+        tile[hasta] = tile[desde];
+        tipo[hasta] = tipo[desde];
+        jugador[hasta] = jugador[desde];
+        entidadDe[hasta] = entidadDe[desde];
+        densoDe[entidadDe[hasta] & ComponentesConstants::MASCARA_INDICE] = static_cast<uint16_t>(hasta);
+    }
+
+public:
+    // Todo se reserva aquí: crear y destruir no tocan el heap
+    explicit AlmacenComponentes(size_t capacidad) {
+        if (capacidad > ComponentesConstants::MAX_ENTIDADES) capacidad = ComponentesConstants::MAX_ENTIDADES;
+        posX.resize(capacidad);
+        posY.resize(capacidad);
+        rol.resize(capacidad);
+        input.resize(capacidad);
+        tile.resize(capacidad);
+        tipo.resize(capacidad);
+        jugador.resize(capacidad);
+        entidadDe.resize(capacidad);
+        densoDe.resize(capacidad);
+        generacion.assign(capacidad, 0);
+        libres.reserve(capacidad);
+        limpiar();
+    }
+
+    size_t tamano() const { return n; }
+    size_t capacidad() const { return posX.size(); }
+
+    // Borra todas las entidades; los handles anteriores dejan de valer
+    void limpiar() {
+        for (size_t i = 0; i < n; i++) {
+            uint32_t slot = entidadDe[i] & ComponentesConstants::MASCARA_INDICE;
+            generacion[slot]++;
+        }
+        n = 0;
+        libres.clear();
+        for (size_t s = capacidad(); s-- > 0;) libres.push_back(static_cast<uint16_t>(s));
+    }
+
+    // ENTIDAD_NULA si el almacén está lleno
+    Entidad crear(uint8_t tipoEntidad, uint8_t rolEntidad, uint8_t numJugador, Vector2 pos) {
+        if (libres.empty()) return ENTIDAD_NULA;
+        uint16_t slot = libres.back();
+        libres.pop_back();
+        size_t i = n++;
+        posX[i] = pos.x;
+        posY[i] = pos.y;
+        rol[i] = rolEntidad;
+        input[i] = 0;
+        tile[i] = -1;
+        tipo[i] = tipoEntidad;
+        jugador[i] = numJugador;
+        entidadDe[i] = slot | (static_cast<uint32_t>(generacion[slot]) << ComponentesConstants::BITS_INDICE);
+        densoDe[slot] = static_cast<uint16_t>(i);
+        return entidadDe[i];
+    }
+
+    // Índice denso de la entidad (-1 si el handle ya no vale). Cambia al borrar otras.
+    int indice(Entidad e) const {
+        uint32_t slot = e & ComponentesConstants::MASCARA_INDICE;
+        if (slot >= capacidad()) return -1;
+        uint16_t d = densoDe[slot];
+        return (d < n && entidadDe[d] == e) ? d : -1;
+    }
+
+    bool valida(Entidad e) const { return indice(e) >= 0; }
+    Entidad entidad(size_t i) const { return entidadDe[i]; }
+
+    // Borrado O(1): la última entidad ocupa el hueco
+    void destruir(Entidad e) {
+        int i = indice(e);
+        if (i < 0) return;
+        uint16_t slot = static_cast<uint16_t>(e & ComponentesConstants::MASCARA_INDICE);
+        if (static_cast<size_t>(i) != n - 1) moverDenso(n - 1, static_cast<size_t>(i));
+        n--;
+        generacion[slot]++;
+        libres.push_back(slot);
+    }
+};
+
+// Sistemas por lotes: cada uno es un bucle sobre los arrays densos
+namespace SistemasEntidades {
+    // Input del tick + colisión con el mapa (SimulacionFija::moverJugador) y después con
+    // puertas correderas y cajas, que se empujan. Sin objetos da lo mismo que SimulacionFija.
+    inline void mover(AlmacenComponentes& a, const MapaNivel& mapa, Canales canales, const MetadatosNivel& meta,
+                      MundoObjetos& objetos) {
+        const size_t n = a.tamano();
+        float* px = a.posX.data();
+        float* py = a.posY.data();
+        for (size_t i = 0; i < n; i++) {
+            Vector2 antes = {px[i], py[i]};
+            Vector2 p = objetos.moverJugador(antes, SimulacionFija::moverJugador(antes, a.input[i], a.rol[i] == ROL_MASTER,
+                                                                                 mapa, canales, meta));
+            px[i] = p.x;
+            py[i] = p.y;
+        }
+    }
+
+    // Quien toca un peligro vuelve al inicio de su rol. Devuelve cuántos.
+    inline int peligros(AlmacenComponentes& a, MundoObjetos& objetos, const Vector2 inicios[2]) {
+        if (objetos.tamano() == 0) return 0;
+        const size_t n = a.tamano();
+        int golpes = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (!objetos.tocaPeligro({a.posX[i], a.posY[i]})) continue;
+            const Vector2& inicio = inicios[a.rol[i] == ROL_MASTER ? 0 : 1];
+            a.posX[i] = inicio.x;
+            a.posY[i] = inicio.y;
+            golpes++;
+        }
+        return golpes;
+    }
+    
+    inline void actualizarTiles(AlmacenComponentes& a, const MapaNivel& mapa) {
+        const size_t n = a.tamano();
+        for (size_t i = 0; i < n; i++) {
+            a.tile[i] = static_cast<int16_t>(ReglasJuego::tileEn(mapa, {a.posX[i], a.posY[i]}));
+        }
+    }
+
+    // ReglasJuego::evaluar para N jugadores: un canal individual lo activa cualquiera que
+    // pueda pulsarlo; uno de MODO_AMBOS necesita al menos un jugador de cada rol sobre sus
+    // botones. Devuelve cuántas entidades están en la meta.
+    inline int disparadores(const AlmacenComponentes& a, Canales& canales, const MetadatosNivel& meta) {
+        const size_t n = a.tamano();
+        Canales solos = 0;
+        Canales conjuntos[2] = {0, 0};     // Por rol: [0] master, [1] slave
+        int enMeta = 0;
+        for (size_t i = 0; i < n; i++) {
+            Canales pulsado = ReglasJuego::pulsa(meta, a.tile[i], a.rol[i]);
+            Canales solo = ReglasJuego::pulsaSolo(meta, a.tile[i], a.rol[i]);
+            solos |= solo;
+            conjuntos[a.rol[i] == ROL_MASTER ? 0 : 1] |= pulsado & ~solo;
+            enMeta += meta.rasgos(a.tile[i]).meta;
+        }
+        canales = (canales & meta.enclavados) | solos | (conjuntos[0] & conjuntos[1]);
+        return enMeta;
+    }
+}
+
+// Simulación de paso fijo de una partida de N jugadores. Los jugadores pares son del rol
+// master y los impares del slave, y cada uno empieza en el inicio de su rol. Con dos
+// jugadores y sin objetos da exactamente lo mismo que SimulacionFija::paso.
+class SimulacionFiesta {
+private:
+    AlmacenComponentes almacen{ComponentesConstants::MAX_JUGADORES};
+    Entidad jugadores[ComponentesConstants::MAX_JUGADORES];
+    MundoObjetos objetos;
+    Vector2 inicios[2] = {};        // [0] master, [1] slave
+    MapaNivel mapa{};
+    Canales canales = 0;
+    int numJugadores = ComponentesConstants::MIN_JUGADORES;
+    int enMeta = 0;
+    int golpes = 0;                 // Veces que un peligro ha devuelto a alguien al inicio
+    uint8_t nivel = 0;
+    bool completado = false;
+    uint32_t tick = 0;
+
+public:
+    // conObjetos = false deja solo las tiles (para comparar con SimulacionFija)
+    void cargarNivel(int nuevoNivel, int jugadoresPartida, bool conObjetos = true) {
+        SimEstado inicio;
+        SimulacionFija::cargarNivel(nuevoNivel, mapa, inicio);
+        inicios[0] = inicio.masterPos;
+        inicios[1] = inicio.slavePos;
+        objetos.cargarNivel(inicio.nivel, mapa);
+        if (!conObjetos) objetos.vaciar();
+        numJugadores = jugadoresPartida < ComponentesConstants::MIN_JUGADORES ? ComponentesConstants::MIN_JUGADORES
+                     : (jugadoresPartida > ComponentesConstants::MAX_JUGADORES ? ComponentesConstants::MAX_JUGADORES
+                                                                               : jugadoresPartida);
+        almacen.limpiar();
+        for (int j = 0; j < numJugadores; j++) {
+            bool master = (j % 2) == 0;
+            jugadores[j] = almacen.crear(ENTIDAD_JUGADOR, master ? ROL_MASTER : ROL_SLAVE, static_cast<uint8_t>(j),
+                                         master ? inicio.masterPos : inicio.slavePos);
+        }
+        canales = 0;
+        enMeta = 0;
+        golpes = 0;
+        nivel = inicio.nivel;
+        completado = false;
+        tick = 0;
+    }
+
+    // inputs[j] es el del jugador j
+    void paso(const uint8_t* inputs) {
+        for (int j = 0; j < numJugadores; j++) {
+            int i = almacen.indice(jugadores[j]);
+            if (i >= 0) almacen.input[i] = inputs[j];
+        }
+        const MetadatosNivel& meta = metadatosNivel(nivel);
+        objetos.avanzar(canales);
+        SistemasEntidades::mover(almacen, mapa, canales, meta, objetos);
+        golpes += SistemasEntidades::peligros(almacen, objetos, inicios);
+        SistemasEntidades::actualizarTiles(almacen, mapa);
+        enMeta = SistemasEntidades::disparadores(almacen, canales, meta);
+        if (enMeta == static_cast<int>(almacen.tamano())) completado = true;
+        tick++;
+    }
+
+    const AlmacenComponentes& getAlmacen() const { return almacen; }
+    const MundoObjetos& getObjetos() const { return objetos; }
+    const MapaNivel& getMapa() const { return mapa; }
+    Entidad getJugador(int j) const { return jugadores[j]; }
+    int getNumJugadores() const { return numJugadores; }
+    Canales getCanales() const { return canales; }
+    int getEnMeta() const { return enMeta; }
+    int getGolpes() const { return golpes; }
+    int getNivel() const { return nivel; }
+    bool getCompletado() const { return completado; }
+    uint32_t getTick() const { return tick; }
+};
+
+#endif
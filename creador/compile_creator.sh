@@ -93,6 +93,7 @@ CONTROLES:
 - Click IZQUIERDO: Ciclar entre tipos de tile (0-12)
 - Click DERECHO: Borrar tile (poner VACIO)
 - G: Mostrar/ocultar grid
+- R: Mostrar/ocultar regiones alcanzables (rojo solo master, azul solo slave, negro nadie)
 - C: Limpiar nivel completo
 - S: Guardar nivel generado
 
@@ -109,6 +110,7 @@ CARACTERÍSTICAS:
 ✅ Bordes automáticos (siempre activos)
 ✅ Grid con coordenadas
 ✅ Panel informativo en tiempo real
+✅ Análisis de dependencias en cada edición: bloqueos, botones inalcanzables y ruta crítica
 ✅ Exportación directa a código C++
 
 USO:
@@ -4,6 +4,8 @@
 #define NOMINMAX
 
 #include "raylib.h"
+#include "../dependencias_nivel.h"
+#include <algorithm>
 #include <array>
 #include <string>
 #include <fstream>
@@ -21,22 +23,19 @@ namespace CreatorConstants {
     constexpr bool AUTO_BORDES = true;
 }
 
-// Enumeraciones (igual que en el juego)
-enum TileType {
-    VACIO = 0,
-    PARED = 1,
-    START_MASTER = 2,
-    START_SLAVE = 3,
-    BOTON_1 = 4,
-    BOTON_2 = 5,
-    BOTON_3 = 6,
-    PUERTA_1 = 7,
-    PUERTA_2 = 8,
-    PUERTA_3 = 9,
-    OBSTACULO_ROJO = 10,
-    OBSTACULO_AZUL = 11,
-    META = 12,
-    TOTAL_TILE_TYPES = 13
+// Tipos de tile del juego y análisis de dependencias (simulacion.h, bitboards)
+static_assert(CreatorConstants::MAP_WIDTH == GameConstants::MAP_WIDTH &&
+              CreatorConstants::MAP_HEIGHT == GameConstants::MAP_HEIGHT,
+              "El creador edita niveles del tamaño del juego");
+
+// Sprite del creador para cada TexturaTile (nullptr = sin sprite: se dibuja en color)
+constexpr const char* RUTAS_TEXTURA_TILE[NUM_TEXTURAS_TILE] = {
+    nullptr, "resources/pared.png", "resources/master.png", "resources/slave.png",
+    "resources/boton1.png", "resources/boton2.png", "resources/boton3.png",
+    "resources/puerta_roja_cerrada.png", nullptr,
+    "resources/puerta_azul_cerrada.png", nullptr,
+    "resources/puerta_morada_cerrada.png", nullptr,
+    nullptr, nullptr, "resources/meta.png"
 };
 
 class TextureManager {
@@ -57,41 +56,25 @@ private:
     }
     
 public:
-    Texture2D piso, pared, master, slave;
-    Texture2D boton1, boton2, boton3;
-    Texture2D puerta1, puerta2, puerta3;
-    Texture2D meta;
+    Texture2D piso;
+    std::array<Texture2D, NUM_TEXTURAS_TILE> tiles{};
     
     bool loadAllTextures() {
         int size = CreatorConstants::TILE_SIZE;
         
         piso = loadTexture("resources/piso.png", size);
-        pared = loadTexture("resources/pared.png", size);
-        master = loadTexture("resources/master.png", size);
-        slave = loadTexture("resources/slave.png", size);
-        boton1 = loadTexture("resources/boton1.png", size);
-        boton2 = loadTexture("resources/boton2.png", size);
-        boton3 = loadTexture("resources/boton3.png", size);
-        puerta1 = loadTexture("resources/puerta_roja_cerrada.png", size);
-        puerta2 = loadTexture("resources/puerta_azul_cerrada.png", size);
-        puerta3 = loadTexture("resources/puerta_morada_cerrada.png", size);
-        meta = loadTexture("resources/meta.png", size);
+        for (int i = 0; i < NUM_TEXTURAS_TILE; i++) {
+            if (RUTAS_TEXTURA_TILE[i]) tiles[i] = loadTexture(RUTAS_TEXTURA_TILE[i], size);
+        }
         
         return true;
     }
     
     void unloadAll() {
         UnloadTexture(piso);
-        UnloadTexture(pared);
-        UnloadTexture(master);
-        UnloadTexture(slave);
-        UnloadTexture(boton1);
-        UnloadTexture(boton2);
-        UnloadTexture(boton3);
-        UnloadTexture(puerta1);
-        UnloadTexture(puerta2);
-        UnloadTexture(puerta3);
-        UnloadTexture(meta);
+        for (Texture2D& t : tiles) {
+            if (t.id != 0) UnloadTexture(t);
+        }
     }
 };
 
@@ -100,9 +83,11 @@ private:
     std::array<std::array<int, CreatorConstants::MAP_WIDTH>, CreatorConstants::MAP_HEIGHT> nivel;
     TextureManager& textures;
     bool gridVisible;
+    bool regionesVisibles;
+    InformeDependencias informe;    // Se recalcula en cada edición
     
 public:
-    LevelCreator(TextureManager& tm) : textures(tm), gridVisible(true) {
+    LevelCreator(TextureManager& tm) : textures(tm), gridVisible(true), regionesVisibles(false) {
         initializeWithBordes();
     }
     
@@ -118,6 +103,12 @@ public:
         if (CreatorConstants::AUTO_BORDES) {
             createBordes();
         }
+        analizar();
+    }
+    
+    // Dependencias entre regiones, botones y puertas (menos de 1 ms en 20x15)
+    void analizar() {
+        informe = AnalizadorDependencias::analizar(nivel);
     }
     
     void createBordes() {
@@ -152,18 +143,21 @@ public:
                 
                 if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                     // Ciclo: 0->1->2->...->12->0
-                    nivel[tileY][tileX] = (nivel[tileY][tileX] + 1) % TOTAL_TILE_TYPES;
+                    nivel[tileY][tileX] = (nivel[tileY][tileX] + 1) % NUM_TIPOS_TILE;
+                    analizar();
                 }
                 
                 // Click derecho para borrar (poner VACIO)
                 if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
                     nivel[tileY][tileX] = VACIO;
+                    analizar();
                 }
             }
         }
         
         // Controles de teclado
         if (IsKeyPressed(KEY_G)) gridVisible = !gridVisible;
+        if (IsKeyPressed(KEY_R)) regionesVisibles = !regionesVisibles;
         if (IsKeyPressed(KEY_C)) clearLevel();
         if (IsKeyPressed(KEY_S)) saveLevel();
     }
@@ -186,6 +180,17 @@ public:
                 // Dibujar elemento
                 drawTile(nivel[y][x], destRect);
                 
+                // Regiones: tiles a las que no llega nadie, solo el master o solo el slave
+                if (regionesVisibles) {
+                    drawRegion(x, y, destRect);
+                }
+                
+                // Botones que no se pueden pulsar jugando
+                int tipo = nivel[y][x];
+                if (tipo >= BOTON_1 && tipo <= BOTON_3 && !informe.eventos[tipo - BOTON_1].alcanzable) {
+                    DrawRectangleLinesEx(destRect, 3, RED);
+                }
+                
                 // Grid
                 if (gridVisible) {
                     DrawRectangleLines((int)destRect.x, (int)destRect.y, 
@@ -209,6 +214,7 @@ public:
         }
         
         drawUI();
+        drawAnalisis();
     }
     
     void clearLevel() {
@@ -247,46 +253,64 @@ public:
     }
     
 private:
+    void drawRegion(int x, int y, const Rectangle& destRect) {
+        int celda = y * CreatorConstants::MAP_WIDTH + x;
+        auto alcanza = [&](int rol) {
+            int g = informe.roles[rol].region[celda];
+            return g >= 0 && informe.roles[rol].regionAlcanzable[g];
+        };
+        bool pasable = informe.roles[0].region[celda] >= 0 || informe.roles[1].region[celda] >= 0;
+        if (!pasable) return;
+        bool master = alcanza(1), slave = alcanza(0);
+        if (!master && !slave) {
+            DrawRectangleRec(destRect, Fade(BLACK, 0.5f));
+        } else if (master && !slave) {
+            DrawRectangleRec(destRect, Fade(RED, 0.25f));
+        } else if (slave && !master) {
+            DrawRectangleRec(destRect, Fade(BLUE, 0.25f));
+        }
+    }
+    
+    // Resultado del análisis en la franja bajo el mapa
+    void drawAnalisis() {
+        int y0 = CreatorConstants::MAP_HEIGHT * CreatorConstants::TILE_SIZE + 6;
+        DrawText(TextFormat("ANALISIS (%.2f ms): %s", informe.ms,
+                            informe.completable ? "completable" : "NO completable"),
+                 10, y0, 16, informe.completable ? DARKGREEN : RED);
+        
+        if (informe.largoCadena > 0) {
+            std::string ruta = "Ruta critica: ";
+            for (int i = informe.largoCadena - 1; i >= 0; i--) {
+                ruta += AnalizadorDependencias::nombreEvento(informe.cadenaCritica[i]);
+                if (i > 0) ruta += " -> ";
+            }
+            DrawText(TextFormat("%s (%d tiles, ~%.1f s)", ruta.c_str(), informe.longitudCritica,
+                                informe.longitudCritica * DependenciasConstants::SEGUNDOS_POR_TILE),
+                     330, y0 + 2, 14, DARKBLUE);
+        }
+        
+        DrawText(TextFormat("Regiones master: %d (%d alcanzables) | slave: %d (%d alcanzables) | R: ver regiones",
+                            informe.roles[1].regiones, informe.roles[1].regionesAlcanzables,
+                            informe.roles[0].regiones, informe.roles[0].regionesAlcanzables),
+                 10, y0 + 22, 12, DARKGRAY);
+        
+        // Los tres primeros avisos (bloqueos, botones inalcanzables, inicios y meta)
+        int lineas = std::min(3, static_cast<int>(informe.avisos.size()));
+        for (int i = 0; i < lineas; i++) {
+            DrawText(informe.avisos[i].c_str(), 10, y0 + 40 + i * 16, 14, informe.bloqueo ? RED : MAROON);
+        }
+    }
+    
+    // Mismos rasgos que el juego; los obstáculos no tienen sprite y se pintan del color de quien pasa
     void drawTile(int tileType, const Rectangle& destRect) {
-        switch (tileType) {
-            case PARED:
-                DrawTexturePro(textures.pared, {0,0,(float)textures.pared.width,(float)textures.pared.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case START_MASTER:
-                DrawTexturePro(textures.master, {0,0,(float)textures.master.width,(float)textures.master.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case START_SLAVE:
-                DrawTexturePro(textures.slave, {0,0,(float)textures.slave.width,(float)textures.slave.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case BOTON_1:
-                DrawTexturePro(textures.boton1, {0,0,(float)textures.boton1.width,(float)textures.boton1.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case BOTON_2:
-                DrawTexturePro(textures.boton2, {0,0,(float)textures.boton2.width,(float)textures.boton2.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case BOTON_3:
-                DrawTexturePro(textures.boton3, {0,0,(float)textures.boton3.width,(float)textures.boton3.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case PUERTA_1:
-                DrawTexturePro(textures.puerta1, {0,0,(float)textures.puerta1.width,(float)textures.puerta1.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case PUERTA_2:
-                DrawTexturePro(textures.puerta2, {0,0,(float)textures.puerta2.width,(float)textures.puerta2.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case PUERTA_3:
-                DrawTexturePro(textures.puerta3, {0,0,(float)textures.puerta3.width,(float)textures.puerta3.height}, destRect, {0,0}, 0, WHITE);
-                break;
-            case OBSTACULO_ROJO:
-                DrawRectangleRec(destRect, RED);
-                DrawText("R", (int)destRect.x + 15, (int)destRect.y + 12, 20, WHITE);
-                break;
-            case OBSTACULO_AZUL:
-                DrawRectangleRec(destRect, BLUE);
-                DrawText("B", (int)destRect.x + 15, (int)destRect.y + 12, 20, WHITE);
-                break;
-            case META:
-                DrawTexturePro(textures.meta, {0,0,(float)textures.meta.width,(float)textures.meta.height}, destRect, {0,0}, 0, WHITE);
-                break;
+        const RasgosTile& r = METADATOS_BASICOS.rasgos(tileType);
+        const Texture2D& t = textures.tiles[r.textura];
+        if (t.id != 0) {
+            DrawTexturePro(t, {0,0,(float)t.width,(float)t.height}, destRect, {0,0}, 0, WHITE);
+        } else if (r.textura != TEX_NINGUNA) {
+            bool rojo = r.paso == ROL_MASTER;
+            DrawRectangleRec(destRect, rojo ? RED : BLUE);
+            DrawText(rojo ? "R" : "B", (int)destRect.x + 15, (int)destRect.y + 12, 20, WHITE);
         }
     }
     
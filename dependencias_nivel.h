@@ -0,0 +1,331 @@
+#ifndef DUOMAZE_DEPENDENCIAS_NIVEL_H
+#define DUOMAZE_DEPENDENCIAS_NIVEL_H
+
+// Análisis de dependencias entre regiones, botones y puertas de un nivel.
+//
+// Cada botón k abre la puerta k para los dos jugadores y se queda pulsado (ReglasJuego):
+// el 1 lo pulsa el master, el 2 el slave y el 3 los dos a la vez. Las regiones de un rol
+// son sus componentes conexas con todas las puertas cerradas.
+//
+// - Dependencias: una región, un botón o la meta requiere el botón k si con todas las
+//   puertas abiertas se alcanza y quitando solo la puerta k deja de alcanzarse. Esas
+//   aristas forman el grafo de dependencias; un ciclo es un bloqueo.
+// - Alcance real: desde el inicio se pulsan los botones alcanzables hasta un punto fijo.
+// - Ruta crítica: Dijkstra por rol en el que una puerta se puede cruzar desde que se
+//   pulsa su botón (se puede esperar delante), repetido hasta que los tiempos de
+//   apertura no cambian. Es una cota inferior en tiles del tiempo para completar el nivel.
+//
+// Pensado para ejecutarse en cada edición del creador de niveles: en un mapa de 20x15
+// son unas decenas de rellenos de bitboard y unos pocos Dijkstra de 300 celdas.
+
+#include "simulacion.h"
+#include "bitboard_laberinto.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+enum EventoNivel { EVENTO_BOTON_1, EVENTO_BOTON_2, EVENTO_BOTON_3, EVENTO_META, NUM_EVENTOS };
+
+namespace DependenciasConstants {
+    constexpr int CELDAS = GameConstants::MAP_WIDTH * GameConstants::MAP_HEIGHT;
+    constexpr int NUNCA = 1 << 29;
+    constexpr uint8_t TODAS = BIT_BOTON_1 | BIT_BOTON_2 | BIT_BOTON_3;
+    // Ticks que tarda un jugador en cruzar una tile (para mostrar la ruta crítica en segundos)
+    constexpr float SEGUNDOS_POR_TILE = static_cast<float>(GameConstants::TILE_SIZE) / GameConstants::PLAYER_SPEED *
+                                        GameConstants::PHYSICS_UPDATE_RATE / 1000.0f;
+}
+
+struct InformeDependencias {
+    struct Evento {
+        bool existe = false;        // Hay tiles de ese tipo en el mapa
+        bool alcanzable = false;    // Se consigue jugando desde el inicio
+        bool conTodoAbierto = false;// Se conseguiría con todas las puertas abiertas
+        uint8_t requiere = 0;       // BIT_BOTON_* imprescindibles
+        int tiempo = DependenciasConstants::NUNCA;   // Tiles mínimas hasta conseguirlo
+    };
+
+    struct Rol {
+        std::array<int16_t, DependenciasConstants::CELDAS> region;   // -1 = no pasable
+        std::vector<uint8_t> requiereRegion;     // Por región: BIT_BOTON_* imprescindibles
+        std::vector<uint8_t> regionAlcanzable;   // Por región: se llega jugando desde el inicio
+        int regiones = 0;
+        int regionesAlcanzables = 0;
+    };
+
+    Evento eventos[NUM_EVENTOS];
+    Rol roles[2];                   // 0 = slave, 1 = master
+    uint8_t botonesPulsables = 0;   // BIT_BOTON_* que se llegan a pulsar
+    bool bloqueo = false;           // Hay un ciclo de dependencias entre botones
+    bool completable = false;       // Los dos jugadores llegan a la meta
+    int longitudCritica = DependenciasConstants::NUNCA;
+    EventoNivel cadenaCritica[NUM_EVENTOS];   // De la meta hacia atrás
+    int largoCadena = 0;
+    std::vector<std::string> avisos;
+    double ms = 0.0;
+};
+
+class AnalizadorDependencias {
+private:
+    static constexpr int W = GameConstants::MAP_WIDTH;
+    static constexpr int H = GameConstants::MAP_HEIGHT;
+
+    static uint8_t bitDeBoton(int k) { return static_cast<uint8_t>(1u << k); }
+
+    // Eventos conseguidos con los alcances de cada rol
+    static bool conseguido(EventoNivel e, const LaberintoBits& bits, const Bitboard& alcMaster, const Bitboard& alcSlave) {
+        switch (e) {
+            case EVENTO_BOTON_1: return alcMaster.intersecta(bits.de(BOTON_1));
+            case EVENTO_BOTON_2: return alcSlave.intersecta(bits.de(BOTON_2));
+            case EVENTO_BOTON_3: return alcMaster.intersecta(bits.de(BOTON_3)) && alcSlave.intersecta(bits.de(BOTON_3));
+            default:             return alcMaster.intersecta(bits.de(META)) && alcSlave.intersecta(bits.de(META));
+        }
+    }
+
+    static void etiquetarRegiones(const MapaNivel& mapa, bool esMaster, InformeDependencias::Rol& rol) {
+        rol.region.fill(-1);
+        rol.regiones = 0;
+        std::array<int, DependenciasConstants::CELDAS> cola;
+        for (int c0 = 0; c0 < DependenciasConstants::CELDAS; c0++) {
+            if (rol.region[c0] >= 0 || !CollisionSystem::canPassTile(mapa[c0 / W][c0 % W], esMaster, 0)) continue;
+            int cabeza = 0, fin = 0;
+            rol.region[c0] = static_cast<int16_t>(rol.regiones);
+            cola[fin++] = c0;
+            while (cabeza < fin) {
+                int c = cola[cabeza++];
+                int x = c % W, y = c / W;
+                const int vecinos[4] = {x > 0 ? c - 1 : -1, x + 1 < W ? c + 1 : -1, y > 0 ? c - W : -1, y + 1 < H ? c + W : -1};
+                for (int v : vecinos) {
+                    if (v < 0 || rol.region[v] >= 0) continue;
+                    if (!CollisionSystem::canPassTile(mapa[v / W][v % W], esMaster, 0)) continue;
+                    rol.region[v] = static_cast<int16_t>(rol.regiones);
+                    cola[fin++] = v;
+                }
+            }
+            rol.regiones++;
+        }
+        rol.requiereRegion.assign(rol.regiones, 0);
+        rol.regionAlcanzable.assign(rol.regiones, 0);
+    }
+
+    // Llegada más temprana (en tiles) a cada celda desde el inicio; la puerta k se puede
+    // cruzar a partir de apertura[k]
+    static void dijkstra(const MapaNivel& mapa, bool esMaster, int inicio, const int apertura[3],
+                         std::array<int, DependenciasConstants::CELDAS>& llegada) {
+        llegada.fill(DependenciasConstants::NUNCA);
+        if (inicio < 0) return;
+        using Nodo = std::pair<int, int>;   // (tiempo, celda)
+        std::priority_queue<Nodo, std::vector<Nodo>, std::greater<Nodo>> abiertos;
+        llegada[inicio] = 0;
+        abiertos.push({0, inicio});
+        while (!abiertos.empty()) {
+            auto [t, c] = abiertos.top();
+            abiertos.pop();
+            if (t != llegada[c]) continue;
+            int x = c % W, y = c / W;
+            const int vecinos[4] = {x > 0 ? c - 1 : -1, x + 1 < W ? c + 1 : -1, y > 0 ? c - W : -1, y + 1 < H ? c + W : -1};
+            for (int v : vecinos) {
+                if (v < 0) continue;
+                int tile = mapa[v / W][v % W];
+                int salida = t;
+                if (tile >= PUERTA_1 && tile <= PUERTA_3) {
+                    int k = tile - PUERTA_1;
+                    if (apertura[k] >= DependenciasConstants::NUNCA) continue;
+                    salida = std::max(t, apertura[k]);
+                } else if (!CollisionSystem::canPassTile(tile, esMaster, 0)) {
+                    continue;
+                }
+                if (salida + 1 < llegada[v]) {
+                    llegada[v] = salida + 1;
+                    abiertos.push({salida + 1, v});
+                }
+            }
+        }
+    }
+
+    static int minimoEn(const MapaNivel& mapa, int tipo, const std::array<int, DependenciasConstants::CELDAS>& llegada) {
+        int m = DependenciasConstants::NUNCA;
+        for (int c = 0; c < DependenciasConstants::CELDAS; c++) {
+            if (mapa[c / W][c % W] == tipo) m = std::min(m, llegada[c]);
+        }
+        return m;
+    }
+
+public:
+    static const char* nombreEvento(EventoNivel e) {
+        switch (e) {
+            case EVENTO_BOTON_1: return "B1";
+            case EVENTO_BOTON_2: return "B2";
+            case EVENTO_BOTON_3: return "B3";
+            default:             return "META";
+        }
+    }
+
+    static InformeDependencias analizar(const MapaNivel& mapa) {
+        using namespace DependenciasConstants;
+        auto inicioReloj = std::chrono::steady_clock::now();
+        InformeDependencias inf;
+        LaberintoBits bits(mapa);
+
+        // Inicios: el juego se queda con el último de cada tipo (SimulacionFija::cargarNivel)
+        int inicio[2] = {-1, -1};
+        int cuenta[NUM_TIPOS_TILE] = {};
+        for (int c = 0; c < CELDAS; c++) {
+            int t = mapa[c / W][c % W];
+            if (t >= 0 && t < NUM_TIPOS_TILE) cuenta[t]++;
+            if (t == START_SLAVE) inicio[0] = c;
+            if (t == START_MASTER) inicio[1] = c;
+        }
+        if (inicio[1] < 0) inf.avisos.push_back("Falta el inicio del master");
+        if (inicio[0] < 0) inf.avisos.push_back("Falta el inicio del slave");
+        if (cuenta[START_MASTER] > 1) inf.avisos.push_back("Varios inicios del master: se usa el último");
+        if (cuenta[START_SLAVE] > 1) inf.avisos.push_back("Varios inicios del slave: se usa el último");
+        if (cuenta[META] == 0) inf.avisos.push_back("Falta la meta");
+        for (int k = 0; k < 3; k++) {
+            if (cuenta[PUERTA_1 + k] > 0 && cuenta[BOTON_1 + k] == 0) {
+                inf.avisos.push_back("Puerta " + std::to_string(k + 1) + " sin botón: nunca se abre");
+            }
+        }
+        for (int e = 0; e < NUM_EVENTOS; e++) {
+            inf.eventos[e].existe = cuenta[e == EVENTO_META ? META : BOTON_1 + e] > 0;
+        }
+
+        auto alcance = [&](int rol, uint8_t puertas) {
+            Bitboard semilla(W, H);
+            if (inicio[rol] >= 0) semilla.set(inicio[rol] % W, inicio[rol] / W);
+            return BitboardOps::rellenar(semilla, bits.pasable(rol == 1, puertas));
+        };
+
+        // --- Dependencias: todas las puertas abiertas menos una ---
+        Bitboard todo[2] = {alcance(0, TODAS), alcance(1, TODAS)};
+        Bitboard sinPuerta[3][2];
+        for (int k = 0; k < 3; k++) {
+            for (int rol = 0; rol < 2; rol++) sinPuerta[k][rol] = alcance(rol, TODAS & ~bitDeBoton(k));
+        }
+        for (int e = 0; e < NUM_EVENTOS; e++) {
+            auto& ev = inf.eventos[e];
+            ev.conTodoAbierto = conseguido(static_cast<EventoNivel>(e), bits, todo[1], todo[0]);
+            if (!ev.conTodoAbierto) continue;
+            for (int k = 0; k < 3; k++) {
+                if (!conseguido(static_cast<EventoNivel>(e), bits, sinPuerta[k][1], sinPuerta[k][0])) {
+                    ev.requiere |= bitDeBoton(k);
+                }
+            }
+        }
+
+        // --- Alcance real: pulsar botones hasta el punto fijo ---
+        uint8_t pulsados = 0;
+        Bitboard real[2];
+        while (true) {
+            real[0] = alcance(0, pulsados);
+            real[1] = alcance(1, pulsados);
+            uint8_t nuevos = pulsados;
+            for (int k = 0; k < 3; k++) {
+                if (conseguido(static_cast<EventoNivel>(k), bits, real[1], real[0])) nuevos |= bitDeBoton(k);
+            }
+            if (nuevos == pulsados) break;
+            pulsados = nuevos;
+        }
+        inf.botonesPulsables = pulsados;
+        for (int e = 0; e < NUM_EVENTOS; e++) {
+            inf.eventos[e].alcanzable = conseguido(static_cast<EventoNivel>(e), bits, real[1], real[0]);
+        }
+        inf.completable = inf.eventos[EVENTO_META].alcanzable;
+
+        // --- Regiones de cada rol ---
+        for (int rol = 0; rol < 2; rol++) {
+            auto& r = inf.roles[rol];
+            etiquetarRegiones(mapa, rol == 1, r);
+            std::vector<uint8_t> vista(r.regiones, 0);
+            for (int c = 0; c < CELDAS; c++) {
+                int g = r.region[c];
+                if (g < 0 || vista[g]) continue;
+                vista[g] = 1;
+                int x = c % W, y = c / W;
+                if (real[rol].get(x, y)) {
+                    r.regionAlcanzable[g] = 1;
+                    r.regionesAlcanzables++;
+                }
+                if (!todo[rol].get(x, y)) continue;
+                for (int k = 0; k < 3; k++) {
+                    if (!sinPuerta[k][rol].get(x, y)) r.requiereRegion[g] |= bitDeBoton(k);
+                }
+            }
+        }
+
+        // --- Bloqueos: ciclos entre botones (cierre transitivo de 3 nodos) ---
+        uint8_t alcanza[3];
+        for (int k = 0; k < 3; k++) alcanza[k] = inf.eventos[k].requiere;
+        for (int paso = 0; paso < 3; paso++) {
+            for (int k = 0; k < 3; k++) {
+                for (int j = 0; j < 3; j++) {
+                    if (alcanza[k] & bitDeBoton(j)) alcanza[k] |= alcanza[j];
+                }
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            if (!inf.eventos[k].existe) continue;
+            std::string nombre = "Botón " + std::to_string(k + 1);
+            if (inf.eventos[k].requiere & bitDeBoton(k)) {
+                inf.bloqueo = true;
+                inf.avisos.push_back("Bloqueo: la puerta " + std::to_string(k + 1) + " cierra el paso a su botón");
+            } else if (alcanza[k] & bitDeBoton(k)) {
+                inf.bloqueo = true;
+                inf.avisos.push_back("Bloqueo: " + nombre + " depende de sí mismo a través de otro botón");
+            } else if (!inf.eventos[k].conTodoAbierto) {
+                inf.avisos.push_back(nombre + " inalcanzable" + std::string(k == 0 ? " para el master" :
+                                                                            k == 1 ? " para el slave" : " para los dos"));
+            } else if (!inf.eventos[k].alcanzable) {
+                inf.avisos.push_back(nombre + " inalcanzable: faltan botones previos");
+            }
+        }
+        if (!inf.completable && cuenta[META] > 0) inf.avisos.push_back("Nivel imposible: no llegan los dos a la meta");
+
+        // --- Ruta crítica: tiempos de apertura hasta el punto fijo ---
+        int apertura[3] = {NUNCA, NUNCA, NUNCA};
+        std::array<int, CELDAS> llegada[2];
+        for (int iter = 0; iter < 8; iter++) {
+            dijkstra(mapa, false, inicio[0], apertura, llegada[0]);
+            dijkstra(mapa, true, inicio[1], apertura, llegada[1]);
+            int nueva[3] = {
+                minimoEn(mapa, BOTON_1, llegada[1]),
+                minimoEn(mapa, BOTON_2, llegada[0]),
+                std::max(minimoEn(mapa, BOTON_3, llegada[1]), minimoEn(mapa, BOTON_3, llegada[0]))
+            };
+            bool igual = true;
+            for (int k = 0; k < 3; k++) {
+                igual = igual && nueva[k] == apertura[k];
+                apertura[k] = nueva[k];
+            }
+            if (igual) break;
+        }
+        for (int k = 0; k < 3; k++) inf.eventos[k].tiempo = apertura[k];
+        inf.eventos[EVENTO_META].tiempo = std::max(minimoEn(mapa, META, llegada[1]), minimoEn(mapa, META, llegada[0]));
+        inf.longitudCritica = inf.eventos[EVENTO_META].tiempo;
+
+        // Cadena: desde la meta, el requisito que más tarde se cumple
+        if (inf.completable) {
+            EventoNivel actual = EVENTO_META;
+            inf.cadenaCritica[inf.largoCadena++] = actual;
+            while (inf.largoCadena < NUM_EVENTOS) {
+                int siguiente = -1;
+                for (int k = 0; k < 3; k++) {
+                    if ((inf.eventos[actual].requiere & bitDeBoton(k)) &&
+                        (siguiente < 0 || inf.eventos[k].tiempo > inf.eventos[siguiente].tiempo)) {
+                        siguiente = k;
+                    }
+                }
+                if (siguiente < 0) break;
+                actual = static_cast<EventoNivel>(siguiente);
+                inf.cadenaCritica[inf.largoCadena++] = actual;
+            }
+        }
+
+        inf.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicioReloj).count();
+        return inf;
+    }
+};
+
+#endif
@@ -0,0 +1,13 @@
+#!/bin/bash
+echo "📦 Compilando Empaquetador de Recursos - DuoMaze Dev Tool..."
+
+# Se ejecuta en la máquina de build (Linux), también antes del build de Windows
+g++ -o empaquetador empaquetador.cpp -lraylib -lm -lpthread -ldl -lX11 -std=c++17 -O2
+
+if [ $? -eq 0 ]; then
+    echo "✅ ¡Compilación exitosa!"
+    echo "🚀 Uso (desde la raíz del proyecto): ./empaquetador/empaquetador [resources/duomaze.pak]"
+else
+    echo "❌ Error en la compilación"
+    exit 1
+fi
@@ -0,0 +1,193 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#define NOMINMAX
+
+#include "raylib.h"
+#include "../fuentes_sdf.h"
+#include "../paquete.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Empaquetador de recursos - DuoMaze Dev Tool
+// Genera resources/duomaze.pak con los sprites ya reescalados a TILE_SIZE y un
+// atlas SDF por fuente, listos para subir a GPU sin decodificar nada.
+
+namespace PackerConstants {
+    constexpr int TILE_SIZE = 40;  // Igual que GameConstants::TILE_SIZE
+}
+
+class Empaquetador {
+private:
+    std::ofstream archivo;
+    std::vector<PakEntrada> indice;
+    uint64_t posicion = 0;
+
+    void escribir(const void* datos, size_t bytes) {
+        archivo.write(static_cast<const char*>(datos), bytes);
+        posicion += bytes;
+    }
+
+    void alinear() {
+        static const char ceros[PAK_ALINEACION] = {};
+        size_t relleno = (PAK_ALINEACION - posicion % PAK_ALINEACION) % PAK_ALINEACION;
+        escribir(ceros, relleno);
+    }
+
+    PakEntrada nuevaEntrada(const std::string& nombre, PakTipo tipo) {
+        PakEntrada e{};
+        std::strncpy(e.nombre, nombre.c_str(), sizeof(e.nombre) - 1);
+        e.tipo = tipo;
+        alinear();
+        e.offset = posicion;
+        return e;
+    }
+
+public:
+    bool abrir(const char* ruta) {
+        archivo.open(ruta, std::ios::binary | std::ios::trunc);
+        if (!archivo.is_open()) return false;
+
+        // La cabecera se reescribe al final con el offset del índice
+        PakCabecera cabecera{};
+        escribir(&cabecera, sizeof(cabecera));
+        return true;
+    }
+
+    bool agregarTextura(const char* nombre, const char* ruta, int ancho, int alto) {
+        Image imagen = LoadImage(ruta);
+        if (imagen.data == nullptr) {
+            printf("  ⚠️  %s no encontrado\n", ruta);
+            return false;
+        }
+        if (ancho > 0) {
+            ImageResize(&imagen, ancho, alto);
+        }
+        ImageFormat(&imagen, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        PakEntrada e = nuevaEntrada(nombre, PAK_TEXTURA);
+        e.formato = imagen.format;
+        e.ancho = imagen.width;
+        e.alto = imagen.height;
+        e.tamano = GetPixelDataSize(imagen.width, imagen.height, imagen.format);
+        escribir(imagen.data, e.tamano);
+        indice.push_back(e);
+
+        UnloadImage(imagen);
+        printf("  ✅ %s (%dx%d)\n", nombre, e.ancho, e.alto);
+        return true;
+    }
+
+    bool agregarFuente(const char* ruta) {
+        int tamArchivo = 0;
+        unsigned char* datos = LoadFileData(ruta, &tamArchivo);
+        if (datos == nullptr) {
+            printf("  ⚠️  %s no encontrado\n", ruta);
+            return false;
+        }
+
+        GlyphInfo* glifos = nullptr;
+        Rectangle* recs = nullptr;
+        Image atlas = FuentesSDF::generarAtlas(datos, tamArchivo, &glifos, &recs);
+        UnloadFileData(datos);
+        if (atlas.data == nullptr) {
+            printf("  ⚠️  %s no se pudo rasterizar\n", ruta);
+            if (glifos != nullptr) UnloadFontData(glifos, FuentesSDF::CARACTERES);
+            return false;
+        }
+
+        // La clave es la ruta del TTF, igual que RUTAS_FUENTES en el juego
+        const int numGlifos = FuentesSDF::CARACTERES;
+        PakEntrada e = nuevaEntrada(ruta, PAK_FUENTE);
+        e.formato = atlas.format;
+        e.ancho = atlas.width;
+        e.alto = atlas.height;
+        e.fontSize = FuentesSDF::TAMANO_BASE;
+        e.glyphCount = numGlifos;
+        e.glyphPadding = FuentesSDF::PADDING_ATLAS;
+
+        uint64_t bytesPixeles = GetPixelDataSize(atlas.width, atlas.height, atlas.format);
+        escribir(atlas.data, bytesPixeles);
+        escribir(recs, sizeof(Rectangle) * numGlifos);
+        for (int i = 0; i < numGlifos; i++) {
+            PakGlifo g = { glifos[i].value, glifos[i].offsetX, glifos[i].offsetY, glifos[i].advanceX };
+            escribir(&g, sizeof(g));
+        }
+        e.tamano = posicion - e.offset;
+        indice.push_back(e);
+
+        UnloadImage(atlas);
+        MemFree(recs);
+        UnloadFontData(glifos, numGlifos);
+        printf("  ✅ %s SDF (%dx%d)\n", ruta, e.ancho, e.alto);
+        return true;
+    }
+
+    bool cerrar() {
+        alinear();
+        PakCabecera cabecera{};
+        std::memcpy(cabecera.magia, PAK_MAGIA, sizeof(PAK_MAGIA));
+        cabecera.version = PAK_VERSION;
+        cabecera.numEntradas = static_cast<uint32_t>(indice.size());
+        cabecera.offsetIndice = posicion;
+
+        escribir(indice.data(), sizeof(PakEntrada) * indice.size());
+        archivo.seekp(0);
+        archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+        archivo.close();
+        return !archivo.fail();
+    }
+
+    size_t getNumEntradas() const { return indice.size(); }
+    uint64_t getTamano() const { return posicion; }
+};
+
+int main(int argc, char** argv) {
+    const char* salida = (argc > 1) ? argv[1] : "resources/duomaze.pak";
+
+    SetTraceLogLevel(LOG_WARNING);
+    printf("📦 Empaquetando recursos de DuoMaze en %s\n", salida);
+
+    Empaquetador pak;
+    if (!pak.abrir(salida)) {
+        printf("❌ Error: No se pudo crear %s\n", salida);
+        return 1;
+    }
+
+    // Misma lista que TEXTURAS_JUEGO en main_a.cpp: el juego rechaza el paquete si falta alguna
+    const int tile = PackerConstants::TILE_SIZE;
+    pak.agregarTextura("menu_background", "resources/backgrounds/menu_bg.png", 0, 0);
+    pak.agregarTextura("piso", "resources/sprites/piso.png", tile, tile);
+    pak.agregarTextura("pared", "resources/sprites/pared.png", tile, tile);
+    pak.agregarTextura("master", "resources/sprites/master.png", tile, tile);
+    pak.agregarTextura("slave", "resources/sprites/slave.png", tile, tile);
+    pak.agregarTextura("boton1", "resources/sprites/boton1.png", tile, tile);
+    pak.agregarTextura("boton2", "resources/sprites/boton2.png", tile, tile);
+    pak.agregarTextura("boton3", "resources/sprites/boton3.png", tile, tile);
+    pak.agregarTextura("puerta1Cerrada", "resources/sprites/puerta_roja_cerrada.png", tile, tile);
+    pak.agregarTextura("puerta2Cerrada", "resources/sprites/puerta_azul_cerrada.png", tile, tile);
+    pak.agregarTextura("puerta1Abierta", "resources/sprites/puerta_roja_abierta.png", tile, tile);
+    pak.agregarTextura("puerta2Abierta", "resources/sprites/puerta_azul_abierta.png", tile, tile);
+    pak.agregarTextura("puerta3Cerrada", "resources/sprites/puerta_morada_cerrada.png", tile, tile);
+    pak.agregarTextura("puerta3Abierta", "resources/sprites/puerta_morada_abierta.png", tile, tile);
+    pak.agregarTextura("ObstaculoRojo", "resources/sprites/obstaculo_rojo.png", tile, tile);
+    pak.agregarTextura("ObstaculoAzul", "resources/sprites/obstaculo_azul.png", tile, tile);
+    pak.agregarTextura("meta", "resources/sprites/meta.png", tile, tile);
+
+    pak.agregarFuente("resources/fonts/Arrows.ttf");
+    pak.agregarFuente("resources/fonts/upheavtt.ttf");
+    pak.agregarFuente("resources/fonts/Inversionz.ttf");
+    pak.agregarFuente("resources/fonts/spaceranger.ttf");
+
+    if (!pak.cerrar()) {
+        printf("❌ Error al escribir %s\n", salida);
+        return 1;
+    }
+
+    printf("✅ %zu entradas, %.1f KB\n", pak.getNumEntradas(), pak.getTamano() / 1024.0);
+    return 0;
+}
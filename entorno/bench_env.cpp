@@ -0,0 +1,138 @@
+#include "duomaze_env.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// Benchmark del entorno vectorizado - DuoMaze Dev Tool
+// Mide steps/s con acciones aleatorias, comprueba que el resultado no depende del
+// número de hilos y que step no reserva memoria (operator new contado).
+
+static std::atomic<uint64_t> reservas{0};
+
+void* operator new(size_t bytes) {
+    reservas.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(bytes != 0 ? bytes : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+// Todas las formas, y los delete sin inline: si GCC ve el free dentro de delete junto a un
+// new de esta misma unidad avisa de un par malloc/free cruzado (-Wmismatched-new-delete)
+void* operator new[](size_t bytes) {
+    return operator new(bytes);
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+static double ahoraSeg() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t aleatorio(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+// Acciones pregeneradas: el benchmark mide el entorno, no el generador
+static std::vector<std::vector<uint8_t>> generarAcciones(int lote, int buffers) {
+    std::vector<std::vector<uint8_t>> acciones(buffers, std::vector<uint8_t>(lote * DUOMAZE_JUGADORES));
+    uint32_t s = 12345;
+    for (auto& a : acciones) {
+        for (auto& x : a) x = static_cast<uint8_t>(aleatorio(s) & 0x0F);
+    }
+    return acciones;
+}
+
+static uint64_t huellaTensores(const DuoMazeTensores* t, int lote) {
+    uint64_t h = 1469598103934665603ull;
+    auto mezclar = [&h](const void* datos, size_t bytes) {
+        const uint8_t* p = static_cast<const uint8_t*>(datos);
+        for (size_t i = 0; i < bytes; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mezclar(t->tiles, static_cast<size_t>(lote) * DUOMAZE_ALTO * DUOMAZE_ANCHO);
+    mezclar(t->posiciones, static_cast<size_t>(lote) * DUOMAZE_JUGADORES * 2 * sizeof(float));
+    mezclar(t->puertas, lote);
+    mezclar(t->metas, lote);
+    mezclar(t->recompensas, lote * sizeof(float));
+    return h;
+}
+
+static uint64_t ejecutarFijo(int lote, int hilos, int pasos, const std::vector<std::vector<uint8_t>>& acciones) {
+    DuoMazeConfig config{lote, hilos, -1, 2000, 7};
+    DuoMazeEnv* env = duomaze_env_crear(&config);
+    for (int i = 0; i < pasos; i++) {
+        duomaze_env_step(env, acciones[i % acciones.size()].data());
+    }
+    uint64_t h = huellaTensores(duomaze_env_tensores(env), lote);
+    duomaze_env_destruir(env);
+    return h;
+}
+
+int main(int argc, char** argv) {
+    int lote = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    int hilos = (argc > 2) ? std::atoi(argv[2]) : 0;
+    double segundos = (argc > 3) ? std::atof(argv[3]) : 5.0;
+    if (lote <= 0) lote = 4096;
+
+    printf("🧪 Entorno vectorizado de DuoMaze: lote %d, hilos %d (0 = todos)\n", lote, hilos);
+    auto acciones = generarAcciones(lote, 64);
+
+    // Mismo resultado con un hilo que con varios
+    uint64_t uno = ejecutarFijo(lote, 1, 500, acciones);
+    uint64_t varios = ejecutarFijo(lote, hilos, 500, acciones);
+    printf("  %s resultado independiente del número de hilos\n", uno == varios ? "✅" : "❌");
+
+    DuoMazeConfig config{lote, hilos, -1, 3000, 1};
+    DuoMazeEnv* env = duomaze_env_crear(&config);
+    const DuoMazeTensores* t = duomaze_env_tensores(env);
+
+    // Calentamiento y comprobación de reservas
+    for (int i = 0; i < 100; i++) duomaze_env_step(env, acciones[i % acciones.size()].data());
+    uint64_t reservasAntes = reservas.load();
+    uint64_t pasos = 0;
+    uint64_t episodios = 0;
+    double inicio = ahoraSeg();
+    double fin = inicio + segundos;
+    while (ahoraSeg() < fin) {
+        for (int k = 0; k < 16; k++, pasos++) {
+            duomaze_env_step(env, acciones[pasos % acciones.size()].data());
+            for (int i = 0; i < lote; i++) episodios += t->terminados[i] | t->truncados[i];
+        }
+    }
+    double transcurrido = ahoraSeg() - inicio;
+    uint64_t reservasStep = reservas.load() - reservasAntes;
+    duomaze_env_destruir(env);
+
+    double stepsEntorno = static_cast<double>(pasos) * lote / transcurrido;
+    printf("  Steps de lote: %llu (%.1f µs cada uno)\n", static_cast<unsigned long long>(pasos),
+           transcurrido * 1e6 / pasos);
+    printf("  Steps de entorno: %.2f millones/s (%llu episodios terminados)\n", stepsEntorno / 1e6,
+           static_cast<unsigned long long>(episodios));
+    printf("  %s reservas de memoria durante los steps: %llu\n", reservasStep == 0 ? "✅" : "❌",
+           static_cast<unsigned long long>(reservasStep));
+    return (uno == varios && reservasStep == 0) ? 0 : 1;
+}
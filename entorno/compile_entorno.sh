@@ -0,0 +1,15 @@
+#!/bin/bash
+echo "🧪 Compilando Entorno Vectorizado - DuoMaze Dev Tool..."
+
+# libduomaze_env.so para enlazar desde C/C++ (o cargar con ctypes/cffi) y el benchmark.
+# Usa las cabeceras de raylib pero no enlaza la librería
+g++ -o libduomaze_env.so duomaze_env.cpp -shared -fPIC -lpthread -std=c++17 -O2 && \
+g++ -o bench_env bench_env.cpp duomaze_env.cpp -lpthread -std=c++17 -O2
+
+if [ $? -eq 0 ]; then
+    echo "✅ ¡Compilación exitosa!"
+    echo "🚀 Benchmark: ./bench_env [lote=4096] [hilos=0] [segundos=5]"
+else
+    echo "❌ Error en la compilación"
+    exit 1
+fi
@@ -0,0 +1,296 @@
+#include "duomaze_env.h"
+#include "../simulacion.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Implementación del entorno vectorizado (ver duomaze_env.h)
+
+static_assert(DUOMAZE_ANCHO == GameConstants::MAP_WIDTH, "DUOMAZE_ANCHO debe coincidir con MAP_WIDTH");
+static_assert(DUOMAZE_ALTO == GameConstants::MAP_HEIGHT, "DUOMAZE_ALTO debe coincidir con MAP_HEIGHT");
+static_assert(+DUOMAZE_IZQ == +INPUT_IZQ && +DUOMAZE_DER == +INPUT_DER &&
+              +DUOMAZE_ARR == +INPUT_ARR && +DUOMAZE_ABA == +INPUT_ABA, "Acciones distintas de InputBits");
+
+namespace EntornoConstants {
+    constexpr float RECOMPENSA_BOTON = 0.5f;    // Por cada puerta que se abre
+    constexpr float RECOMPENSA_NIVEL = 10.0f;
+    constexpr float PENALIZACION_TICK = -0.001f;
+    constexpr uint8_t MASCARA_ACCION = INPUT_IZQ | INPUT_DER | INPUT_ARR | INPUT_ABA;
+    constexpr size_t ALINEACION = 64;           // Una línea de caché por tensor
+    constexpr int GIROS_ANTES_DE_DORMIR = 4096;
+    constexpr int TILES = GameConstants::MAP_WIDTH * GameConstants::MAP_HEIGHT;
+}
+
+namespace {
+
+// Mapas compartidos por todas las partidas: el de la simulación y su copia en uint8 para el tensor
+struct NivelEntorno {
+    MapaNivel mapa{};
+    std::array<uint8_t, EntornoConstants::TILES> tiles{};
+    SimEstado inicio;
+};
+
+struct PartidaEntorno {
+    SimEstado sim;
+    uint32_t ticksEpisodio = 0;
+    uint32_t semilla = 1;
+};
+
+// Hilos persistentes con reparto estático: el trozo i del lote siempre lo hace el hilo i.
+// Entre steps los hilos giran un rato sobre el contador antes de dormir, así un step
+// seguido de otro no paga el coste de despertar a nadie.
+class PoolPasos {
+private:
+    std::vector<std::thread> hilos;
+    std::mutex mtx;
+    std::condition_variable despertar;
+    std::atomic<uint64_t> generacion{0};
+    std::atomic<int> pendientes{0};
+    std::atomic<bool> parar{false};
+    void (*tarea)(void*, int) = nullptr;
+    void* contexto = nullptr;
+
+    void bucle(int trozo) {
+        uint64_t vista = 0;
+        while (true) {
+            int giros = 0;
+            while (generacion.load(std::memory_order_acquire) == vista && !parar) {
+                if (++giros < EntornoConstants::GIROS_ANTES_DE_DORMIR) {
+                    std::this_thread::yield();
+                } else {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    despertar.wait(lock, [&] { return parar || generacion.load() != vista; });
+                }
+            }
+            if (parar) return;
+            vista = generacion.load(std::memory_order_acquire);
+            tarea(contexto, trozo);
+            pendientes.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+public:
+    void iniciar(int numHilos) {
+        for (int i = 1; i < numHilos; i++) {
+            hilos.emplace_back(&PoolPasos::bucle, this, i);
+        }
+    }
+
+    ~PoolPasos() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            parar = true;
+        }
+        despertar.notify_all();
+        for (auto& h : hilos) h.join();
+    }
+
+    int getNumTrozos() const { return static_cast<int>(hilos.size()) + 1; }
+
+    // Ejecuta f(ctx, trozo) para todos los trozos; el hilo que llama hace el 0
+    void ejecutar(void (*f)(void*, int), void* ctx) {
+        tarea = f;
+        contexto = ctx;
+        pendientes.store(static_cast<int>(hilos.size()), std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            generacion.fetch_add(1, std::memory_order_release);
+        }
+        despertar.notify_all();
+        f(ctx, 0);
+        while (pendientes.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace
+
+struct DuoMazeEnv {
+    DuoMazeConfig config;
+    std::array<NivelEntorno, GameConstants::TOTAL_LEVELS> niveles;
+    std::vector<PartidaEntorno> partidas;
+    std::vector<uint8_t> memoria;       // Todos los tensores, una sola reserva
+    DuoMazeTensores tensores{};
+    PoolPasos pool;
+
+    // Argumentos de la pasada en curso (evita capturas y std::function por step)
+    const uint8_t* acciones = nullptr;
+    const uint8_t* mascaraReset = nullptr;
+
+    static uint32_t aleatorio(uint32_t& s) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+
+    void rango(int trozo, int& inicio, int& fin) const {
+        int trozos = pool.getNumTrozos();
+        inicio = static_cast<int>(static_cast<int64_t>(config.lote) * trozo / trozos);
+        fin = static_cast<int>(static_cast<int64_t>(config.lote) * (trozo + 1) / trozos);
+    }
+
+    void reiniciar(int i) {
+        PartidaEntorno& p = partidas[i];
+        int nivel = config.nivel >= 0 ? config.nivel
+                                      : static_cast<int>(aleatorio(p.semilla) % GameConstants::TOTAL_LEVELS);
+        p.sim = niveles[nivel].inicio;
+        p.ticksEpisodio = 0;
+        std::memcpy(tensores.tiles + static_cast<size_t>(i) * EntornoConstants::TILES,
+                    niveles[nivel].tiles.data(), EntornoConstants::TILES);
+    }
+
+    void escribirObservacion(int i) {
+        const SimEstado& s = partidas[i].sim;
+        float* pos = tensores.posiciones + static_cast<size_t>(i) * 4;
+        pos[0] = s.masterPos.x;
+        pos[1] = s.masterPos.y;
+        pos[2] = s.slavePos.x;
+        pos[3] = s.slavePos.y;
+        tensores.puertas[i] = static_cast<uint8_t>(s.canales);    // Los niveles solo usan canales < 8
+        tensores.metas[i] = s.metas;
+        tensores.niveles[i] = s.nivel;
+    }
+
+    void pasoPartida(int i) {
+        PartidaEntorno& p = partidas[i];
+        Canales antes = p.sim.canales;
+        uint8_t accionMaster = acciones[2 * i] & EntornoConstants::MASCARA_ACCION;
+        uint8_t accionSlave = acciones[2 * i + 1] & EntornoConstants::MASCARA_ACCION;
+        SimulacionFija::paso(p.sim, niveles[p.sim.nivel].mapa, accionMaster, accionSlave);
+        p.ticksEpisodio++;
+
+        Canales abiertas = p.sim.canales & ~antes;
+        float recompensa = EntornoConstants::PENALIZACION_TICK;
+        for (; abiertas != 0; abiertas &= abiertas - 1) recompensa += EntornoConstants::RECOMPENSA_BOTON;
+
+        bool terminado = p.sim.completado;
+        bool truncado = !terminado && config.maxTicks > 0 &&
+                        p.ticksEpisodio >= static_cast<uint32_t>(config.maxTicks);
+        if (terminado) recompensa += EntornoConstants::RECOMPENSA_NIVEL;
+        tensores.recompensas[i] = recompensa;
+        tensores.terminados[i] = terminado ? 1 : 0;
+        tensores.truncados[i] = truncado ? 1 : 0;
+
+        if (terminado || truncado) reiniciar(i);
+        escribirObservacion(i);
+    }
+
+    static void trozoStep(void* ctx, int trozo) {
+        DuoMazeEnv& env = *static_cast<DuoMazeEnv*>(ctx);
+        int inicio, fin;
+        env.rango(trozo, inicio, fin);
+        for (int i = inicio; i < fin; i++) env.pasoPartida(i);
+    }
+
+    static void trozoReset(void* ctx, int trozo) {
+        DuoMazeEnv& env = *static_cast<DuoMazeEnv*>(ctx);
+        int inicio, fin;
+        env.rango(trozo, inicio, fin);
+        for (int i = inicio; i < fin; i++) {
+            if (env.mascaraReset != nullptr && env.mascaraReset[i] == 0) continue;
+            env.reiniciar(i);
+            env.tensores.recompensas[i] = 0.0f;
+            env.tensores.terminados[i] = 0;
+            env.tensores.truncados[i] = 0;
+            env.escribirObservacion(i);
+        }
+    }
+
+    // Reparte la reserva única en tensores alineados
+    void reservarTensores() {
+        const size_t n = static_cast<size_t>(config.lote);
+        const size_t tamanos[] = {
+            n * EntornoConstants::TILES, n * 4 * sizeof(float), n, n, n, n * sizeof(float), n, n
+        };
+        size_t total = 0;
+        for (size_t t : tamanos) {
+            total += (t + EntornoConstants::ALINEACION - 1) / EntornoConstants::ALINEACION * EntornoConstants::ALINEACION;
+        }
+        memoria.assign(total + EntornoConstants::ALINEACION, 0);
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(memoria.data());
+        uintptr_t cursor = (base + EntornoConstants::ALINEACION - 1) & ~(uintptr_t)(EntornoConstants::ALINEACION - 1);
+        uint8_t* punteros[8];
+        for (int k = 0; k < 8; k++) {
+            punteros[k] = reinterpret_cast<uint8_t*>(cursor);
+            cursor += (tamanos[k] + EntornoConstants::ALINEACION - 1) / EntornoConstants::ALINEACION * EntornoConstants::ALINEACION;
+        }
+        tensores.tiles = punteros[0];
+        tensores.posiciones = reinterpret_cast<float*>(punteros[1]);
+        tensores.puertas = punteros[2];
+        tensores.metas = punteros[3];
+        tensores.niveles = punteros[4];
+        tensores.recompensas = reinterpret_cast<float*>(punteros[5]);
+        tensores.terminados = punteros[6];
+        tensores.truncados = punteros[7];
+    }
+
+    explicit DuoMazeEnv(const DuoMazeConfig& c) : config(c) {
+        for (int n = 0; n < GameConstants::TOTAL_LEVELS; n++) {
+            NivelEntorno& nivel = niveles[n];
+            SimulacionFija::cargarNivel(n, nivel.mapa, nivel.inicio);
+            for (int y = 0; y < GameConstants::MAP_HEIGHT; y++) {
+                for (int x = 0; x < GameConstants::MAP_WIDTH; x++) {
+                    nivel.tiles[y * GameConstants::MAP_WIDTH + x] = static_cast<uint8_t>(nivel.mapa[y][x]);
+                }
+            }
+        }
+
+        partidas.resize(config.lote);
+        uint64_t s = config.semilla != 0 ? config.semilla : 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < config.lote; i++) {
+            // splitmix64: semillas independientes por partida
+            uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            uint32_t semilla = static_cast<uint32_t>(z ^ (z >> 31));
+            partidas[i].semilla = semilla != 0 ? semilla : 1;
+        }
+        reservarTensores();
+
+        int numHilos = config.hilos > 0 ? config.hilos : static_cast<int>(std::thread::hardware_concurrency());
+        numHilos = std::max(1, std::min(numHilos, config.lote));
+        pool.iniciar(numHilos);
+    }
+};
+
+extern "C" {
+
+DuoMazeEnv* duomaze_env_crear(const DuoMazeConfig* config) {
+    if (config == nullptr || config->lote <= 0) return nullptr;
+    if (config->nivel >= GameConstants::TOTAL_LEVELS) return nullptr;
+    DuoMazeEnv* env = new DuoMazeEnv(*config);
+    duomaze_env_reset(env, nullptr);
+    return env;
+}
+
+void duomaze_env_destruir(DuoMazeEnv* env) {
+    delete env;
+}
+
+const DuoMazeTensores* duomaze_env_tensores(const DuoMazeEnv* env) {
+    return &env->tensores;
+}
+
+int duomaze_env_lote(const DuoMazeEnv* env) {
+    return env->config.lote;
+}
+
+void duomaze_env_reset(DuoMazeEnv* env, const uint8_t* mascara) {
+    env->mascaraReset = mascara;
+    env->pool.ejecutar(&DuoMazeEnv::trozoReset, env);
+}
+
+void duomaze_env_step(DuoMazeEnv* env, const uint8_t* acciones) {
+    env->acciones = acciones;
+    env->pool.ejecutar(&DuoMazeEnv::trozoStep, env);
+}
+
+}
@@ -0,0 +1,74 @@
+#ifndef DUOMAZE_ENV_H
+#define DUOMAZE_ENV_H
+
+/*
+ * Entorno vectorizado de DuoMaze para entrenar bots (API en C).
+ * Un DuoMazeEnv simula `lote` partidas independientes con la misma simulación de paso
+ * fijo que el juego y el servidor (simulacion.h). Cada step avanza un tick de 10 ms en
+ * todas a la vez, repartidas entre hilos que se crean una sola vez.
+ *
+ * Las observaciones se escriben en tensores contiguos reservados al crear el entorno;
+ * los punteros de DuoMazeTensores no cambian durante su vida (se pueden envolver con
+ * numpy/torch sin copiar). Ni reset ni step reservan memoria.
+ *
+ * Una partida que termina (nivel completado o límite de ticks) se reinicia sola en ese
+ * mismo step: terminados/truncados marcan el fin y las observaciones ya son del inicio
+ * del episodio siguiente.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUOMAZE_ANCHO 20
+#define DUOMAZE_ALTO 15
+#define DUOMAZE_JUGADORES 2     /* 0 = master, 1 = slave */
+
+/* Acción por jugador y step: bits de dirección, igual que InputBits del juego */
+enum {
+    DUOMAZE_IZQ = 1,
+    DUOMAZE_DER = 2,
+    DUOMAZE_ARR = 4,
+    DUOMAZE_ABA = 8
+};
+
+typedef struct {
+    int lote;               /* Partidas en paralelo */
+    int hilos;              /* 0 = uno por núcleo */
+    int nivel;              /* Nivel de cada episodio; -1 = aleatorio en cada reinicio */
+    int maxTicks;           /* Ticks por episodio antes de truncar (0 = sin límite) */
+    uint64_t semilla;
+} DuoMazeConfig;
+
+typedef struct {
+    uint8_t* tiles;         /* [lote][ALTO][ANCHO] TileType; solo cambia al reiniciar */
+    float* posiciones;      /* [lote][JUGADORES][2] x, y en píxeles */
+    uint8_t* puertas;       /* [lote] bit i = canal i activo (puertas 1/2/3 = canales 0/1/2) */
+    uint8_t* metas;         /* [lote] bit 0 master en la meta, bit 1 slave */
+    uint8_t* niveles;       /* [lote] */
+    float* recompensas;     /* [lote] del último step */
+    uint8_t* terminados;    /* [lote] 1 si el último step completó el nivel */
+    uint8_t* truncados;     /* [lote] 1 si el último step llegó a maxTicks */
+} DuoMazeTensores;
+
+typedef struct DuoMazeEnv DuoMazeEnv;
+
+DuoMazeEnv* duomaze_env_crear(const DuoMazeConfig* config);
+void duomaze_env_destruir(DuoMazeEnv* env);
+
+const DuoMazeTensores* duomaze_env_tensores(const DuoMazeEnv* env);
+int duomaze_env_lote(const DuoMazeEnv* env);
+
+/* Reinicia las partidas con mascara[i] != 0 (NULL = todas) */
+void duomaze_env_reset(DuoMazeEnv* env, const uint8_t* mascara);
+
+/* acciones: [lote][JUGADORES] bits DUOMAZE_* */
+void duomaze_env_step(DuoMazeEnv* env, const uint8_t* acciones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef DUOMAZE_FUENTES_SDF_H
+#define DUOMAZE_FUENTES_SDF_H
+
+// Fuentes con campo de distancia con signo (SDF), compartido por el juego y el empaquetador.
+// Cada fuente se rasteriza una sola vez a TAMANO_BASE; el shader la escala a cualquier
+// tamaño y dibuja el contorno en la misma pasada.
+
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace FuentesSDF {
+    constexpr int TAMANO_BASE = 48;     // Tamaño de rasterizado del atlas
+    constexpr int SPREAD = 8;           // Píxeles de distancia guardados fuera/dentro del glifo
+    constexpr int CARACTERES = 250;     // Mismos glifos que antes cargaba LoadFontEx
+    constexpr int PADDING_ATLAS = 2;    // Separación entre glifos dentro del atlas
+
+    // Transformada de distancia euclídea 1D (Felzenszwalb & Huttenlocher), sobre distancias al cuadrado
+    inline void transformada1D(const float* f, float* d, int* v, float* z, int n) {
+        const float INF = 1e20f;
+        int k = 0;
+        v[0] = 0;
+        z[0] = -INF;
+        z[1] = INF;
+        for (int q = 1; q < n; q++) {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+            while (s <= z[k]) {
+                k--;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = INF;
+        }
+        k = 0;
+        for (int q = 0; q < n; q++) {
+            while (z[k + 1] < q) k++;
+            float dq = static_cast<float>(q - v[k]);
+            d[q] = dq * dq + f[v[k]];
+        }
+    }
+
+    // Transformada 2D separable: primero columnas, después filas
+    inline void transformada2D(std::vector<float>& grid, int ancho, int alto) {
+        int n = std::max(ancho, alto);
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+
+        for (int x = 0; x < ancho; x++) {
+            for (int y = 0; y < alto; y++) f[y] = grid[y * ancho + x];
+            transformada1D(f.data(), d.data(), v.data(), z.data(), alto);
+            for (int y = 0; y < alto; y++) grid[y * ancho + x] = d[y];
+        }
+        for (int y = 0; y < alto; y++) {
+            transformada1D(&grid[y * ancho], d.data(), v.data(), z.data(), ancho);
+            std::copy(d.begin(), d.begin() + ancho, grid.begin() + y * ancho);
+        }
+    }
+
+    // Sustituye la imagen de cobertura del glifo por su SDF, con SPREAD píxeles de margen
+    inline void convertirGlifo(GlyphInfo& glifo) {
+        const Image& origen = glifo.image;
+        const int ancho = origen.width + 2 * SPREAD;
+        const int alto = origen.height + 2 * SPREAD;
+        const float INF = 1e20f;
+        const unsigned char* cobertura = static_cast<const unsigned char*>(origen.data);
+
+        // Distancia a los píxeles de dentro (para los de fuera) y a los de fuera (para los de dentro)
+        std::vector<float> haciaDentro(ancho * alto, INF);
+        std::vector<float> haciaFuera(ancho * alto, 0.0f);
+        for (int y = 0; y < origen.height; y++) {
+            for (int x = 0; x < origen.width; x++) {
+                if (cobertura != nullptr && cobertura[y * origen.width + x] >= 128) {
+                    int i = (y + SPREAD) * ancho + (x + SPREAD);
+                    haciaDentro[i] = 0.0f;
+                    haciaFuera[i] = INF;
+                }
+            }
+        }
+        transformada2D(haciaDentro, ancho, alto);
+        transformada2D(haciaFuera, ancho, alto);
+
+        unsigned char* sdf = static_cast<unsigned char*>(MemAlloc(ancho * alto));
+        for (int i = 0; i < ancho * alto; i++) {
+            float distancia = std::sqrt(haciaFuera[i]) - std::sqrt(haciaDentro[i]);
+            float valor = 0.5f + distancia / (2.0f * SPREAD);
+            sdf[i] = static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, valor)) * 255.0f + 0.5f);
+        }
+
+        if (glifo.image.data != nullptr) MemFree(glifo.image.data);
+        glifo.image.data = sdf;
+        glifo.image.width = ancho;
+        glifo.image.height = alto;
+        glifo.image.mipmaps = 1;
+        glifo.image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+        glifo.offsetX -= SPREAD;
+        glifo.offsetY -= SPREAD;
+    }
+
+    // Solo CPU (apto para hilos de trabajo): rasteriza el TTF y genera el atlas SDF.
+    // glifos y recs quedan reservados con el allocator de raylib, como en LoadFontEx.
+    inline Image generarAtlas(const unsigned char* ttf, int tamTtf, GlyphInfo** glifos, Rectangle** recs) {
+        *glifos = LoadFontData(ttf, tamTtf, TAMANO_BASE, nullptr, CARACTERES, FONT_DEFAULT);
+        *recs = nullptr;
+        if (*glifos == nullptr) return Image{};
+
+        for (int i = 0; i < CARACTERES; i++) {
+            convertirGlifo((*glifos)[i]);
+        }
+        // La altura de cada glifo ya incluye el spread: se pasa para que el atlas tenga sitio
+        return GenImageFontAtlas(*glifos, recs, CARACTERES, TAMANO_BASE + 2 * SPREAD, PADDING_ATLAS, 1);
+    }
+
+    // Hilo principal: sube el atlas y arma la Font (toma posesión de glifos y recs)
+    inline Font construirFuente(Image atlas, GlyphInfo* glifos, Rectangle* recs) {
+        Font font{};
+        font.baseSize = TAMANO_BASE;
+        font.glyphCount = CARACTERES;
+        font.glyphPadding = PADDING_ATLAS;
+        font.glyphs = glifos;
+        font.recs = recs;
+        font.texture = LoadTextureFromImage(atlas);
+        SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+        return font;
+    }
+
+    // Shader de texto: relleno y contorno a partir de la distancia, con antialiasing por fwidth
+    constexpr const char* SHADER_FS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform vec4 colorContorno;
+uniform float anchoContorno;
+out vec4 finalColor;
+
+void main() {
+    float d = texture(texture0, fragTexCoord).a;
+    float w = max(fwidth(d) * 0.7, 0.0001);
+    float relleno = smoothstep(0.5 - w, 0.5 + w, d);
+    float borde = 0.5 - anchoContorno;
+    float cobertura = smoothstep(borde - w, borde + w, d);
+    vec4 color = mix(colorContorno, fragColor * colDiffuse, relleno);
+    finalColor = vec4(color.rgb, color.a * cobertura);
+}
+)";
+
+    // Convierte un contorno en píxeles de pantalla a unidades del SDF para un tamaño dado
+    inline float contornoEnUnidadesSDF(float contornoPx, float fontSize) {
+        float pxAtlas = contornoPx * static_cast<float>(TAMANO_BASE) / std::max(fontSize, 1.0f);
+        return std::min(0.49f, pxAtlas / (2.0f * SPREAD));
+    }
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef DUOMAZE_LIENZO_VIRTUAL_H
+#define DUOMAZE_LIENZO_VIRTUAL_H
+
+// Lienzo virtual: todo el juego se dibuja en coordenadas de SCREEN_WIDTH x SCREEN_HEIGHT sobre
+// una textura de render de ese tamaño por una escala interna (1 = 800x600 píxeles reales), y al
+// final un solo quad la lleva a la ventana, sea del tamaño que sea, con bandas negras para
+// conservar la proporción. En una pantalla 4K con una gráfica integrada se dibuja a escala 1 y
+// solo el escalado final toca los píxeles de la pantalla.
+//
+// Escalado al vecino más cercano o "bilineal nítido": bilineal solo en el borde entre píxeles
+// del lienzo, sin el desenfoque del bilineal ni los píxeles desiguales del vecino más cercano
+// con factores no enteros. El ratón se traduce a coordenadas virtuales con SetMouseScale.
+//
+// Quien necesite otro destino (bloom, cachés del menú) llama a terminar() antes y otra vez a
+// comenzar() después: las texturas de render de raylib no se anidan.
+
+#include "raylib.h"
+#include "memoria.h"
+#include <algorithm>
+#include <cmath>
+
+enum FiltroEscalado {
+    ESCALADO_CERCANO = 0,
+    ESCALADO_NITIDO
+};
+
+namespace LienzoGLSL {
+    // Bilineal nítido: cada texel se amplía al múltiplo entero que cabe y solo la franja que
+    // sobra entre texels se interpola (textura con filtro bilineal)
+    constexpr const char* NITIDO_FS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec2 tamTextura;
+uniform vec2 tamDestino;
+out vec4 finalColor;
+
+void main() {
+    vec2 prescala = max(floor(tamDestino / tamTextura), vec2(1.0));
+    vec2 texel = fragTexCoord * tamTextura;
+    vec2 centro = fract(texel) - 0.5;
+    vec2 rango = 0.5 - 0.5 / prescala;
+    vec2 f = (centro - clamp(centro, -rango, rango)) * prescala + 0.5;
+    finalColor = texture(texture0, (floor(texel) + f) / tamTextura) * fragColor;
+}
+)";
+}
+
+class LienzoVirtual {
+private:
+    int anchoVirtual;
+    int altoVirtual;
+    float escala = 1.0f;
+    FiltroEscalado filtro = ESCALADO_NITIDO;
+    RenderTexture2D objetivo{};
+    Shader nitido{};
+    int locTamTextura = -1;
+    int locTamDestino = -1;
+    Rectangle destino{};
+
+    void aplicarFiltro() {
+        SetTextureFilter(objetivo.texture, filtro == ESCALADO_CERCANO || nitido.id == 0 ? TEXTURE_FILTER_POINT
+                                                                                          : TEXTURE_FILTER_BILINEAR);
+    }
+
+public:
+    LienzoVirtual(int ancho, int alto) : anchoVirtual(ancho), altoVirtual(alto) {
+        destino = {0, 0, static_cast<float>(ancho), static_cast<float>(alto)};
+    }
+
+    // Con la ventana ya abierta. false si no hay textura de render: se dibuja directamente en
+    // la ventana a 800x600 como antes, sin escalar.
+    bool cargar(float escalaInterna, FiltroEscalado f) {
+        descargar();
+        escala = std::clamp(escalaInterna, 0.25f, 4.0f);
+        filtro = f;
+        objetivo = LoadRenderTexture(getAnchoInterno(), getAltoInterno());
+        if (objetivo.id == 0) return false;
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(objetivo));
+        nitido = LoadShaderFromMemory(nullptr, LienzoGLSL::NITIDO_FS);
+        if (nitido.id != 0) {
+            locTamTextura = GetShaderLocation(nitido, "tamTextura");
+            locTamDestino = GetShaderLocation(nitido, "tamDestino");
+        }
+        aplicarFiltro();
+        return true;
+    }
+
+    bool listo() const { return objetivo.id != 0; }
+    // Sin el shader, el escalado nítido se queda en el vecino más cercano
+    bool hayNitido() const { return nitido.id != 0; }
+
+    void setFiltro(FiltroEscalado f) {
+        filtro = f;
+        if (listo()) aplicarFiltro();
+    }
+    FiltroEscalado getFiltro() const { return filtro; }
+    float getEscala() const { return escala; }
+    int getAnchoInterno() const { return std::max(1, static_cast<int>(std::lround(anchoVirtual * escala))); }
+    int getAltoInterno() const { return std::max(1, static_cast<int>(std::lround(altoVirtual * escala))); }
+    // Dónde acabó el lienzo en la última presentación, en píxeles de la salida
+    Rectangle getDestino() const { return destino; }
+
+    static const char* nombreFiltro(FiltroEscalado f) { return f == ESCALADO_CERCANO ? "cercano" : "nítido"; }
+
+    // El lienzo pasa a ser el destino, con la escala interna como cámara. No lo limpia, así que
+    // también sirve para volver a él tras la pasada de otro destino.
+    void comenzar() {
+        if (!listo()) return;
+        BeginTextureMode(objetivo);
+        Camera2D camara = {};
+        camara.zoom = escala;
+        BeginMode2D(camara);
+    }
+
+    void terminar() {
+        if (!listo()) return;
+        EndMode2D();
+        EndTextureMode();
+    }
+
+    // Entre BeginDrawing y EndDrawing, con el lienzo terminado: lo escala al mayor rectángulo de
+    // la proporción virtual que cabe en la salida y deja el ratón en coordenadas virtuales
+    void presentar(int anchoSalida, int altoSalida) {
+        if (!listo()) return;
+        float factor = std::min(static_cast<float>(anchoSalida) / anchoVirtual, static_cast<float>(altoSalida) / altoVirtual);
+        float w = std::floor(anchoVirtual * factor), h = std::floor(altoVirtual * factor);
+        destino = {std::floor((anchoSalida - w) / 2), std::floor((altoSalida - h) / 2), w, h};
+        SetMouseOffset(-static_cast<int>(destino.x), -static_cast<int>(destino.y));
+        SetMouseScale(anchoVirtual / w, altoVirtual / h);
+
+        ClearBackground(BLACK);
+        Rectangle fuente = {0, 0, static_cast<float>(objetivo.texture.width), -static_cast<float>(objetivo.texture.height)};
+        bool conShader = filtro == ESCALADO_NITIDO && hayNitido();
+        if (conShader) {
+            float tamTextura[2] = {static_cast<float>(objetivo.texture.width), static_cast<float>(objetivo.texture.height)};
+            float tamDestino[2] = {w, h};
+            BeginShaderMode(nitido);
+            SetShaderValue(nitido, locTamTextura, tamTextura, SHADER_UNIFORM_VEC2);
+            SetShaderValue(nitido, locTamDestino, tamDestino, SHADER_UNIFORM_VEC2);
+        }
+        DrawTexturePro(objetivo.texture, fuente, destino, {0, 0}, 0, WHITE);
+        if (conShader) EndShaderMode();
+    }
+
+    // Alterna pantalla completa al tamaño del monitor; al salir vuelve a la ventana indicada
+    static void alternarPantallaCompleta(int anchoVentana, int altoVentana) {
+        if (IsWindowFullscreen()) {
+            ToggleFullscreen();
+            SetWindowSize(anchoVentana, altoVentana);
+        } else {
+            int monitor = GetCurrentMonitor();
+            SetWindowSize(GetMonitorWidth(monitor), GetMonitorHeight(monitor));
+            ToggleFullscreen();
+        }
+    }
+
+    void descargar() {
+        if (objetivo.id != 0) {
+            ContabilidadMemoria::liberaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(objetivo));
+            UnloadRenderTexture(objetivo);
+        }
+        if (nitido.id != 0) UnloadShader(nitido);
+        objetivo = RenderTexture2D{};
+        nitido = Shader{};
+        SetMouseOffset(0, 0);
+        SetMouseScale(1.0f, 1.0f);
+    }
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef DUOMAZE_LOTE_SPRITES_H
+#define DUOMAZE_LOTE_SPRITES_H
+
+// Lote instanciado de sprites de color: rectángulos rotados y halos circulares. Cada frame
+// las instancias (centro, tamaño, rotación, halo y color) se suben de una vez a un vertex
+// buffer y se dibujan con una sola llamada instanciada sobre un quad de 6 vértices. La
+// caída del halo la calcula el fragment shader, así que no hay que teselar círculos en CPU.
+//
+// Va directamente por rlgl (VAO, buffers y atributos con divisor), con GLSL 330 como el
+// resto de shaders del juego. Respeta las matrices actuales de raylib (cámaras, modo textura).
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "memoria.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace LoteSpritesGLSL {
+    constexpr const char* SHADER_VS = R"(#version 330
+in vec2 vertexPosition;         // Esquina del quad unidad, de -0.5 a 0.5
+in vec4 instanciaPosTam;        // Centro (px) y tamaño (px)
+in vec2 instanciaRotHalo;       // Rotación (rad) y halo (0 = rectángulo sólido)
+in vec4 instanciaColor;
+uniform mat4 proyeccion;
+uniform mat4 vista;
+out vec2 local;
+out vec4 color;
+out float halo;
+
+void main() {
+    float c = cos(instanciaRotHalo.x);
+    float s = sin(instanciaRotHalo.x);
+    vec2 p = vertexPosition * instanciaPosTam.zw;
+    p = vec2(c * p.x - s * p.y, s * p.x + c * p.y) + instanciaPosTam.xy;
+    local = vertexPosition * 2.0;
+    color = instanciaColor;
+    halo = instanciaRotHalo.y;
+    gl_Position = proyeccion * vista * vec4(p, 0.0, 1.0);
+}
+)";
+
+    // Halo: caída cuadrática desde el centro hasta el borde del círculo inscrito
+    constexpr const char* SHADER_FS = R"(#version 330
+in vec2 local;
+in vec4 color;
+in float halo;
+out vec4 finalColor;
+
+void main() {
+    if (halo > 0.0) {
+        float caida = max(0.0, 1.0 - length(local));
+        finalColor = vec4(color.rgb, color.a * halo * caida * caida);
+    } else {
+        finalColor = color;
+    }
+}
+)";
+}
+
+struct InstanciaSprite {
+    float x, y;             // Centro en píxeles
+    float ancho, alto;
+    float rotacion;         // Radianes
+    float halo;             // 0 = rectángulo sólido; > 0 = intensidad del halo en el centro
+    Color color;
+};
+static_assert(sizeof(InstanciaSprite) == 28, "Disposición que esperan los atributos del shader");
+
+class LoteSprites {
+private:
+    static constexpr size_t CAPACIDAD_INICIAL = 1024;
+
+    Shader shader{};
+    unsigned int vao = 0;
+    unsigned int vboQuad = 0;
+    unsigned int vboInstancias = 0;
+    size_t capacidadGPU = 0;                // Instancias que caben en vboInstancias
+    int locProyeccion = -1;
+    int locVista = -1;
+    int locPosTam = -1;
+    int locRotHalo = -1;
+    int locColor = -1;
+    // Solo crece; usadas marca el final del frame
+    std::vector<InstanciaSprite, AsignadorEtiquetado<InstanciaSprite, MEM_RENDER>> instancias;
+    size_t usadas = 0;
+    size_t subidas = 0;                         // Instancias en vboInstancias
+
+    // rlgl 5.5 recibe el desplazamiento del atributo como int; hasta entonces, como puntero
+    static void atributo(int loc, int componentes, int tipo, bool normalizado, int paso, size_t desplazamiento) {
+#if defined(RAYLIB_VERSION_MAJOR) && (RAYLIB_VERSION_MAJOR > 5 || (RAYLIB_VERSION_MAJOR == 5 && RAYLIB_VERSION_MINOR >= 5))
+        rlSetVertexAttribute(loc, componentes, tipo, normalizado, paso, static_cast<int>(desplazamiento));
+#else
+        rlSetVertexAttribute(loc, componentes, tipo, normalizado, paso, reinterpret_cast<const void*>(desplazamiento));
+#endif
+    }
+
+    // Con el VAO activo: buffer de instancias nuevo y sus atributos (divisor 1)
+    void crearBufferInstancias(size_t capacidad) {
+        if (vboInstancias != 0) {
+            rlUnloadVertexBuffer(vboInstancias);
+            ContabilidadMemoria::liberaGPU(MEM_RENDER, capacidadGPU * sizeof(InstanciaSprite));
+        }
+        capacidadGPU = capacidad;
+        vboInstancias = rlLoadVertexBuffer(nullptr, static_cast<int>(capacidad * sizeof(InstanciaSprite)), true);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, capacidad * sizeof(InstanciaSprite));
+        const int paso = sizeof(InstanciaSprite);
+        atributo(locPosTam, 4, RL_FLOAT, false, paso, offsetof(InstanciaSprite, x));
+        atributo(locRotHalo, 2, RL_FLOAT, false, paso, offsetof(InstanciaSprite, rotacion));
+        atributo(locColor, 4, RL_UNSIGNED_BYTE, true, paso, offsetof(InstanciaSprite, color));
+        for (int loc : {locPosTam, locRotHalo, locColor}) {
+            rlEnableVertexAttribute(loc);
+            rlSetVertexAttributeDivisor(loc, 1);
+        }
+    }
+
+public:
+    // Con la ventana ya abierta. false si el shader no compila (el que llama usa su camino de siempre).
+    bool cargar() {
+        descargar();
+        shader = LoadShaderFromMemory(LoteSpritesGLSL::SHADER_VS, LoteSpritesGLSL::SHADER_FS);
+        if (shader.id == 0) return false;
+        locProyeccion = GetShaderLocation(shader, "proyeccion");
+        locVista = GetShaderLocation(shader, "vista");
+        locPosTam = GetShaderLocationAttrib(shader, "instanciaPosTam");
+        locRotHalo = GetShaderLocationAttrib(shader, "instanciaRotHalo");
+        locColor = GetShaderLocationAttrib(shader, "instanciaColor");
+        int locVertice = GetShaderLocationAttrib(shader, "vertexPosition");
+        if (locPosTam < 0 || locRotHalo < 0 || locColor < 0 || locVertice < 0) {
+            descargar();
+            return false;
+        }
+
+        const float quad[12] = {-0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f,
+                                -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f};
+        vao = rlLoadVertexArray();
+        rlEnableVertexArray(vao);
+        vboQuad = rlLoadVertexBuffer(quad, sizeof(quad), false);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, sizeof(quad));
+        atributo(locVertice, 2, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(locVertice);
+        crearBufferInstancias(CAPACIDAD_INICIAL);
+        rlDisableVertexArray();
+        return true;
+    }
+
+    bool listo() const { return vao != 0; }
+
+    void limpiar() { usadas = 0; }
+    size_t tamano() const { return usadas; }
+
+    // n huecos seguidos para rellenar en el sitio; solo reserva memoria si el lote crece
+    InstanciaSprite* ampliar(size_t n) {
+        if (usadas + n > instancias.size()) instancias.resize(std::max(usadas + n, instancias.size() * 2));
+        InstanciaSprite* huecos = &instancias[usadas];
+        usadas += n;
+        return huecos;
+    }
+
+    void agregar(const InstanciaSprite& instancia) { *ampliar(1) = instancia; }
+
+    // Sube las instancias en el orden en que se agregaron y las dibuja en una llamada
+    void dibujar() {
+        if (!listo() || usadas == 0) return;
+        rlDrawRenderBatchActive();      // Lo que raylib tenga en cola va debajo
+
+        rlEnableVertexArray(vao);
+        if (usadas > capacidadGPU) crearBufferInstancias(std::max(usadas, capacidadGPU * 2));
+        rlUpdateVertexBuffer(vboInstancias, instancias.data(), static_cast<int>(usadas * sizeof(InstanciaSprite)), 0);
+        rlDisableVertexArray();
+        subidas = usadas;
+        redibujar();
+    }
+
+    // Otra pasada de lo último subido, sin volver a subirlo (otro destino u otras matrices)
+    void redibujar() {
+        if (!listo() || subidas == 0) return;
+        rlDrawRenderBatchActive();
+
+        rlEnableVertexArray(vao);
+        rlEnableShader(shader.id);
+        rlSetUniformMatrix(locProyeccion, rlGetMatrixProjection());
+        rlSetUniformMatrix(locVista, rlGetMatrixModelview());
+        rlDisableBackfaceCulling();     // La Y de la pantalla invierte el sentido del quad
+        rlDrawVertexArrayInstanced(0, 6, static_cast<int>(subidas));
+        rlEnableBackfaceCulling();
+        rlDisableShader();
+        rlDisableVertexArray();
+    }
+
+    void descargar() {
+        if (vboInstancias != 0) {
+            rlUnloadVertexBuffer(vboInstancias);
+            ContabilidadMemoria::liberaGPU(MEM_RENDER, capacidadGPU * sizeof(InstanciaSprite));
+        }
+        if (vboQuad != 0) {
+            rlUnloadVertexBuffer(vboQuad);
+            ContabilidadMemoria::liberaGPU(MEM_RENDER, 12 * sizeof(float));
+        }
+        if (vao != 0) rlUnloadVertexArray(vao);
+        if (shader.id != 0) UnloadShader(shader);
+        vboInstancias = vboQuad = vao = 0;
+        capacidadGPU = subidas = usadas = 0;
+        shader = Shader{};
+        instancias.clear();
+        instancias.shrink_to_fit();
+    }
+};
+
+#endif
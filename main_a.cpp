@@ -4,11 +4,26 @@
 #define NOMINMAX
 
 #include "raylib.h"
+#include "fuentes_sdf.h"
+#include "simulacion.h"
+#include "protocolo_red.h"
+#include "companero_ia.h"
+#include "campos_distancia.h"
+#include "componentes.h"
+#include "tilemap_gpu.h"
+#include "lote_sprites.h"
+#include "bloom.h"
+#include "ritmo_frames.h"
+#include "lienzo_virtual.h"
+#include "arena_frame.h"
+#include "paquete.h"
+#include "memoria.h"
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <cstdarg>
 #include <fstream>
 #include <array>
 #include <unordered_map>
@@ -17,52 +32,99 @@
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <deque>
 
 // Configuración multiplataforma
 #ifdef _WIN32
+    #include <winsock2.h>       // Antes de windows.h
+    #include <ws2tcpip.h>
     #include <windows.h>
     #define SLEEP_MS(ms) Sleep(ms)
 #else
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
     #define SLEEP_MS(ms) usleep((ms) * 1000)
 #endif
+#include <cstring>
 
-// Constantes del juego
+// Constantes del juego (las de la simulación están en simulacion.h)
 namespace GameConstants {
-    constexpr int MAP_WIDTH = 20;
-    constexpr int MAP_HEIGHT = 15;
-    constexpr int TILE_SIZE = 40;
     constexpr int SCREEN_WIDTH = 800;
     constexpr int SCREEN_HEIGHT = 600;
-    constexpr int PLAYER_RADIUS = 15;
-    constexpr int PLAYER_SPEED = 3;
     constexpr int FPS_TARGET = 60;
+    constexpr int MENU_FPS = 30;            // El menú no necesita el ritmo del juego
+    
+    // Menú quieto: sin entrada durante MENU_SEGUNDOS_REPOSO se presenta a MENU_FPS_REPOSO
+    constexpr int MENU_FPS_REPOSO = 10;
+    constexpr double MENU_SEGUNDOS_REPOSO = 2.0;
     
     // Tiempos de actualización de hilos (en ms)
-    constexpr int PHYSICS_UPDATE_RATE = 10;
     constexpr int VALIDATION_UPDATE_RATE = 15;
     constexpr int AUDIO_UPDATE_RATE = 10;
     
-    // NUEVO: Sistema de niveles
-    constexpr int TOTAL_LEVELS = 4;
+    // Música: duración del crossfade y tamaño del buffer de decodificación anticipada
+    constexpr int MUSIC_CROSSFADE_MS = 1500;
+    constexpr int MUSIC_BUFFER_FRAMES = 8192;
 }
 
 // Enumeraciones
 enum GameScreen { MENU = 0, GAMEPLAY = 1 };
-enum TileType {
-    VACIO = 0,
-    PARED = 1,
-    START_MASTER = 2,
-    START_SLAVE = 3,
-    BOTON_1 = 4,
-    BOTON_2 = 5,
-    BOTON_3 = 6,
-    PUERTA_1 = 7,
-    PUERTA_2 = 8,
-    PUERTA_3 = 9,
-    OBSTACULO_ROJO = 10,
-    OBSTACULO_AZUL = 11,
-    META = 12
+enum FuenteId { FUENTE_ARROWS = 0, FUENTE_UPHEAVTT, FUENTE_INVERSIONZ, FUENTE_SPACERANGER, FUENTE_TOTAL };
+
+// Ruta de cada fuente (también es su clave dentro de duomaze.pak)
+constexpr const char* RUTAS_FUENTES[FUENTE_TOTAL] = {
+    "resources/fonts/Arrows.ttf",
+    "resources/fonts/upheavtt.ttf",
+    "resources/fonts/Inversionz.ttf",
+    "resources/fonts/spaceranger.ttf"
+};
+
+// Clave del sprite de cada TexturaTile (nullptr = no se dibuja en el juego, como los inicios)
+constexpr const char* CLAVES_TEXTURA_TILE[NUM_TEXTURAS_TILE] = {
+    nullptr, "pared", nullptr, nullptr,
+    "boton1", "boton2", "boton3",
+    "puerta1Cerrada", "puerta1Abierta",
+    "puerta2Cerrada", "puerta2Abierta",
+    "puerta3Cerrada", "puerta3Abierta",
+    "ObstaculoRojo", "ObstaculoAzul", "meta"
+};
+
+// Texturas del juego: clave (la misma dentro de duomaze.pak) y archivo suelto.
+// Los sprites se reescalan a TILE_SIZE; el resto se queda con su tamaño.
+struct RecursoTextura {
+    const char* clave;
+    const char* ruta;
+    bool sprite;
+};
+
+constexpr RecursoTextura TEXTURAS_JUEGO[] = {
+    {"menu_background", "resources/backgrounds/menu_bg.png", false},
+    {"piso", "resources/sprites/piso.png", true},
+    {"pared", "resources/sprites/pared.png", true},
+    {"master", "resources/sprites/master.png", true},
+    {"slave", "resources/sprites/slave.png", true},
+    {"boton1", "resources/sprites/boton1.png", true},
+    {"boton2", "resources/sprites/boton2.png", true},
+    {"boton3", "resources/sprites/boton3.png", true},
+    {"puerta1Cerrada", "resources/sprites/puerta_roja_cerrada.png", true},
+    {"puerta2Cerrada", "resources/sprites/puerta_azul_cerrada.png", true},
+    {"puerta1Abierta", "resources/sprites/puerta_roja_abierta.png", true},
+    {"puerta2Abierta", "resources/sprites/puerta_azul_abierta.png", true},
+    {"puerta3Cerrada", "resources/sprites/puerta_morada_cerrada.png", true},
+    {"puerta3Abierta", "resources/sprites/puerta_morada_abierta.png", true},
+    {"ObstaculoRojo", "resources/sprites/obstaculo_rojo.png", true},
+    {"ObstaculoAzul", "resources/sprites/obstaculo_azul.png", true},
+    {"meta", "resources/sprites/meta.png", true}
 };
 
 // Sistema de logging optimizado
@@ -82,35 +144,339 @@ public:
         }
     }
     
-    void write(const std::string& message) {
+    void write(const char* message) {
         std::lock_guard<std::mutex> lock(logMutex);
         if (logfile.is_open()) {
             logfile << message << std::endl;
         }
     }
+    
+    void write(const std::string& message) { write(message.c_str()); }
+    
+    // printf en la pila: sin concatenar std::string (se puede llamar desde cualquier hilo)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void writef(const char* formato, ...) {
+        char linea[512];
+        va_list args;
+        va_start(args, formato);
+        std::vsnprintf(linea, sizeof(linea), formato, args);
+        va_end(args);
+        write(linea);
+    }
 };
 
 static Logger logger;
 
+// Textos y formateos que solo viven un frame; se reinicia tras cada EndDrawing
+static ArenaFrame arenaFrame(64 * 1024);
+
+// Compilando con -DDUOMAZE_CONTAR_ASIGNACIONES se cuentan las reservas con new de cada hilo
+// (--contar-asignaciones comprueba que el bucle principal estable no hace ninguna)
+namespace ContadorAsignaciones {
+    inline long& delHilo() {
+        static thread_local long cuenta = 0;
+        return cuenta;
+    }
+    
+    inline bool activo() {
+#ifdef DUOMAZE_CONTAR_ASIGNACIONES
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+#ifdef DUOMAZE_CONTAR_ASIGNACIONES
+void* operator new(size_t bytes) {
+    ContadorAsignaciones::delHilo()++;
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t bytes) { return operator new(bytes); }
+// Sin inline: con el free a la vista GCC avisa de un par malloc/free cruzado (-Wmismatched-new-delete)
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, size_t) noexcept { std::free(p); }
+#endif
+
+// Cola acotada sin locks (varios productores, un consumidor).
+// Cada celda lleva un número de secuencia que indica si está libre u ocupada,
+// así los productores reservan posición con un CAS y nunca se reserva memoria.
+template <typename T, size_t CAPACIDAD>
+class ColaSinLocks {
+    static_assert((CAPACIDAD & (CAPACIDAD - 1)) == 0, "CAPACIDAD debe ser potencia de 2");
+    
+    struct Celda {
+        std::atomic<size_t> secuencia;
+        T dato;
+    };
+    
+    std::array<Celda, CAPACIDAD> celdas;
+    alignas(64) std::atomic<size_t> posEscritura{0};
+    alignas(64) std::atomic<size_t> posLectura{0};
+    
+public:
+    ColaSinLocks() {
+        for (size_t i = 0; i < CAPACIDAD; i++) {
+            celdas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    // Seguro desde cualquier hilo. Devuelve false si la cola está llena.
+    bool push(const T& valor) {
+        size_t pos = posEscritura.load(std::memory_order_relaxed);
+        for (;;) {
+            Celda& celda = celdas[pos & (CAPACIDAD - 1)];
+            size_t seq = celda.secuencia.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (posEscritura.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    celda.dato = valor;
+                    celda.secuencia.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = posEscritura.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Solo desde el hilo consumidor
+    bool pop(T& salida) {
+        size_t pos = posLectura.load(std::memory_order_relaxed);
+        Celda& celda = celdas[pos & (CAPACIDAD - 1)];
+        size_t seq = celda.secuencia.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        salida = celda.dato;
+        celda.secuencia.store(pos + CAPACIDAD, std::memory_order_release);
+        posLectura.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Efectos de sonido disponibles
+enum SfxId : uint8_t { SFX_PUERTA = 0, SFX_NIVEL_COMPLETADO, SFX_CLICK, SFX_TOTAL };
+enum SfxPrioridad : uint8_t { PRIORIDAD_BAJA = 0, PRIORIDAD_NORMAL = 1, PRIORIDAD_ALTA = 2 };
+
+// Mezclador polifónico de SFX con pool fijo de voces.
+// Cada efecto tiene sus propias voces (alias del Sound original) creadas al cargar,
+// así dos puertas en el mismo tick suenan a la vez en vez de cortarse.
+// El volumen se aplica a cada voz, nunca al Sound compartido.
+class SfxMixer {
+public:
+    static constexpr int VOCES_POR_EFECTO = 8;
+    static constexpr int MAX_VOCES_ACTIVAS = 16;   // Límite global de voces sonando
+    
+private:
+    struct SolicitudSfx {
+        uint8_t efecto;
+        uint8_t prioridad;
+        float volumen;
+    };
+    
+    struct Voz {
+        Sound sonido{};
+        uint8_t prioridad = 0;
+        uint64_t orden = 0;     // Para robar la voz más antigua
+        bool activa = false;
+    };
+    
+    std::array<Sound, SFX_TOTAL> fuentes{};
+    std::array<std::array<Voz, VOCES_POR_EFECTO>, SFX_TOTAL> voces{};
+    ColaSinLocks<SolicitudSfx, 64> pendientes;
+    std::atomic<uint32_t> descartadas{0};
+    uint64_t contadorOrden = 0;
+    size_t bytesMuestras = 0;   // Anotado en MEM_AUDIO
+    
+    static Sound crearVoz(Sound fuente, const Wave& wave) {
+#if defined(RAYLIB_VERSION_MAJOR) && RAYLIB_VERSION_MAJOR >= 5
+        (void)wave;
+        return LoadSoundAlias(fuente);   // Comparte el buffer de muestras
+#else
+        (void)fuente;
+        return LoadSoundFromWave(wave);  // raylib 4.x no tiene alias: copia por voz
+#endif
+    }
+    
+    static void liberarVoz(Sound voz) {
+#if defined(RAYLIB_VERSION_MAJOR) && RAYLIB_VERSION_MAJOR >= 5
+        UnloadSoundAlias(voz);
+#else
+        UnloadSound(voz);
+#endif
+    }
+    
+    // Refresca qué voces siguen sonando y cuenta las activas
+    int actualizarActivas() {
+        int activas = 0;
+        for (auto& grupo : voces) {
+            for (auto& voz : grupo) {
+                if (voz.activa && !IsSoundPlaying(voz.sonido)) {
+                    voz.activa = false;
+                }
+                if (voz.activa) activas++;
+            }
+        }
+        return activas;
+    }
+    
+    // Voz activa de menor prioridad (y más antigua) en todo el mezclador
+    Voz* buscarVictimaGlobal() {
+        Voz* victima = nullptr;
+        for (auto& grupo : voces) {
+            for (auto& voz : grupo) {
+                if (!voz.activa) continue;
+                if (!victima || voz.prioridad < victima->prioridad ||
+                    (voz.prioridad == victima->prioridad && voz.orden < victima->orden)) {
+                    victima = &voz;
+                }
+            }
+        }
+        return victima;
+    }
+    
+    void reproducir(const SolicitudSfx& s, float volumenMaestro, int& activas) {
+        if (s.efecto >= SFX_TOTAL || fuentes[s.efecto].frameCount == 0) return;
+        
+        auto& grupo = voces[s.efecto];
+        Voz* destino = nullptr;
+        Voz* masVieja = nullptr;
+        for (auto& voz : grupo) {
+            if (voz.sonido.frameCount == 0) continue;
+            if (!voz.activa) { destino = &voz; break; }
+            if (!masVieja || voz.prioridad < masVieja->prioridad ||
+                (voz.prioridad == masVieja->prioridad && voz.orden < masVieja->orden)) {
+                masVieja = &voz;
+            }
+        }
+        
+        // Sin voz libre en este efecto: robar la más débil si no supera la prioridad pedida
+        if (!destino) {
+            if (!masVieja || masVieja->prioridad > s.prioridad) {
+                descartadas++;
+                return;
+            }
+            StopSound(masVieja->sonido);
+            masVieja->activa = false;
+            activas--;
+            destino = masVieja;
+        }
+        
+        // Límite global de polifonía
+        if (activas >= MAX_VOCES_ACTIVAS) {
+            Voz* victima = buscarVictimaGlobal();
+            if (!victima || victima->prioridad > s.prioridad) {
+                descartadas++;
+                return;
+            }
+            StopSound(victima->sonido);
+            victima->activa = false;
+            activas--;
+        }
+        
+        SetSoundVolume(destino->sonido, volumenMaestro * s.volumen);
+        PlaySound(destino->sonido);
+        destino->prioridad = s.prioridad;
+        destino->orden = ++contadorOrden;
+        destino->activa = true;
+        activas++;
+    }
+    
+public:
+    bool cargar(SfxId id, const char* fileName) {
+        Wave wave = LoadWave(fileName);
+        if (wave.frameCount == 0) {
+            return false;
+        }
+        fuentes[id] = LoadSoundFromWave(wave);
+        size_t bytes = ContabilidadMemoria::bytesSonido(fuentes[id]);
+        for (auto& voz : voces[id]) {
+            voz.sonido = crearVoz(fuentes[id], wave);
+#if !defined(RAYLIB_VERSION_MAJOR) || RAYLIB_VERSION_MAJOR < 5
+            bytes += ContabilidadMemoria::bytesSonido(voz.sonido);
+#endif
+        }
+        UnloadWave(wave);
+        ContabilidadMemoria::reservaCPU(MEM_AUDIO, bytes);
+        bytesMuestras += bytes;
+        return fuentes[id].frameCount > 0;
+    }
+    
+    // Seguro desde cualquier hilo, sin locks ni reservas de memoria
+    void solicitar(SfxId id, float volumen, SfxPrioridad prioridad = PRIORIDAD_NORMAL) {
+        if (!pendientes.push(SolicitudSfx{static_cast<uint8_t>(id), static_cast<uint8_t>(prioridad), volumen})) {
+            descartadas++;
+        }
+    }
+    
+    // Llamado desde el hilo de audio: vacía la cola y lanza las voces
+    void procesar(float volumenMaestro) {
+        int activas = actualizarActivas();
+        SolicitudSfx s;
+        while (pendientes.pop(s)) {
+            reproducir(s, volumenMaestro, activas);
+        }
+    }
+    
+    uint32_t getDescartadas() const { return descartadas.load(); }
+    
+    void descargar() {
+        for (int id = 0; id < SFX_TOTAL; id++) {
+            for (auto& voz : voces[id]) {
+                if (voz.sonido.frameCount > 0) {
+                    StopSound(voz.sonido);
+                    liberarVoz(voz.sonido);
+                }
+                voz = Voz{};
+            }
+            if (fuentes[id].frameCount > 0) {
+                UnloadSound(fuentes[id]);
+            }
+            fuentes[id] = Sound{};
+        }
+        ContabilidadMemoria::liberaCPU(MEM_AUDIO, bytesMuestras);
+        bytesMuestras = 0;
+    }
+};
+
 // Sistema de audio optimizado CON HILO DEDICADO
 // SISTEMA DE AUDIO MEJORADO CON MÚSICAS DIFERENTES POR PANTALLA
 class AudioSystem {
 private:
-    Music menuMusic;
-    Music gameplayMusic;
-    Sound sfxOpenDoor;
-    Sound sfxLevelComplete;
-    Sound sfxClick;
+    Music menuMusic{};
+    Music gameplayMusic{};
+    SfxMixer sfxMixer;
     std::atomic<bool> audioRunning{true};
     std::atomic<bool> musicPaused{false};
     std::atomic<float> volume{0.7f};
     std::atomic<bool> isMenuMusic{true};  // true = menú, false = gameplay
+    std::atomic<int> crossfadeMs{GameConstants::MUSIC_CROSSFADE_MS};
     std::thread musicThread;
+    size_t bytesMusicas = 0;    // Buffers de los dos streams, anotados en MEM_AUDIO
+    
+    // Deja el stream en el inicio con sus buffers ya decodificados y en pausa,
+    // para que reanudarlo no tenga que decodificar nada en el momento del cambio
+    static void cebarMusica(Music& music) {
+        StopMusicStream(music);
+        SetMusicVolume(music, 0.0f);
+        PlayMusicStream(music);
+        UpdateMusicStream(music);
+        PauseMusicStream(music);
+    }
     
-    void playSFX(Sound sound, float volumeMultiplier = 1.0f) {
-        if (sound.frameCount > 0) {
-            SetSoundVolume(sound, volume.load() * volumeMultiplier);
-            PlaySound(sound);
+    void cargarSFX(SfxId id, const char* fileName, const char* nombre) {
+        if (!sfxMixer.cargar(id, fileName)) {
+            logger.write("⚠️  Advertencia: No se pudo cargar " + std::string(nombre));
+        } else {
+            logger.write("✅ SFX cargado: " + std::string(nombre));
         }
     }
     
@@ -122,10 +488,14 @@ public:
             InitAudioDevice();
         }
         
+        // Buffers de música más grandes: el hilo de audio decodifica por adelantado
+        SetAudioStreamBufferSizeDefault(GameConstants::MUSIC_BUFFER_FRAMES);
+        
         // Cargar música del menú (NUEVA)
         menuMusic = LoadMusicStream("resources/sound/music/Maze_Quest_Echoes.ogg");
         if (menuMusic.frameCount == 0) {
             logger.write("❌ Error: No se pudo cargar Maze_Quest_Echoes.ogg (música de menú)");
+            SetAudioStreamBufferSizeDefault(0);
             return false;
         }
         
@@ -134,30 +504,22 @@ public:
         if (gameplayMusic.frameCount == 0) {
             logger.write("❌ Error: No se pudo cargar Maze_Quest.ogg (música de gameplay)");
             UnloadMusicStream(menuMusic);
+            SetAudioStreamBufferSizeDefault(0);
             return false;
         }
+        SetAudioStreamBufferSizeDefault(0);  // Los SFX usan el tamaño por defecto
+        bytesMusicas = ContabilidadMemoria::bytesMusica(menuMusic, GameConstants::MUSIC_BUFFER_FRAMES) +
+                       ContabilidadMemoria::bytesMusica(gameplayMusic, GameConstants::MUSIC_BUFFER_FRAMES);
+        ContabilidadMemoria::reservaCPU(MEM_AUDIO, bytesMusicas);
         
-        //Cargar efectos de sonido
-        sfxOpenDoor = LoadSound("resources/sound/sfx/abrir_puerta.wav");
-        if (sfxOpenDoor.frameCount == 0) {
-            logger.write("⚠️  Advertencia: No se pudo cargar abrir_puerta.wav");
-        } else {
-            logger.write("✅ SFX cargado: abrir_puerta.wav");
-        }
-        
-        sfxLevelComplete = LoadSound("resources/sound/sfx/zelda_headlift.wav");
-        if (sfxLevelComplete.frameCount == 0) {
-            logger.write("⚠️  Advertencia: No se pudo cargar zelda_headlift.wav");
-        } else {
-            logger.write("✅ SFX cargado: zelda_headlift.wav");
-        }
+        // El bucle lo hace el decodificador al rellenar el buffer: sin huecos
+        menuMusic.looping = true;
+        gameplayMusic.looping = true;
         
-        sfxClick = LoadSound("resources/sound/sfx/clic.wav");
-        if (sfxClick.frameCount == 0) {
-            logger.write("⚠️  Advertencia: No se pudo cargar clic.wav");
-        } else {
-            logger.write("✅ SFX cargado: clic.wav");
-        }
+        //Cargar efectos de sonido (con su pool de voces)
+        cargarSFX(SFX_PUERTA, "resources/sound/sfx/abrir_puerta.wav", "abrir_puerta.wav");
+        cargarSFX(SFX_NIVEL_COMPLETADO, "resources/sound/sfx/zelda_headlift.wav", "zelda_headlift.wav");
+        cargarSFX(SFX_CLICK, "resources/sound/sfx/clic.wav", "clic.wav");
         
         logger.write("✅ Audio cargado correctamente");
         
@@ -173,58 +535,100 @@ public:
     }
     
     // NUEVO: Métodos públicos para reproducir SFX
+    // Se pueden llamar desde cualquier hilo: solo encolan la petición
     void playDoorOpen() {
-        playSFX(sfxOpenDoor, 0.8f); // Un poco más bajo que la música
+        sfxMixer.solicitar(SFX_PUERTA, 0.8f); // Un poco más bajo que la música
     }
     
     void playLevelComplete() {
-        playSFX(sfxLevelComplete, 1.0f);
+        sfxMixer.solicitar(SFX_NIVEL_COMPLETADO, 1.0f, PRIORIDAD_ALTA);
     }
     
     void playClick() {
-        playSFX(sfxClick, 0.6f); // Click más suave
+        sfxMixer.solicitar(SFX_CLICK, 0.6f, PRIORIDAD_BAJA); // Click más suave
     }
     
     void musicThreadFunction() {
         logger.write("🎵 MusicThread started - Reproduciendo música de menú");
         
-        Music* currentMusic = &menuMusic;  // Empezar con música del menú
-        SetMusicVolume(*currentMusic, volume.load());
-        PlayMusicStream(*currentMusic);
+        // Ambas músicas quedan cebadas; la activa suena y la otra espera en pausa
+        Music* musicas[2] = { &menuMusic, &gameplayMusic };
+        cebarMusica(menuMusic);
+        cebarMusica(gameplayMusic);
+        
+        int activa = isMenuMusic.load() ? 0 : 1;
+        int saliente = -1;          // Música que se está desvaneciendo (-1 = ninguna)
+        float progreso = 1.0f;      // 0 = inicio del crossfade, 1 = terminado
+        bool pausada = false;
+        auto ultimoTick = std::chrono::steady_clock::now();
+        
+        SetMusicVolume(*musicas[activa], volume.load());
+        ResumeMusicStream(*musicas[activa]);
         
         while (audioRunning.load()) {
-            if (!musicPaused.load()) {
-                UpdateMusicStream(*currentMusic);
-                
-                // Cambiar música si es necesario
-                if (isMenuMusic.load()) {
-                    if (currentMusic != &menuMusic) {
-                        logger.write("🎵 Cambiando a música de menú");
-                        StopMusicStream(*currentMusic);
-                        currentMusic = &menuMusic;
-                        PlayMusicStream(*currentMusic);
-                        SetMusicVolume(*currentMusic, volume.load());
-                    }
-                } else {
-                    if (currentMusic != &gameplayMusic) {
-                        logger.write("🎵 Cambiando a música de gameplay");
-                        StopMusicStream(*currentMusic);
-                        currentMusic = &gameplayMusic;
-                        PlayMusicStream(*currentMusic);
-                        SetMusicVolume(*currentMusic, volume.load());
+            auto ahora = std::chrono::steady_clock::now();
+            float dt = std::chrono::duration<float>(ahora - ultimoTick).count();
+            ultimoTick = ahora;
+            
+            // Pausa/reanudación aplicada siempre desde este hilo
+            if (musicPaused.load() != pausada) {
+                pausada = musicPaused.load();
+                for (int i : {activa, saliente}) {
+                    if (i < 0) continue;
+                    if (pausada) PauseMusicStream(*musicas[i]);
+                    else ResumeMusicStream(*musicas[i]);
+                }
+            }
+            
+            if (!pausada) {
+                // Cambiar música si es necesario (crossfade)
+                int objetivo = isMenuMusic.load() ? 0 : 1;
+                if (objetivo != activa) {
+                    logger.write(objetivo == 0 ? "🎵 Crossfade a música de menú"
+                                               : "🎵 Crossfade a música de gameplay");
+                    if (objetivo == saliente) {
+                        // Vuelta atrás a mitad de crossfade: invertir sin saltos de volumen
+                        progreso = 1.0f - progreso;
+                    } else {
+                        if (saliente >= 0) cebarMusica(*musicas[saliente]);
+                        progreso = 0.0f;
+                        ResumeMusicStream(*musicas[objetivo]);
                     }
+                    saliente = activa;
+                    activa = objetivo;
                 }
                 
-                // Reiniciar música si llegó al final
-                if (GetMusicTimePlayed(*currentMusic) >= GetMusicTimeLength(*currentMusic)) {
-                    StopMusicStream(*currentMusic);
-                    PlayMusicStream(*currentMusic);
+                if (saliente >= 0) {
+                    float duracion = std::max(crossfadeMs.load(), 1) / 1000.0f;
+                    progreso = std::min(1.0f, progreso + dt / duracion);
+                }
+                
+                // Curva de igual potencia para que el volumen percibido no caiga a la mitad
+                float vol = volume.load();
+                float ganancia = sinf(progreso * PI / 2.0f);
+                SetMusicVolume(*musicas[activa], vol * ganancia);
+                UpdateMusicStream(*musicas[activa]);
+                
+                if (saliente >= 0) {
+                    SetMusicVolume(*musicas[saliente], vol * cosf(progreso * PI / 2.0f));
+                    UpdateMusicStream(*musicas[saliente]);
+                    
+                    if (progreso >= 1.0f) {
+                        // Rebobinar y dejar lista la saliente para el próximo cambio
+                        cebarMusica(*musicas[saliente]);
+                        saliente = -1;
+                    }
                 }
             }
+            
+            // Los SFX suenan aunque la música esté en pausa
+            sfxMixer.procesar(volume.load());
+            
             std::this_thread::sleep_for(std::chrono::milliseconds(GameConstants::AUDIO_UPDATE_RATE));
         }
         
-        StopMusicStream(*currentMusic);
+        StopMusicStream(menuMusic);
+        StopMusicStream(gameplayMusic);
         logger.write("🎵 MusicThread finished");
     }
     
@@ -236,27 +640,17 @@ public:
         isMenuMusic = false;
     }
     
+    void setDuracionCrossfade(int milisegundos) {
+        crossfadeMs = std::max(0, milisegundos);
+    }
+    
     void togglePausa() {
         musicPaused = !musicPaused;
-        if (isMenuMusic) {
-            if (musicPaused) {
-                PauseMusicStream(menuMusic);
-            } else {
-                ResumeMusicStream(menuMusic);
-            }
-        } else {
-            if (musicPaused) {
-                PauseMusicStream(gameplayMusic);
-            } else {
-                ResumeMusicStream(gameplayMusic);
-            }
-        }
     }
     
+    // El hilo de audio aplica el volumen en su siguiente tick
     void setVolume(float newVolume) {
         volume.store(newVolume);
-        SetMusicVolume(menuMusic, newVolume);
-        SetMusicVolume(gameplayMusic, newVolume);
     }
     
     float getVolume() const { return volume.load(); }
@@ -274,17 +668,13 @@ public:
         if (gameplayMusic.frameCount > 0) {
             UnloadMusicStream(gameplayMusic);
         }
+        menuMusic = Music{};
+        gameplayMusic = Music{};
+        ContabilidadMemoria::liberaCPU(MEM_AUDIO, bytesMusicas);
+        bytesMusicas = 0;
         
-        // NUEVO: Liberar efectos de sonido
-        if (sfxOpenDoor.frameCount > 0) {
-            UnloadSound(sfxOpenDoor);
-        }
-        if (sfxLevelComplete.frameCount > 0) {
-            UnloadSound(sfxLevelComplete);
-        }
-        if (sfxClick.frameCount > 0) {
-            UnloadSound(sfxClick);
-        }
+        // NUEVO: Liberar efectos de sonido y sus voces
+        sfxMixer.descargar();
         if (IsAudioDeviceReady()) {
             CloseAudioDevice();
         }
@@ -313,9 +703,10 @@ private:
     static constexpr int MAX_PARTICLES = 150;
 
 protected:
-    std::vector<ConfettiParticle> particles;
-    std::vector<ConfettiParticle>& getParticles() { return particles; }
-    const std::vector<ConfettiParticle>& getParticles() const { return particles; }
+    using ListaParticulas = std::vector<ConfettiParticle, AsignadorEtiquetado<ConfettiParticle, MEM_PARTICULAS>>;
+    ListaParticulas particles;
+    ListaParticulas& getParticles() { return particles; }
+    const ListaParticulas& getParticles() const { return particles; }
     bool isActive = false;
     double startTime = 0.0;
     
@@ -367,25 +758,27 @@ public:
             // hasta que su lifetime termine.
         }
 
-        for (auto it = particles.begin(); it != particles.end(); ) {
-            it->lifetime -= dt;
+        // Compactación en el sitio: borrar con erase una a una es cuadrático con miles de partículas
+        size_t vivas = 0;
+        for (size_t i = 0; i < particles.size(); i++) {
+            ConfettiParticle& p = particles[i];
+            p.lifetime -= dt;
+            if (p.lifetime <= 0) continue;
 
-            if (it->lifetime <= 0) {
-                it = particles.erase(it);
-            } else {
-                // Aplicar gravedad (simulación simple)
-                it->velocity.y += 9.8f * 0.008f; 
-                
-                // Actualizar posición
-                it->position.x += it->velocity.x;
-                it->position.y += it->velocity.y;
-                
-                // Actualizar rotación
-                it->rotation += it->angularVelocity * dt;
-                
-                ++it;
-            }
+            // Aplicar gravedad (simulación simple)
+            p.velocity.y += 9.8f * 0.008f; 
+            
+            // Actualizar posición
+            p.position.x += p.velocity.x;
+            p.position.y += p.velocity.y;
+            
+            // Actualizar rotación
+            p.rotation += p.angularVelocity * dt;
+            
+            if (vivas != i) particles[vivas] = p;
+            vivas++;
         }
+        particles.resize(vivas);
         
         if (particles.empty() && GetTime() - startTime > DURATION) {
             isActive = false;
@@ -419,9 +812,62 @@ public:
 
 class EnhancedConfettiSystem : public ConfettiSystem {
 private:
+    friend class BenchParticulas;
+
     Vector2 windForce = {0, 0};
     bool useWind = false;
     float opacity = 1.0f;
+
+    // Lote instanciado: halos y cuerpos en una sola llamada de dibujo
+    LoteSprites lote;
+    bool usarLote = true;
+    bool loteFallido = false;
+    bool conHalo = true;        // Sin halo cuando el brillo lo pone el bloom (bloom.h)
+
+    static Color conAlfa(Color c, float alfa) {
+        alfa = std::clamp(alfa, 0.0f, 1.0f);
+        c.a = static_cast<unsigned char>(255.0f * alfa);
+        return c;
+    }
+
+    bool prepararLote() {
+        if (!usarLote || loteFallido) return false;
+        if (lote.listo()) return true;
+        if (!lote.cargar()) {
+            loteFallido = true;
+            logger.write("⚠️ Shader del lote de partículas no disponible, se usa el dibujo clásico");
+            return false;
+        }
+        return true;
+    }
+
+    // Mismas formas que el camino clásico: halo de radio 1.5 * size y rectángulo size x size/2.
+    // Todos los halos van delante de todos los cuerpos, igual que las dos pasadas clásicas.
+    void rellenarLote() {
+        const auto& ps = getParticles();
+        const size_t n = ps.size();
+        const size_t numHalos = conHalo ? n : 0, numCuerpos = isActive ? n : 0;
+        lote.limpiar();
+        InstanciaSprite* halos = lote.ampliar(numHalos + numCuerpos);     // Una sola vez: ampliar puede mover el lote
+        InstanciaSprite* cuerpos = halos + numHalos;
+        for (size_t i = 0; i < n; i++) {
+            const ConfettiParticle& p = ps[i];
+            if (numHalos) {
+                float diametro = p.size * 3.0f;
+                halos[i] = {p.position.x, p.position.y, diametro, diametro, 0.0f, 0.3f, p.color};
+            }
+            if (numCuerpos) {
+                float lifeRatio = p.lifetime / p.totalLifetime;
+                cuerpos[i] = {p.position.x, p.position.y, p.size, p.size / 2.0f, p.rotation * DEG2RAD, 0.0f,
+                              conAlfa(p.color, lifeRatio)};
+            }
+        }
+    }
+
+    void drawLote() {
+        rellenarLote();
+        lote.dibujar();
+    }
     
 public:
     void setOpacity(float value) { opacity = value; }
@@ -451,9 +897,21 @@ public:
         }
     }
     
+    // false fuerza el dibujo clásico (una llamada por halo y por partícula)
+    void setInstanciado(bool activo) { usarLote = activo; }
+    bool isInstanciado() { return prepararLote(); }
+    size_t getNumParticles() const { return getParticles().size(); }
+
     void drawWithGlow() {
+        if (getParticles().empty()) return;
+        if (prepararLote()) {
+            drawLote();
+            return;
+        }
+
         // Primera pasada: sombra/difuminado
         for (const auto& p : getParticles()) {
+            if (!conHalo) break;
             float glowSize = p.size * 1.5f;
             Color glowColor = Fade(p.color, 0.3f);
             DrawCircleV(p.position, glowSize, glowColor);
@@ -462,22 +920,39 @@ public:
         // Segunda pasada: partícula principal
         ConfettiSystem::draw();
     }
+
+    void setHalo(bool activo) { conHalo = activo; }
+    
+    // Los cuerpos otra vez, para la capa de emisivos del bloom. Sin halo el lote ya tiene
+    // solo los cuerpos de este frame y no hace falta volver a subirlos.
+    void drawEmisivo() {
+        if (!isActive || getParticles().empty()) return;
+        if (!conHalo && prepararLote()) {
+            lote.redibujar();
+        } else {
+            ConfettiSystem::draw();
+        }
+    }
+
+    void descargar() {
+        lote.descargar();
+        particles.clear();
+        particles.shrink_to_fit();
+    }
 };
 
 // Estado del juego optimizado - CON SISTEMA DE NIVELES
 struct GameState {
     mutable std::mutex mtx;
     
-    using MapArray = std::array<std::array<int, GameConstants::MAP_WIDTH>, GameConstants::MAP_HEIGHT>;
+    using MapArray = MapaNivel;
     MapArray laberinto;
     
     Vector2 masterPos;
     Vector2 slavePos;
     
     // Estados atómicos
-    std::atomic<bool> button1Active{false};
-    std::atomic<bool> button2Active{false};
-    std::atomic<bool> button3Active{false};
+    std::atomic<Canales> canales{0};        // Canales de disparadores activos (bit i = canal i)
     
     std::atomic<bool> masterInGoal{false};
     std::atomic<bool> slaveInGoal{false};
@@ -493,42 +968,268 @@ struct GameState {
     std::atomic<double> startTime{0.0};
     std::atomic<double> totalGameTime{0.0};
     std::atomic<bool> gameStarted{false};
+    
+    // Las pistas solo razonan con los tres botones básicos
+    uint8_t botonesBasicos() const {
+        return static_cast<uint8_t>(canales.load() & (BIT_BOTON_1 | BIT_BOTON_2 | BIT_BOTON_3));
+    }
+};
+
+// Archivo mapeado en memoria de solo lectura
+class ArchivoMapeado {
+private:
+    const unsigned char* datos = nullptr;
+    size_t tamano = 0;
+#ifdef _WIN32
+    HANDLE archivo = INVALID_HANDLE_VALUE;
+    HANDLE mapeo = nullptr;
+#endif
+    
+public:
+    ~ArchivoMapeado() { cerrar(); }
+    
+    bool abrir(const char* ruta) {
+        cerrar();
+#ifdef _WIN32
+        archivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (archivo == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER tam;
+        if (!GetFileSizeEx(archivo, &tam) || tam.QuadPart == 0) { cerrar(); return false; }
+        mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapeo == nullptr) { cerrar(); return false; }
+        datos = static_cast<const unsigned char*>(MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0));
+        if (datos == nullptr) { cerrar(); return false; }
+        tamano = static_cast<size_t>(tam.QuadPart);
+#else
+        int fd = open(ruta, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        datos = static_cast<const unsigned char*>(p);
+        tamano = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+    
+    void cerrar() {
+#ifdef _WIN32
+        if (datos) UnmapViewOfFile(datos);
+        if (mapeo) CloseHandle(mapeo);
+        if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+        mapeo = nullptr;
+        archivo = INVALID_HANDLE_VALUE;
+#else
+        if (datos) munmap(const_cast<unsigned char*>(datos), tamano);
+#endif
+        datos = nullptr;
+        tamano = 0;
+    }
+    
+    const unsigned char* getDatos() const { return datos; }
+    size_t getTamano() const { return tamano; }
 };
 
+// Medición de tiempos de arranque
+using RelojArranque = std::chrono::steady_clock;
+
+inline double msDesde(RelojArranque::time_point inicio) {
+    return std::chrono::duration<double, std::milli>(RelojArranque::now() - inicio).count();
+}
+
+// Tiempo de CPU de todo el proceso (todos los hilos) en ms, para medir consumo en reposo
+inline double msCPUProceso() {
+#ifdef _WIN32
+    FILETIME creacion, salida, nucleo, usuario;
+    if (!GetProcessTimes(GetCurrentProcess(), &creacion, &salida, &nucleo, &usuario)) return 0.0;
+    auto a100ns = [](const FILETIME& f) { return (static_cast<uint64_t>(f.dwHighDateTime) << 32) | f.dwLowDateTime; };
+    return (a100ns(nucleo) + a100ns(usuario)) / 10000.0;
+#else
+    return 1000.0 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
 // Gestor de texturas optimizado
 class TextureManager {
 private:
+    // Trabajo de carga: la parte de CPU (decodificar PNG, reescalar, rasterizar
+    // la fuente) se hace en hilos de trabajo; la subida a GPU queda en el hilo principal
+    struct TrabajoCarga {
+        std::string clave;
+        std::string ruta;
+        int ancho = 0;              // 0 = sin reescalar
+        int alto = 0;
+        int fuente = -1;            // >= 0 = es la fuente SDF con ese FuenteId
+        
+        // Resultado producido por el hilo de trabajo
+        Image imagen{};
+        GlyphInfo* glifos = nullptr;
+        Rectangle* recs = nullptr;
+        double msCPU = 0.0;
+        bool subido = false;
+    };
+    
     std::unordered_map<std::string, Texture2D> textures;
-    std::unordered_map<std::string, Font> fonts;
+    std::unordered_map<std::string, size_t> bytesTexturas;     // Bytes en GPU de cada entrada de textures
+    std::array<Texture2D, NUM_TEXTURAS_TILE> texturasTile{};   // Copia indexada por TexturaTile para drawLaberinto
+    std::array<Font, FUENTE_TOTAL> fonts{};
+    std::array<bool, FUENTE_TOTAL> fontsSDF{};     // false = fallback a la fuente por defecto
+    std::array<size_t, FUENTE_TOTAL> bytesFuentesGPU{};
+    std::array<size_t, FUENTE_TOTAL> bytesFuentesCPU{};
+    Shader shaderSDF{};
+    int locColorContorno = -1;
+    int locAnchoContorno = -1;
     bool texturesLoaded = false;
     
-public:
-    Font loadFont(const char* fileName, int fontSize = 32, int fontCharsCount = 250) {
-        std::string key = std::string(fileName) + "_" + std::to_string(fontSize);
-        
-        auto it = fonts.find(key);
-        if (it != fonts.end()) {
-            return it->second;
+    // Estado de la carga en paralelo
+    std::vector<TrabajoCarga> trabajos;
+    std::vector<std::thread> trabajadores;
+    std::atomic<size_t> siguienteTrabajo{0};
+    std::mutex terminadosMutex;
+    std::vector<size_t> terminados;
+    size_t subidos = 0;
+    double msSubidaGPU = 0.0;
+    RelojArranque::time_point inicioCarga;
+    
+    void agregarTextura(const char* clave, const char* ruta, int ancho, int alto) {
+        TrabajoCarga t;
+        t.clave = clave;
+        t.ruta = ruta;
+        t.ancho = ancho;
+        t.alto = alto;
+        trabajos.push_back(std::move(t));
+    }
+    
+    void agregarSprite(const char* clave, const char* ruta) {
+        agregarTextura(clave, ruta, GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
+    }
+    
+    void agregarFuente(FuenteId id) {
+        TrabajoCarga t;
+        t.clave = RUTAS_FUENTES[id];
+        t.ruta = RUTAS_FUENTES[id];
+        t.fuente = id;
+        trabajos.push_back(std::move(t));
+    }
+    
+    void cargarShaderSDF() {
+        if (shaderSDF.id != 0) return;
+        shaderSDF = LoadShaderFromMemory(nullptr, FuentesSDF::SHADER_FS);
+        locColorContorno = GetShaderLocation(shaderSDF, "colorContorno");
+        locAnchoContorno = GetShaderLocation(shaderSDF, "anchoContorno");
+    }
+    
+    // Todas las entradas de textures pasan por aquí para que cuenten en MEM_TEXTURAS
+    void guardarTextura(const std::string& clave, Texture2D textura) {
+        size_t bytes = ContabilidadMemoria::bytesTextura(textura);
+        ContabilidadMemoria::reservaGPU(MEM_TEXTURAS, bytes);
+        textures[clave] = textura;
+        bytesTexturas[clave] = bytes;
+    }
+    
+    // Tablas de glifos y, si la fuente se generó aquí y no viene del paquete, sus imágenes SDF
+    static size_t bytesFuenteCPU(const Font& font) {
+        size_t bytes = static_cast<size_t>(font.glyphCount) * (sizeof(Rectangle) + sizeof(GlyphInfo));
+        for (int g = 0; font.glyphs != nullptr && g < font.glyphCount; g++) {
+            const Image& imagen = font.glyphs[g].image;
+            if (imagen.data != nullptr) bytes += GetPixelDataSize(imagen.width, imagen.height, imagen.format);
         }
-        
-        Font font = LoadFontEx(fileName, fontSize, 0, fontCharsCount);
+        return bytes;
+    }
+    
+    void registrarFuente(int id, Font font, const std::string& ruta) {
         if (font.texture.id == 0) {
-            logger.write("❌ Error: No se pudo cargar la fuente: " + std::string(fileName));
-            // Fallback a fuente por defecto
-            font = GetFontDefault();
+            logger.write("❌ Error: No se pudo cargar la fuente: " + ruta);
+            fonts[id] = GetFontDefault();
+            fontsSDF[id] = false;
+        } else {
+            logger.write("✅ Fuente SDF cargada: " + ruta);
+            fonts[id] = font;
+            fontsSDF[id] = true;
+            bytesFuentesGPU[id] = ContabilidadMemoria::bytesTextura(font.texture);
+            bytesFuentesCPU[id] = bytesFuenteCPU(font);
+            ContabilidadMemoria::reservaGPU(MEM_FUENTES, bytesFuentesGPU[id]);
+            ContabilidadMemoria::reservaCPU(MEM_FUENTES, bytesFuentesCPU[id]);
+        }
+    }
+    
+    // Solo CPU: se ejecuta en los hilos de trabajo
+    static void ejecutarTrabajo(TrabajoCarga& t) {
+        auto inicio = RelojArranque::now();
+        
+        if (t.fuente >= 0) {
+            int tamArchivo = 0;
+            unsigned char* datos = LoadFileData(t.ruta.c_str(), &tamArchivo);
+            if (datos != nullptr) {
+                t.imagen = FuentesSDF::generarAtlas(datos, tamArchivo, &t.glifos, &t.recs);
+                UnloadFileData(datos);
+            }
         } else {
-            logger.write("✅ Fuente cargada: " + std::string(fileName));
+            t.imagen = LoadImage(t.ruta.c_str());
+            if (t.imagen.data != nullptr && t.ancho > 0) {
+                ImageResize(&t.imagen, t.ancho, t.alto);
+            }
         }
         
-        fonts[key] = font;
-        return font;
+        t.msCPU = msDesde(inicio);
+    }
+    
+    void bucleTrabajador() {
+        for (;;) {
+            size_t i = siguienteTrabajo.fetch_add(1);
+            if (i >= trabajos.size()) return;
+            ejecutarTrabajo(trabajos[i]);
+            std::lock_guard<std::mutex> lock(terminadosMutex);
+            terminados.push_back(i);
+        }
     }
     
-    Font getFont(const std::string& name, int fontSize = 32) const {
-        std::string key = name + "_" + std::to_string(fontSize);
-        auto it = fonts.find(key);
-        return (it != fonts.end()) ? it->second : GetFontDefault();
+    // Solo GPU: hilo principal (el contexto OpenGL es de este hilo)
+    void subirTrabajo(TrabajoCarga& t) {
+        if (t.fuente >= 0) {
+            Font font{};
+            if (t.imagen.data != nullptr) {
+                font = FuentesSDF::construirFuente(t.imagen, t.glifos, t.recs);
+                UnloadImage(t.imagen);
+            }
+            if (font.texture.id == 0) {
+                if (t.glifos != nullptr) UnloadFontData(t.glifos, FuentesSDF::CARACTERES);
+                if (t.recs != nullptr) MemFree(t.recs);
+            }
+            registrarFuente(t.fuente, font, t.ruta);
+        } else if (t.imagen.data == nullptr) {
+            if (t.ancho > 0) {
+                logger.write("❌ Error: No se pudo cargar la textura: " + t.ruta);
+                Image fallback = GenImageColor(t.ancho, t.alto, MAGENTA);
+                guardarTextura(t.clave, LoadTextureFromImage(fallback));
+                UnloadImage(fallback);
+            } else {
+                logger.write("❌ Error: No se pudo cargar " + t.ruta);
+                guardarTextura(t.clave, Texture2D{});
+            }
+        } else {
+            guardarTextura(t.clave, LoadTextureFromImage(t.imagen));
+            UnloadImage(t.imagen);
+            logger.write("✅ Textura cargada: " + t.ruta);
+        }
+        t.imagen = Image{};
+        t.subido = true;
+    }
+    
+public:
+    // Una sola fuente SDF por archivo: sirve para cualquier tamaño
+    Font getFont(FuenteId id) const {
+        return fonts[id].texture.id != 0 ? fonts[id] : GetFontDefault();
     }
+    
+    bool isFontSDF(FuenteId id) const { return fontsSDF[id] && shaderSDF.id != 0; }
+    
+    const Shader& getShaderSDF() const { return shaderSDF; }
+    int getLocColorContorno() const { return locColorContorno; }
+    int getLocAnchoContorno() const { return locAnchoContorno; }
 
     Texture2D loadAndRescaleTexture(const char* fileName, int targetWidth, int targetHeight) {
         std::string key = fileName;
@@ -546,7 +1247,7 @@ public:
             Texture2D texture = LoadTextureFromImage(fallback);
             UnloadImage(fallback);
             
-            textures[key] = texture;
+            guardarTextura(key, texture);
             return texture;
         }
         
@@ -554,7 +1255,7 @@ public:
         Texture2D texture = LoadTextureFromImage(image);
         UnloadImage(image);
         
-        textures[key] = texture;
+        guardarTextura(key, texture);
         logger.write("✅ Textura cargada: " + std::string(fileName));
         
         return texture;
@@ -565,193 +1266,375 @@ public:
         return (it != textures.end()) ? it->second : Texture2D{};
     }
     
-    bool loadAllTextures() {
-        if (texturesLoaded) return true;
-        
-        logger.write("📥 Cargando y reescalando texturas...");
-        
-        textures["menu_background"] = LoadTexture("resources/backgrounds/menu_bg.png");
-        if (textures["menu_background"].id == 0) {
-            logger.write("❌ Error: No se pudo cargar el fondo del menú");
-        } else {
-            logger.write("✅ Fondo del menú cargado");
-        }
-        
-        textures["piso"] = loadAndRescaleTexture("resources/sprites/piso.png", 
-                                               GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["pared"] = loadAndRescaleTexture("resources/sprites/pared.png", 
-                                                GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["master"] = loadAndRescaleTexture("resources/sprites/master.png", 
-                                                 GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["slave"] = loadAndRescaleTexture("resources/sprites/slave.png", 
-                                                GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["boton1"] = loadAndRescaleTexture("resources/sprites/boton1.png", 
-                                                 GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["boton2"] = loadAndRescaleTexture("resources/sprites/boton2.png", 
-                                                 GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["boton3"] = loadAndRescaleTexture("resources/sprites/boton3.png", 
-                                                 GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta1Cerrada"] = loadAndRescaleTexture("resources/sprites/puerta_roja_cerrada.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta2Cerrada"] = loadAndRescaleTexture("resources/sprites/puerta_azul_cerrada.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta1Abierta"] = loadAndRescaleTexture("resources/sprites/puerta_roja_abierta.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta2Abierta"] = loadAndRescaleTexture("resources/sprites/puerta_azul_abierta.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta3Cerrada"] = loadAndRescaleTexture("resources/sprites/puerta_morada_cerrada.png",
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["puerta3Abierta"] = loadAndRescaleTexture("resources/sprites/puerta_morada_abierta.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["ObstaculoRojo"] = loadAndRescaleTexture("resources/sprites/obstaculo_rojo.png",
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["ObstaculoAzul"] = loadAndRescaleTexture("resources/sprites/obstaculo_azul.png", 
-                                                         GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        textures["meta"] = loadAndRescaleTexture("resources/sprites/meta.png", 
-                                               GameConstants::TILE_SIZE, GameConstants::TILE_SIZE);
-        loadFont("resources/fonts/Arrows.ttf", 20, 250);
-        loadFont("resources/fonts/Arrows.ttf", 24, 250);
-        loadFont("resources/fonts/upheavtt.ttf", 20, 250);
-        loadFont("resources/fonts/upheavtt.ttf", 60, 250);
-        loadFont("resources/fonts/upheavtt.ttf", 30, 250);
-        // Para controles - estilo inversión/tecnológico
-        loadFont("resources/fonts/Inversionz.ttf", 22, 250);      // Tamaño para controles
-        loadFont("resources/fonts/Inversionz.ttf", 18, 250);      // Tamaño más pequeño
-        loadFont("resources/fonts/Inversionz.ttf", 16, 250);      // Para texto pequeño
-    
-        // Para nivel - estilo espacial/futurista
-        loadFont("resources/fonts/spaceranger.ttf", 28, 250);     // Tamaño principal nivel
-        loadFont("resources/fonts/spaceranger.ttf", 32, 250);     // Tamaño más grande
-        loadFont("resources/fonts/spaceranger.ttf", 24, 250);     // Tamaño alternativo
-        loadFont("resources/fonts/spaceranger.ttf", 40, 250);
-        loadFont("resources/fonts/spaceranger.ttf", 20, 250);
+    // Sin buscar por nombre: la tabla se rellena al terminar la carga
+    const Texture2D& getTexturaTile(int textura) const {
+        return texturasTile[static_cast<unsigned>(textura) < NUM_TEXTURAS_TILE ? textura : TEX_NINGUNA];
+    }
+    
+    void resolverTexturasTile() {
+        for (int i = 0; i < NUM_TEXTURAS_TILE; i++) {
+            texturasTile[i] = CLAVES_TEXTURA_TILE[i] ? getTexture(CLAVES_TEXTURA_TILE[i]) : Texture2D{};
+        }
+    }
+    
+    // Bytes que tiene que ocupar la entrada según su tipo, formato y tamaño; 0 si no es válida
+    static uint64_t bytesEntradaPak(const PakEntrada& e) {
+        if (e.ancho == 0 || e.alto == 0 || e.ancho > PAK_MAX_LADO || e.alto > PAK_MAX_LADO ||
+            e.formato < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE || e.formato > PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA) {
+            return 0;
+        }
+        uint64_t bytes = static_cast<uint64_t>(GetPixelDataSize(static_cast<int>(e.ancho), static_cast<int>(e.alto),
+                                                                static_cast<int>(e.formato)));
+        if (bytes == 0) return 0;
+        if (e.tipo == PAK_TEXTURA) return bytes;
+        if (e.tipo != PAK_FUENTE || e.glyphCount <= 0 || e.glyphCount > PAK_MAX_GLIFOS) return 0;
+        return bytes + static_cast<uint64_t>(e.glyphCount) * (sizeof(Rectangle) + sizeof(PakGlifo));
+    }
+    
+    // Carga todo desde el archivo empaquetado: sin decodificar PNG ni rasterizar
+    // fuentes, los píxeles del mapeo se suben directamente a GPU.
+    // Devuelve false si no hay archivo, no es válido o le falta algún recurso: entonces no
+    // queda nada cargado y se usa la carga normal desde los archivos sueltos.
+    bool cargarDesdePaquete(const char* ruta) {
+        if (texturesLoaded) return true;
+        
+        auto inicio = RelojArranque::now();
+        ArchivoMapeado pak;
+        if (!pak.abrir(ruta)) return false;
+        
+        const unsigned char* base = pak.getDatos();
+        const size_t tam = pak.getTamano();
+        PakCabecera cabecera;
+        if (tam < sizeof(cabecera)) return false;
+        std::memcpy(&cabecera, base, sizeof(cabecera));
+        if (std::memcmp(cabecera.magia, PAK_MAGIA, sizeof(PAK_MAGIA)) != 0 ||
+            cabecera.version != PAK_VERSION ||
+            cabecera.offsetIndice > tam ||
+            uint64_t(cabecera.numEntradas) > (tam - cabecera.offsetIndice) / sizeof(PakEntrada)) {
+            logger.write("⚠️  Advertencia: " + std::string(ruta) + " no es válido, se usan los archivos sueltos");
+            return false;
+        }
+        
+        // Primero se comprueba todo el índice: una entrada mala descarta el paquete entero
+        const PakEntrada* indice = reinterpret_cast<const PakEntrada*>(base + cabecera.offsetIndice);
+        for (uint32_t i = 0; i < cabecera.numEntradas; i++) {
+            const PakEntrada& e = indice[i];
+            uint64_t esperados = bytesEntradaPak(e);
+            if (esperados == 0 || e.offset > tam || e.tamano > tam - e.offset || esperados > e.tamano) {
+                logger.writef("⚠️  Advertencia: entrada %u de %s corrupta, se usan los archivos sueltos", i, ruta);
+                return false;
+            }
+        }
+        
+        cargarShaderSDF();
+        for (uint32_t i = 0; i < cabecera.numEntradas; i++) {
+            const PakEntrada& e = indice[i];
+            std::string nombre(e.nombre, strnlen(e.nombre, sizeof(e.nombre)));
+            Image imagen{};
+            imagen.data = const_cast<unsigned char*>(base + e.offset);  // Solo se lee
+            imagen.width = static_cast<int>(e.ancho);
+            imagen.height = static_cast<int>(e.alto);
+            imagen.mipmaps = 1;
+            imagen.format = static_cast<int>(e.formato);
+            
+            if (e.tipo == PAK_TEXTURA) {
+                guardarTextura(nombre, LoadTextureFromImage(imagen));
+            } else {
+                int id = -1;
+                for (int f = 0; f < FUENTE_TOTAL; f++) {
+                    if (nombre == RUTAS_FUENTES[f]) id = f;
+                }
+                if (id < 0) continue;
+                
+                // recs y glyphs se copian con el allocator de raylib para que UnloadFont pueda liberarlos
+                size_t bytesPixeles = GetPixelDataSize(imagen.width, imagen.height, imagen.format);
+                const unsigned char* p = base + e.offset + bytesPixeles;
+                Font font{};
+                font.baseSize = e.fontSize;
+                font.glyphCount = e.glyphCount;
+                font.glyphPadding = e.glyphPadding;
+                font.recs = static_cast<Rectangle*>(MemAlloc(sizeof(Rectangle) * e.glyphCount));
+                std::memcpy(font.recs, p, sizeof(Rectangle) * e.glyphCount);
+                p += sizeof(Rectangle) * e.glyphCount;
+                font.glyphs = static_cast<GlyphInfo*>(MemAlloc(sizeof(GlyphInfo) * e.glyphCount));
+                for (int g = 0; g < e.glyphCount; g++) {
+                    PakGlifo glifo;
+                    std::memcpy(&glifo, p + g * sizeof(PakGlifo), sizeof(glifo));
+                    font.glyphs[g].value = glifo.value;
+                    font.glyphs[g].offsetX = glifo.offsetX;
+                    font.glyphs[g].offsetY = glifo.offsetY;
+                    font.glyphs[g].advanceX = glifo.advanceX;
+                    font.glyphs[g].image = Image{};
+                }
+                font.texture = LoadTextureFromImage(imagen);
+                SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+                if (font.texture.id == 0) UnloadFont(font);     // registrarFuente no se queda con ella
+                registrarFuente(id, font, nombre);
+            }
+        }
+        
+        // Un paquete viejo o incompleto no sirve a medias: o están todos los recursos o ninguno
+        const char* falta = nullptr;
+        for (const RecursoTextura& r : TEXTURAS_JUEGO) {
+            if (getTexture(r.clave).id == 0) falta = r.clave;
+        }
+        for (int f = 0; f < FUENTE_TOTAL; f++) {
+            if (!fontsSDF[f]) falta = RUTAS_FUENTES[f];
+        }
+        if (falta != nullptr) {
+            logger.writef("⚠️  Advertencia: a %s le falta %s, se usan los archivos sueltos", ruta, falta);
+            unloadAll();
+            return false;
+        }
+        
+        texturesLoaded = true;
+        resolverTexturasTile();
+        logger.write("⏱️  " + std::to_string(cabecera.numEntradas) + " recursos cargados desde " +
+                     std::string(ruta) + " en " + std::to_string(msDesde(inicio)) + " ms");
+        return true;
+    }
+    
+    // Reparte la decodificación entre hilos de trabajo y vuelve enseguida.
+    // Después hay que llamar a procesarCargas() cada frame desde el hilo principal.
+    void iniciarCargaParalela() {
+        if (texturesLoaded || !trabajos.empty()) return;
+        
+        logger.write("📥 Cargando y reescalando texturas en paralelo...");
+        inicioCarga = RelojArranque::now();
+        
+        for (const RecursoTextura& r : TEXTURAS_JUEGO) {
+            if (r.sprite) {
+                agregarSprite(r.clave, r.ruta);
+            } else {
+                agregarTextura(r.clave, r.ruta, 0, 0);
+            }
+        }
+        // Un atlas SDF por fuente, válido para todos los tamaños
+        agregarFuente(FUENTE_ARROWS);
+        agregarFuente(FUENTE_UPHEAVTT);
+        agregarFuente(FUENTE_INVERSIONZ);       // Para controles - estilo inversión/tecnológico
+        agregarFuente(FUENTE_SPACERANGER);      // Para nivel - estilo espacial/futurista
+        cargarShaderSDF();
+        
+        terminados.reserve(trabajos.size());
+        unsigned int nucleos = std::thread::hardware_concurrency();
+        size_t numHilos = std::min<size_t>(trabajos.size(), std::max(1u, std::min(nucleos, 8u)));
+        for (size_t i = 0; i < numHilos; i++) {
+            trabajadores.emplace_back(&TextureManager::bucleTrabajador, this);
+        }
+    }
+    
+    // Sube a GPU lo que ya esté decodificado. Devuelve true cuando ha terminado todo.
+    bool procesarCargas() {
+        if (texturesLoaded) return true;
+        
+        std::vector<size_t> listos;
+        {
+            std::lock_guard<std::mutex> lock(terminadosMutex);
+            listos.swap(terminados);
+        }
         
+        auto inicioSubida = RelojArranque::now();
+        for (size_t i : listos) {
+            subirTrabajo(trabajos[i]);
+            subidos++;
+        }
+        msSubidaGPU += msDesde(inicioSubida);
+        
+        if (subidos < trabajos.size()) return false;
+        
+        for (auto& hilo : trabajadores) {
+            if (hilo.joinable()) hilo.join();
+        }
+        
+        double msCPUTotal = 0.0;
+        for (const auto& t : trabajos) msCPUTotal += t.msCPU;
+        logger.write("⏱️  Texturas y fuentes: " + std::to_string(msDesde(inicioCarga)) + " ms (CPU " +
+                     std::to_string(msCPUTotal) + " ms en " + std::to_string(trabajadores.size()) +
+                     " hilos, subida GPU " + std::to_string(msSubidaGPU) + " ms)");
+        
+        trabajadores.clear();
+        trabajos.clear();
+        trabajos.shrink_to_fit();
         texturesLoaded = true;
+        resolverTexturasTile();
         logger.write("🎨 Texturas cargadas correctamente");
         return true;
     }
     
+    float getProgresoCarga() const {
+        if (texturesLoaded) return 1.0f;
+        if (trabajos.empty()) return 0.0f;
+        return static_cast<float>(subidos) / static_cast<float>(trabajos.size());
+    }
+    
+    // Versión bloqueante (sin pantalla de carga)
+    bool loadAllTextures() {
+        iniciarCargaParalela();
+        while (!procesarCargas()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+    
     void unloadAll() {
         for (auto& pair : textures) {
             UnloadTexture(pair.second);
+            ContabilidadMemoria::liberaGPU(MEM_TEXTURAS, bytesTexturas[pair.first]);
         }
         textures.clear();
+        bytesTexturas.clear();
+        texturasTile.fill(Texture2D{});
+        // Las fuentes SDF son nuestras; el fallback es la fuente por defecto de raylib y no se toca
+        for (int id = 0; id < FUENTE_TOTAL; id++) {
+            if (fontsSDF[id]) {
+                UnloadFont(fonts[id]);
+                ContabilidadMemoria::liberaGPU(MEM_FUENTES, bytesFuentesGPU[id]);
+                ContabilidadMemoria::liberaCPU(MEM_FUENTES, bytesFuentesCPU[id]);
+            }
+            fonts[id] = Font{};
+            fontsSDF[id] = false;
+            bytesFuentesGPU[id] = bytesFuentesCPU[id] = 0;
+        }
+        if (shaderSDF.id != 0) {
+            UnloadShader(shaderSDF);
+            shaderSDF = Shader{};
+        }
         texturesLoaded = false;
-        logger.write("🧹 Todas las texturas liberadas");
+        logger.write("🧹 Todas las texturas y fuentes liberadas");
+    }
+    
+    size_t getBytesTextura(const std::string& name) const {
+        auto it = bytesTexturas.find(name);
+        return it != bytesTexturas.end() ? it->second : 0;
+    }
+    
+    // Una línea por entrada, de la que más ocupa a la que menos
+    void volcarMemoria() const {
+        std::vector<std::pair<size_t, const std::string*>> entradas;
+        entradas.reserve(bytesTexturas.size());
+        for (const auto& pair : bytesTexturas) entradas.push_back({pair.second, &pair.first});
+        std::sort(entradas.begin(), entradas.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (const auto& e : entradas) {
+            const Texture2D& t = textures.at(*e.second);
+            logger.writef("   - %s: %dx%d, %.1f KB", e.second->c_str(), t.width, t.height, e.first / 1024.0);
+        }
+        for (int id = 0; id < FUENTE_TOTAL; id++) {
+            if (!fontsSDF[id]) continue;
+            logger.writef("   - %s: atlas %.1f KB + glifos %.1f KB", RUTAS_FUENTES[id], bytesFuentesGPU[id] / 1024.0,
+                          bytesFuentesCPU[id] / 1024.0);
+        }
     }
     
     bool areTexturesLoaded() const { return texturesLoaded; }
 };
 
-// Sistema de colisiones optimizado
-class CollisionSystem {
+// Memoria por subsistema: panel en pantalla (F4), volcado al log y comprobación de fugas al cerrar
+class InformeMemoria {
 private:
-    static constexpr int COLLISION_CHECK_RADIUS = 1;
+    static double mb(int64_t bytes) { return bytes / (1024.0 * 1024.0); }
     
 public:
-    static bool canPassTile(int tileType, bool isMaster, const GameState& state) {
-        switch (tileType) {
-            case VACIO: case START_MASTER: case START_SLAVE: 
-            case BOTON_1: case BOTON_2: case BOTON_3: case META:
-                return true;
-            case PARED:
-                return false;
-            case PUERTA_1:
-                return state.button1Active.load();
-            case PUERTA_2:
-                return state.button2Active.load();
-            case PUERTA_3:
-                return state.button3Active.load();
-            case OBSTACULO_ROJO:
-                return isMaster;
-            case OBSTACULO_AZUL:
-                return !isMaster;
-            default:
-                return false;
+    // Con lienzo o ventana como destino; los textos van a la arena del frame
+    static void draw(int x, int y) {
+        const int LINEA = 16;
+        DrawRectangle(x - 6, y - 4, 360, LINEA * (MEM_TOTAL + 3) + 8, Fade(BLACK, 0.75f));
+        DrawText("Memoria MB (actual / pico)", x, y, 14, LIME);
+        for (int e = 0; e < MEM_TOTAL; e++) {
+            const CuentaMemoria& cpu = ContabilidadMemoria::getCPU(static_cast<EtiquetaMemoria>(e));
+            const CuentaMemoria& gpu = ContabilidadMemoria::getGPU(static_cast<EtiquetaMemoria>(e));
+            DrawText(arenaFrame.formatear("%s: CPU %.2f / %.2f   GPU %.2f / %.2f",
+                                          ContabilidadMemoria::nombre(static_cast<EtiquetaMemoria>(e)),
+                                          mb(cpu.actual.load()), mb(cpu.pico.load()), mb(gpu.actual.load()),
+                                          mb(gpu.pico.load())),
+                     x, y + LINEA * (e + 1), 14, WHITE);
         }
+        DrawText(arenaFrame.formatear("total: CPU %.2f   GPU %.2f", mb(ContabilidadMemoria::totalCPU()),
+                                      mb(ContabilidadMemoria::totalGPU())),
+                 x, y + LINEA * (MEM_TOTAL + 1), 14, YELLOW);
+        DrawText(arenaFrame.formatear("arena %zu / %zu KB (máx %zu), desbordes %ld", arenaFrame.getUsado() / 1024,
+                                      arenaFrame.getCapacidad() / 1024, arenaFrame.getMaximo() / 1024,
+                                      arenaFrame.getDesbordes()),
+                 x, y + LINEA * (MEM_TOTAL + 2), 14, WHITE);
     }
     
-    static bool checkCollisionWithLaberinto(Vector2 position, float radius, bool isMaster, const GameState& state) {
-        using namespace GameConstants;
-        
-        if (position.x < radius || position.y < radius || 
-            position.x >= MAP_WIDTH * TILE_SIZE - radius || 
-            position.y >= MAP_HEIGHT * TILE_SIZE - radius) {
-            return true;
+    static void volcar() {
+        logger.write("📊 Memoria por subsistema (MB actual / pico, reservas):");
+        for (int e = 0; e < MEM_TOTAL; e++) {
+            const CuentaMemoria& cpu = ContabilidadMemoria::getCPU(static_cast<EtiquetaMemoria>(e));
+            const CuentaMemoria& gpu = ContabilidadMemoria::getGPU(static_cast<EtiquetaMemoria>(e));
+            logger.writef("   - %s: CPU %.2f / %.2f (%lld), GPU %.2f / %.2f (%lld)",
+                          ContabilidadMemoria::nombre(static_cast<EtiquetaMemoria>(e)), mb(cpu.actual.load()),
+                          mb(cpu.pico.load()), static_cast<long long>(cpu.reservas.load()), mb(gpu.actual.load()),
+                          mb(gpu.pico.load()), static_cast<long long>(gpu.reservas.load()));
         }
-        
-        int centerTileX = static_cast<int>(position.x / TILE_SIZE);
-        int centerTileY = static_cast<int>(position.y / TILE_SIZE);
-        
-        for (int y = centerTileY - COLLISION_CHECK_RADIUS; y <= centerTileY + COLLISION_CHECK_RADIUS; y++) {
-            for (int x = centerTileX - COLLISION_CHECK_RADIUS; x <= centerTileX + COLLISION_CHECK_RADIUS; x++) {
-                if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
-                    int tileType = state.laberinto[y][x];
-                    
-                    if (!canPassTile(tileType, isMaster, state)) {
-                        Rectangle tileRect = {
-                            static_cast<float>(x * TILE_SIZE), 
-                            static_cast<float>(y * TILE_SIZE), 
-                            static_cast<float>(TILE_SIZE), 
-                            static_cast<float>(TILE_SIZE)
-                        };
-                        if (CheckCollisionCircleRec(position, radius, tileRect)) {
-                            return true;
-                        }
-                    }
-                }
-            }
+        logger.writef("   - arena del frame: máx %zu de %zu bytes, %ld desbordes", arenaFrame.getMaximo(),
+                      arenaFrame.getCapacidad(), arenaFrame.getDesbordes());
+    }
+    
+    // Tras descargar todo: lo que quede anotado no se liberó. Devuelve cuántas etiquetas fugan.
+    static int comprobarFugas() {
+        int fugas = 0;
+        for (int e = 0; e < MEM_TOTAL; e++) {
+            int64_t cpu = ContabilidadMemoria::getCPU(static_cast<EtiquetaMemoria>(e)).actual.load();
+            int64_t gpu = ContabilidadMemoria::getGPU(static_cast<EtiquetaMemoria>(e)).actual.load();
+            if (cpu == 0 && gpu == 0) continue;
+            logger.writef("⚠️  Fuga en %s: %lld bytes en CPU y %lld en GPU sin liberar",
+                          ContabilidadMemoria::nombre(static_cast<EtiquetaMemoria>(e)), static_cast<long long>(cpu),
+                          static_cast<long long>(gpu));
+            fugas++;
         }
-        return false;
+        if (fugas == 0) logger.write("✅ Sin fugas: toda la memoria anotada se liberó");
+        return fugas;
     }
 };
 
-// Sistema de movimiento optimizado
+// Sistema de movimiento optimizado (la regla de movimiento está en SimulacionFija)
 class MovementSystem {
-private:
-    static constexpr float BORDER_MARGIN = 1.0f;
-    
-    static float clamp(float value, float min, float max) {
-        if (value < min) return min;
-        if (value > max) return max;
-        return value;
+public:
+    // keys en grupos de 4: izquierda, derecha, arriba, abajo
+    static uint8_t leerInput(const std::vector<int>& keys) {
+        uint8_t input = 0;
+        for (size_t i = 0; i + 3 < keys.size(); i += 4) {
+            if (IsKeyDown(keys[i])) input |= INPUT_IZQ;
+            if (IsKeyDown(keys[i+1])) input |= INPUT_DER;
+            if (IsKeyDown(keys[i+2])) input |= INPUT_ARR;
+            if (IsKeyDown(keys[i+3])) input |= INPUT_ABA;
+        }
+        return input;
     }
     
-public:
     static Vector2 calculateNewPosition(Vector2 currentPos, const std::vector<int>& keys) {
-        Vector2 newPos = currentPos;
-        
-        for (size_t i = 0; i < keys.size(); i += 4) {
-            if (IsKeyDown(keys[i])) newPos.x -= GameConstants::PLAYER_SPEED;
-            if (IsKeyDown(keys[i+1])) newPos.x += GameConstants::PLAYER_SPEED;
-            if (IsKeyDown(keys[i+2])) newPos.y -= GameConstants::PLAYER_SPEED;
-            if (IsKeyDown(keys[i+3])) newPos.y += GameConstants::PLAYER_SPEED;
-        }
-        
-        const float maxX = GameConstants::MAP_WIDTH * GameConstants::TILE_SIZE - BORDER_MARGIN;
-        const float maxY = GameConstants::MAP_HEIGHT * GameConstants::TILE_SIZE - BORDER_MARGIN;
-        
-        newPos.x = clamp(newPos.x, BORDER_MARGIN, maxX);
-        newPos.y = clamp(newPos.y, BORDER_MARGIN, maxY);
-        
-        return newPos;
+        return SimulacionFija::aplicarInput(currentPos, leerInput(keys));
     }
 };
 
 // Hilos del juego optimizados
-void physicsThread(GameState& state, bool isMaster, const std::vector<int>& keys) {
+// controlIA: el jugador lo maneja CompaneroIA en vez del teclado (modo un jugador)
+void physicsThread(GameState& state, bool isMaster, const std::vector<int>& keys, bool controlIA) {
     logger.write((isMaster ? "Master" : "Slave") + std::string("PhysicsThread started"));
     
+    // El hilo se recrea en cada nivel, así que el planificador se construye con el mapa actual
+    std::unique_ptr<CompaneroIA> ia;
+    if (controlIA) {
+        ia = std::make_unique<CompaneroIA>(CompaneroIA::rejillaDe(state.laberinto), isMaster, state.canales.load(),
+                                           metadatosNivel(state.currentLevel.load()));
+    }
+    
     while (state.gameRunning) {
-        Vector2 currentPos;
+        Vector2 currentPos, otherPos;
         {
             std::lock_guard<std::mutex> lock(state.mtx);
             currentPos = isMaster ? state.masterPos : state.slavePos;
+            otherPos = isMaster ? state.slavePos : state.masterPos;
         }
         
-        Vector2 newPos = MovementSystem::calculateNewPosition(currentPos, keys);
+        Vector2 newPos = ia ? SimulacionFija::aplicarInput(currentPos, ia->decidir(currentPos, otherPos, state.canales.load()))
+                            : MovementSystem::calculateNewPosition(currentPos, keys);
         
-        if (!CollisionSystem::checkCollisionWithLaberinto(newPos, GameConstants::PLAYER_RADIUS, isMaster, state)) {
+        if (!CollisionSystem::checkCollisionWithLaberinto(newPos, GameConstants::PLAYER_RADIUS, isMaster,
+                                                          state.laberinto, state.canales.load(),
+                                                          metadatosNivel(state.currentLevel.load()))) {
             std::lock_guard<std::mutex> lock(state.mtx);
             if (isMaster) {
                 state.masterPos = newPos;
@@ -762,15 +1645,18 @@ void physicsThread(GameState& state, bool isMaster, const std::vector<int>& keys
         
         SLEEP_MS(GameConstants::PHYSICS_UPDATE_RATE);
     }
+    if (ia) {
+        const CompaneroIA::Estadisticas& e = ia->getEstadisticas();
+        logger.write("🤖 Compañero IA: " + std::to_string(e.ticks) + " ticks, medio " +
+                     std::to_string(e.ticks ? e.msTotal / e.ticks : 0.0) + " ms, máximo " +
+                     std::to_string(e.msMaximo) + " ms");
+    }
     logger.write((isMaster ? "Master" : "Slave") + std::string("PhysicsThread finished"));
 }
 
 void validationThread(GameState& state, AudioSystem& audio) {
     logger.write("ValidationThread started");
     
-    bool prevButton1Active = false;
-    bool prevButton2Active = false;
-    bool prevButton3Active = false;
     bool prevLevelCompleted = false;
     
     while (state.gameRunning) {
@@ -781,71 +1667,21 @@ void validationThread(GameState& state, AudioSystem& audio) {
             slavePos = state.slavePos;
         }
         
-        int masterTileX = static_cast<int>(masterPos.x / GameConstants::TILE_SIZE);
-        int masterTileY = static_cast<int>(masterPos.y / GameConstants::TILE_SIZE);
-        int slaveTileX = static_cast<int>(slavePos.x / GameConstants::TILE_SIZE);
-        int slaveTileY = static_cast<int>(slavePos.y / GameConstants::TILE_SIZE);
-        
-        // Botones 1 y 2 (activación individual)
-        if (masterTileX >= 0 && masterTileX < GameConstants::MAP_WIDTH && 
-            masterTileY >= 0 && masterTileY < GameConstants::MAP_HEIGHT) {
-            int tile = state.laberinto[masterTileY][masterTileX];
-            if (tile == BOTON_1) state.button1Active = true;
-        }
-        
-        if (slaveTileX >= 0 && slaveTileX < GameConstants::MAP_WIDTH && 
-            slaveTileY >= 0 && slaveTileY < GameConstants::MAP_HEIGHT) {
-            int tile = state.laberinto[slaveTileY][slaveTileX];
-            if (tile == BOTON_2) state.button2Active = true;
-        }
-        if (!state.button3Active){
-          // NUEVO: Botón 3 requiere AMBOS jugadores
-          bool masterOnButton3 = false;
-          bool slaveOnButton3 = false;
-        
-          if (masterTileX >= 0 && masterTileX < GameConstants::MAP_WIDTH && 
-              masterTileY >= 0 && masterTileY < GameConstants::MAP_HEIGHT) {
-              int tile = state.laberinto[masterTileY][masterTileX];
-              if (tile == BOTON_3) masterOnButton3 = true;
-          }
-        
-          if (slaveTileX >= 0 && slaveTileX < GameConstants::MAP_WIDTH && 
-              slaveTileY >= 0 && slaveTileY < GameConstants::MAP_HEIGHT) {
-              int tile = state.laberinto[slaveTileY][slaveTileX];
-              if (tile == BOTON_3) slaveOnButton3 = true;
-          }
-        
-          // Solo activar si AMBOS están en el botón
-          state.button3Active = masterOnButton3 && slaveOnButton3;
-        }
+        Canales canales = state.canales.load();
+        uint8_t metas = 0;
+        ReglasJuego::evaluar(state.laberinto, masterPos, slavePos, canales, metas,
+                             metadatosNivel(state.currentLevel.load()));
+        Canales anteriores = state.canales.exchange(canales);
         
-        //Detectar cuando una puerta se abre
-        if (!prevButton1Active && state.button1Active) {
-            audio.playDoorOpen();
-            logger.write("🔊 SFX: Puerta 1 abierta");
-        }
-        if (!prevButton2Active && state.button2Active) {
-            audio.playDoorOpen();
-            logger.write("🔊 SFX: Puerta 2 abierta");
-        }
-        if (!prevButton3Active && state.button3Active) {
+        //Detectar cuando una puerta se abre: un sonido por cada canal que se activa
+        for (Canales abiertos = canales & ~anteriores; abiertos != 0; abiertos &= abiertos - 1) {
             audio.playDoorOpen();
-            logger.write("🔊 SFX: Puerta 3 abierta");
+            logger.writef("🔊 SFX: Puerta %d abierta", __builtin_ctzll(abiertos) + 1);
         }
         
-        // Actualizar estados anteriores
-        prevButton1Active = state.button1Active.load();
-        prevButton2Active = state.button2Active.load();
-        prevButton3Active = state.button3Active.load();
-        
-        
-        // Verificar victoria (se mantiene igual)
-        bool masterOnGoal = (masterTileX >= 0 && masterTileX < GameConstants::MAP_WIDTH && 
-                           masterTileY >= 0 && masterTileY < GameConstants::MAP_HEIGHT) &&
-                           (state.laberinto[masterTileY][masterTileX] == META);
-        bool slaveOnGoal = (slaveTileX >= 0 && slaveTileX < GameConstants::MAP_WIDTH && 
-                          slaveTileY >= 0 && slaveTileY < GameConstants::MAP_HEIGHT) &&
-                          (state.laberinto[slaveTileY][slaveTileX] == META);
+        // Verificar victoria
+        bool masterOnGoal = (metas & BIT_META_MASTER) != 0;
+        bool slaveOnGoal = (metas & BIT_META_SLAVE) != 0;
         
         state.masterInGoal = masterOnGoal;
         state.slaveInGoal = slaveOnGoal;
@@ -853,7 +1689,7 @@ void validationThread(GameState& state, AudioSystem& audio) {
         
         if (state.bothInGoal && !state.levelCompleted) {
             state.levelCompleted = true;
-            logger.write("✅ Nivel " + std::to_string(state.currentLevel.load()) + " completado!");
+            logger.writef("✅ Nivel %d completado!", state.currentLevel.load());
         }
         
         //Reproducir sonido cuando se completa el nivel
@@ -873,183 +1709,270 @@ void validationThread(GameState& state, AudioSystem& audio) {
 class RenderSystem {
 private:
     TextureManager& textureManager;
+    RenderTilemapGPU tilemapGPU;
+    bool usarTilemapGPU = false;
+    bool tilemapGPUFallido = false;
     
 public:
 
     RenderSystem(TextureManager& tm) : textureManager(tm) {}
     
-    void drawUpheavttText(const std::string& text, Vector2 position, float fontSize, 
-                         Color textColor, Color outlineColor = BLACK) {
+    // Texto con fuente SDF: relleno y contorno en una sola pasada del shader.
+    // contornoPx es el grosor del contorno en píxeles de pantalla (0 = sin contorno).
+    void drawTextSDF(FuenteId fuente, const char* text, Vector2 position, float fontSize, float spacing,
+                     Color textColor, float contornoPx = 0.0f, Color outlineColor = BLACK) {
+        Font font = textureManager.getFont(fuente);
         
-        Font font = textureManager.getFont("resources/fonts/upheavtt.ttf", 
-                                          static_cast<int>(fontSize));
-        
-        if (font.texture.id != 0 && font.texture.id != GetFontDefault().texture.id) {
-            // Contorno grueso (8 direcciones)
-            std::vector<Vector2> outlineOffsets = {
-                {-2, 0}, {2, 0}, {0, -2}, {0, 2},
-                {-2, -2}, {2, -2}, {-2, 2}, {2, 2}
-            };
-            
-            // Dibujar contorno
-            for (const auto& offset : outlineOffsets) {
-                DrawTextEx(font, text.c_str(), 
-                          Vector2{position.x + offset.x, position.y + offset.y}, 
-                          fontSize, 1, outlineColor);
-            }
-            
-            // Dibujar texto principal
-            DrawTextEx(font, text.c_str(), position, fontSize, 1, textColor);
+        if (textureManager.isFontSDF(fuente)) {
+            const Shader& shader = textureManager.getShaderSDF();
+            Color contorno = (contornoPx > 0.0f) ? outlineColor : textColor;
+            float colorContorno[4] = { contorno.r / 255.0f, contorno.g / 255.0f,
+                                       contorno.b / 255.0f, contorno.a / 255.0f };
+            float ancho = FuentesSDF::contornoEnUnidadesSDF(contornoPx, fontSize);
             
+            BeginShaderMode(shader);
+            SetShaderValue(shader, textureManager.getLocColorContorno(), colorContorno, SHADER_UNIFORM_VEC4);
+            SetShaderValue(shader, textureManager.getLocAnchoContorno(), &ancho, SHADER_UNIFORM_FLOAT);
+            DrawTextEx(font, text, position, fontSize, spacing, textColor);
+            EndShaderMode();
         } else {
-            // Fallback
-            DrawText(text.c_str(), (int)position.x + 1, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x - 1, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y + 1, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y - 1, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y, (int)fontSize, textColor);
+            // Fallback: fuente por defecto con contorno simple
+            int x = static_cast<int>(position.x);
+            int y = static_cast<int>(position.y);
+            int size = static_cast<int>(fontSize);
+            if (contornoPx > 0.0f) {
+                int o = std::max(1, static_cast<int>(contornoPx) - 1);
+                DrawText(text, x + o, y, size, outlineColor);
+                DrawText(text, x - o, y, size, outlineColor);
+                DrawText(text, x, y + o, size, outlineColor);
+                DrawText(text, x, y - o, size, outlineColor);
+            }
+            DrawText(text, x, y, size, textColor);
+        }
+    }
+    
+    Vector2 measureTextSDF(FuenteId fuente, const char* text, float fontSize, float spacing) {
+        if (textureManager.isFontSDF(fuente)) {
+            return MeasureTextEx(textureManager.getFont(fuente), text, fontSize, spacing);
         }
+        return Vector2{ static_cast<float>(MeasureText(text, static_cast<int>(fontSize))), fontSize };
+    }
+    
+    void drawUpheavttText(const char* text, Vector2 position, float fontSize, 
+                         Color textColor, Color outlineColor = BLACK) {
+        // Contorno grueso
+        drawTextSDF(FUENTE_UPHEAVTT, text, position, fontSize, 1, textColor, 2.0f, outlineColor);
     }
     
     // MÉTODO 1: Para arrows.ttf CON CONTORNO
-    void drawArrowsText(const std::string& text, Vector2 position, float fontSize, 
+    void drawArrowsText(const char* text, Vector2 position, float fontSize, 
                        Color textColor, Color outlineColor = BLACK) {
-        
-        Font font = textureManager.getFont("resources/fonts/Arrows.ttf", 
-                                          static_cast<int>(fontSize));
-        
-        if (font.texture.id != 0 && font.texture.id != GetFontDefault().texture.id) {
-            // Contorno de 8 direcciones
-            std::vector<Vector2> outlineOffsets = {
-              {-1, 0}, {1, 0}, {0, -1}, {0, 1},  // Solo 4 direcciones, no diagonales
-              // {-1, -1}, {1, -1}, {-1, 1}, {1, 1}  // Comentadas para hacerlo más sutil
-            };
-            
-            // Dibujar contorno
-            for (const auto& offset : outlineOffsets) {
-                DrawTextEx(font, text.c_str(), 
-                          Vector2{position.x + offset.x, position.y + offset.y}, 
-                          fontSize, 1, outlineColor);
-            }
-            
-            // Dibujar texto principal
-            DrawTextEx(font, text.c_str(), position, fontSize, 1, textColor);
-            
-        } else {
-            // Fallback: texto normal con contorno simple
-            DrawText(text.c_str(), (int)position.x + 1, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x - 1, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y + 1, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y - 1, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y, (int)fontSize, textColor);
-        }
+        // Contorno fino para hacerlo más sutil
+        drawTextSDF(FUENTE_ARROWS, text, position, fontSize, 1, textColor, 1.0f, outlineColor);
     }
     
     // MÉTODO 2: Para inversionz.ttf SIN CONTORNO
-    void drawInversionzText(const std::string& text, Vector2 position, float fontSize, 
+    void drawInversionzText(const char* text, Vector2 position, float fontSize, 
                            Color textColor) {
-        
-        Font font = textureManager.getFont("resources/fonts/Inversionz.ttf", 
-                                          static_cast<int>(fontSize));
-        
-        if (font.texture.id != 0 && font.texture.id != GetFontDefault().texture.id) {
-            DrawTextEx(font, text.c_str(), position, fontSize, 1, textColor);
-        } else {
-            DrawText(text.c_str(), (int)position.x, (int)position.y, (int)fontSize, textColor);
-        }
+        drawTextSDF(FUENTE_INVERSIONZ, text, position, fontSize, 1, textColor);
     }
     
     // MÉTODO 3: Para spaceranger.ttf CON CONTORNO (más grueso)
-    void drawSpacerangerText(const std::string& text, Vector2 position, float fontSize, 
+    void drawSpacerangerText(const char* text, Vector2 position, float fontSize, 
                             Color textColor, Color outlineColor = BLACK) {
+        drawTextSDF(FUENTE_SPACERANGER, text, position, fontSize, 1, textColor, 3.0f, outlineColor);
+    }
+    
+    void drawLaberinto(const GameState& state) {
+        using namespace GameConstants;
+        const MetadatosNivel& meta = metadatosNivel(state.currentLevel.load());
+        Rectangle vista = {0, 0, static_cast<float>(MAP_WIDTH), static_cast<float>(MAP_HEIGHT)};
+        Rectangle destino = {0, 0, static_cast<float>(MAP_WIDTH * TILE_SIZE), static_cast<float>(MAP_HEIGHT * TILE_SIZE)};
+        if (usarTilemapGPU && prepararTilemapGPU()) {
+            tilemapGPU.actualizarMapa(&state.laberinto[0][0], MAP_WIDTH, MAP_HEIGHT, meta);
+            tilemapGPU.dibujar(vista, destino, state.canales.load(), state.bothInGoal);
+        } else {
+            drawTilesQuads(&state.laberinto[0][0], MAP_WIDTH, vista, destino, meta, state.canales.load(),
+                           state.bothInGoal);
+        }
+    }
+    
+    // Capa de emisivos del bloom: botones pulsados y meta resaltada en verde, puertas
+    // abiertas con el tono de su canal. Solo las tiles que brillan; nada si no hay ninguna.
+    void drawResaltados(const GameState& state) {
+        using namespace GameConstants;
+        const MetadatosNivel& meta = metadatosNivel(state.currentLevel.load());
+        Canales canales = state.canales.load();
+        bool metaResaltada = state.bothInGoal;
+        for (int y = 0; y < MAP_HEIGHT; y++) {
+            for (int x = 0; x < MAP_WIDTH; x++) {
+                const RasgosTile& r = meta.rasgos(state.laberinto[y][x]);
+                bool activo = ((canales >> r.canal) & 1) != 0;
+                Rectangle destRect = {static_cast<float>(x * TILE_SIZE), static_cast<float>(y * TILE_SIZE),
+                                      static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE)};
+                if ((r.tipo == TRIGGER_BOTON && activo) || (r.meta && metaResaltada)) {
+                    drawTexture(textureManager.getTexturaTile(r.textura), destRect, GREEN);
+                } else if (r.tipo == TRIGGER_PUERTA && activo) {
+                    drawTexture(textureManager.getTexturaTile(r.textura + 1), destRect, Fade(tintaCanal(r.canal), 0.5f));
+                }
+            }
+        }
+    }
+    
+    // HUD del gameplay: controles, nivel, cronómetro y pantallas de victoria. Los textos
+    // variables se formatean en la arena del frame, sin std::string.
+    void drawHUD(const GameState& state) {
+        using namespace GameConstants;
         
-        Font font = textureManager.getFont("resources/fonts/spaceranger.ttf", 
-                                          static_cast<int>(fontSize));
+        // Fondo para mejor legibilidad
+        DrawRectangle(0, 0, SCREEN_WIDTH, 40, Fade(BLACK, 0.4f));
         
-        if (font.texture.id != 0 && font.texture.id != GetFontDefault().texture.id) {
-            // Contorno más grueso (12 direcciones)
-            std::vector<Vector2> outlineOffsets = {
-                {-3, 0}, {3, 0}, {0, -3}, {0, 3},
-                {-3, -3}, {3, -3}, {-3, 3}, {3, 3},
-                {-2, 0}, {2, 0}, {0, -2}, {0, 2}
-            };
+        // 1. CONTROLES - Usando inversionz.ttf (SIN contorno)
+        drawInversionzText("master: wasd", Vector2{10, 10}, 22, RED);
+        
+        // 2. NIVEL - Usando spaceranger.ttf (CON contorno)
+        const char* levelText = arenaFrame.formatear("NIVEL %d", state.currentLevel.load() + 1);
+        float levelTextWidth = MeasureText(levelText, 28);
+        drawSpacerangerText(levelText, Vector2{SCREEN_WIDTH/2 - levelTextWidth/2, 5}, 28, GOLD);
+        
+        // 3. SLAVE - Usando inversionz.ttf (SIN contorno) + arrows.ttf (CON contorno)
+        drawInversionzText("slave:", Vector2{(float)SCREEN_WIDTH - 260, 10}, 22, BLUE);
+        
+        // Flechas CON CONTORNO usando arrows.ttf
+        drawArrowsText("cbda", Vector2{(float)SCREEN_WIDTH - 110, 10}, 24, BLUE);
+        
+        // Mostrar tiempo actual
+        if (state.gameStarted) {
+            const char* timeText = arenaFrame.tiempo(GetTime() - state.startTime.load());
+            float fontSize = 20.0f;
+            float textWidth = measureTextSDF(FUENTE_UPHEAVTT, timeText, fontSize, 1).x;
+            float posX = SCREEN_WIDTH - textWidth - 20.0f;
+            float posY = SCREEN_HEIGHT - 35.0f;
             
-            // Dibujar contorno
-            for (const auto& offset : outlineOffsets) {
-                DrawTextEx(font, text.c_str(), 
-                          Vector2{position.x + offset.x, position.y + offset.y}, 
-                          fontSize, 1, outlineColor);
-            }
+            DrawRectangleRounded((Rectangle){posX - 15.0f, posY - 5.0f, textWidth + 30.0f, fontSize + 15.0f},
+                                 0.3f, 8, Fade(DARKBLUE, 0.7f));
+            drawUpheavttText(timeText, Vector2{posX, posY}, fontSize, GREEN, BLACK);
+        }
+        
+        // Pantallas de victoria diferenciadas
+        if (state.levelCompleted) {
+            DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, Fade(BLACK, 0.8f));
             
-            // Dibujar texto principal
-            DrawTextEx(font, text.c_str(), position, fontSize, 1, textColor);
+            bool ultimo = state.currentLevel >= TOTAL_LEVELS - 1;
+            const char* titulo = ultimo ? "¡JUEGO COMPLETADO!" : "¡NIVEL COMPLETADO!";
+            const char* siguiente = ultimo ? "Presiona ENTER para volver al menú" : "Presiona ENTER para siguiente nivel";
             
-        } else {
-            // Fallback
-            DrawText(text.c_str(), (int)position.x + 2, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x - 2, (int)position.y, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y + 2, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y - 2, (int)fontSize, outlineColor);
-            DrawText(text.c_str(), (int)position.x, (int)position.y, (int)fontSize, textColor);
+            Vector2 tituloSize = measureTextSDF(FUENTE_SPACERANGER, titulo, 40, 1);
+            drawSpacerangerText(titulo, Vector2{SCREEN_WIDTH/2 - tituloSize.x/2, SCREEN_HEIGHT/2 - 40}, 40,
+                                ultimo ? GOLD : GREEN);
+            
+            Vector2 siguienteSize = measureTextSDF(FUENTE_SPACERANGER, siguiente, 20, 1);
+            drawSpacerangerText(siguiente, Vector2{SCREEN_WIDTH/2 - siguienteSize.x/2, SCREEN_HEIGHT/2 + 10}, 20, WHITE);
         }
+        
+        const char* controles = "Controles: WASD (Master), Flechas (Slave)";
+        DrawText(controles, SCREEN_WIDTH/2 - MeasureText(controles, 16)/2, SCREEN_HEIGHT - 25, 16, DARKGRAY);
     }
     
+    // Un quad de piso y otro de contenido por tile visible. vista en tiles, destino en píxeles.
+    void drawTilesQuads(const int* tiles, int ancho, Rectangle vista, Rectangle destino, const MetadatosNivel& meta,
+                        Canales canales, bool metaResaltada) {
+        Texture2D piso = textureManager.getTexture("piso");
+        float lado = destino.width / vista.width;
+        int x0 = static_cast<int>(vista.x), y0 = static_cast<int>(vista.y);
+        for (int y = 0; y < static_cast<int>(vista.height); y++) {
+            for (int x = 0; x < static_cast<int>(vista.width); x++) {
+                Rectangle destRect = {destino.x + x * lado, destino.y + y * lado, lado, lado};
+                drawTexture(piso, destRect, WHITE);
+                drawTileContent(tiles[(y0 + y) * ancho + x0 + x], destRect, meta, canales, metaResaltada);
+            }
+        }
+    }
     
+    // Alternativa a los quads: todo el mapa en un quad con tilemap_gpu.h (--tilemap-gpu).
+    // Si el shader no compila se queda en los quads.
+    void setTilemapGPU(bool activo) { usarTilemapGPU = activo; }
     
-    
-    /*
-    bool drawTextWithFont(const std::string& fontName, const std::string& text, 
-                         Vector2 position, float fontSize, Color color) {
-        Font customFont = textureManager.getFont(fontName, static_cast<int>(fontSize));
-        if (customFont.texture.id != 0 && customFont.texture.id != GetFontDefault().texture.id) {
-            DrawTextEx(customFont, text.c_str(), position, fontSize, 2, color);
-            return true;
-        } else {
-            // Fallback a fuente por defecto
-            DrawText(text.c_str(), (int)position.x, (int)position.y, (int)fontSize, color);
+    bool prepararTilemapGPU() {
+        if (tilemapGPU.listo()) return true;
+        if (tilemapGPUFallido || !textureManager.areTexturesLoaded()) return false;
+        std::array<Texture2D, NUM_TEXTURAS_TILE> sprites;
+        for (int i = 0; i < NUM_TEXTURAS_TILE; i++) sprites[i] = textureManager.getTexturaTile(i);
+        sprites[TEX_NINGUNA] = textureManager.getTexture("piso");
+        if (!tilemapGPU.cargar(sprites.data(), NUM_TEXTURAS_TILE)) {
+            tilemapGPU.descargar();
+            tilemapGPUFallido = true;
+            logger.write("⚠️  Advertencia: el shader del tilemap no compila, se dibuja tile a tile");
             return false;
         }
-    }*/
-    void drawLaberinto(const GameState& state) {
-        for (int y = 0; y < GameConstants::MAP_HEIGHT; y++) {
-            for (int x = 0; x < GameConstants::MAP_WIDTH; x++) {
-                Rectangle destRect = {
-                    static_cast<float>(x * GameConstants::TILE_SIZE),
-                    static_cast<float>(y * GameConstants::TILE_SIZE),
-                    static_cast<float>(GameConstants::TILE_SIZE),
-                    static_cast<float>(GameConstants::TILE_SIZE)
-                };
-                int tileType = state.laberinto[y][x];
-                
-                drawTexture("piso", destRect, WHITE);
-                drawTileContent(tileType, destRect, state);
-            }
-        }
+        logger.write("🧩 Tilemap en GPU: atlas de " + std::to_string(NUM_TEXTURAS_TILE) + " sprites");
+        return true;
     }
     
+    RenderTilemapGPU& getTilemapGPU() { return tilemapGPU; }
+    
+    // Recursos de GPU propios; antes de cerrar la ventana
+    void descargar() { tilemapGPU.descargar(); }
+    
     void drawPlayers(GameState& state) {
         std::lock_guard<std::mutex> lock(state.mtx);
-        
-        Rectangle masterDest = {
-            state.masterPos.x - GameConstants::TILE_SIZE/2, 
-            state.masterPos.y - GameConstants::TILE_SIZE/2, 
-            static_cast<float>(GameConstants::TILE_SIZE), 
-            static_cast<float>(GameConstants::TILE_SIZE)
-        };
-        drawTexture("master", masterDest, WHITE);
-        
-        Rectangle slaveDest = {
-            state.slavePos.x - GameConstants::TILE_SIZE/2, 
-            state.slavePos.y - GameConstants::TILE_SIZE/2, 
+        drawJugador(state.masterPos, "master", WHITE);
+        drawJugador(state.slavePos, "slave", WHITE);
+    }
+    
+    // Modo fiesta: un sprite por equipo y un tono distinto a partir del tercer jugador
+    void drawJugadores(const AlmacenComponentes& almacen) {
+        for (size_t i = 0; i < almacen.tamano(); i++) {
+            int j = almacen.jugador[i];
+            Color tinta = j < 2 ? WHITE : ColorFromHSV(static_cast<float>(j * 53 % 360), 0.35f, 1.0f);
+            drawJugador({almacen.posX[i], almacen.posY[i]}, almacen.rol[i] == ROL_MASTER ? "master" : "slave", tinta);
+        }
+    }
+    
+    // Objetos dinámicos: la puerta corredera usa el sprite de puerta de su canal; cajas y
+    // peligros no tienen sprite y se dibujan con primitivas
+    void drawObjetos(const MundoObjetos& objetos) {
+        for (size_t i = 0; i < objetos.tamano(); i++) {
+            CajaEntera c = objetos.caja(i);
+            Rectangle dest = {static_cast<float>(c.x0), static_cast<float>(c.y0),
+                              static_cast<float>(c.x1 - c.x0), static_cast<float>(c.y1 - c.y0)};
+            switch (objetos.tipo[i]) {
+                case OBJETO_PUERTA_CORREDIZA:
+                    drawTexture(textureManager.getTexturaTile(TEX_PUERTA_1 + 2 * (objetos.canal[i] % 3)), dest,
+                                tintaCanal(objetos.canal[i]));
+                    break;
+                case OBJETO_CAJA:
+                    DrawRectangleRec(dest, Color{150, 105, 60, 255});
+                    DrawRectangleLinesEx(dest, 3, Color{90, 60, 30, 255});
+                    DrawLineEx({dest.x, dest.y}, {dest.x + dest.width, dest.y + dest.height}, 2, Color{90, 60, 30, 255});
+                    DrawLineEx({dest.x + dest.width, dest.y}, {dest.x, dest.y + dest.height}, 2, Color{90, 60, 30, 255});
+                    break;
+                default:
+                    DrawCircleV({static_cast<float>(objetos.x[i]), static_cast<float>(objetos.y[i])},
+                                dest.width / 2 + 2, MAROON);
+                    DrawCircleV({static_cast<float>(objetos.x[i]), static_cast<float>(objetos.y[i])},
+                                dest.width / 2 - 3, RED);
+                    break;
+            }
+        }
+    }
+    
+private:
+    void drawJugador(Vector2 pos, const char* textura, Color tinta) {
+        Rectangle dest = {
+            pos.x - GameConstants::TILE_SIZE/2, 
+            pos.y - GameConstants::TILE_SIZE/2, 
             static_cast<float>(GameConstants::TILE_SIZE), 
             static_cast<float>(GameConstants::TILE_SIZE)
         };
-        drawTexture("slave", slaveDest, WHITE);
+        drawTexture(textura, dest, tinta);
     }
     
-private:
-    void drawTexture(const std::string& textureName, const Rectangle& destRect, Color tint) {
-        Texture2D texture = textureManager.getTexture(textureName);
+    void drawTexture(const char* textureName, const Rectangle& destRect, Color tint) {
+        drawTexture(textureManager.getTexture(textureName), destRect, tint);
+    }
+    
+    void drawTexture(const Texture2D& texture, const Rectangle& destRect, Color tint) {
         if (texture.id != 0) {
             DrawTexturePro(texture, 
                           {0, 0, (float)texture.width, (float)texture.height},
@@ -1057,67 +1980,21 @@ private:
         }
     }
     
-    void drawTileContent(int tileType, const Rectangle& destRect, const GameState& state) {
-        switch (tileType) {
-            case PARED:
-                drawTexture("pared", destRect, WHITE);
-                break;
-                
-            case BOTON_1:
-                drawTexture("boton1", destRect, state.button1Active.load() ? GREEN : WHITE);
-                break;
-                
-            case BOTON_2:
-                drawTexture("boton2", destRect, state.button2Active.load() ? GREEN : WHITE);
-                break;
-                
-            case BOTON_3:
-                drawTexture("boton3", destRect, state.button3Active.load() ? GREEN : WHITE);
-                break;
-                
-            case PUERTA_1:
-                if (state.button1Active.load()) {
-                    drawTexture("puerta1Abierta", destRect, WHITE);
-                } else {
-                    drawTexture("puerta1Cerrada", destRect, WHITE);
-                }
-                break;
-                
-            case PUERTA_2:
-                if (state.button2Active.load()) {
-                    drawTexture("puerta2Abierta", destRect, WHITE);
-                } else {
-                    drawTexture("puerta2Cerrada", destRect, WHITE);
-                }
-                break;
-            
-            case PUERTA_3:
-                if (state.button3Active.load()) {
-                    drawTexture("puerta3Abierta", destRect, WHITE);
-                } else {
-                    drawTexture("puerta3Cerrada", destRect, WHITE);
-                }
-                break;
-                
-            case OBSTACULO_ROJO:
-                // NUEVO: Sprite temporal - reemplaza cuando tengas el sprite real
-                drawTexture("ObstaculoRojo", destRect, WHITE);
-                break;
-                
-            case OBSTACULO_AZUL:
-                // NUEVO: Sprite temporal - reemplaza cuando tengas el sprite real
-                drawTexture("ObstaculoAzul", destRect, WHITE);
-                break;
-                
-            case META:
-                drawTexture("meta", destRect, state.bothInGoal ? GREEN : WHITE);
-                break;
-                
-            default:
-                break;
-        }
+    // Los canales propios de un nivel reutilizan los sprites básicos, teñidos por canal
+    static Color tintaCanal(int canal) {
+        return canal < 3 ? WHITE : ColorFromHSV(static_cast<float>((canal * 47) % 360), 0.45f, 1.0f);
     }
-};
+    
+    // Todo sale de los rasgos de la tile: sprite, puerta abierta (textura + 1) y resaltado
+    // en verde de los botones activos y de la meta con los dos jugadores dentro
+    void drawTileContent(int tileType, const Rectangle& destRect, const MetadatosNivel& meta, Canales canales,
+                         bool metaResaltada) {
+        const RasgosTile& r = meta.rasgos(tileType);
+        bool activo = ((canales >> r.canal) & 1) != 0;
+        int textura = r.textura + ((r.tipo == TRIGGER_PUERTA && activo) ? 1 : 0);
+        bool resaltado = (r.tipo == TRIGGER_BOTON && activo) || (r.meta && metaResaltada);
+        drawTexture(textureManager.getTexturaTile(textura), destRect, resaltado ? GREEN : tintaCanal(r.canal));
+    }};
 
 // Sistema de menú optimizado
 class MenuSystem {
@@ -1128,34 +2005,37 @@ private:
     AudioSystem& audioSystem;
     RenderSystem& renderSystem;
     
-    void drawTextWithOutline(Font font, const char* text, Vector2 position, 
+    // Caché: fondoFijo se compone una vez; composicion = fondoFijo + botones en su hover actual.
+    // Las dos tienen el tamaño interno del lienzo y se dibujan con su escala.
+    static constexpr float MARGEN_BOTON = 4.0f;     // Contorno del texto y del borde
+    RenderTexture2D fondoFijo{};
+    RenderTexture2D composicion{};
+    int anchoCache = GameConstants::SCREEN_WIDTH;
+    int altoCache = GameConstants::SCREEN_HEIGHT;
+    float escalaCache = 1.0f;
+    bool compuesto = false;
+    bool cacheFallida = false;
+    bool hoverJugar = false;
+    bool hoverSalir = false;
+    int regionesRedibujadas = 0;
+    double ultimaActividad = 0.0;
+    
+    void drawTextWithOutline(const char* text, Vector2 position, 
                            float fontSize, float spacing, Color textColor) {
-        // Efecto de contorno
-        std::vector<Vector2> outlineOffsets = {
-            {-3, 0}, {3, 0}, {0, -3}, {0, 3},
-            {-3, -3}, {3, -3}, {-3, 3}, {3, 3}
-        };
-        
-        for (const auto& offset : outlineOffsets) {
-            DrawTextEx(font, text, 
-                       Vector2{position.x + offset.x, position.y + offset.y}, 
-                       fontSize, spacing, BLACK);
-        }
-        
-        // Texto principal
-        DrawTextEx(font, text, position, fontSize, spacing, textColor);
+        // Efecto de contorno (lo dibuja el shader SDF)
+        renderSystem.drawTextSDF(FUENTE_UPHEAVTT, text, position, fontSize, spacing, textColor, 3.0f, BLACK);
     }
     
-    void drawButtonText(Font font, const char* text, Rectangle button, Color textColor) {
-        if (font.texture.id != 0) {
+    void drawButtonText(const char* text, Rectangle button, Color textColor) {
+        if (textureManager.isFontSDF(FUENTE_UPHEAVTT)) {
             // Usar MeasureTextEx para centrar correctamente
-            Vector2 textSize = MeasureTextEx(font, text, 30, 2);
+            Vector2 textSize = MeasureTextEx(textureManager.getFont(FUENTE_UPHEAVTT), text, 30, 2);
             Vector2 textPosition = {
                 button.x + (button.width - textSize.x) / 2,
                 button.y + (button.height - textSize.y) / 2
             };
             
-            drawTextWithOutline(font, text, textPosition, 30, 2, textColor);
+            drawTextWithOutline(text, textPosition, 30, 2, textColor);
         } else {
             // Fallback a la función original
             DrawText(text, 
@@ -1164,17 +2044,8 @@ private:
         }
     }
     
-public:
-    MenuSystem(TextureManager& tm, AudioSystem& audio, RenderSystem& rs) : textureManager(tm), audioSystem(audio), renderSystem(rs) {
-        playButton = { GameConstants::SCREEN_WIDTH/2 - 100, GameConstants::SCREEN_HEIGHT/2, 200, 50 };
-        exitButton = { GameConstants::SCREEN_WIDTH/2 - 100, GameConstants::SCREEN_HEIGHT/2 + 70, 200, 50 };
-    }
-    
-    
-    
-    
-    
-    void draw() {
+    // Fondo, título, subtítulo y línea de ayuda: todo lo que no cambia con el ratón
+    void drawFondoFijo() {
         Texture2D background = textureManager.getTexture("menu_background");
         if (background.id != 0) {
             // Escalar la imagen para que cubra toda la pantalla
@@ -1187,19 +2058,19 @@ public:
             ClearBackground(RAYWHITE);
         }
         
-        Font titleFont = textureManager.getFont("resources/fonts/upheavtt.ttf", 60);
-        Font regularFont = textureManager.getFont("resources/fonts/upheavtt.ttf", 20);
-        Font buttonFont = textureManager.getFont("resources/fonts/upheavtt.ttf", 30);
+        // Un solo atlas SDF de upheavtt para título (60), botones (30) y textos (20 y 16)
+        Font menuFont = textureManager.getFont(FUENTE_UPHEAVTT);
+        bool fuenteMenuLista = textureManager.isFontSDF(FUENTE_UPHEAVTT);
         
-        if (titleFont.texture.id != 0) {
+        if (fuenteMenuLista) {
             const char* duoText = "DUO";
             const char* mazeText = "MAZE";
             float titleSize = 60;
             float spacing = 2;
             
             // Medir ambas partes
-            Vector2 duoSize = MeasureTextEx(titleFont, duoText, titleSize, spacing);
-            Vector2 mazeSize = MeasureTextEx(titleFont, mazeText, titleSize, spacing);
+            Vector2 duoSize = MeasureTextEx(menuFont, duoText, titleSize, spacing);
+            Vector2 mazeSize = MeasureTextEx(menuFont, mazeText, titleSize, spacing);
             
             // Posición central
             float totalWidth = duoSize.x + mazeSize.x;
@@ -1209,10 +2080,10 @@ public:
             };
             
             // Dibujar cada parte
-            drawTextWithOutline(titleFont, duoText, basePos, titleSize, spacing, BLUE);
+            drawTextWithOutline(duoText, basePos, titleSize, spacing, BLUE);
             
             Vector2 mazePos = Vector2{basePos.x + duoSize.x, basePos.y};
-            drawTextWithOutline(titleFont, mazeText, mazePos, titleSize, spacing, RED);
+            drawTextWithOutline(mazeText, mazePos, titleSize, spacing, RED);
         
     } else {
         // Fallback
@@ -1225,62 +2096,31 @@ public:
         /*DrawText("Cooperación en el Laberinto", 
                  GameConstants::SCREEN_WIDTH/2 - MeasureText("Cooperación en el Laberinto", 20)/2, 
                  GameConstants::SCREEN_HEIGHT/3 + 20, 20, DARKGRAY);*/
-        if (regularFont.texture.id != 0) {
+        if (fuenteMenuLista) {
         const char* subtitle = "Cooperación en el Laberinto";
-        Vector2 subtitleSize = MeasureTextEx(regularFont, subtitle, 20, 1);
+        Vector2 subtitleSize = MeasureTextEx(menuFont, subtitle, 20, 1);
         Vector2 subtitlePos = Vector2{
             GameConstants::SCREEN_WIDTH/2 - subtitleSize.x/2,
             GameConstants::SCREEN_HEIGHT/3 + 20
         };
-        drawTextWithOutline(regularFont, subtitle, subtitlePos, 20, 1, GRAY);
+        drawTextWithOutline(subtitle, subtitlePos, 20, 1, GRAY);
     } else {
         DrawText("Cooperación en el Laberinto", 
                  GameConstants::SCREEN_WIDTH/2 - MeasureText("Cooperación en el Laberinto", 20)/2, 
                  GameConstants::SCREEN_HEIGHT/3 + 20, 20, GRAY);
     }
         
-        Vector2 mousePoint = GetMousePosition();
-        
-        /*DrawRectangleRec(playButton, 
-            CheckCollisionPointRec(mousePoint, playButton) ? BLUE : SKYBLUE);
-        DrawRectangleLinesEx(playButton, 2, DARKBLUE);
-        DrawText("JUGAR", 
-                 playButton.x + playButton.width/2 - MeasureText("JUGAR", 30)/2,
-                 playButton.y + playButton.height/2 - 15, 30, WHITE);
-        
-        DrawRectangleRec(exitButton, 
-            CheckCollisionPointRec(mousePoint, exitButton) ? RED : PINK);
-        DrawRectangleLinesEx(exitButton, 2, MAROON);
-        DrawText("SALIR", 
-                 exitButton.x + exitButton.width/2 - MeasureText("SALIR", 30)/2,
-                 exitButton.y + exitButton.height/2 - 15, 30, WHITE);*/
-        // Botón JUGAR
-        DrawRectangleRec(playButton, 
-            CheckCollisionPointRec(mousePoint, playButton) ? BLUE : SKYBLUE);
-        DrawRectangleLinesEx(playButton, 2, DARKBLUE);
-        
-        // Usar la nueva función para dibujar el texto del botón
-        drawButtonText(buttonFont, "JUGAR", playButton, WHITE);
-        
-        // Botón SALIR
-        DrawRectangleRec(exitButton, 
-            CheckCollisionPointRec(mousePoint, exitButton) ? RED : PINK);
-        DrawRectangleLinesEx(exitButton, 2, MAROON);
-        
-        // Usar la nueva función para dibujar el texto del botón
-        drawButtonText(buttonFont, "SALIR", exitButton, WHITE);
-        
         /*DrawText("Usa P: Pausar música, M: Mutear, U: Subir volumen", 
                  GameConstants::SCREEN_WIDTH/2 - MeasureText("Usa P: Pausar música, M: Mutear, U: Subir volumen", 16)/2,
                  GameConstants::SCREEN_HEIGHT - 50, 16, GRAY);*/
-        if (regularFont.texture.id != 0) {
+        if (fuenteMenuLista) {
         const char* audioText = "Usa P: Pausar música, M: Mutear, U: Subir volumen, H: Alto/Bajo";
-        Vector2 textSize = MeasureTextEx(regularFont, audioText, 16, 1);
+        Vector2 textSize = MeasureTextEx(menuFont, audioText, 16, 1);
         Vector2 textPos = Vector2{
             GameConstants::SCREEN_WIDTH/2 - textSize.x/2,
             GameConstants::SCREEN_HEIGHT - 50
         };
-        drawTextWithOutline(regularFont, audioText, textPos, 16, 1, DARKGRAY);
+        drawTextWithOutline(audioText, textPos, 16, 1, DARKGRAY);
     } else {
         DrawText("Usa P: Pausar música, M: Mutear, U: Subir volumen", 
                  GameConstants::SCREEN_WIDTH/2 - MeasureText("Usa P: Pausar música, M: Mutear, U: Subir volumen", 16)/2,
@@ -1288,6 +2128,182 @@ public:
     }
     }
     
+    void drawBotonJugar(bool hover) {
+        /*DrawRectangleRec(playButton, 
+            CheckCollisionPointRec(mousePoint, playButton) ? BLUE : SKYBLUE);
+        DrawRectangleLinesEx(playButton, 2, DARKBLUE);
+        DrawText("JUGAR", 
+                 playButton.x + playButton.width/2 - MeasureText("JUGAR", 30)/2,
+                 playButton.y + playButton.height/2 - 15, 30, WHITE);
+        
+        DrawRectangleRec(exitButton, 
+            CheckCollisionPointRec(mousePoint, exitButton) ? RED : PINK);
+        DrawRectangleLinesEx(exitButton, 2, MAROON);
+        DrawText("SALIR", 
+                 exitButton.x + exitButton.width/2 - MeasureText("SALIR", 30)/2,
+                 exitButton.y + exitButton.height/2 - 15, 30, WHITE);*/
+        // Botón JUGAR
+        DrawRectangleRec(playButton, hover ? BLUE : SKYBLUE);
+        DrawRectangleLinesEx(playButton, 2, DARKBLUE);
+        
+        // Usar la nueva función para dibujar el texto del botón
+        drawButtonText("JUGAR", playButton, WHITE);
+    }
+    
+    void drawBotonSalir(bool hover) {
+        // Botón SALIR
+        DrawRectangleRec(exitButton, hover ? RED : PINK);
+        DrawRectangleLinesEx(exitButton, 2, MAROON);
+        
+        // Usar la nueva función para dibujar el texto del botón
+        drawButtonText("SALIR", exitButton, WHITE);
+    }
+    
+    // Una textura de la caché como destino, en coordenadas virtuales
+    void comenzarCache(RenderTexture2D& rt) {
+        BeginTextureMode(rt);
+        Camera2D camara = {};
+        camara.zoom = escalaCache;
+        BeginMode2D(camara);
+    }
+    
+    void terminarCache() {
+        EndMode2D();
+        EndTextureMode();
+    }
+    
+    // Rectángulo de un botón en la composición: el fondo fijo debajo y el botón encima
+    void redibujarBoton(bool jugar) {
+        const Rectangle& boton = jugar ? playButton : exitButton;
+        Rectangle r = {boton.x - MARGEN_BOTON, boton.y - MARGEN_BOTON,
+                       boton.width + 2 * MARGEN_BOTON, boton.height + 2 * MARGEN_BOTON};
+        float alto = static_cast<float>(fondoFijo.texture.height);
+        float e = escalaCache;
+        comenzarCache(composicion);
+        DrawTexturePro(fondoFijo.texture, {r.x * e, alto - (r.y + r.height) * e, r.width * e, -r.height * e}, r, {0, 0}, 0,
+                       WHITE);
+        if (jugar) {
+            drawBotonJugar(hoverJugar);
+        } else {
+            drawBotonSalir(hoverSalir);
+        }
+        terminarCache();
+        regionesRedibujadas++;
+    }
+    
+    // Compone el menú en texturas la primera vez que se dibuja con los recursos ya cargados
+    bool prepararCache() {
+        if (compuesto) return true;
+        if (cacheFallida || !textureManager.areTexturesLoaded()) return false;
+        fondoFijo = LoadRenderTexture(anchoCache, altoCache);
+        composicion = LoadRenderTexture(anchoCache, altoCache);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(fondoFijo) +
+                                                    ContabilidadMemoria::bytesTexturaRender(composicion));
+        if (fondoFijo.id == 0 || composicion.id == 0) {
+            descargar();
+            cacheFallida = true;
+            logger.write("⚠️  Advertencia: sin texturas de render para el menú, se dibuja cada frame");
+            return false;
+        }
+        comenzarCache(fondoFijo);
+        ClearBackground(RAYWHITE);
+        drawFondoFijo();
+        terminarCache();
+        
+        Vector2 raton = GetMousePosition();
+        hoverJugar = CheckCollisionPointRec(raton, playButton);
+        hoverSalir = CheckCollisionPointRec(raton, exitButton);
+        comenzarCache(composicion);
+        DrawTexturePro(fondoFijo.texture, fuenteCompleta(fondoFijo), pantallaVirtual(), {0, 0}, 0, WHITE);
+        drawBotonJugar(hoverJugar);
+        drawBotonSalir(hoverSalir);
+        terminarCache();
+        compuesto = true;
+        logger.write("🖼️  Menú compuesto en caché");
+        return true;
+    }
+    
+    static Rectangle fuenteCompleta(const RenderTexture2D& rt) {
+        return {0, 0, static_cast<float>(rt.texture.width), -static_cast<float>(rt.texture.height)};
+    }
+    
+    static Rectangle pantallaVirtual() {
+        return {0, 0, static_cast<float>(GameConstants::SCREEN_WIDTH), static_cast<float>(GameConstants::SCREEN_HEIGHT)};
+    }
+    
+public:
+    MenuSystem(TextureManager& tm, AudioSystem& audio, RenderSystem& rs) : textureManager(tm), audioSystem(audio), renderSystem(rs) {
+        playButton = { GameConstants::SCREEN_WIDTH/2 - 100, GameConstants::SCREEN_HEIGHT/2, 200, 50 };
+        exitButton = { GameConstants::SCREEN_WIDTH/2 - 100, GameConstants::SCREEN_HEIGHT/2 + 70, 200, 50 };
+    }
+    
+    // Tamaño interno y escala del lienzo en que se dibuja el menú; si cambian, la caché se
+    // vuelve a componer
+    void setResolucion(int ancho, int alto, float escala) {
+        if (ancho == anchoCache && alto == altoCache && escala == escalaCache) return;
+        descargar();
+        cacheFallida = false;
+        anchoCache = ancho;
+        altoCache = alto;
+        escalaCache = escala;
+    }
+    
+    // Antes de BeginDrawing (usa sus propias texturas de render): compone la caché la primera
+    // vez y redibuja solo el botón cuyo hover ha cambiado
+    void actualizarCache() {
+        if (!prepararCache()) return;
+        Vector2 raton = GetMousePosition();
+        bool jugar = CheckCollisionPointRec(raton, playButton);
+        bool salir = CheckCollisionPointRec(raton, exitButton);
+        if (jugar != hoverJugar) {
+            hoverJugar = jugar;
+            redibujarBoton(true);
+        }
+        if (salir != hoverSalir) {
+            hoverSalir = salir;
+            redibujarBoton(false);
+        }
+    }
+    
+    // Un quad con la composición; sin caché, el menú entero
+    void draw() {
+        if (!compuesto) {
+            drawInmediato();
+            return;
+        }
+        DrawTexturePro(composicion.texture, fuenteCompleta(composicion), pantallaVirtual(), {0, 0}, 0, WHITE);
+    }
+    
+    // Todo el menú desde cero (sin caché, y como referencia en --bench-menu)
+    void drawInmediato() {
+        Vector2 raton = GetMousePosition();
+        drawFondoFijo();
+        drawBotonJugar(CheckCollisionPointRec(raton, playButton));
+        drawBotonSalir(CheckCollisionPointRec(raton, exitButton));
+    }
+    
+    // Reposo: nada de ratón, teclado ni rueda durante MENU_SEGUNDOS_REPOSO
+    bool enReposo() {
+        bool actividad = GetMouseDelta().x != 0.0f || GetMouseDelta().y != 0.0f || GetMouseWheelMove() != 0.0f ||
+                         IsMouseButtonDown(MOUSE_LEFT_BUTTON) || IsMouseButtonDown(MOUSE_RIGHT_BUTTON) ||
+                         GetKeyPressed() != 0;
+        double ahora = GetTime();
+        if (actividad) ultimaActividad = ahora;
+        return ahora - ultimaActividad > GameConstants::MENU_SEGUNDOS_REPOSO;
+    }
+    
+    int getRegionesRedibujadas() const { return regionesRedibujadas; }
+    
+    void descargar() {
+        ContabilidadMemoria::liberaGPU(MEM_RENDER, ContabilidadMemoria::bytesTexturaRender(fondoFijo) +
+                                                   ContabilidadMemoria::bytesTexturaRender(composicion));
+        if (fondoFijo.id != 0) UnloadRenderTexture(fondoFijo);
+        if (composicion.id != 0) UnloadRenderTexture(composicion);
+        fondoFijo = RenderTexture2D{};
+        composicion = RenderTexture2D{};
+        compuesto = false;
+    }
+    
     bool isPlayButtonPressed() {
         Vector2 mousePoint = GetMousePosition();
         bool pressed = CheckCollisionPointRec(mousePoint, playButton) && 
@@ -1315,227 +2331,2550 @@ public:
         int milliseconds = static_cast<int>((totalTime - static_cast<int>(totalTime)) * 100);
         
         // Formatear el texto
-        char timeBuffer[32];
-        snprintf(timeBuffer, sizeof(timeBuffer), "TIEMPO TOTAL: %02d:%02d:%02d", 
-                minutes, seconds, milliseconds);
+        const char* timeText = arenaFrame.formatear("TIEMPO TOTAL: %02d:%02d:%02d", minutes, seconds, milliseconds);
+        
+        // POSICIÓN: Debajo del botón SALIR
+        float posY = exitButton.y + exitButton.height + 20;
+        float posX = GameConstants::SCREEN_WIDTH/2;
+        
+        // Tamaño de fuente
+        float fontSize = 24.0f;
+        
+        // Usar spaceranger.ttf
+        renderSystem.drawSpacerangerText(timeText, 
+            Vector2{posX, posY}, 
+            fontSize, 
+            GOLD,
+            BLACK);
+        
+        // Mensaje de felicitación (opcional)
+        const char* congratsText = "¡FELICIDADES!";
+        float congratsFontSize = 28.0f;
+        float congratsY = posY - 40;
+        
+        renderSystem.drawSpacerangerText(congratsText, 
+            Vector2{posX, congratsY}, 
+            congratsFontSize, 
+            GOLD,
+            BLACK);
+    }
+};
+
+// Pistas de dirección (tecla I): flecha hacia el siguiente paso óptimo de cada jugador.
+// Los campos de distancia de un nivel se calculan en un hilo al cargarlo y se guardan;
+// mientras no están listos simplemente no se dibuja nada.
+class SistemaPistas {
+private:
+    std::array<std::unique_ptr<CamposDistancia>, GameConstants::TOTAL_LEVELS> campos;
+    std::array<std::atomic<bool>, GameConstants::TOTAL_LEVELS> listos{};
+    std::thread calculo;
+    int nivelPedido = -1;
+    bool visibles = false;
+    
+    void drawFlecha(Vector2 centro, DireccionPista dir, Color color) {
+        Vector2 d = {0, 0};
+        switch (dir) {
+            case PISTA_IZQ: d = {-1, 0}; break;
+            case PISTA_DER: d = {1, 0}; break;
+            case PISTA_ARR: d = {0, -1}; break;
+            case PISTA_ABA: d = {0, 1}; break;
+            default: return;
+        }
+        const float r = static_cast<float>(GameConstants::PLAYER_RADIUS);
+        Vector2 base = {centro.x + d.x * (r + 4), centro.y + d.y * (r + 4)};
+        Vector2 punta = {centro.x + d.x * (r + 16), centro.y + d.y * (r + 16)};
+        Vector2 ala1 = {base.x - d.y * 8, base.y + d.x * 8};
+        Vector2 ala2 = {base.x + d.y * 8, base.y - d.x * 8};
+        // raylib espera los vértices en sentido antihorario en pantalla (producto cruzado negativo)
+        float cruz = (ala1.x - punta.x) * (ala2.y - punta.y) - (ala1.y - punta.y) * (ala2.x - punta.x);
+        if (cruz > 0) std::swap(ala1, ala2);
+        DrawTriangle(punta, ala1, ala2, Fade(color, 0.85f));
+    }
+    
+public:
+    ~SistemaPistas() {
+        if (calculo.joinable()) calculo.join();
+    }
+    
+    void toggle() {
+        visibles = !visibles;
+    }
+    
+    // Se llama cada frame de juego; solo lanza el cálculo la primera vez que se ve un nivel
+    void prepararNivel(int nivel) {
+        if (nivel == nivelPedido || nivel < 0 || nivel >= GameConstants::TOTAL_LEVELS) return;
+        nivelPedido = nivel;
+        if (campos[nivel]) return;
+        
+        // El cálculo anterior dura menos de un milisegundo
+        if (calculo.joinable()) calculo.join();
+        campos[nivel] = std::make_unique<CamposDistancia>();
+        calculo = std::thread([this, nivel]() {
+            auto inicio = std::chrono::steady_clock::now();
+            MapaNivel mapa;
+            SimEstado sim;
+            SimulacionFija::cargarNivel(nivel, mapa, sim);
+            campos[nivel]->calcular(mapa);
+            listos[nivel].store(true, std::memory_order_release);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+            logger.write("🧭 Campos de distancia del nivel " + std::to_string(nivel + 1) + " en " +
+                         std::to_string(ms) + " ms");
+        });
+    }
+    
+    void draw(GameState& state) {
+        int nivel = state.currentLevel.load();
+        if (!visibles || nivel < 0 || nivel >= GameConstants::TOTAL_LEVELS) return;
+        if (!listos[nivel].load(std::memory_order_acquire)) return;
+        const CamposDistancia& c = *campos[nivel];
+        
+        Vector2 master, slave;
+        {
+            std::lock_guard<std::mutex> lock(state.mtx);
+            master = state.masterPos;
+            slave = state.slavePos;
+        }
+        uint8_t botones = state.botonesBasicos();
+        int celdaMaster = CamposDistancia::celdaDe(master);
+        int celdaSlave = CamposDistancia::celdaDe(slave);
+        
+        CamposDistancia::Objetivo objMaster = c.objetivoPara(true, celdaMaster, celdaSlave, botones);
+        if (objMaster != CamposDistancia::NUM_OBJETIVOS) {
+            drawFlecha(master, c.direccion(objMaster, true, botones, celdaMaster), RED);
+        }
+        CamposDistancia::Objetivo objSlave = c.objetivoPara(false, celdaSlave, celdaMaster, botones);
+        if (objSlave != CamposDistancia::NUM_OBJETIVOS) {
+            drawFlecha(slave, c.direccion(objSlave, false, botones, celdaSlave), BLUE);
+        }
+    }
+};
+
+// NUEVO: Sistema de niveles expandido
+class LevelSystem {
+public:
+    static void initializeLevel(GameState& state, int level) {
+        // Resetear estados
+        state.canales = 0;
+        state.masterInGoal = false;
+        state.slaveInGoal = false;
+        state.bothInGoal = false;
+        state.levelCompleted = false;
+        
+        // Los mapas están en simulacion.h (DATOS_NIVELES); fuera de rango se carga el primero
+        SimEstado inicial;
+        {
+            std::lock_guard<std::mutex> lock(state.mtx);
+            SimulacionFija::cargarNivel(level, state.laberinto, inicial);
+            state.masterPos = inicial.masterPos;
+            state.slavePos = inicial.slavePos;
+        }
+        state.currentLevel = level;
+        
+        logger.write("🎮 Nivel " + std::to_string(level) + " cargado");
+    }
+};
+
+// ============================================================================
+// Modo en red: cooperativo online por UDP con predicción en el cliente
+// ============================================================================
+// El host es autoritativo y controla al master; el cliente controla al slave.
+// Ambos ejecutan SimulacionFija a 100 ticks/s (un tick = PHYSICS_UPDATE_RATE):
+//  - El cliente muestrea un input por tick, lo aplica al momento (predicción) y
+//    manda los últimos INPUTS_POR_PAQUETE inputs cada 3 ticks (redundancia ante pérdidas).
+//  - El host consume los inputs del cliente en orden de secuencia y manda un
+//    snapshot cada 5 ticks (20 Hz) con el último input del cliente que ya procesó.
+//  - Al recibir un snapshot el cliente parte de la posición autoritativa del slave
+//    y vuelve a aplicar los inputs aún no confirmados (reconciliación). El error
+//    residual se reparte en unos frames para que no se vea un salto.
+//  - El master se dibuja en el cliente interpolado ~100 ms por detrás del host.
+// Contra el servidor dedicado el cliente puede recibir el master: predice al suyo
+// e interpola al otro. Constantes y paquetes en protocolo_red.h.
+
+// Transporte de datagramas. ahoraMs solo lo usa el enlace con latencia simulada.
+class CanalRed {
+public:
+    virtual ~CanalRed() = default;
+    virtual void enviar(const void* datos, int bytes, double ahoraMs) = 0;
+    virtual int recibir(void* buffer, int capacidad, double ahoraMs) = 0;
+};
+
+// Socket UDP no bloqueante con un único par remoto (el host lo aprende del primer paquete)
+class CanalUDP : public CanalRed {
+private:
+#ifdef _WIN32
+    SOCKET sock = INVALID_SOCKET;
+    static bool valido(SOCKET s) { return s != INVALID_SOCKET; }
+#else
+    int sock = -1;
+    static bool valido(int s) { return s >= 0; }
+#endif
+    sockaddr_in remoto{};
+    bool conRemoto = false;
+    
+public:
+    CanalUDP() {
+#ifdef _WIN32
+        WSADATA wsa;
+        WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    }
+    
+    ~CanalUDP() override {
+        if (valido(sock)) {
+#ifdef _WIN32
+            closesocket(sock);
+#else
+            close(sock);
+#endif
+        }
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+    
+    // puertoLocal = 0 deja que el sistema elija uno (cliente)
+    bool abrir(uint16_t puertoLocal) {
+        sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (!valido(sock)) return false;
+        
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        local.sin_port = htons(puertoLocal);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) return false;
+        
+#ifdef _WIN32
+        u_long noBloqueante = 1;
+        ioctlsocket(sock, FIONBIO, &noBloqueante);
+#else
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+        return true;
+    }
+    
+    bool conectarA(const char* ip, uint16_t puerto) {
+        remoto = sockaddr_in{};
+        remoto.sin_family = AF_INET;
+        remoto.sin_port = htons(puerto);
+        conRemoto = inet_pton(AF_INET, ip, &remoto.sin_addr) == 1;
+        return conRemoto;
+    }
+    
+    void enviar(const void* datos, int bytes, double) override {
+        if (!conRemoto) return;
+        sendto(sock, static_cast<const char*>(datos), bytes, 0,
+               reinterpret_cast<const sockaddr*>(&remoto), sizeof(remoto));
+    }
+    
+    int recibir(void* buffer, int capacidad, double) override {
+        sockaddr_in origen{};
+        socklen_t tamOrigen = sizeof(origen);
+        int bytes = static_cast<int>(recvfrom(sock, static_cast<char*>(buffer), capacidad, 0,
+                                              reinterpret_cast<sockaddr*>(&origen), &tamOrigen));
+        if (bytes <= 0) return -1;
+        // El primer par que habla queda como remoto; el resto se ignora
+        if (!conRemoto) {
+            remoto = origen;
+            conRemoto = true;
+        } else if (origen.sin_addr.s_addr != remoto.sin_addr.s_addr || origen.sin_port != remoto.sin_port) {
+            return -1;
+        }
+        return bytes;
+    }
+};
+
+// Cola de datagramas en memoria (un sentido), para la prueba en loopback
+struct TuberiaMemoria {
+    std::deque<std::vector<uint8_t>> paquetes;
+};
+
+class CanalMemoria : public CanalRed {
+private:
+    TuberiaMemoria& salida;
+    TuberiaMemoria& entrada;
+    
+public:
+    CanalMemoria(TuberiaMemoria& salida, TuberiaMemoria& entrada) : salida(salida), entrada(entrada) {}
+    
+    void enviar(const void* datos, int bytes, double) override {
+        const uint8_t* p = static_cast<const uint8_t*>(datos);
+        salida.paquetes.emplace_back(p, p + bytes);
+    }
+    
+    int recibir(void* buffer, int capacidad, double) override {
+        if (entrada.paquetes.empty()) return -1;
+        std::vector<uint8_t>& p = entrada.paquetes.front();
+        int bytes = std::min(capacidad, static_cast<int>(p.size()));
+        std::memcpy(buffer, p.data(), bytes);
+        entrada.paquetes.pop_front();
+        return bytes;
+    }
+};
+
+// Envuelve otro canal añadiendo latencia de ida, jitter y pérdida (al enviar).
+// Los paquetes retenidos salen al llamar a enviar/recibir, así que basta con
+// que el juego siga sondeando el canal. Puede desordenar paquetes, como UDP.
+class CanalConPerdidas : public CanalRed {
+private:
+    struct Retenido {
+        double salidaMs;
+        std::vector<uint8_t> datos;
+    };
+    
+    CanalRed& interno;
+    double latenciaMs;
+    double jitterMs;
+    float perdida;
+    uint32_t semilla;
+    std::vector<Retenido> retenidos;
+    
+    // xorshift32: determinista para que la prueba sea reproducible
+    float aleatorio() {
+        semilla ^= semilla << 13;
+        semilla ^= semilla >> 17;
+        semilla ^= semilla << 5;
+        return (semilla & 0xFFFFFF) / static_cast<float>(0x1000000);
+    }
+    
+    void liberar(double ahoraMs) {
+        for (size_t i = 0; i < retenidos.size();) {
+            if (retenidos[i].salidaMs <= ahoraMs) {
+                interno.enviar(retenidos[i].datos.data(), static_cast<int>(retenidos[i].datos.size()), ahoraMs);
+                retenidos[i] = std::move(retenidos.back());
+                retenidos.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    
+public:
+    CanalConPerdidas(CanalRed& interno, double latenciaMs, double jitterMs, float perdida, uint32_t semilla)
+        : interno(interno), latenciaMs(latenciaMs), jitterMs(jitterMs), perdida(perdida),
+          semilla(semilla != 0 ? semilla : 1) {}
+    
+    void enviar(const void* datos, int bytes, double ahoraMs) override {
+        liberar(ahoraMs);
+        if (aleatorio() < perdida) return;
+        const uint8_t* p = static_cast<const uint8_t*>(datos);
+        double retardo = std::max(0.0, latenciaMs + (aleatorio() * 2.0 - 1.0) * jitterMs);
+        retenidos.push_back({ahoraMs + retardo, std::vector<uint8_t>(p, p + bytes)});
+    }
+    
+    int recibir(void* buffer, int capacidad, double ahoraMs) override {
+        liberar(ahoraMs);
+        return interno.recibir(buffer, capacidad, ahoraMs);
+    }
+};
+
+// Base de las sesiones online (un extremo). No toca ventana ni teclado: recibe el input
+// local ya muestreado y el reloj, así las pruebas en loopback pueden usar un reloj virtual.
+// Se encarga del saludo inicial, el timeout, el tráfico y de volcar el resultado en GameState.
+class SesionOnline {
+public:
+    enum Rol { HOST, CLIENTE };
+    enum Fase { ESPERANDO, JUGANDO, TERMINADA, DESCONECTADA };
+    
+    struct Trafico {
+        uint64_t bytesEnviados = 0;         // Incluye cabeceras UDP/IP
+        uint64_t bytesRecibidos = 0;
+        uint32_t paquetesEnviados = 0;
+        uint32_t paquetesRecibidos = 0;
+    };
+    
+    virtual ~SesionOnline() = default;
+    
+    // Avanza la sesión hasta ahoraMs; inputLocal es el del jugador de esta máquina
+    virtual void actualizar(double ahoraMs, uint8_t inputLocal) = 0;
+    // Host: pasa al siguiente nivel (o termina la partida) si el actual está completado
+    virtual void avanzarNivel(double ahoraMs) = 0;
+    // Copia el estado a GameState para RenderSystem y dispara los SFX por flanco
+    virtual void aplicarAEstado(GameState& state, AudioSystem& audio) const = 0;
+    
+    Rol getRol() const { return rol; }
+    Fase getFase() const { return fase; }
+    const Trafico& getTrafico() const { return trafico; }
+    
+protected:
+    Rol rol;
+    Fase fase = ESPERANDO;
+    CanalRed& canal;
+    Trafico trafico;
+    double ultimoRecibidoMs = 0.0;
+    double ultimoHolaMs = -1e9;
+    bool localEsMaster = false;         // Cliente: rol asignado en la bienvenida
+    
+    SesionOnline(Rol rol, CanalRed& canal) : rol(rol), canal(canal) {}
+    
+    // Se llama una vez al quedar conectados (en el cliente, con el nivel del host)
+    virtual void alConectar(int nivel) = 0;
+    
+    void enviar(const void* datos, int bytes, double ahoraMs) {
+        canal.enviar(datos, bytes, ahoraMs);
+        trafico.bytesEnviados += bytes + RedConstants::CABECERA_UDP_IP;
+        trafico.paquetesEnviados++;
+    }
+    
+    int recibir(uint8_t* buffer, int capacidad, double ahoraMs) {
+        int bytes = canal.recibir(buffer, capacidad, ahoraMs);
+        if (bytes > 0) {
+            trafico.bytesRecibidos += bytes + RedConstants::CABECERA_UDP_IP;
+            trafico.paquetesRecibidos++;
+            ultimoRecibidoMs = ahoraMs;
+        }
+        return bytes;
+    }
+    
+    // HOLA/BIENVENIDA; devuelve true si el paquete era de control
+    bool procesarControl(const uint8_t* buffer, int bytes, double ahoraMs, int nivelActual) {
+        if (bytes < static_cast<int>(sizeof(PaqueteControl))) return false;
+        if (buffer[0] == MSG_HOLA) {
+            if (rol == HOST) {
+                PaqueteControl bienvenida{MSG_BIENVENIDA, static_cast<uint8_t>(nivelActual), 0, 0};
+                enviar(&bienvenida, sizeof(bienvenida), ahoraMs);
+                if (fase == ESPERANDO) {
+                    fase = JUGANDO;
+                    alConectar(nivelActual);
+                    logger.write("🌐 Jugador remoto conectado");
+                }
+            }
+            return true;
+        }
+        if (buffer[0] == MSG_BIENVENIDA) {
+            if (rol == CLIENTE && fase == ESPERANDO) {
+                PaqueteControl p;
+                std::memcpy(&p, buffer, sizeof(p));
+                fase = JUGANDO;
+                localEsMaster = p.rol == 1;
+                alConectar(p.nivel);
+                logger.write(localEsMaster ? "🌐 Conectado (controlas al master)" : "🌐 Conectado al host");
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    // Mientras se espera: el cliente repite HOLA. Devuelve true si hay que seguir esperando.
+    bool esperarConexion(double ahoraMs) {
+        if (fase != ESPERANDO) return false;
+        if (rol == CLIENTE && ahoraMs - ultimoHolaMs >= RedConstants::INTERVALO_HOLA_MS) {
+            PaqueteControl hola{MSG_HOLA, 0, 0, 0};
+            enviar(&hola, sizeof(hola), ahoraMs);
+            ultimoHolaMs = ahoraMs;
+        }
+        ultimoRecibidoMs = ahoraMs;
+        return true;
+    }
+    
+    bool comprobarTimeout(double ahoraMs) {
+        if (fase == JUGANDO && ahoraMs - ultimoRecibidoMs > RedConstants::TIMEOUT_MS) {
+            fase = DESCONECTADA;
+            logger.write("🌐 Conexión perdida (sin paquetes en " +
+                         std::to_string(static_cast<int>(RedConstants::TIMEOUT_MS)) + " ms)");
+            return true;
+        }
+        return false;
+    }
+    
+    static void volcarEstado(GameState& state, AudioSystem& audio, const SimEstado& sim,
+                             Vector2 masterPos, Vector2 slavePos, const MapaNivel& laberinto) {
+        if (sim.canales & ~state.canales.load()) {
+            audio.playDoorOpen();
+        }
+        if (sim.completado && !state.levelCompleted) {
+            audio.playLevelComplete();
+            logger.writef("✅ Nivel %d completado!", static_cast<int>(sim.nivel));
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(state.mtx);
+            state.masterPos = masterPos;
+            state.slavePos = slavePos;
+            state.laberinto = laberinto;
+        }
+        state.currentLevel = sim.nivel;
+        state.canales = sim.canales;
+        state.masterInGoal = (sim.metas & BIT_META_MASTER) != 0;
+        state.slaveInGoal = (sim.metas & BIT_META_SLAVE) != 0;
+        state.bothInGoal = state.masterInGoal && state.slaveInGoal;
+        state.levelCompleted = sim.completado;
+    }
+};
+
+// Sesión cliente-servidor: host autoritativo y predicción con reconciliación en el cliente
+class SesionRed : public SesionOnline {
+public:
+    struct Estadisticas {
+        uint32_t correcciones = 0;          // Reconciliaciones con error distinto de cero
+        uint32_t inputsPerdidos = 0;        // Huecos que ni la redundancia cubrió (host)
+        double errorMaximo = 0.0;           // px
+        double errorAcumulado = 0.0;
+    };
+    
+private:
+    struct SnapshotRemoto {
+        uint32_t tick;
+        Vector2 pos;
+    };
+    
+    MapaNivel laberinto{};
+    SimEstado sim;
+    double acumuladoMs = 0.0;
+    double ultimoActualizarMs = 0.0;
+    bool relojIniciado = false;
+    Estadisticas stats;
+    
+    // Host: inputs del cliente indexados por secuencia
+    std::array<uint8_t, RedConstants::HISTORIAL_INPUTS> inputsCliente{};
+    uint32_t inputsRecibidosHasta = 0;  // Última secuencia recibida
+    uint32_t inputsProcesadosHasta = 0; // Última secuencia aplicada al slave
+    
+    // Cliente: predicción, historial propio y snapshots del otro jugador
+    std::array<uint8_t, RedConstants::HISTORIAL_INPUTS> historial{};
+    uint32_t secuencia = 0;
+    uint32_t ultimoTickSnapshot = 0;
+    bool haySnapshot = false;
+    Vector2 errorVisual{0, 0};
+    std::array<SnapshotRemoto, RedConstants::SNAPSHOTS_INTERPOLACION> snapshots{};
+    int numSnapshots = 0;
+    double tickServidorEstimado = 0.0;
+    
+    static constexpr uint32_t MASCARA = RedConstants::HISTORIAL_INPUTS - 1;
+    static constexpr uint8_t BIT_COMPLETADO = 0x80;
+    
+    // El tick sigue corriendo entre niveles: el cliente descarta snapshots con tick viejo
+    void cargarNivel(int nivel) {
+        uint32_t tick = sim.tick;
+        SimulacionFija::cargarNivel(nivel, laberinto, sim);
+        sim.tick = tick;
+    }
+    
+    void alConectar(int nivel) override {
+        if (rol == CLIENTE) cargarNivel(nivel);
+    }
+    
+    void procesarPaquetes(double ahoraMs) {
+        uint8_t buffer[64];
+        int bytes;
+        while ((bytes = recibir(buffer, sizeof(buffer), ahoraMs)) > 0) {
+            if (procesarControl(buffer, bytes, ahoraMs, sim.nivel)) continue;
+            
+            if (buffer[0] == MSG_INPUT && rol == HOST && bytes == static_cast<int>(sizeof(PaqueteInput))) {
+                PaqueteInput p;
+                std::memcpy(&p, buffer, sizeof(p));
+                recibirInputs(p);
+            } else if (buffer[0] == MSG_ESTADO && rol == CLIENTE && fase == JUGANDO &&
+                       bytes == static_cast<int>(sizeof(PaqueteEstado))) {
+                PaqueteEstado p;
+                std::memcpy(&p, buffer, sizeof(p));
+                recibirEstado(p);
+            }
+        }
+    }
+    
+    // ---- Host ----
+    void recibirInputs(const PaqueteInput& p) {
+        int cantidad = std::min<int>(p.cantidad, RedConstants::INPUTS_POR_PAQUETE);
+        uint32_t primera = p.ultimaSecuencia - cantidad + 1;
+        for (int i = 0; i < cantidad; i++) {
+            uint32_t seq = primera + i;
+            if (seq > inputsProcesadosHasta) {
+                inputsCliente[seq & MASCARA] = p.inputs[i];
+            }
+        }
+        if (p.ultimaSecuencia > inputsRecibidosHasta) {
+            // Hueco que la redundancia no cubre: esos inputs se dan por perdidos
+            if (primera > inputsRecibidosHasta + 1) {
+                stats.inputsPerdidos += primera - inputsRecibidosHasta - 1;
+                inputsProcesadosHasta = std::max(inputsProcesadosHasta, primera - 1);
+            }
+            inputsRecibidosHasta = p.ultimaSecuencia;
+        }
+    }
+    
+    void tickHost(uint8_t inputLocal, double ahoraMs) {
+        // Un input del cliente por tick; si se acumulan (ráfagas, jitter) se consume uno extra
+        uint8_t inputSlave = 0;
+        uint32_t pendientes = inputsRecibidosHasta - inputsProcesadosHasta;
+        int aConsumir = pendientes == 0 ? 0 : (pendientes > 2 * RedConstants::TICKS_ENTRE_INPUTS ? 2 : 1);
+        
+        const MetadatosNivel& meta = metadatosNivel(sim.nivel);
+        sim.masterPos = SimulacionFija::moverJugador(sim.masterPos, inputLocal, true, laberinto, sim.canales, meta);
+        for (int i = 0; i < aConsumir; i++) {
+            inputsProcesadosHasta++;
+            inputSlave = inputsCliente[inputsProcesadosHasta & MASCARA];
+            sim.slavePos = SimulacionFija::moverJugador(sim.slavePos, inputSlave, false, laberinto, sim.canales, meta);
+        }
+        ReglasJuego::evaluar(laberinto, sim.masterPos, sim.slavePos, sim.canales, sim.metas, meta);
+        if (sim.metas == (BIT_META_MASTER | BIT_META_SLAVE)) sim.completado = true;
+        sim.tick++;
+        
+        if (sim.tick % RedConstants::TICKS_ENTRE_SNAPSHOTS == 0) {
+            enviarEstado(ahoraMs);
+        }
+    }
+    
+    void enviarEstado(double ahoraMs) {
+        PaqueteEstado p{};
+        p.tipo = MSG_ESTADO;
+        p.nivel = sim.nivel;
+        p.canales = sim.canales;
+        p.metas = sim.metas | (sim.completado ? BIT_COMPLETADO : 0);
+        p.tick = sim.tick;
+        p.ultimoInputCliente = inputsProcesadosHasta;
+        p.masterX = static_cast<int16_t>(std::lround(sim.masterPos.x));
+        p.masterY = static_cast<int16_t>(std::lround(sim.masterPos.y));
+        p.slaveX = static_cast<int16_t>(std::lround(sim.slavePos.x));
+        p.slaveY = static_cast<int16_t>(std::lround(sim.slavePos.y));
+        enviar(&p, sizeof(p), ahoraMs);
+    }
+    
+    // ---- Cliente ----
+    // Los botones que el jugador local activa él solo también se predicen, pero solo los
+    // enclavados: no se desactivan dentro de un nivel, así que la predicción nunca hay que
+    // deshacerla. Los momentáneos y los de dos jugadores esperan al snapshot.
+    Vector2 predecirLocal(Vector2 pos, uint8_t input) {
+        const MetadatosNivel& meta = metadatosNivel(sim.nivel);
+        pos = SimulacionFija::moverJugador(pos, input, localEsMaster, laberinto, sim.canales, meta);
+        int tile = ReglasJuego::tileEn(laberinto, pos);
+        sim.canales |= ReglasJuego::pulsaSolo(meta, tile, localEsMaster ? ROL_MASTER : ROL_SLAVE) & meta.enclavados;
+        return pos;
+    }
+    
+    Vector2& posLocal() { return localEsMaster ? sim.masterPos : sim.slavePos; }
+    const Vector2& posLocal() const { return localEsMaster ? sim.masterPos : sim.slavePos; }
+    
+    void tickCliente(uint8_t inputLocal, double ahoraMs) {
+        secuencia++;
+        historial[secuencia & MASCARA] = inputLocal;
+        posLocal() = predecirLocal(posLocal(), inputLocal);
+        sim.tick++;
+        
+        if (secuencia % RedConstants::TICKS_ENTRE_INPUTS == 0) {
+            PaqueteInput p{};
+            p.tipo = MSG_INPUT;
+            p.cantidad = static_cast<uint8_t>(std::min<uint32_t>(secuencia, RedConstants::INPUTS_POR_PAQUETE));
+            p.ultimaSecuencia = secuencia;
+            for (int i = 0; i < p.cantidad; i++) {
+                p.inputs[i] = historial[(secuencia - p.cantidad + 1 + i) & MASCARA];
+            }
+            enviar(&p, sizeof(p), ahoraMs);
+        }
+    }
+    
+    void recibirEstado(const PaqueteEstado& p) {
+        // UDP puede desordenar: los snapshots viejos se descartan
+        if (haySnapshot && p.tick <= ultimoTickSnapshot) return;
+        
+        if (p.nivel != sim.nivel) {
+            if (p.nivel >= GameConstants::TOTAL_LEVELS) {
+                fase = TERMINADA;
+                return;
+            }
+            cargarNivel(p.nivel);
+            numSnapshots = 0;
+            errorVisual = {0, 0};
+        }
+        haySnapshot = true;
+        ultimoTickSnapshot = p.tick;
+        tickServidorEstimado = p.tick;
+        
+        // Los canales enclavados predichos se conservan; el resto manda el servidor
+        sim.canales = p.canales | (sim.canales & metadatosNivel(sim.nivel).enclavados);
+        sim.metas = p.metas & ~BIT_COMPLETADO;
+        sim.completado = (p.metas & BIT_COMPLETADO) != 0;
+        
+        Vector2 master = {static_cast<float>(p.masterX), static_cast<float>(p.masterY)};
+        Vector2 slave = {static_cast<float>(p.slaveX), static_cast<float>(p.slaveY)};
+        
+        // El otro jugador: al buffer de interpolación
+        if (numSnapshots == RedConstants::SNAPSHOTS_INTERPOLACION) {
+            std::move(snapshots.begin() + 1, snapshots.end(), snapshots.begin());
+            numSnapshots--;
+        }
+        snapshots[numSnapshots++] = {p.tick, localEsMaster ? slave : master};
+        
+        // El propio: reconciliar desde la posición autoritativa
+        if (p.ultimoInputCliente > secuencia) return;
+        Vector2 prediccion = posLocal();
+        Vector2 corregida = localEsMaster ? master : slave;
+        uint32_t pendientes = std::min<uint32_t>(secuencia - p.ultimoInputCliente, RedConstants::HISTORIAL_INPUTS - 1);
+        for (uint32_t seq = secuencia - pendientes + 1; seq <= secuencia; seq++) {
+            corregida = predecirLocal(corregida, historial[seq & MASCARA]);
+        }
+        
+        float dx = prediccion.x - corregida.x;
+        float dy = prediccion.y - corregida.y;
+        if (dx != 0.0f || dy != 0.0f) {
+            double error = std::sqrt(dx * dx + dy * dy);
+            stats.correcciones++;
+            stats.errorAcumulado += error;
+            stats.errorMaximo = std::max(stats.errorMaximo, error);
+            
+            // Saltos grandes (cambio de nivel, pérdida larga) no se suavizan
+            if (error < GameConstants::TILE_SIZE * 2) {
+                errorVisual.x += dx;
+                errorVisual.y += dy;
+            } else {
+                errorVisual = {0, 0};
+            }
+        }
+        posLocal() = corregida;
+    }
+    
+    Vector2 remotoInterpolado() const {
+        if (numSnapshots == 0) return localEsMaster ? sim.slavePos : sim.masterPos;
+        double tickRender = tickServidorEstimado - RedConstants::RETARDO_INTERPOLACION_MS / GameConstants::PHYSICS_UPDATE_RATE;
+        if (tickRender <= snapshots[0].tick) return snapshots[0].pos;
+        for (int i = 1; i < numSnapshots; i++) {
+            if (tickRender <= snapshots[i].tick) {
+                const SnapshotRemoto& a = snapshots[i - 1];
+                const SnapshotRemoto& b = snapshots[i];
+                float t = static_cast<float>((tickRender - a.tick) / static_cast<double>(b.tick - a.tick));
+                return {a.pos.x + (b.pos.x - a.pos.x) * t, a.pos.y + (b.pos.y - a.pos.y) * t};
+            }
+        }
+        return snapshots[numSnapshots - 1].pos;
+    }
+    
+public:
+    SesionRed(Rol rol, CanalRed& canal) : SesionOnline(rol, canal) {
+        cargarNivel(0);
+    }
+    
+    void actualizar(double ahoraMs, uint8_t inputLocal) override {
+        if (!relojIniciado) {
+            relojIniciado = true;
+            ultimoActualizarMs = ahoraMs;
+            ultimoRecibidoMs = ahoraMs;
+        }
+        double deltaMs = ahoraMs - ultimoActualizarMs;
+        ultimoActualizarMs = ahoraMs;
+        
+        procesarPaquetes(ahoraMs);
+        if (esperarConexion(ahoraMs) || fase != JUGANDO || comprobarTimeout(ahoraMs)) return;
+        
+        acumuladoMs += deltaMs;
+        int ticks = 0;
+        while (acumuladoMs >= GameConstants::PHYSICS_UPDATE_RATE && ticks < RedConstants::MAX_TICKS_POR_FRAME) {
+            acumuladoMs -= GameConstants::PHYSICS_UPDATE_RATE;
+            if (rol == HOST) tickHost(inputLocal, ahoraMs);
+            else tickCliente(inputLocal, ahoraMs);
+            ticks++;
+        }
+        if (ticks == RedConstants::MAX_TICKS_POR_FRAME) acumuladoMs = 0.0;
+        
+        if (rol == CLIENTE) {
+            tickServidorEstimado += deltaMs / GameConstants::PHYSICS_UPDATE_RATE;
+            // El error de reconciliación se desvanece exponencialmente
+            float factor = static_cast<float>(std::exp(-deltaMs / RedConstants::SUAVIZADO_ERROR_MS));
+            errorVisual.x *= factor;
+            errorVisual.y *= factor;
+        }
+    }
+    
+    void avanzarNivel(double ahoraMs) override {
+        if (rol != HOST || !sim.completado) return;
+        int siguiente = sim.nivel + 1;
+        if (siguiente < GameConstants::TOTAL_LEVELS) {
+            cargarNivel(siguiente);
+        } else {
+            sim.nivel = static_cast<uint8_t>(siguiente);
+            fase = TERMINADA;
+        }
+        // Lo que el cliente mandó antes del cambio ya no aplica al nuevo nivel
+        inputsProcesadosHasta = inputsRecibidosHasta;
+        enviarEstado(ahoraMs);
+    }
+    
+    void aplicarAEstado(GameState& state, AudioSystem& audio) const override {
+        if (rol == HOST) {
+            volcarEstado(state, audio, sim, sim.masterPos, sim.slavePos, laberinto);
+        } else {
+            Vector2 local = {posLocal().x + errorVisual.x, posLocal().y + errorVisual.y};
+            Vector2 remoto = remotoInterpolado();
+            volcarEstado(state, audio, sim, localEsMaster ? local : remoto, localEsMaster ? remoto : local, laberinto);
+        }
+    }
+    
+    const SimEstado& getSim() const { return sim; }
+    const Estadisticas& getEstadisticas() const { return stats; }
+};
+
+// Sesión con rollback (entre pares, sin autoridad): las dos máquinas simulan a los dos
+// jugadores. El input remoto que aún no llegó se predice repitiendo el último conocido;
+// cuando llega el real y no coincide, se restaura el estado de ese tick desde el anillo
+// de snapshots y se vuelven a simular los ticks siguientes en el mismo frame.
+// Cada paquete lleva el checksum del último tick confirmado (inputs reales de ambos),
+// así una desincronización se detecta en cuanto el otro extremo confirma ese tick.
+class SesionRollback : public SesionOnline {
+public:
+    struct Estadisticas {
+        uint32_t rollbacks = 0;
+        uint64_t ticksResimulados = 0;
+        uint32_t profundidadMaxima = 0;
+        uint32_t ticksEsperando = 0;        // Frames parados por ir demasiado adelantados
+        uint32_t ticksCedidos = 0;          // Ticks saltados para igualar el ritmo con el otro
+        uint32_t checksumsComparados = 0;
+        uint32_t desincronizaciones = 0;
+        uint32_t primerTickDesincronizado = 0;
+        double msRollbackMaximo = 0.0;
+    };
+    
+private:
+    friend class BenchRollback;
+    
+    struct NivelSim {
+        MapaNivel laberinto;
+        SimEstado inicial;
+    };
+    
+    static constexpr uint32_t H = RedConstants::HISTORIAL_ROLLBACK;
+    static constexpr uint32_t MASCARA = H - 1;
+    static constexpr uint32_t SIN_ROLLBACK = 0xFFFFFFFFu;
+    
+    std::array<NivelSim, GameConstants::TOTAL_LEVELS> niveles;
+    SimEstado sim;                      // Estado al inicio de tickActual
+    uint32_t tickActual = 0;            // Próximo tick a simular
+    uint32_t maxRollback;
+    
+    // Anillos indexados por tick
+    std::array<SimEstado, H> estados{};         // Estado al inicio de cada tick
+    std::array<uint64_t, H> checksums{};        // Checksum al terminar cada tick
+    std::array<uint8_t, H> inputsLocales{};
+    std::array<uint8_t, H> inputsRemotos{};
+    std::array<uint8_t, H> remotosUsados{};     // Lo que se usó al simular (real o predicho)
+    
+    uint32_t remotosRecibidos = 0;      // Inputs remotos contiguos conocidos: [0, remotosRecibidos)
+    uint32_t ackRemoto = 0;             // El otro ya tiene nuestros inputs [0, ackRemoto)
+    uint32_t rollbackDesde = SIN_ROLLBACK;
+    uint32_t tickChecksumRemoto = 0;    // 0 = ninguno; si no, checksum tras el tick n-1
+    uint64_t checksumRemoto = 0;
+    int ventajaRemota = 0;
+    bool pedirSiguienteNivel = false;
+    
+    double acumuladoMs = 0.0;
+    double ultimoActualizarMs = 0.0;
+    bool relojIniciado = false;
+    Estadisticas stats;
+    
+    void alConectar(int) override {}
+    
+    static void paso(SimEstado& s, const std::array<NivelSim, GameConstants::TOTAL_LEVELS>& niveles,
+                     uint8_t inputMaster, uint8_t inputSlave) {
+        // El cambio de nivel también es parte de la simulación (lo pide el input del master)
+        if (s.completado && (inputMaster & INPUT_SIGUIENTE)) {
+            uint32_t tick = s.tick;
+            int siguiente = s.nivel + 1;
+            if (siguiente < GameConstants::TOTAL_LEVELS) {
+                s = niveles[siguiente].inicial;
+            } else {
+                s.nivel = static_cast<uint8_t>(siguiente);
+            }
+            s.tick = tick + 1;
+            return;
+        }
+        if (s.nivel >= GameConstants::TOTAL_LEVELS) {
+            s.tick++;
+            return;
+        }
+        SimulacionFija::paso(s, niveles[s.nivel].laberinto, inputMaster, inputSlave);
+    }
+    
+    uint8_t prediccionRemota() const {
+        if (remotosRecibidos == 0) return 0;
+        // Nunca se predice un cambio de nivel
+        return inputsRemotos[(remotosRecibidos - 1) & MASCARA] & ~INPUT_SIGUIENTE;
+    }
+    
+    void simularTick(uint32_t t) {
+        uint8_t local = inputsLocales[t & MASCARA];
+        uint8_t remoto = t < remotosRecibidos ? inputsRemotos[t & MASCARA] : prediccionRemota();
+        remotosUsados[t & MASCARA] = remoto;
+        estados[t & MASCARA] = sim;
+        if (rol == HOST) paso(sim, niveles, local, remoto);
+        else paso(sim, niveles, remoto, local);
+        checksums[t & MASCARA] = checksumEstado(sim);
+    }
+    
+    void ejecutarRollback() {
+        if (rollbackDesde >= tickActual) {
+            rollbackDesde = SIN_ROLLBACK;
+            return;
+        }
+        auto inicio = RelojArranque::now();
+        uint32_t profundidad = tickActual - rollbackDesde;
+        sim = estados[rollbackDesde & MASCARA];
+        for (uint32_t t = rollbackDesde; t < tickActual; t++) {
+            simularTick(t);
+        }
+        rollbackDesde = SIN_ROLLBACK;
+        
+        stats.rollbacks++;
+        stats.ticksResimulados += profundidad;
+        stats.profundidadMaxima = std::max(stats.profundidadMaxima, profundidad);
+        stats.msRollbackMaximo = std::max(stats.msRollbackMaximo, msDesde(inicio));
+    }
+    
+    void recibirPaquete(const PaqueteRollback& p) {
+        int cantidad = std::min<int>(p.cantidad, RedConstants::INPUTS_POR_PAQUETE_ROLLBACK);
+        for (int i = 0; i < cantidad; i++) {
+            uint32_t t = p.primerTick + i;
+            if (t < remotosRecibidos) continue;     // Ya conocido
+            if (t > remotosRecibidos) break;        // Hueco: llegará reenviado (se reenvía desde el ack)
+            inputsRemotos[t & MASCARA] = p.inputs[i];
+            if (t < tickActual && remotosUsados[t & MASCARA] != p.inputs[i]) {
+                rollbackDesde = std::min(rollbackDesde, t);
+            }
+            remotosRecibidos++;
+        }
+        ackRemoto = std::max(ackRemoto, p.ackTick);
+        ventajaRemota = p.ventaja;
+        if (p.tickChecksum > tickChecksumRemoto) {
+            tickChecksumRemoto = p.tickChecksum;
+            checksumRemoto = p.checksum;
+        }
+    }
+    
+    void procesarPaquetes(double ahoraMs) {
+        uint8_t buffer[sizeof(PaqueteRollback)];
+        int bytes;
+        while ((bytes = recibir(buffer, sizeof(buffer), ahoraMs)) > 0) {
+            if (procesarControl(buffer, bytes, ahoraMs, 0)) continue;
+            if (buffer[0] == MSG_ROLLBACK && fase == JUGANDO && bytes == static_cast<int>(sizeof(PaqueteRollback))) {
+                PaqueteRollback p;
+                std::memcpy(&p, buffer, sizeof(p));
+                recibirPaquete(p);
+            }
+        }
+    }
+    
+    int ventajaLocal() const {
+        return static_cast<int>(tickActual) - static_cast<int>(remotosRecibidos);
+    }
+    
+    // Ticks [0, n) simulados con los inputs reales de ambos
+    uint32_t ticksConfirmados() const {
+        return std::min(remotosRecibidos, tickActual);
+    }
+    
+    void compararChecksum() {
+        uint32_t n = tickChecksumRemoto;
+        if (n == 0 || n > ticksConfirmados() || n + H <= tickActual) return;
+        stats.checksumsComparados++;
+        if (checksums[(n - 1) & MASCARA] != checksumRemoto && stats.desincronizaciones++ == 0) {
+            stats.primerTickDesincronizado = n - 1;
+            logger.write("❌ Desincronización detectada en el tick " + std::to_string(n - 1));
+        }
+        tickChecksumRemoto = 0;
+    }
+    
+    void enviarInputs(double ahoraMs) {
+        PaqueteRollback p{};
+        p.tipo = MSG_ROLLBACK;
+        // Desde el primer tick que el otro no confirmó (cubre pérdidas y desorden)
+        p.primerTick = std::min(ackRemoto, tickActual);
+        p.cantidad = static_cast<uint8_t>(std::min<uint32_t>(tickActual - p.primerTick,
+                                                             RedConstants::INPUTS_POR_PAQUETE_ROLLBACK));
+        for (int i = 0; i < p.cantidad; i++) {
+            p.inputs[i] = inputsLocales[(p.primerTick + i) & MASCARA];
+        }
+        p.ackTick = remotosRecibidos;
+        p.ventaja = static_cast<int16_t>(ventajaLocal());
+        uint32_t confirmados = ticksConfirmados();
+        if (confirmados > 0) {
+            p.tickChecksum = confirmados;
+            p.checksum = checksums[(confirmados - 1) & MASCARA];
+        }
+        enviar(&p, sizeof(p), ahoraMs);
+    }
+    
+    const SimEstado& estadoConfirmado() const {
+        uint32_t n = ticksConfirmados();
+        return n == tickActual ? sim : estados[n & MASCARA];
+    }
+    
+public:
+    SesionRollback(Rol rol, CanalRed& canal, int maxRollback = RedConstants::MAX_ROLLBACK)
+        : SesionOnline(rol, canal),
+          maxRollback(static_cast<uint32_t>(std::max(1, std::min<int>(maxRollback, H / 2)))) {
+        for (int i = 0; i < GameConstants::TOTAL_LEVELS; i++) {
+            SimulacionFija::cargarNivel(i, niveles[i].laberinto, niveles[i].inicial);
+        }
+        sim = niveles[0].inicial;
+    }
+    
+    void actualizar(double ahoraMs, uint8_t inputLocal) override {
+        if (!relojIniciado) {
+            relojIniciado = true;
+            ultimoActualizarMs = ahoraMs;
+            ultimoRecibidoMs = ahoraMs;
+        }
+        double deltaMs = ahoraMs - ultimoActualizarMs;
+        ultimoActualizarMs = ahoraMs;
+        
+        procesarPaquetes(ahoraMs);
+        if (esperarConexion(ahoraMs) || fase != JUGANDO || comprobarTimeout(ahoraMs)) return;
+        
+        ejecutarRollback();
+        
+        acumuladoMs += deltaMs;
+        // Sincronización de ritmo: el que empezó antes ve al otro con más retraso del que
+        // da la latencia y acabaría parado en el límite; cede un tick por frame hasta igualarse
+        if (ventajaLocal() - ventajaRemota >= 2 && acumuladoMs >= GameConstants::PHYSICS_UPDATE_RATE) {
+            acumuladoMs -= GameConstants::PHYSICS_UPDATE_RATE;
+            stats.ticksCedidos++;
+        }
+        int ticks = 0;
+        while (acumuladoMs >= GameConstants::PHYSICS_UPDATE_RATE && ticks < RedConstants::MAX_TICKS_POR_FRAME) {
+            // Sin inputs remotos recientes no se puede predecir más allá de maxRollback
+            if (tickActual >= remotosRecibidos + maxRollback) {
+                stats.ticksEsperando++;
+                acumuladoMs = GameConstants::PHYSICS_UPDATE_RATE;
+                break;
+            }
+            acumuladoMs -= GameConstants::PHYSICS_UPDATE_RATE;
+            uint8_t input = inputLocal;
+            if (pedirSiguienteNivel) {
+                input |= INPUT_SIGUIENTE;
+                pedirSiguienteNivel = false;
+            }
+            inputsLocales[tickActual & MASCARA] = input;
+            simularTick(tickActual);
+            tickActual++;
+            ticks++;
+        }
+        if (ticks == RedConstants::MAX_TICKS_POR_FRAME) acumuladoMs = 0.0;
+        
+        // Un paquete por frame: los ticks de un mismo frame saldrían juntos de todas formas.
+        // También se envía parado, para que acks y checksums sigan llegando.
+        compararChecksum();
+        enviarInputs(ahoraMs);
+        
+        if (estadoConfirmado().nivel >= GameConstants::TOTAL_LEVELS) {
+            fase = TERMINADA;
+        }
+    }
+    
+    void avanzarNivel(double) override {
+        if (rol == HOST && sim.completado) pedirSiguienteNivel = true;
+    }
+    
+    void aplicarAEstado(GameState& state, AudioSystem& audio) const override {
+        int nivel = std::min<int>(sim.nivel, GameConstants::TOTAL_LEVELS - 1);
+        volcarEstado(state, audio, sim, sim.masterPos, sim.slavePos, niveles[nivel].laberinto);
+    }
+    
+    const SimEstado& getSim() const { return sim; }
+    uint32_t getTick() const { return tickActual; }
+    uint64_t getChecksumConfirmado() const {
+        uint32_t n = ticksConfirmados();
+        return n > 0 ? checksums[(n - 1) & MASCARA] : 0;
+    }
+    const Estadisticas& getEstadisticas() const { return stats; }
+};
+
+// Parámetros de red de la línea de comandos y canal/sesión activos
+struct ConexionRed {
+    bool activa = false;
+    SesionRed::Rol rol = SesionRed::HOST;
+    std::string ip;
+    uint16_t puerto = RedConstants::PUERTO_DEFECTO;
+    double latenciaMs = 0.0;        // Latencia de ida inyectada (pruebas en LAN)
+    float perdida = 0.0f;
+    bool rollback = false;          // Sesión entre pares con rollback en vez de host autoritativo
+    
+    std::unique_ptr<CanalUDP> udp;
+    std::unique_ptr<CanalConPerdidas> conPerdidas;
+    std::unique_ptr<SesionOnline> sesion;
+    
+    bool iniciar() {
+        udp.reset(new CanalUDP());
+        bool ok = (rol == SesionRed::HOST) ? udp->abrir(puerto) : (udp->abrir(0) && udp->conectarA(ip.c_str(), puerto));
+        if (!ok) {
+            logger.write("❌ No se pudo abrir el socket UDP");
+            cerrar();
+            return false;
+        }
+        CanalRed* canal = udp.get();
+        if (latenciaMs > 0.0 || perdida > 0.0f) {
+            conPerdidas.reset(new CanalConPerdidas(*udp, latenciaMs, latenciaMs * 0.1, perdida,
+                                                   static_cast<uint32_t>(RelojArranque::now().time_since_epoch().count())));
+            canal = conPerdidas.get();
+        }
+        if (rollback) sesion.reset(new SesionRollback(rol, *canal));
+        else sesion.reset(new SesionRed(rol, *canal));
+        logger.write(rol == SesionRed::HOST
+            ? "🌐 Esperando jugador en el puerto " + std::to_string(puerto)
+            : "🌐 Conectando a " + ip + ":" + std::to_string(puerto));
+        return true;
+    }
+    
+    void cerrar() {
+        sesion.reset();
+        conPerdidas.reset();
+        udp.reset();
+    }
+};
+
+// ============================================================================
+// Modo fiesta: de 2 a 8 jugadores locales (kioscos, mandos)
+// ============================================================================
+// La simulación es SimulacionFiesta (componentes.h) a paso fijo en el hilo principal,
+// como en red. Jugador 0 con WASD, jugador 1 con flechas y el resto con un mando cada
+// uno (cruceta o stick izquierdo). Los pares son del equipo rojo (master) y los impares
+// del azul (slave); el nivel se completa con todos en la meta.
+class SesionFiesta {
+private:
+    SimulacionFiesta sim;
+    int numJugadores;
+    double acumuladoMs = 0.0;
+    double ultimoMs = -1.0;
+    
+    static constexpr float ZONA_MUERTA_STICK = 0.4f;
+    
+    static uint8_t leerMando(int mando) {
+        if (!IsGamepadAvailable(mando)) return 0;
+        uint8_t input = 0;
+        float ejeX = GetGamepadAxisMovement(mando, GAMEPAD_AXIS_LEFT_X);
+        float ejeY = GetGamepadAxisMovement(mando, GAMEPAD_AXIS_LEFT_Y);
+        if (IsGamepadButtonDown(mando, GAMEPAD_BUTTON_LEFT_FACE_LEFT) || ejeX < -ZONA_MUERTA_STICK) input |= INPUT_IZQ;
+        if (IsGamepadButtonDown(mando, GAMEPAD_BUTTON_LEFT_FACE_RIGHT) || ejeX > ZONA_MUERTA_STICK) input |= INPUT_DER;
+        if (IsGamepadButtonDown(mando, GAMEPAD_BUTTON_LEFT_FACE_UP) || ejeY < -ZONA_MUERTA_STICK) input |= INPUT_ARR;
+        if (IsGamepadButtonDown(mando, GAMEPAD_BUTTON_LEFT_FACE_DOWN) || ejeY > ZONA_MUERTA_STICK) input |= INPUT_ABA;
+        return input;
+    }
+    
+public:
+    explicit SesionFiesta(int jugadores) : numJugadores(jugadores) {
+        sim.cargarNivel(0, jugadores);
+        logger.write("🎉 Modo fiesta: " + std::to_string(sim.getNumJugadores()) + " jugadores");
+    }
+    
+    void actualizar(double ahoraMs, const std::vector<int>& teclas0, const std::vector<int>& teclas1) {
+        double deltaMs = ultimoMs < 0.0 ? 0.0 : ahoraMs - ultimoMs;
+        ultimoMs = ahoraMs;
+        acumuladoMs += deltaMs;
+        
+        uint8_t inputs[ComponentesConstants::MAX_JUGADORES] = {};
+        inputs[0] = MovementSystem::leerInput(teclas0);
+        inputs[1] = MovementSystem::leerInput(teclas1);
+        for (int j = 2; j < sim.getNumJugadores(); j++) inputs[j] = leerMando(j - 2);
+        
+        int ticks = 0;
+        int golpesAntes = sim.getGolpes();
+        while (acumuladoMs >= GameConstants::PHYSICS_UPDATE_RATE && ticks < RedConstants::MAX_TICKS_POR_FRAME) {
+            acumuladoMs -= GameConstants::PHYSICS_UPDATE_RATE;
+            sim.paso(inputs);
+            ticks++;
+        }
+        if (ticks == RedConstants::MAX_TICKS_POR_FRAME) acumuladoMs = 0.0;
+        if (sim.getGolpes() > golpesAntes) logger.write("💥 Un peligro ha devuelto a un jugador a su inicio");
+    }
+    
+    // false si ya no quedan niveles
+    bool avanzarNivel() {
+        int siguiente = sim.getNivel() + 1;
+        if (siguiente >= GameConstants::TOTAL_LEVELS) return false;
+        sim.cargarNivel(siguiente, numJugadores);
+        return true;
+    }
+    
+    // Para el render y las pistas: el primer jugador de cada equipo hace de master/slave
+    void aplicarAEstado(GameState& state, AudioSystem& audio) const {
+        if (sim.getCanales() & ~state.canales.load()) audio.playDoorOpen();
+        if (sim.getCompletado() && !state.levelCompleted) {
+            audio.playLevelComplete();
+            logger.writef("✅ Nivel %d completado!", sim.getNivel());
+        }
+        
+        const AlmacenComponentes& a = sim.getAlmacen();
+        int master = a.indice(sim.getJugador(0));
+        int slave = a.indice(sim.getJugador(1));
+        {
+            std::lock_guard<std::mutex> lock(state.mtx);
+            if (master >= 0) state.masterPos = {a.posX[master], a.posY[master]};
+            if (slave >= 0) state.slavePos = {a.posX[slave], a.posY[slave]};
+        }
+        state.currentLevel = sim.getNivel();
+        state.canales = sim.getCanales();
+        const MetadatosNivel& meta = metadatosNivel(sim.getNivel());
+        state.masterInGoal = master >= 0 && meta.rasgos(a.tile[master]).meta;
+        state.slaveInGoal = slave >= 0 && meta.rasgos(a.tile[slave]).meta;
+        state.bothInGoal = sim.getEnMeta() == sim.getNumJugadores();
+        state.levelCompleted = sim.getCompletado();
+    }
+    
+    const AlmacenComponentes& getAlmacen() const { return sim.getAlmacen(); }
+    const MundoObjetos& getObjetos() const { return sim.getObjetos(); }
+};
+
+// Inputs de guion para las pruebas: cambia de dirección cada ~300 ms y a veces se queda quieto
+struct GuionInputs {
+    uint32_t semilla;
+    uint8_t actual = 0;
+    
+    explicit GuionInputs(uint32_t semilla) : semilla(semilla) {}
+    
+    uint8_t input(int frame) {
+        static const uint8_t direcciones[] = {
+            0, INPUT_IZQ, INPUT_DER, INPUT_ARR, INPUT_ABA,
+            INPUT_IZQ | INPUT_ARR, INPUT_DER | INPUT_ABA, INPUT_DER | INPUT_ARR
+        };
+        if (frame % 18 == 0) {
+            semilla = semilla * 1664525u + 1013904223u;
+            actual = direcciones[(semilla >> 16) % 8];
+        }
+        return actual;
+    }
+};
+
+// Prueba en loopback: host y cliente en el mismo proceso, unidos por canales en memoria
+// con latencia/pérdida inyectadas y un reloj virtual (sin ventana ni espera real).
+// Los dos jugadores siguen un guion de inputs y al final se comprueba que la predicción
+// del cliente coincide con el host y que el ancho de banda está por debajo del objetivo.
+class PruebaRed {
+public:
+    static int ejecutar(double rttMs, float perdida) {
+        using namespace RedConstants;
+        const double latenciaIda = rttMs / 2.0;
+        const double jitter = latenciaIda * 0.1;
+        const double duracionMs = 60000.0;
+        const double reposoMs = 1500.0;         // Al final, sin input, para comprobar convergencia
+        const double frameMs = 1000.0 / GameConstants::FPS_TARGET;
+        
+        printf("🌐 Prueba de red en loopback: RTT %.0f ms (±%.0f), pérdida %.0f%%, %.0f s simulados\n",
+               rttMs, jitter * 2.0, perdida * 100.0f, duracionMs / 1000.0);
+        
+        TuberiaMemoria haciaCliente, haciaHost;
+        CanalMemoria memoriaHost(haciaCliente, haciaHost);
+        CanalMemoria memoriaCliente(haciaHost, haciaCliente);
+        CanalConPerdidas canalHost(memoriaHost, latenciaIda, jitter, perdida, 0x1234u);
+        CanalConPerdidas canalCliente(memoriaCliente, latenciaIda, jitter, perdida, 0xBEEFu);
+        
+        SesionRed host(SesionRed::HOST, canalHost);
+        SesionRed cliente(SesionRed::CLIENTE, canalCliente);
+        
+        GuionInputs guionHost(7), guionCliente(99);
+        int frame = 0;
+        double ahora = 0.0;
+        double inicioJuego = -1.0;
+        for (; ahora < duracionMs + reposoMs; ahora += frameMs, frame++) {
+            bool reposo = ahora >= duracionMs;
+            // El cliente corre con un desfase de medio frame respecto al host
+            host.actualizar(ahora, reposo ? 0 : guionHost.input(frame));
+            cliente.actualizar(ahora + frameMs * 0.5, reposo ? 0 : guionCliente.input(frame + 9));
+            if (inicioJuego < 0 && cliente.getFase() == SesionRed::JUGANDO) inicioJuego = ahora;
+        }
+        
+        const SesionRed::Estadisticas& sh = host.getEstadisticas();
+        const SesionRed::Estadisticas& sc = cliente.getEstadisticas();
+        double segundos = (ahora - std::max(0.0, inicioJuego)) / 1000.0;
+        double subida = cliente.getTrafico().bytesEnviados / segundos;
+        double bajada = host.getTrafico().bytesEnviados / segundos;
+        
+        Vector2 slaveHost = host.getSim().slavePos;
+        Vector2 slaveCliente = cliente.getSim().slavePos;
+        bool converge = slaveHost.x == slaveCliente.x && slaveHost.y == slaveCliente.y &&
+                        host.getSim().canales == cliente.getSim().canales;
+        bool anchoBanda = subida < 2048.0 && bajada < 2048.0;
+        
+        printf("  Cliente -> host: %.0f B/s (%u paquetes, %u inputs perdidos sin recuperar)\n",
+               subida, cliente.getTrafico().paquetesEnviados, sh.inputsPerdidos);
+        printf("  Host -> cliente: %.0f B/s (%u paquetes)\n", bajada, host.getTrafico().paquetesEnviados);
+        printf("  Correcciones del cliente: %u (error medio %.2f px, máximo %.2f px)\n",
+               sc.correcciones, sc.correcciones ? sc.errorAcumulado / sc.correcciones : 0.0, sc.errorMaximo);
+        printf("  Slave final host (%.0f, %.0f) / cliente (%.0f, %.0f)\n",
+               slaveHost.x, slaveHost.y, slaveCliente.x, slaveCliente.y);
+        printf("  %s convergencia tras reposo\n", converge ? "✅" : "❌");
+        printf("  %s ancho de banda < 2 KB/s por sentido\n", anchoBanda ? "✅" : "❌");
+        return (converge && anchoBanda) ? 0 : 1;
+    }
+};
+
+// Benchmark de rollback (sin ventana):
+//  1. Coste de restaurar un snapshot y resimular D ticks, para saber qué profundidad
+//     de rollback cabe en un frame a 60 FPS.
+//  2. Dos pares en loopback con latencia/pérdida: rollbacks reales, esperas y checksums.
+//  3. Se corrompe el estado de un par y se mide cuánto tarda en detectarse.
+class BenchRollback {
+private:
+    static void conectar(SesionRollback& a, SesionRollback& b, double& ahora, double frameMs) {
+        while (a.getFase() != SesionOnline::JUGANDO || b.getFase() != SesionOnline::JUGANDO) {
+            a.actualizar(ahora, 0);
+            b.actualizar(ahora, 0);
+            ahora += frameMs;
+        }
+    }
+    
+public:
+    static int ejecutar(double rttMs, float perdida) {
+        const double frameMs = 1000.0 / GameConstants::FPS_TARGET;
+        const uint32_t H = RedConstants::HISTORIAL_ROLLBACK;
+        bool ok = true;
+        
+        // --- 1. Coste por profundidad ---
+        printf("⏪ Benchmark de rollback\n");
+        TuberiaMemoria ida, vuelta;
+        CanalMemoria canalMudo(ida, vuelta);
+        SesionRollback s(SesionOnline::HOST, canalMudo, H / 2);
+        s.fase = SesionOnline::JUGANDO;
+        GuionInputs guionLocal(3), guionRemoto(11);
+        for (uint32_t t = 0; t < H - 1; t++) {
+            s.inputsLocales[t & SesionRollback::MASCARA] = guionLocal.input(t);
+            s.inputsRemotos[t & SesionRollback::MASCARA] = guionRemoto.input(t + 7);
+            s.remotosRecibidos = t + 1;
+            s.simularTick(t);
+            s.tickActual++;
+        }
+        
+        const int REPETICIONES = 2000;
+        std::vector<double> tiempos(REPETICIONES);
+        double peorNsPorTick = 0.0;
+        printf("  Profundidad | medio (us) | p99 (us) | ns/tick\n");
+        for (uint32_t profundidad = 1; profundidad < H; profundidad *= 2) {
+            double total = 0.0;
+            for (int i = 0; i < REPETICIONES; i++) {
+                s.rollbackDesde = s.tickActual - profundidad;
+                auto inicio = RelojArranque::now();
+                s.ejecutarRollback();
+                tiempos[i] = msDesde(inicio);
+                total += tiempos[i];
+            }
+            // p99 en vez del máximo: el máximo lo marcan las interrupciones del sistema operativo
+            std::nth_element(tiempos.begin(), tiempos.begin() + REPETICIONES * 99 / 100, tiempos.end());
+            double p99 = tiempos[REPETICIONES * 99 / 100];
+            double medioUs = total * 1000.0 / REPETICIONES;
+            // Con pocas profundidades domina la resolución del reloj; se usa desde 8 ticks
+            if (profundidad >= 8) peorNsPorTick = std::max(peorNsPorTick, p99 * 1e6 / profundidad);
+            printf("  %11u | %10.2f | %8.2f | %7.1f\n", profundidad, medioUs, p99 * 1000.0, medioUs * 1000.0 / profundidad);
+        }
+        // Se reserva un cuarto del frame para resimular; el resto es render y lógica
+        double presupuestoMs = frameMs * 0.25;
+        double profundidadAsumible = presupuestoMs * 1e6 / std::max(peorNsPorTick, 1.0);
+        printf("  p99: %.1f ns/tick -> %.0f ticks (%.1f s de juego) en %.1f ms (1/4 de frame a 60 FPS)\n",
+               peorNsPorTick, profundidadAsumible, profundidadAsumible * GameConstants::PHYSICS_UPDATE_RATE / 1000.0,
+               presupuestoMs);
+        printf("  %s MAX_ROLLBACK = %d ticks cabe en el presupuesto\n",
+               profundidadAsumible >= RedConstants::MAX_ROLLBACK ? "✅" : "❌", RedConstants::MAX_ROLLBACK);
+        ok = ok && profundidadAsumible >= RedConstants::MAX_ROLLBACK;
+        
+        // --- 2. Dos pares en loopback ---
+        const double latenciaIda = rttMs / 2.0;
+        printf("  Loopback: RTT %.0f ms, pérdida %.0f%%, 60 s simulados\n", rttMs, perdida * 100.0f);
+        {
+            TuberiaMemoria aB, bA;
+            CanalMemoria memA(aB, bA), memB(bA, aB);
+            CanalConPerdidas canalA(memA, latenciaIda, latenciaIda * 0.1, perdida, 0x51u);
+            CanalConPerdidas canalB(memB, latenciaIda, latenciaIda * 0.1, perdida, 0x77u);
+            SesionRollback host(SesionOnline::HOST, canalA);
+            SesionRollback cliente(SesionOnline::CLIENTE, canalB);
+            GuionInputs guionHost(7), guionCliente(99);
+            
+            double ahora = 0.0;
+            conectar(host, cliente, ahora, frameMs);
+            double inicio = ahora;
+            for (int frame = 0; ahora - inicio < 60000.0; frame++, ahora += frameMs) {
+                host.actualizar(ahora, guionHost.input(frame));
+                cliente.actualizar(ahora + frameMs * 0.5, guionCliente.input(frame + 9));
+            }
+            
+            const SesionRollback::Estadisticas& e = cliente.getEstadisticas();
+            const SesionRollback::Estadisticas& eh = host.getEstadisticas();
+            uint32_t rollbacks = e.rollbacks + eh.rollbacks;
+            uint64_t resimulados = e.ticksResimulados + eh.ticksResimulados;
+            printf("  Rollbacks: %u (profundidad media %.1f, máxima %u ticks, peor %.3f ms)\n", rollbacks,
+                   rollbacks ? static_cast<double>(resimulados) / rollbacks : 0.0,
+                   std::max(e.profundidadMaxima, eh.profundidadMaxima), std::max(e.msRollbackMaximo, eh.msRollbackMaximo));
+            printf("  Frames en espera: host %u, cliente %u (ticks cedidos para igualar ritmo: %u / %u)\n",
+                   eh.ticksEsperando, e.ticksEsperando, eh.ticksCedidos, e.ticksCedidos);
+            printf("  Checksums comparados: %u, desincronizaciones: %u\n",
+                   e.checksumsComparados + eh.checksumsComparados, e.desincronizaciones + eh.desincronizaciones);
+            printf("  Tráfico por par: %.0f B/s\n", host.getTrafico().bytesEnviados / 60.0);
+            bool sinDesync = e.desincronizaciones + eh.desincronizaciones == 0 && e.checksumsComparados > 0;
+            printf("  %s sin desincronizaciones\n", sinDesync ? "✅" : "❌");
+            ok = ok && sinDesync;
+        }
+        
+        // --- 3. Desincronización inyectada ---
+        {
+            TuberiaMemoria aB, bA;
+            CanalMemoria memA(aB, bA), memB(bA, aB);
+            CanalConPerdidas canalA(memA, latenciaIda, latenciaIda * 0.1, perdida, 0x13u);
+            CanalConPerdidas canalB(memB, latenciaIda, latenciaIda * 0.1, perdida, 0x31u);
+            SesionRollback host(SesionOnline::HOST, canalA);
+            SesionRollback cliente(SesionOnline::CLIENTE, canalB);
+            GuionInputs guionHost(21), guionCliente(42);
+            
+            double ahora = 0.0;
+            conectar(host, cliente, ahora, frameMs);
+            int frame = 0;
+            for (double fin = ahora + 5000.0; ahora < fin; frame++, ahora += frameMs) {
+                host.actualizar(ahora, guionHost.input(frame));
+                cliente.actualizar(ahora + frameMs * 0.5, guionCliente.input(frame + 9));
+            }
+            
+            // Simula un bug no determinista en el cliente: desplaza al slave 1 px en el
+            // estado actual y en todos los snapshots a los que un rollback podría volver
+            uint32_t tickCorrupto = cliente.ticksConfirmados();
+            for (uint32_t t = tickCorrupto; t < cliente.tickActual; t++) {
+                cliente.estados[t & SesionRollback::MASCARA].slavePos.x += 1.0f;
+            }
+            cliente.sim.slavePos.x += 1.0f;
+            double ahoraCorrupcion = ahora;
+            
+            for (double fin = ahora + 2000.0; ahora < fin; frame++, ahora += frameMs) {
+                host.actualizar(ahora, guionHost.input(frame));
+                cliente.actualizar(ahora + frameMs * 0.5, guionCliente.input(frame + 9));
+                if (host.getEstadisticas().desincronizaciones || cliente.getEstadisticas().desincronizaciones) break;
+            }
+            bool detectada = host.getEstadisticas().desincronizaciones || cliente.getEstadisticas().desincronizaciones;
+            printf("  %s desincronización inyectada en el tick %u detectada a los %.0f ms\n",
+                   detectada ? "✅" : "❌", tickCorrupto, ahora - ahoraCorrupcion);
+            ok = ok && detectada;
+        }
+        return ok ? 0 : 1;
+    }
+};
+
+// Benchmark del compañero IA (sin ventana): las dos IA juegan los niveles del juego entre
+// sí y después se mide el planificador en un laberinto 100 veces mayor
+class BenchCompanero {
+private:
+    // Laberinto perfecto (backtracking) en el que los muros de una columna pasan a ser
+    // puertas: al abrirlas aparecen atajos y el plan tiene que repararse
+    static std::vector<int> generarLaberinto(int ancho, int alto, int columnaPuertas, uint32_t semilla) {
+        std::vector<int> t(ancho * alto, PARED);
+        auto aleatorio = [&semilla]() {
+            semilla ^= semilla << 13;
+            semilla ^= semilla >> 17;
+            semilla ^= semilla << 5;
+            return semilla;
+        };
+        std::vector<int> pila = {1 * ancho + 1};
+        t[ancho + 1] = VACIO;
+        const int dx[4] = {2, -2, 0, 0};
+        const int dy[4] = {0, 0, 2, -2};
+        while (!pila.empty()) {
+            int c = pila.back();
+            int x = c % ancho, y = c / ancho;
+            int opciones[4], n = 0;
+            for (int k = 0; k < 4; k++) {
+                int nx = x + dx[k], ny = y + dy[k];
+                if (nx > 0 && nx < ancho - 1 && ny > 0 && ny < alto - 1 && t[ny * ancho + nx] == PARED) opciones[n++] = k;
+            }
+            if (n == 0) {
+                pila.pop_back();
+                continue;
+            }
+            int k = opciones[aleatorio() % n];
+            t[(y + dy[k] / 2) * ancho + (x + dx[k] / 2)] = VACIO;
+            t[(y + dy[k]) * ancho + (x + dx[k])] = VACIO;
+            pila.push_back((y + dy[k]) * ancho + (x + dx[k]));
+        }
+        for (int y = 1; y < alto - 1; y += 2) {
+            int c = y * ancho + columnaPuertas;
+            if (t[c] == PARED) t[c] = PUERTA_1;
+        }
+        t[ancho + 1] = START_SLAVE;
+        t[(alto - 2) * ancho + (ancho - 2)] = META;
+        return t;
+    }
+    
+public:
+    static int ejecutar() {
+        bool ok = true;
+        printf("🤖 Benchmark del compañero IA\n");
+        
+        // --- 1. Las dos IA completan los niveles del juego ---
+        printf("  Nivel | ticks | medio (ms) | máximo (ms)\n");
+        double peorMs = 0.0;
+        for (int nivel = 0; nivel < GameConstants::TOTAL_LEVELS; nivel++) {
+            MapaNivel mapa{};
+            SimEstado sim;
+            SimulacionFija::cargarNivel(nivel, mapa, sim);
+            CompaneroIA master(CompaneroIA::rejillaDe(mapa), true, 0, metadatosNivel(nivel));
+            CompaneroIA slave(CompaneroIA::rejillaDe(mapa), false, 0, metadatosNivel(nivel));
+            const uint32_t LIMITE = 60000;      // 10 minutos de juego
+            while (!sim.completado && sim.tick < LIMITE) {
+                uint8_t im = master.decidir(sim.masterPos, sim.slavePos, sim.canales);
+                uint8_t is = slave.decidir(sim.slavePos, sim.masterPos, sim.canales);
+                SimulacionFija::paso(sim, mapa, im, is);
+            }
+            const CompaneroIA::Estadisticas& em = master.getEstadisticas();
+            const CompaneroIA::Estadisticas& es = slave.getEstadisticas();
+            double maximo = std::max(em.msMaximo, es.msMaximo);
+            peorMs = std::max(peorMs, maximo);
+            printf("  %5d | %5u | %10.4f | %11.4f %s\n", nivel + 1, sim.tick,
+                   (em.msTotal + es.msTotal) / std::max(1u, em.ticks + es.ticks), maximo,
+                   sim.completado ? "✅" : "❌ sin completar");
+            ok = ok && sim.completado;
+        }
+        printf("  %s máximo por tick %.4f ms (límite 0.5 ms)\n", peorMs < 0.5 ? "✅" : "❌", peorMs);
+        ok = ok && peorMs < 0.5;
+        
+        // --- 2. Laberinto 100 veces mayor (200x150) ---
+        const int ANCHO = GameConstants::MAP_WIDTH * 10 + 1;
+        const int ALTO = GameConstants::MAP_HEIGHT * 10 + 1;
+        std::vector<int> tiles = generarLaberinto(ANCHO, ALTO, ANCHO / 2, 0xC0FFEEu);
+        RejillaTiles grande{tiles.data(), ANCHO, ALTO};
+        const float centro = GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2.0f;
+        Vector2 inicio = {centro, centro};     // Tile (1, 1)
+        
+        // Ticks hasta que un decidir termina sus búsquedas dentro del presupuesto
+        auto hastaTerminar = [&inicio](CompaneroIA& ia, Canales canales) {
+            int ticks = 0;
+            uint32_t sinTerminar;
+            do {
+                sinTerminar = ia.getEstadisticas().ticksSinTerminar;
+                ia.decidir(inicio, inicio, canales);
+                ticks++;
+            } while (ia.getEstadisticas().ticksSinTerminar != sinTerminar && ticks < 10000);
+            return ticks;
+        };
+        
+        CompaneroIA ia(grande, false);
+        int ticksPlan = hastaTerminar(ia, 0);
+        int expansionesPlan = ia.getExpansiones();
+        printf("  Laberinto %dx%d: primer plan en %d ticks (%d expansiones)\n", ANCHO, ALTO, ticksPlan, expansionesPlan);
+        
+        // Se abren las puertas: reparación incremental frente a una búsqueda desde cero
+        int ticksReparacion = hastaTerminar(ia, BIT_BOTON_1);
+        int expansionesReparacion = ia.getExpansiones() - expansionesPlan;
+        CompaneroIA nueva(grande, false, BIT_BOTON_1);
+        int ticksNueva = hastaTerminar(nueva, BIT_BOTON_1);
+        printf("  Puertas abiertas: reparación %d expansiones (%d ticks) vs. desde cero %d (%d ticks)\n",
+               expansionesReparacion, ticksReparacion, nueva.getExpansiones(), ticksNueva);
+        bool reparaMenos = expansionesReparacion < nueva.getExpansiones();
+        printf("  %s la reparación expande menos que una búsqueda nueva\n", reparaMenos ? "✅" : "❌");
+        double maxGrande = std::max(ia.getEstadisticas().msMaximo, nueva.getEstadisticas().msMaximo);
+        bool presupuesto = maxGrande < 0.5;
+        printf("  %s presupuesto por tick respetado en el mapa grande (máximo %.3f ms)\n",
+               presupuesto ? "✅" : "❌", maxGrande);
+        ok = ok && reparaMenos && presupuesto;
+        
+        // --- 3. Puertas de un canal propio del nivel: cerradas no hay camino, abiertas sí ---
+        const int PUERTA_PROPIA = TriggerConstants::PRIMER_ID_PROPIO;
+        const int CANAL_PROPIO = 5;
+        const MetadatosNivel metaPropia = metadatosBasicos().puerta(PUERTA_PROPIA, CANAL_PROPIO);
+        std::vector<int> pasillo = {PARED, PARED, PARED,         PARED, PARED, PARED,
+                                    PARED, VACIO, PUERTA_PROPIA, VACIO, META,  PARED,
+                                    PARED, PARED, PARED,         PARED, PARED, PARED};
+        CompaneroIA propia({pasillo.data(), 6, 3}, false, 0, metaPropia);
+        hastaTerminar(propia, 0);
+        bool cerrada = propia.decidir(inicio, inicio, 0) == 0;
+        hastaTerminar(propia, bitCanal(CANAL_PROPIO));
+        bool abierta = propia.decidir(inicio, inicio, bitCanal(CANAL_PROPIO)) != 0 && propia.getObjetivo() == CompaneroIA::OBJ_META;
+        printf("  %s puertas del canal %d: se queda quieta con el canal apagado y va a la meta al abrirlas\n",
+               cerrada && abierta ? "✅" : "❌", CANAL_PROPIO);
+        ok = ok && cerrada && abierta;
+        return ok ? 0 : 1;
+    }
+};
+
+// Pantalla de carga con barra de progreso (solo usa la fuente por defecto)
+class LoadingScreen {
+public:
+    static void draw(float progreso, const char* etapa) {
+        using namespace GameConstants;
+        
+        ClearBackground(BLACK);
+        
+        const char* titulo = "DUOMAZE";
+        DrawText(titulo, SCREEN_WIDTH/2 - MeasureText(titulo, 40)/2, SCREEN_HEIGHT/3, 40, RAYWHITE);
+        
+        const int anchoBarra = 400;
+        const int altoBarra = 20;
+        int x = SCREEN_WIDTH/2 - anchoBarra/2;
+        int y = SCREEN_HEIGHT/2;
+        DrawRectangle(x, y, static_cast<int>(anchoBarra * progreso), altoBarra, GOLD);
+        DrawRectangleLines(x, y, anchoBarra, altoBarra, RAYWHITE);
+        
+        const char* texto = TextFormat("%s %d%%", etapa, static_cast<int>(progreso * 100.0f));
+        DrawText(texto, SCREEN_WIDTH/2 - MeasureText(texto, 20)/2, y + 35, 20, GRAY);
+    }
+};
+
+// Controlador de audio en pantalla
+class AudioOverlay {
+private:
+    std::atomic<bool> mostrarControles{false};
+    double tiempoOcultarControles{0};
+    
+public:
+    void update() {
+        if (GetTime() > tiempoOcultarControles) {
+            mostrarControles = false;
+        }
+    }
+    
+    void draw() {
+        if (!mostrarControles) return;
+        
+        DrawRectangle(10, GameConstants::SCREEN_HEIGHT - 120, 250, 110, Fade(BLACK, 0.8f));
+        DrawText("CONTROLES AUDIO:", 20, GameConstants::SCREEN_HEIGHT - 110, 16, YELLOW);
+        DrawText("P: Pausar/Reanudar musica", 20, GameConstants::SCREEN_HEIGHT - 90, 14, WHITE);
+        DrawText("M: Mutear", 20, GameConstants::SCREEN_HEIGHT - 70, 14, WHITE);
+        DrawText("U: Subir volumen", 20, GameConstants::SCREEN_HEIGHT - 50, 14, WHITE);
+        DrawText("H: Alto/Bajo volumen", 20, GameConstants::SCREEN_HEIGHT - 30, 14, WHITE);
+        DrawText("V: Mostrar/ocultar controles", 20, GameConstants::SCREEN_HEIGHT - 10, 14, WHITE);
+        
+    }
+    
+    bool isVisible() const { return mostrarControles; }
+    
+    void showTemporarily(double seconds = 3.0) {
+        mostrarControles = true;
+        tiempoOcultarControles = GetTime() + seconds;
+    }
+    
+    void toggle() {
+        mostrarControles = !mostrarControles;
+        if (mostrarControles) {
+            tiempoOcultarControles = GetTime() + 3.0;
+        }
+    }
+};
+
+// Benchmark del modo fiesta: la simulación de N jugadores con dos debe coincidir con
+// SimulacionFija, los handles tienen que sobrevivir a los borrados y el coste por tick
+// de los sistemas tiene que crecer de forma lineal con las entidades.
+class BenchJugadores {
+private:
+    static constexpr int TICKS_EQUIVALENCIA = 6000;
+    static constexpr int TICKS_COSTE = 2000;
+    
+    static bool equivalencia() {
+        bool ok = true;
+        for (int nivel = 0; nivel < GameConstants::TOTAL_LEVELS; nivel++) {
+            MapaNivel mapa;
+            SimEstado fija;
+            SimulacionFija::cargarNivel(nivel, mapa, fija);
+            SimulacionFiesta fiesta;
+            fiesta.cargarNivel(nivel, 2, false);
+            GuionInputs guionMaster(11 + nivel), guionSlave(97 + nivel);
+            int ticksIguales = 0;
+            for (int t = 0; t < TICKS_EQUIVALENCIA; t++) {
+                uint8_t inputs[2] = {guionMaster.input(t), guionSlave.input(t)};
+                SimulacionFija::paso(fija, mapa, inputs[0], inputs[1]);
+                fiesta.paso(inputs);
+                const AlmacenComponentes& a = fiesta.getAlmacen();
+                int m = a.indice(fiesta.getJugador(0));
+                int s = a.indice(fiesta.getJugador(1));
+                bool igual = a.posX[m] == fija.masterPos.x && a.posY[m] == fija.masterPos.y &&
+                             a.posX[s] == fija.slavePos.x && a.posY[s] == fija.slavePos.y &&
+                             fiesta.getCanales() == fija.canales && fiesta.getCompletado() == fija.completado;
+                if (!igual) break;
+                ticksIguales++;
+            }
+            bool nivelOk = ticksIguales == TICKS_EQUIVALENCIA;
+            printf("  Nivel %d: %d/%d ticks idénticos a SimulacionFija %s\n", nivel + 1, ticksIguales,
+                   TICKS_EQUIVALENCIA, nivelOk ? "✅" : "❌");
+            ok = ok && nivelOk;
+        }
+        return ok;
+    }
+    
+    static bool handles() {
+        AlmacenComponentes a(16);
+        Entidad e[10];
+        for (int i = 0; i < 10; i++) {
+            e[i] = a.crear(ENTIDAD_JUGADOR, ROL_MASTER, static_cast<uint8_t>(i), {static_cast<float>(i), 0.0f});
+        }
+        a.destruir(e[3]);
+        a.destruir(e[0]);
+        Entidad nueva = a.crear(ENTIDAD_JUGADOR, ROL_SLAVE, 10, {100.0f, 0.0f});
+        bool ok = !a.valida(e[3]) && !a.valida(e[0]) && a.valida(nueva) && a.tamano() == 9;
+        for (int i = 0; i < 10; i++) {
+            if (i == 0 || i == 3) continue;
+            int d = a.indice(e[i]);
+            ok = ok && d >= 0 && a.posX[d] == static_cast<float>(i) && a.jugador[d] == i;
+        }
+        // Llenar del todo: el siguiente falla sin reservar
+        while (a.tamano() < a.capacidad()) a.crear(ENTIDAD_JUGADOR, ROL_SLAVE, 0, {0.0f, 0.0f});
+        ok = ok && a.crear(ENTIDAD_JUGADOR, ROL_SLAVE, 0, {0.0f, 0.0f}) == ENTIDAD_NULA;
+        printf("  %s handles estables tras borrar y reutilizar slots\n", ok ? "✅" : "❌");
+        return ok;
+    }
+    
+    // ns por entidad y tick de los tres sistemas con n entidades repartidas entre los inicios
+    static double coste(int n, const MapaNivel& mapa, const SimEstado& inicio) {
+        AlmacenComponentes a(static_cast<size_t>(n));
+        for (int j = 0; j < n; j++) {
+            bool master = (j % 2) == 0;
+            a.crear(ENTIDAD_JUGADOR, master ? ROL_MASTER : ROL_SLAVE, static_cast<uint8_t>(j),
+                    master ? inicio.masterPos : inicio.slavePos);
+        }
+        const MetadatosNivel& meta = metadatosNivel(inicio.nivel);
+        MundoObjetos sinObjetos;
+        sinObjetos.cargar(nullptr, 0, &mapa[0][0], GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT, meta);
+        GuionInputs guion(0xF1E57A);
+        Canales canales = 0;
+        int enMeta = 0;
+        auto t0 = RelojArranque::now();
+        for (int t = 0; t < TICKS_COSTE; t++) {
+            for (int j = 0; j < n; j++) a.input[j] = guion.input(t + j * 7);
+            SistemasEntidades::mover(a, mapa, canales, meta, sinObjetos);
+            SistemasEntidades::actualizarTiles(a, mapa);
+            enMeta += SistemasEntidades::disparadores(a, canales, meta);
+        }
+        double ms = msDesde(t0);
+        if (enMeta < 0) printf("%d", enMeta);      // Que el optimizador no quite el bucle
+        return ms * 1e6 / (static_cast<double>(TICKS_COSTE) * n);
+    }
+    
+public:
+    static int ejecutar() {
+        printf("🎉 Benchmark del modo fiesta (almacén de componentes)\n");
+        bool ok = equivalencia();
+        ok = handles() && ok;
+        
+        MapaNivel mapa;
+        SimEstado inicio;
+        SimulacionFija::cargarNivel(0, mapa, inicio);
+        printf("  Entidades | ns/entidad/tick | µs/tick\n");
+        const int tamanos[] = {2, 4, 8, 64, 512, 4096};
+        double nsOcho = 0.0, nsMayor = 0.0, usOcho = 0.0;
+        for (int n : tamanos) {
+            double ns = coste(n, mapa, inicio);
+            printf("  %9d | %15.1f | %7.2f\n", n, ns, ns * n / 1000.0);
+            if (n == 8) {
+                nsOcho = ns;
+                usOcho = ns * n / 1000.0;
+            }
+            nsMayor = ns;
+        }
+        bool lineal = nsMayor < nsOcho * 2.5;
+        bool rapido = usOcho < 50.0;
+        printf("  %s coste lineal: %.1f ns/entidad con 4096 frente a %.1f con 8\n", lineal ? "✅" : "❌", nsMayor, nsOcho);
+        printf("  %s tick de 8 jugadores en %.2f µs (límite 50 µs)\n", rapido ? "✅" : "❌", usOcho);
+        return (ok && lineal && rapido) ? 0 : 1;
+    }
+};
+
+// Benchmark del tilemap en GPU (necesita ventana: se abre oculta). Compara los píxeles del
+// shader con los de los quads a escala 1:1, mide los dos con vistas cada vez mayores de un
+// mapa grande y comprueba que cambiar unas pocas tiles solo sube esas tiles.
+// Con LIBGL_ALWAYS_SOFTWARE=1 corre sobre llvmpipe.
+class BenchTilemap {
+private:
+    static constexpr int FRAMES = 60;
+    static constexpr int REPETICIONES_MAPA = 8;         // Mapa grande: 8x8 niveles
+    static constexpr int TOLERANCIA_COLOR = 2;          // Redondeo de la mezcla por alfa
+    
+    // Dibuja FRAMES veces en el destino y espera a la GPU leyendo el resultado
+    template <typename F>
+    static double msPorFrame(RenderTexture2D& destino, F&& dibujar) {
+        auto t0 = RelojArranque::now();
+        for (int f = 0; f < FRAMES; f++) {
+            BeginTextureMode(destino);
+            ClearBackground(BLACK);
+            dibujar();
+            EndTextureMode();
+        }
+        Image sincronizar = LoadImageFromTexture(destino.texture);
+        UnloadImage(sincronizar);
+        return msDesde(t0) / FRAMES;
+    }
+    
+    static int pixelesDistintos(const Image& a, const Image& b) {
+        const unsigned char* pa = static_cast<const unsigned char*>(a.data);
+        const unsigned char* pb = static_cast<const unsigned char*>(b.data);
+        int distintos = 0;
+        for (int i = 0; i < a.width * a.height; i++) {
+            for (int c = 0; c < 3; c++) {
+                if (std::abs(pa[i * 4 + c] - pb[i * 4 + c]) > TOLERANCIA_COLOR) {
+                    distintos++;
+                    break;
+                }
+            }
+        }
+        return distintos;
+    }
+    
+public:
+    static int ejecutar() {
+        using namespace GameConstants;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "DuoMaze - Benchmark tilemap");
+        SetTargetFPS(0);
+        printf("🧩 Benchmark del tilemap en GPU\n");
+        
+        TextureManager textureManager;
+        if (!textureManager.cargarDesdePaquete("resources/duomaze.pak")) textureManager.loadAllTextures();
+        RenderSystem renderSystem(textureManager);
+        bool ok = renderSystem.prepararTilemapGPU();
+        printf("  %s shader GLSL 330 compilado y atlas montado\n", ok ? "✅" : "❌");
+        if (!ok) {
+            textureManager.unloadAll();
+            CloseWindow();
+            return 1;
+        }
+        RenderTilemapGPU& gpu = renderSystem.getTilemapGPU();
+        
+        // Mapa grande: los cuatro niveles en mosaico
+        const int ancho = MAP_WIDTH * REPETICIONES_MAPA, alto = MAP_HEIGHT * REPETICIONES_MAPA;
+        std::vector<int> mapa(static_cast<size_t>(ancho) * alto);
+        for (int y = 0; y < alto; y++) {
+            for (int x = 0; x < ancho; x++) {
+                int nivel = (x / MAP_WIDTH + y / MAP_HEIGHT) % TOTAL_LEVELS;
+                mapa[y * ancho + x] = DATOS_NIVELES[nivel][y % MAP_HEIGHT][x % MAP_WIDTH];
+            }
+        }
+        const MetadatosNivel& meta = METADATOS_BASICOS;
+        const Canales canales = bitCanal(0) | bitCanal(2);     // Una puerta abierta y otra cerrada
+        gpu.actualizarMapa(mapa.data(), ancho, alto, meta);
+        
+        RenderTexture2D destino = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+        Rectangle pantalla = {0, 0, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)};
+        
+        // Mismos píxeles a 1:1 (la textura de render sale invertida en Y en los dos casos)
+        Rectangle vistaNivel = {0, 0, static_cast<float>(MAP_WIDTH), static_cast<float>(MAP_HEIGHT)};
+        msPorFrame(destino, [&]() { renderSystem.drawTilesQuads(mapa.data(), ancho, vistaNivel, pantalla, meta, canales, true); });
+        Image conQuads = LoadImageFromTexture(destino.texture);
+        msPorFrame(destino, [&]() { gpu.dibujar(vistaNivel, pantalla, canales, true); });
+        Image conShader = LoadImageFromTexture(destino.texture);
+        ImageFormat(&conQuads, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        ImageFormat(&conShader, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        int distintos = pixelesDistintos(conQuads, conShader);
+        UnloadImage(conQuads);
+        UnloadImage(conShader);
+        bool iguales = distintos == 0;
+        printf("  %s píxeles distintos de los quads a 1:1: %d de %d\n", iguales ? "✅" : "❌", distintos,
+               SCREEN_WIDTH * SCREEN_HEIGHT);
+        
+        printf("  Vista (tiles) | quads (ms/frame) | shader (ms/frame) | x quads\n");
+        const int anchosVista[] = {MAP_WIDTH, MAP_WIDTH * 4, ancho};
+        for (int anchoVista : anchosVista) {
+            Rectangle vista = {0, 0, static_cast<float>(anchoVista), static_cast<float>(anchoVista * MAP_HEIGHT / MAP_WIDTH)};
+            double msQuads = msPorFrame(destino, [&]() {
+                renderSystem.drawTilesQuads(mapa.data(), ancho, vista, pantalla, meta, canales, true);
+            });
+            double msShader = msPorFrame(destino, [&]() { gpu.dibujar(vista, pantalla, canales, true); });
+            printf("  %5dx%-7d | %16.3f | %17.3f | %7.1f\n", anchoVista, static_cast<int>(vista.height), msQuads,
+                   msShader, msQuads / msShader);
+        }
+        
+        // Cambiar tres tiles sube tres texels, no el mapa (cada una a un tipo distinto del que tenía)
+        RenderTilemapGPU::Estadisticas antes = gpu.getEstadisticas();
+        auto cambiar = [&](int x, int y, int tile) { mapa[y * ancho + x] = mapa[y * ancho + x] != tile ? tile : VACIO; };
+        cambiar(1, 1, META);
+        cambiar(40, 5, PUERTA_2);
+        cambiar(90, 70, PARED);
+        gpu.actualizarMapa(mapa.data(), ancho, alto, meta);
+        const RenderTilemapGPU::Estadisticas& despues = gpu.getEstadisticas();
+        bool parcial = despues.subidasCompletas == antes.subidasCompletas &&
+                       despues.tilesSubidas - antes.tilesSubidas == 3;
+        printf("  %s cambiar 3 tiles sube %ld texels (mapa de %d)\n", parcial ? "✅" : "❌",
+               despues.tilesSubidas - antes.tilesSubidas, ancho * alto);
+        
+        UnloadRenderTexture(destino);
+        renderSystem.descargar();
+        textureManager.unloadAll();
+        CloseWindow();
+        return (iguales && parcial) ? 0 : 1;
+    }
+};
+
+// Benchmark del confeti con el lote instanciado (necesita ventana: se abre oculta). Mide el
+// tiempo de CPU del hilo de render en drawWithGlow con PARTICULAS partículas vivas, con el
+// lote y con el dibujo clásico de una llamada por halo y por partícula.
+class BenchParticulas {
+private:
+    static constexpr int PARTICULAS = 50000;
+    static constexpr int FRAMES = 60;
+    static constexpr int FRAMES_CLASICO = 5;            // El camino clásico es mucho más lento
+    static constexpr double OBJETIVO_MS = 1.0;
+    
+    // Mediana del tiempo de CPU de drawWithGlow; el confeti avanza entre frames como en el juego
+    static double medianaMs(EnhancedConfettiSystem& confeti, RenderTexture2D& destino, int frames) {
+        std::vector<double> tiempos;
+        for (int f = 0; f < frames; f++) {
+            confeti.update(1.0f / GameConstants::FPS_TARGET);
+            BeginTextureMode(destino);
+            ClearBackground(BLACK);
+            auto t0 = RelojArranque::now();
+            confeti.drawWithGlow();
+            tiempos.push_back(msDesde(t0));
+            EndTextureMode();
+        }
+        std::sort(tiempos.begin(), tiempos.end());
+        return tiempos[tiempos.size() / 2];
+    }
+    
+    // Solo el relleno de las instancias, sin subirlas ni dibujarlas: la parte del juego. Con un
+    // rasterizador por software (llvmpipe) el driver hace el trabajo de la GPU dentro de la
+    // llamada de dibujo y se lleva casi todo el tiempo de drawWithGlow.
+    static double medianaRellenoMs(EnhancedConfettiSystem& confeti, int frames) {
+        std::vector<double> tiempos;
+        for (int f = 0; f < frames; f++) {
+            confeti.update(1.0f / GameConstants::FPS_TARGET);
+            auto t0 = RelojArranque::now();
+            confeti.rellenarLote();
+            tiempos.push_back(msDesde(t0));
+        }
+        std::sort(tiempos.begin(), tiempos.end());
+        return tiempos[tiempos.size() / 2];
+    }
+    
+public:
+    static int ejecutar() {
+        using namespace GameConstants;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "DuoMaze - Benchmark partículas");
+        SetTargetFPS(0);
+        printf("🎉 Benchmark del confeti instanciado (%d partículas)\n", PARTICULAS);
         
-        std::string timeText = timeBuffer;
+        EnhancedConfettiSystem confeti;
+        bool ok = confeti.isInstanciado();
+        printf("  %s shader del lote compilado\n", ok ? "✅" : "❌");
+        if (!ok) {
+            CloseWindow();
+            return 1;
+        }
         
-        // POSICIÓN: Debajo del botón SALIR
-        float posY = exitButton.y + exitButton.height + 20;
-        float posX = GameConstants::SCREEN_WIDTH/2;
+        RenderTexture2D destino = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+        Vector2 centro = {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+        confeti.startEffect(centro, PARTICULAS);
+        double msLote = medianaMs(confeti, destino, FRAMES);
+        confeti.startEffect(centro, PARTICULAS);
+        double msRelleno = medianaRellenoMs(confeti, FRAMES);
         
-        // Tamaño de fuente
-        float fontSize = 24.0f;
+        confeti.startEffect(centro, PARTICULAS);
+        confeti.setInstanciado(false);
+        double msClasico = medianaMs(confeti, destino, FRAMES_CLASICO);
         
-        // Usar spaceranger.ttf
-        renderSystem.drawSpacerangerText(timeText, 
-            Vector2{posX, posY}, 
-            fontSize, 
-            GOLD,
-            BLACK);
+        // Lo que haya quedado en la GPU cuenta fuera del hilo de render
+        Image sincronizar = LoadImageFromTexture(destino.texture);
+        UnloadImage(sincronizar);
         
-        // Mensaje de felicitación (opcional)
-        std::string congratsText = "¡FELICIDADES!";
-        float congratsFontSize = 28.0f;
-        float congratsY = posY - 40;
+        bool rapido = msLote < OBJETIVO_MS;
+        printf("  Camino   | CPU (ms/frame, mediana)\n");
+        printf("  lote     | %23.3f\n", msLote);
+        printf("  relleno  | %23.3f\n", msRelleno);
+        printf("  clásico  | %23.3f\n", msClasico);
+        printf("  %s lote por debajo de %.1f ms de CPU (x%.1f frente al clásico)\n", rapido ? "✅" : "❌",
+               OBJETIVO_MS, msClasico / msLote);
         
-        renderSystem.drawSpacerangerText(congratsText, 
-            Vector2{posX, congratsY}, 
-            congratsFontSize, 
-            GOLD,
-            BLACK);
+        UnloadRenderTexture(destino);
+        confeti.descargar();
+        CloseWindow();
+        return rapido ? 0 : 1;
     }
 };
 
-// NUEVO: Sistema de niveles expandido
-class LevelSystem {
+// Benchmark del bloom (necesita ventana: se abre oculta). Coste por frame, con la GPU incluida,
+// del brillo por partícula (halo clásico con DrawCircleV y halo en el lote instanciado) frente
+// al posproceso en calidad baja y alta, con cada vez más confeti en pantalla. Se repite a las
+// escalas internas del lienzo de ESCALAS: la escena va a una textura de ese tamaño con la
+// escala como cámara, como en el juego.
+class BenchBloom {
+private:
+    static constexpr int FRAMES = 30;
+    static constexpr int FRAMES_CLASICO = 5;
+    static constexpr int TICKS_DISPERSION = 30;         // Medio segundo de vuelo: el confeti se reparte
+    static constexpr float ESCALAS[] = {1.0f, 2.0f};
+    
+    // Dibuja frames veces en el destino y espera a la GPU leyendo el resultado
+    template <typename F>
+    static double msPorFrame(RenderTexture2D& destino, int frames, F&& dibujar) {
+        auto t0 = RelojArranque::now();
+        for (int f = 0; f < frames; f++) dibujar();
+        Image sincronizar = LoadImageFromTexture(destino.texture);
+        UnloadImage(sincronizar);
+        return msDesde(t0) / frames;
+    }
+    
 public:
-    static void initializeLevel(GameState& state, int level) {
-        // Resetear estados
-        state.button1Active = false;
-        state.button2Active = false;
-        state.button3Active = false;
-        state.masterInGoal = false;
-        state.slaveInGoal = false;
-        state.bothInGoal = false;
-        state.levelCompleted = false;
-        
-        state.currentLevel = level;
+    static int ejecutar() {
+        using namespace GameConstants;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "DuoMaze - Benchmark bloom");
+        SetTargetFPS(0);
+        printf("✨ Benchmark del bloom frente al brillo por partícula\n");
         
-        switch(level) {
-            case 0: initializeLevel0(state); break;
-            case 1: initializeLevel1(state); break;
-            case 2: initializeLevel2(state); break;  // NUEVO: Nivel 2
-            case 3: initializeLevel3(state); break;  // NUEVO: Nivel 3
-            default: initializeLevel0(state); break;
+        CadenaBloom bloom;
+        EnhancedConfettiSystem confeti;
+        bool ok = bloom.cargar(SCREEN_WIDTH, SCREEN_HEIGHT) && confeti.isInstanciado();
+        printf("  %s shaders del bloom y del lote compilados\n", ok ? "✅" : "❌");
+        if (!ok) {
+            bloom.descargar();
+            confeti.descargar();
+            CloseWindow();
+            return 1;
         }
         
-        logger.write("🎮 Nivel " + std::to_string(level) + " cargado");
-    }
-    
-private:
-    static void loadLevelData(GameState& state, const int levelData[GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH]) {
-        for (int y = 0; y < GameConstants::MAP_HEIGHT; y++) {
-            for (int x = 0; x < GameConstants::MAP_WIDTH; x++) {
-                state.laberinto[y][x] = levelData[y][x];
+        const Rectangle pantalla = {0, 0, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)};
+        const int cantidades[] = {1000, 10000, 50000};
+        bool masBarato = true;
+        for (float escala : ESCALAS) {
+            int ancho = static_cast<int>(std::lround(SCREEN_WIDTH * escala));
+            int alto = static_cast<int>(std::lround(SCREEN_HEIGHT * escala));
+            bloom.ajustar(ancho, alto, escala);
+            RenderTexture2D destino = LoadRenderTexture(ancho, alto);
+            Camera2D camara = {};
+            camara.zoom = escala;
+            
+            auto conHalo = [&](bool instanciado) {
+                confeti.setInstanciado(instanciado);
+                confeti.setHalo(true);
+                BeginTextureMode(destino);
+                BeginMode2D(camara);
+                ClearBackground(BLACK);
+                confeti.drawWithGlow();
+                EndMode2D();
+                EndTextureMode();
+            };
+            auto conBloom = [&](CalidadBloom calidad) {
+                confeti.setInstanciado(true);
+                confeti.setHalo(false);
+                bloom.setCalidad(calidad);
+                bloom.comenzar();
+                ClearBackground(BLACK);
+                confeti.drawWithGlow();
+                bloom.terminar();
+                bloom.procesar([&]() { confeti.drawEmisivo(); });
+                BeginTextureMode(destino);
+                BeginMode2D(camara);
+                bloom.componer(pantalla);
+                EndMode2D();
+                EndTextureMode();
+            };
+            
+            double msClasico = 0.0, msAlta = 0.0;
+            printf("  Escala %.1f (%dx%d)\n", escala, ancho, alto);
+            printf("  Partículas | halo clásico | halo instanciado | bloom baja | bloom alta (ms/frame)\n");
+            for (int n : cantidades) {
+                confeti.startEffect({SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, n);
+                for (int t = 0; t < TICKS_DISPERSION; t++) confeti.update(1.0f / FPS_TARGET);
                 
-                if (levelData[y][x] == START_MASTER) {
-                    state.masterPos = {
-                        static_cast<float>(x * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2), 
-                        static_cast<float>(y * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2)
-                    };
-                }
-                if (levelData[y][x] == START_SLAVE) {
-                    state.slavePos = {
-                        static_cast<float>(x * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2), 
-                        static_cast<float>(y * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2)
-                    };
-                }
+                msClasico = msPorFrame(destino, FRAMES_CLASICO, [&]() { conHalo(false); });
+                double msInstanciado = msPorFrame(destino, FRAMES, [&]() { conHalo(true); });
+                double msBaja = msPorFrame(destino, FRAMES, [&]() { conBloom(BLOOM_BAJA); });
+                msAlta = msPorFrame(destino, FRAMES, [&]() { conBloom(BLOOM_ALTA); });
+                printf("  %10d | %12.3f | %16.3f | %10.3f | %10.3f\n", n, msClasico, msInstanciado, msBaja, msAlta);
             }
+            
+            // Con mucho confeti el coste del bloom no crece con las partículas y el del halo sí
+            bool esta = msAlta < msClasico;
+            masBarato = masBarato && esta;
+            printf("  %s bloom alto más barato que el halo por partícula con el máximo de confeti (x%.1f)\n",
+                   esta ? "✅" : "❌", msClasico / msAlta);
+            UnloadRenderTexture(destino);
         }
+        
+        bloom.descargar();
+        confeti.descargar();
+        CloseWindow();
+        return masBarato ? 0 : 1;
     }
-    //Nivel 1
-    static void initializeLevel0(GameState& state) {
-        constexpr int nivel0[GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH] = {
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-            {1, 2, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 1},
-            {1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 1, 0, 1},
-            {1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1},
-            {1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1},
-            {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1},
-            {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 8, 1},
-            {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 3, 0, 0, 0, 0, 0, 0, 7, 0, 5, 0, 0, 0, 0, 0, 0, 0, 12, 1},
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-          };
-        
-        loadLevelData(state, nivel0);
-    }
-    
-    //Nivel 2
-    static void initializeLevel1(GameState& state) {
-    constexpr int nivel1[GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH] = {
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 4, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1},
-        {1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1},
-        {1, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 1, 11, 1},
-        {1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 1, 1, 5, 1, 0, 1, 0, 1},
-        {1, 1, 0, 0, 1, 1, 1, 0, 1, 6, 1, 0, 0, 0, 0, 10, 0, 1, 0, 1},
-        {1, 0, 0, 0, 1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
-        {1, 0, 1, 0, 1, 1, 1, 7, 8, 0, 1, 1, 0, 11, 0, 0, 0, 0, 0, 1},
-        {1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1},
-        {1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 9, 1, 1, 1, 0, 1},
-        {1, 10, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 1, 1, 1, 12, 1, 1, 1, 0, 1},
-        {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-        {1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
+};
+
+// Benchmark del menú en reposo (necesita ventana: se abre oculta). Consumo de CPU del proceso
+// y coste de GPU por frame del menú dibujado entero cada frame (como antes), del menú en caché
+// y del menú en caché en reposo a MENU_FPS_REPOSO, más la comprobación de que un cambio de
+// hover redibuja solo su botón.
+class BenchMenu {
+private:
+    static constexpr double SEGUNDOS = 3.0;
+    static constexpr int FRAMES_GPU = 60;
+    
+    struct Medida {
+        double fps;
+        double cpuPorciento;        // De un núcleo
+        double gpuPorciento;        // Estimado: coste de GPU por frame x frames por segundo
     };
     
-    loadLevelData(state, nivel1);
-}
-    // Nivel 3
-    static void initializeLevel2(GameState& state) {
-        constexpr int nivel2[GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH] = {
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-            {1, 0, 0, 0, 11, 0, 0, 0, 0, 0, 6, 1, 0, 0, 0, 0, 4, 7, 0, 1},
-            {1, 0, 1, 0, 1, 8, 1, 1, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1},
-            {1, 0, 1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
-            {1, 0, 0, 0, 10, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1},
-            {1, 1, 0, 1, 1, 1, 0, 0, 1, 1, 9, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 5, 0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 10, 0, 0, 0, 0, 1},
-            {1, 0, 1, 0, 1, 0, 1, 1, 1, 1, 9, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1},
-            {1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 0, 1, 0, 1, 1, 1, 0, 1, 0, 1},
-            {1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 12, 0, 0, 1, 0, 1},
-            {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-            {1, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 1},
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-        };
+    template <typename F>
+    static Medida medir(int fpsObjetivo, RenderTexture2D& destino, F&& dibujar) {
+        // GPU: frames seguidos en una textura, esperando al final
+        auto g0 = RelojArranque::now();
+        for (int f = 0; f < FRAMES_GPU; f++) {
+            BeginTextureMode(destino);
+            ClearBackground(RAYWHITE);
+            dibujar();
+            EndTextureMode();
+        }
+        Image sincronizar = LoadImageFromTexture(destino.texture);
+        UnloadImage(sincronizar);
+        double msGPU = msDesde(g0) / FRAMES_GPU;
         
-        loadLevelData(state, nivel2);
-    }
-    
-    //Nivel 4
-    static void initializeLevel3(GameState& state) {
-    constexpr int nivel3[GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH] = {
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 0, 4, 1, 6, 0, 0, 8, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 1},
-        {1, 10, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 0, 11, 0, 1, 0, 1, 0, 1},
-        {1, 0, 0, 11, 0, 10, 0, 1, 0, 1, 0, 1, 0, 1, 0, 10, 0, 1, 0, 1},
-        {1, 11, 10, 1, 0, 1, 0, 1, 0, 1, 0, 10, 0, 1, 0, 1, 0, 1, 0, 1},
-        {1, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
-        {1, 10, 11, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
-        {1, 0, 0, 1, 0, 11, 0, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
-        {1, 11, 10, 1, 10, 1, 1, 0, 0, 10, 0, 11, 0, 1, 0, 1, 0, 1, 0, 1},
-        {1, 0, 0, 0, 0, 11, 5, 1, 0, 7, 0, 1, 0, 10, 0, 11, 0, 1, 0, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
-        {1, 0, 9, 3, 0, 10, 0, 11, 0, 1, 0, 11, 0, 1, 0, 11, 0, 1, 0, 1},
-        {1, 12, 1, 0, 0, 11, 0, 1, 0, 10, 0, 1, 0, 10, 0, 1, 0, 10, 0, 1},
-        {1, 0, 9, 2, 0, 1, 0, 10, 0, 11, 0, 10, 0, 11, 0, 10, 0, 11, 0, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-    };
+        // CPU: presentando de verdad al ritmo objetivo
+        SetTargetFPS(fpsObjetivo);
+        int frames = 0;
+        double cpu0 = msCPUProceso();
+        auto t0 = RelojArranque::now();
+        while (msDesde(t0) < SEGUNDOS * 1000.0) {
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+            dibujar();
+            EndDrawing();
+            frames++;
+        }
+        double ms = msDesde(t0);
+        double fps = frames * 1000.0 / ms;
+        return {fps, 100.0 * (msCPUProceso() - cpu0) / ms, 100.0 * msGPU * fps / 1000.0};
+    }
     
-    loadLevelData(state, nivel3);
-}
+public:
+    static int ejecutar() {
+        using namespace GameConstants;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "DuoMaze - Benchmark menú");
+        printf("🖼️  Benchmark del menú en reposo (%.0f s por modo)\n", SEGUNDOS);
+        
+        TextureManager textureManager;
+        if (!textureManager.cargarDesdePaquete("resources/duomaze.pak")) textureManager.loadAllTextures();
+        AudioSystem audio;
+        RenderSystem renderSystem(textureManager);
+        MenuSystem menu(textureManager, audio, renderSystem);
+        RenderTexture2D destino = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+        
+        // Ratón fuera de los botones: menú quieto
+        SetMousePosition(10, 10);
+        menu.actualizarCache();
+        Medida antes = medir(FPS_TARGET, destino, [&]() { menu.drawInmediato(); });
+        Medida cache = medir(FPS_TARGET, destino, [&]() { menu.draw(); });
+        Medida reposo = medir(MENU_FPS_REPOSO, destino, [&]() { menu.draw(); });
+        
+        printf("  Modo                  |   FPS | CPU (%% núcleo) | GPU (%% estimado)\n");
+        printf("  antes: todo cada frame | %5.1f | %14.2f | %16.2f\n", antes.fps, antes.cpuPorciento, antes.gpuPorciento);
+        printf("  caché                 | %5.1f | %14.2f | %16.2f\n", cache.fps, cache.cpuPorciento, cache.gpuPorciento);
+        printf("  caché + reposo        | %5.1f | %14.2f | %16.2f\n", reposo.fps, reposo.cpuPorciento, reposo.gpuPorciento);
+        
+        // Entrar en JUGAR, quedarse, y pasar a SALIR: tres cambios de hover, tres regiones
+        int regiones0 = menu.getRegionesRedibujadas();
+        const Vector2 recorrido[] = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f + 25}, {SCREEN_WIDTH / 2.0f + 5, SCREEN_HEIGHT / 2.0f + 25},
+                                     {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f + 95}, {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f + 95}};
+        for (const Vector2& p : recorrido) {
+            SetMousePosition(static_cast<int>(p.x), static_cast<int>(p.y));
+            menu.actualizarCache();
+            BeginDrawing();
+            menu.draw();
+            EndDrawing();
+        }
+        int regiones = menu.getRegionesRedibujadas() - regiones0;
+        
+        bool menosCPU = reposo.cpuPorciento < antes.cpuPorciento;
+        bool menosGPU = reposo.gpuPorciento < antes.gpuPorciento && cache.gpuPorciento <= antes.gpuPorciento;
+        bool sucio = regiones == 3;
+        printf("  %s CPU en reposo: %.2f%% frente a %.2f%% (x%.1f)\n", menosCPU ? "✅" : "❌", reposo.cpuPorciento,
+               antes.cpuPorciento, antes.cpuPorciento / std::max(reposo.cpuPorciento, 0.01));
+        printf("  %s GPU en reposo: %.2f%% frente a %.2f%%\n", menosGPU ? "✅" : "❌", reposo.gpuPorciento, antes.gpuPorciento);
+        printf("  %s tres cambios de hover redibujan %d regiones de botón\n", sucio ? "✅" : "❌", regiones);
+        
+        UnloadRenderTexture(destino);
+        menu.descargar();
+        textureManager.unloadAll();
+        CloseWindow();
+        return (menosCPU && menosGPU && sucio) ? 0 : 1;
+    }
 };
 
-// Controlador de audio en pantalla
-class AudioOverlay {
+// Benchmark del ritmo de frames (sin ventana: el trabajo del frame se simula girando). Precisión
+// de la espera híbrida frente a solo dormir a 60, 144 y 240 Hz, y reacción del modo adaptativo
+// a un frame que deja de caber en su periodo y vuelve a caber.
+class BenchRitmo {
 private:
-    std::atomic<bool> mostrarControles{false};
-    double tiempoOcultarControles{0};
+    static constexpr double SEGUNDOS = 2.0;
+    static constexpr double OBJETIVO_P99_MS = 0.5;
+    static constexpr int REPETICIONES = 3;     // Se queda la mejor: filtra interferencias de otros procesos
+    
+    static void trabajar(double ms) {
+        auto fin = RelojArranque::now() + std::chrono::duration_cast<RelojArranque::duration>(
+                                              std::chrono::duration<double, std::milli>(ms));
+        while (RelojArranque::now() < fin) {}
+    }
+    
+    struct Precision {
+        double p99RetrasoMs;
+        double jitterMs;
+        long perdidos;
+    };
+    
+    // Trabajo aleatorio entre el 20% y el 60% del periodo
+    static Precision precision(int hz, bool giro) {
+        RitmoFrames ritmo;
+        ritmo.setModo(RITMO_FIJO);
+        ritmo.setContexto(CONTEXTO_JUEGO);
+        ritmo.setObjetivos(hz, hz, hz);
+        ritmo.setGiro(giro);
+        uint32_t semilla = 0x717A0u + hz;
+        std::vector<double> retrasos;
+        int frames = static_cast<int>(SEGUNDOS * hz);
+        for (int f = 0; f < frames; f++) {
+            semilla = semilla * 1664525u + 1013904223u;
+            trabajar((0.2 + 0.4 * (semilla >> 8) / 16777216.0) * 1000.0 / hz);
+            retrasos.push_back(ritmo.esperarPlazo());
+            ritmo.marcarPresentacion();
+        }
+        std::sort(retrasos.begin(), retrasos.end());
+        const EstadisticasRitmo& e = ritmo.getEstadisticas(RITMO_FIJO, CONTEXTO_JUEGO);
+        return {retrasos[retrasos.size() * 99 / 100], e.jitterMs(), e.perdidos};
+    }
+    
+    static Precision mejorPrecision(int hz, bool giro) {
+        Precision mejor = precision(hz, giro);
+        for (int r = 1; r < REPETICIONES; r++) {
+            Precision otra = precision(hz, giro);
+            if (otra.perdidos < mejor.perdidos ||
+                (otra.perdidos == mejor.perdidos && otra.p99RetrasoMs < mejor.p99RetrasoMs)) mejor = otra;
+        }
+        return mejor;
+    }
+    
+    // n frames con un trabajo fijo; devuelve los perdidos en la segunda mitad (ya adaptado)
+    static long fase(RitmoFrames& ritmo, double trabajoMs, int frames) {
+        long antes = 0;
+        for (int f = 0; f < frames; f++) {
+            if (f == frames / 2) antes = ritmo.getEstadisticas(RITMO_ADAPTATIVO, CONTEXTO_JUEGO).perdidos;
+            trabajar(trabajoMs);
+            ritmo.esperarPlazo();
+            ritmo.marcarPresentacion();
+        }
+        return ritmo.getEstadisticas(RITMO_ADAPTATIVO, CONTEXTO_JUEGO).perdidos - antes;
+    }
     
 public:
-    void update() {
-        if (GetTime() > tiempoOcultarControles) {
-            mostrarControles = false;
+    static int ejecutar() {
+        printf("⏱️  Benchmark del ritmo de frames (mejor de %d pasadas)\n", REPETICIONES);
+        printf("    Hz | espera  | p99 retraso (ms) | jitter (ms) | perdidos\n");
+        bool preciso = true;
+        for (int hz : {60, 144, 240}) {
+            Precision dormir = mejorPrecision(hz, false);
+            Precision hibrida = mejorPrecision(hz, true);
+            printf("  %4d | dormir  | %16.3f | %11.3f | %8ld\n", hz, dormir.p99RetrasoMs, dormir.jitterMs, dormir.perdidos);
+            printf("  %4d | híbrida | %16.3f | %11.3f | %8ld\n", hz, hibrida.p99RetrasoMs, hibrida.jitterMs, hibrida.perdidos);
+            preciso = preciso && hibrida.p99RetrasoMs < OBJETIVO_P99_MS && hibrida.perdidos == 0;
         }
+        printf("  %s espera híbrida con p99 por debajo de %.1f ms y sin frames perdidos\n", preciso ? "✅" : "❌",
+               OBJETIVO_P99_MS);
+        
+        // 144 Hz con 10 ms de trabajo no cabe (6.9 ms): tiene que bajar a 72 Hz sin perder frames;
+        // con 3 ms vuelve a caber y tiene que volver a 144
+        RitmoFrames ritmo;
+        ritmo.setModo(RITMO_ADAPTATIVO);
+        ritmo.setContexto(CONTEXTO_JUEGO);
+        ritmo.setObjetivos(144, 30, 10);
+        long perdidosPesado = fase(ritmo, 10.0, static_cast<int>(SEGUNDOS * 72));
+        int hzPesado = ritmo.getHzEfectivo();
+        long perdidosLigero = fase(ritmo, 3.0, static_cast<int>(SEGUNDOS * 144));
+        int hzLigero = ritmo.getHzEfectivo();
+        bool adapta = hzPesado == 72 && perdidosPesado == 0 && hzLigero == 144 && perdidosLigero == 0;
+        printf("  %s adaptativo: 10 ms de trabajo -> %d Hz (%ld perdidos ya adaptado), 3 ms -> %d Hz (%ld perdidos)\n",
+               adapta ? "✅" : "❌", hzPesado, perdidosPesado, hzLigero, perdidosLigero);
+        return (preciso && adapta) ? 0 : 1;
     }
+};
+
+// Benchmark del lienzo virtual (necesita ventana: se abre oculta). Coste de GPU de un frame de
+// juego en una salida 4K dibujado a resolución nativa (todo ampliado con una cámara) frente al
+// lienzo más un solo quad escalado, con el vecino más cercano y con bilineal nítido, a cada
+// escala interna de ESCALAS. La comparación con el nativo se hace a escala 1.
+class BenchLienzo {
+private:
+    static constexpr int FRAMES = 30;
+    static constexpr int ANCHO_SALIDA = 3840;
+    static constexpr int ALTO_SALIDA = 2160;
+    static constexpr float ESCALAS[] = {0.5f, 1.0f, 2.0f};
     
-    void draw() {
-        if (!mostrarControles) return;
+    template <typename F>
+    static double msPorFrame(RenderTexture2D& salida, F&& dibujar) {
+        auto t0 = RelojArranque::now();
+        for (int f = 0; f < FRAMES; f++) dibujar();
+        Image sincronizar = LoadImageFromTexture(salida.texture);
+        UnloadImage(sincronizar);
+        return msDesde(t0) / FRAMES;
+    }
+    
+public:
+    static int ejecutar() {
+        using namespace GameConstants;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "DuoMaze - Benchmark lienzo");
+        SetTargetFPS(0);
+        printf("🖥️  Benchmark del lienzo virtual: un frame de juego en una salida de %dx%d\n", ANCHO_SALIDA, ALTO_SALIDA);
         
-        DrawRectangle(10, GameConstants::SCREEN_HEIGHT - 120, 250, 110, Fade(BLACK, 0.8f));
-        DrawText("CONTROLES AUDIO:", 20, GameConstants::SCREEN_HEIGHT - 110, 16, YELLOW);
-        DrawText("P: Pausar/Reanudar musica", 20, GameConstants::SCREEN_HEIGHT - 90, 14, WHITE);
-        DrawText("M: Mutear", 20, GameConstants::SCREEN_HEIGHT - 70, 14, WHITE);
-        DrawText("U: Subir volumen", 20, GameConstants::SCREEN_HEIGHT - 50, 14, WHITE);
-        DrawText("H: Alto/Bajo volumen", 20, GameConstants::SCREEN_HEIGHT - 30, 14, WHITE);
-        DrawText("V: Mostrar/ocultar controles", 20, GameConstants::SCREEN_HEIGHT - 10, 14, WHITE);
+        TextureManager textureManager;
+        if (!textureManager.cargarDesdePaquete("resources/duomaze.pak")) textureManager.loadAllTextures();
+        RenderSystem renderSystem(textureManager);
+        GameState estado;
+        LevelSystem::initializeLevel(estado, 0);
+        LienzoVirtual lienzo(SCREEN_WIDTH, SCREEN_HEIGHT);
+        RenderTexture2D salida = LoadRenderTexture(ANCHO_SALIDA, ALTO_SALIDA);
+        bool ok = lienzo.cargar(1.0f, ESCALADO_NITIDO) && lienzo.hayNitido() && salida.id != 0;
+        printf("  %s lienzo y shader del bilineal nítido listos\n", ok ? "✅" : "❌");
+        if (!ok) {
+            if (salida.id != 0) UnloadRenderTexture(salida);
+            lienzo.descargar();
+            textureManager.unloadAll();
+            CloseWindow();
+            return 1;
+        }
+        
+        auto escena = [&]() {
+            ClearBackground(RAYWHITE);
+            renderSystem.drawLaberinto(estado);
+            renderSystem.drawPlayers(estado);
+            DrawRectangle(0, 0, SCREEN_WIDTH, 40, Fade(BLACK, 0.4f));
+            renderSystem.drawSpacerangerText("NIVEL 1", Vector2{SCREEN_WIDTH / 2.0f - 50, 8}, 24, WHITE);
+        };
+        
+        // Nativo: la misma escena con una cámara que la ajusta a la salida
+        float factor = std::min(static_cast<float>(ANCHO_SALIDA) / SCREEN_WIDTH, static_cast<float>(ALTO_SALIDA) / SCREEN_HEIGHT);
+        Camera2D ajuste = {};
+        ajuste.offset = {(ANCHO_SALIDA - SCREEN_WIDTH * factor) / 2, (ALTO_SALIDA - SCREEN_HEIGHT * factor) / 2};
+        ajuste.zoom = factor;
+        double msNativo = msPorFrame(salida, [&]() {
+            BeginTextureMode(salida);
+            ClearBackground(BLACK);
+            BeginMode2D(ajuste);
+            escena();
+            EndMode2D();
+            EndTextureMode();
+        });
+        
+        auto conLienzo = [&]() {
+            lienzo.comenzar();
+            escena();
+            lienzo.terminar();
+            BeginTextureMode(salida);
+            lienzo.presentar(ANCHO_SALIDA, ALTO_SALIDA);
+            EndTextureMode();
+        };
+        
+        printf("  Camino                            | ms/frame\n");
+        printf("  nativo a %dx%d               | %8.3f\n", ANCHO_SALIDA, ALTO_SALIDA, msNativo);
+        double msNitido = 0.0;
+        for (float escala : ESCALAS) {
+            if (!lienzo.cargar(escala, ESCALADO_CERCANO)) continue;
+            double msCercano = msPorFrame(salida, conLienzo);
+            lienzo.setFiltro(ESCALADO_NITIDO);
+            double msEsta = msPorFrame(salida, conLienzo);
+            if (escala == 1.0f) msNitido = msEsta;
+            printf("  lienzo %.1fx (%4dx%-4d) + cercano | %8.3f\n", escala, lienzo.getAnchoInterno(),
+                   lienzo.getAltoInterno(), msCercano);
+            printf("  lienzo %.1fx (%4dx%-4d) + nítido  | %8.3f\n", escala, lienzo.getAnchoInterno(),
+                   lienzo.getAltoInterno(), msEsta);
+        }
+        
+        // El ratón de la salida llega en coordenadas virtuales: el centro de la salida es el del lienzo
+        Rectangle d = lienzo.getDestino();
+        bool centrado = std::abs(d.x + d.width / 2 - ANCHO_SALIDA / 2.0f) <= 1 && std::abs(d.y + d.height / 2 - ALTO_SALIDA / 2.0f) <= 1;
+        bool masBarato = msNitido < msNativo;
+        printf("  %s lienzo centrado en %.0fx%.0f con la proporción de %dx%d\n", centrado ? "✅" : "❌", d.width, d.height,
+               SCREEN_WIDTH, SCREEN_HEIGHT);
+        printf("  %s lienzo 1x + nítido más barato que nativo (x%.1f)\n", masBarato ? "✅" : "❌", msNativo / msNitido);
         
+        UnloadRenderTexture(salida);
+        lienzo.descargar();
+        textureManager.unloadAll();
+        CloseWindow();
+        return (centrado && masBarato) ? 0 : 1;
     }
+};
+
+// Reservas de memoria del bucle principal (--contar-asignaciones [frames]). El juego arranca
+// directamente en el nivel 1 con las pistas, el overlay de audio y los paneles F3 y F4 a la
+// vista; tras FRAMES_CALENTAMIENTO frames cuenta las reservas con new del hilo principal
+// durante N frames jugando y otros N con los dos jugadores en la meta (confeti y pantalla de
+// victoria). Tienen que ser cero. El contador solo existe compilando con
+// -DDUOMAZE_CONTAR_ASIGNACIONES.
+class ComprobacionAsignaciones {
+public:
+    enum Fase { JUGANDO = 0, VICTORIA, TERMINADA };
     
-    void showTemporarily(double seconds = 3.0) {
-        mostrarControles = true;
-        tiempoOcultarControles = GetTime() + seconds;
+private:
+    static constexpr int FRAMES_CALENTAMIENTO = 60;
+    
+    int frames;                     // Frames contados por fase
+    Fase fase = JUGANDO;
+    int enFase = 0;
+    long inicio = 0;
+    long reservas[2] = {0, 0};
+    
+public:
+    explicit ComprobacionAsignaciones(int framesPorFase) : frames(std::max(1, framesPorFase)) {}
+    
+    Fase getFase() const { return fase; }
+    
+    // Los dos jugadores al centro de la primera tile de meta del nivel actual
+    static void llevarAMeta(GameState& estado) {
+        const MetadatosNivel& meta = metadatosNivel(estado.currentLevel.load());
+        std::lock_guard<std::mutex> lock(estado.mtx);
+        for (int y = 0; y < GameConstants::MAP_HEIGHT; y++) {
+            for (int x = 0; x < GameConstants::MAP_WIDTH; x++) {
+                if (!meta.rasgos(estado.laberinto[y][x]).meta) continue;
+                Vector2 centro = {static_cast<float>(x * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2),
+                                  static_cast<float>(y * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2)};
+                estado.masterPos = centro;
+                estado.slavePos = centro;
+                return;
+            }
+        }
     }
     
-    void toggle() {
-        mostrarControles = !mostrarControles;
-        if (mostrarControles) {
-            tiempoOcultarControles = GetTime() + 3.0;
+    // Tras cada frame completo (EndDrawing y reinicio de la arena); devuelve la fase siguiente
+    Fase frameTerminado() {
+        if (fase == TERMINADA) return fase;
+        enFase++;
+        if (enFase == FRAMES_CALENTAMIENTO) inicio = ContadorAsignaciones::delHilo();
+        if (enFase == FRAMES_CALENTAMIENTO + frames) {
+            reservas[fase] = ContadorAsignaciones::delHilo() - inicio;
+            fase = static_cast<Fase>(fase + 1);
+            enFase = 0;
         }
+        return fase;
+    }
+    
+    // Código de salida del proceso
+    int informe() const {
+        bool contado = ContadorAsignaciones::activo();
+        bool terminada = fase == TERMINADA;
+        bool cero = contado && terminada && reservas[JUGANDO] == 0 && reservas[VICTORIA] == 0;
+        bool cabe = arenaFrame.getDesbordes() == 0;
+        printf("🧮 Reservas de memoria del bucle principal (%d frames por fase tras %d de calentamiento)\n", frames,
+               FRAMES_CALENTAMIENTO);
+        if (!contado) printf("  ⚠️  Sin contador: compila con -DDUOMAZE_CONTAR_ASIGNACIONES\n");
+        if (!terminada) printf("  ⚠️  La ventana se cerró antes de terminar de contar\n");
+        printf("  %s reservas con new: %ld jugando, %ld con el nivel completado\n", cero ? "✅" : "❌",
+               reservas[JUGANDO], reservas[VICTORIA]);
+        printf("  %s arena del frame: %zu de %zu bytes como máximo, %ld desbordes\n", cabe ? "✅" : "❌",
+               arenaFrame.getMaximo(), arenaFrame.getCapacidad(), arenaFrame.getDesbordes());
+        return (cero && cabe) ? 0 : 1;
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
+    // Modo en red: --host [puerto] | --unir <ip> [puerto], opcionalmente con
+    // --rollback (entre pares), --latencia <ms de ida> y --perdida <%> para probar en LAN.
+    // --prueba-red y --bench-rollback [rttMs] [perdida%] se ejecutan sin ventana.
+    // --companero master|slave: la IA maneja ese jugador (un jugador, sin red).
+    // --bench-companero mide el planificador de la IA sin ventana.
+    // --jugadores <2-8>: modo fiesta local; --bench-jugadores mide sus sistemas sin ventana.
+    // --tilemap-gpu: mapa en una sola pasada de shader; --bench-tilemap lo compara (ventana oculta).
+    // --bench-particulas mide el confeti instanciado con 50k partículas (ventana oculta).
+    // --bloom alta|baja|no: calidad del posproceso (tecla B en juego); --bench-bloom lo mide.
+    // --menu-eventos: el menú quieto espera a eventos en vez de bajar a pocos FPS; --bench-menu.
+    // --ritmo libre|fijo|adaptativo, --hz <juego>, --hz-menu <menú>, --vsync; --bench-ritmo (F3: estadísticas).
+    // --escala <interna>, --escalado cercano|nitido, --pantalla-completa (F11); --bench-lienzo.
+    // --contar-asignaciones [frames]: reservas del bucle principal jugando y en la victoria; sale
+    // con 1 si hay alguna (compilar con -DDUOMAZE_CONTAR_ASIGNACIONES).
+    ConexionRed red;
+    bool iaMaster = false;
+    bool iaSlave = false;
+    int jugadoresFiesta = 0;
+    std::unique_ptr<SesionFiesta> fiesta;
+    bool tilemapGPU = false;
+    CalidadBloom calidadBloom = BLOOM_ALTA;
+    bool menuEventos = false;
+    ModoRitmo modoRitmo = RITMO_ADAPTATIVO;
+    int hzJuego = GameConstants::FPS_TARGET;
+    int hzMenu = GameConstants::MENU_FPS;
+    bool pedirVsync = false;
+    float escalaInterna = 1.0f;
+    FiltroEscalado filtroEscalado = ESCALADO_NITIDO;
+    bool pantallaCompleta = false;
+    int framesContados = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hayValor = i + 1 < argc && argv[i + 1][0] != '-';
+        if (arg == "--prueba-red" || arg == "--bench-rollback") {
+            double rtt = hayValor ? std::atof(argv[++i]) : 150.0;
+            float perdida = (i + 1 < argc && argv[i + 1][0] != '-') ? std::atof(argv[++i]) / 100.0f : 0.05f;
+            return arg == "--prueba-red" ? PruebaRed::ejecutar(rtt, perdida) : BenchRollback::ejecutar(rtt, perdida);
+        } else if (arg == "--bench-companero") {
+            return BenchCompanero::ejecutar();
+        } else if (arg == "--bench-jugadores") {
+            return BenchJugadores::ejecutar();
+        } else if (arg == "--bench-tilemap") {
+            return BenchTilemap::ejecutar();
+        } else if (arg == "--bench-particulas") {
+            return BenchParticulas::ejecutar();
+        } else if (arg == "--bench-bloom") {
+            return BenchBloom::ejecutar();
+        } else if (arg == "--bench-menu") {
+            return BenchMenu::ejecutar();
+        } else if (arg == "--bench-ritmo") {
+            return BenchRitmo::ejecutar();
+        } else if (arg == "--bench-lienzo") {
+            return BenchLienzo::ejecutar();
+        } else if (arg == "--contar-asignaciones") {
+            framesContados = hayValor ? std::atoi(argv[++i]) : 600;
+        } else if (arg == "--menu-eventos") {
+            menuEventos = true;
+        } else if (arg == "--ritmo" && hayValor) {
+            std::string valor = argv[++i];
+            modoRitmo = valor == "libre" ? RITMO_LIBRE : (valor == "fijo" ? RITMO_FIJO : RITMO_ADAPTATIVO);
+        } else if (arg == "--hz" && hayValor) {
+            hzJuego = std::atoi(argv[++i]);
+        } else if (arg == "--hz-menu" && hayValor) {
+            hzMenu = std::atoi(argv[++i]);
+        } else if (arg == "--vsync") {
+            pedirVsync = true;
+        } else if (arg == "--escala" && hayValor) {
+            escalaInterna = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--escalado" && hayValor) {
+            filtroEscalado = std::string(argv[++i]) == "cercano" ? ESCALADO_CERCANO : ESCALADO_NITIDO;
+        } else if (arg == "--pantalla-completa") {
+            pantallaCompleta = true;
+        } else if (arg == "--bloom" && hayValor) {
+            std::string valor = argv[++i];
+            calidadBloom = valor == "no" ? BLOOM_APAGADO : (valor == "baja" ? BLOOM_BAJA : BLOOM_ALTA);
+        } else if (arg == "--tilemap-gpu") {
+            tilemapGPU = true;
+        } else if (arg == "--jugadores" && hayValor) {
+            jugadoresFiesta = std::max(ComponentesConstants::MIN_JUGADORES,
+                                       std::min(ComponentesConstants::MAX_JUGADORES, std::atoi(argv[++i])));
+        } else if (arg == "--companero" && hayValor) {
+            std::string rolIA = argv[++i];
+            iaMaster = rolIA == "master";
+            iaSlave = !iaMaster;
+        } else if (arg == "--rollback") {
+            red.rollback = true;
+        } else if (arg == "--host") {
+            red.activa = true;
+            red.rol = SesionRed::HOST;
+            if (hayValor) red.puerto = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--unir" && hayValor) {
+            red.activa = true;
+            red.rol = SesionRed::CLIENTE;
+            red.ip = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') red.puerto = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--latencia" && hayValor) {
+            red.latenciaMs = std::atof(argv[++i]);
+        } else if (arg == "--perdida" && hayValor) {
+            red.perdida = std::atof(argv[++i]) / 100.0f;
+        }
+    }
+    
+    auto inicioArranque = RelojArranque::now();
     logger.write("=== DuoMaze Iniciado ===");
+    if (iaMaster || iaSlave) {
+        logger.write(std::string("🤖 Compañero IA controla al ") + (iaMaster ? "master" : "slave"));
+    }
     
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE | (pedirVsync ? FLAG_VSYNC_HINT : 0));
     InitWindow(GameConstants::SCREEN_WIDTH, GameConstants::SCREEN_HEIGHT, "DuoMaze - Sistema de Niveles");
-    SetTargetFPS(GameConstants::FPS_TARGET);
+    SetWindowMinSize(GameConstants::SCREEN_WIDTH / 2, GameConstants::SCREEN_HEIGHT / 2);
+    if (pantallaCompleta) LienzoVirtual::alternarPantallaCompleta(GameConstants::SCREEN_WIDTH, GameConstants::SCREEN_HEIGHT);
+    
+    // Todo se dibuja en coordenadas virtuales de 800x600 y se escala a la ventana al final
+    LienzoVirtual lienzo(GameConstants::SCREEN_WIDTH, GameConstants::SCREEN_HEIGHT);
+    if (lienzo.cargar(escalaInterna, filtroEscalado)) {
+        logger.write("🖥️  Lienzo de " + std::to_string(lienzo.getAnchoInterno()) + "x" +
+                     std::to_string(lienzo.getAltoInterno()) + ", escalado " +
+                     LienzoVirtual::nombreFiltro(lienzo.hayNitido() ? filtroEscalado : ESCALADO_CERCANO));
+    } else {
+        logger.write("⚠️  Advertencia: sin textura de render para el lienzo, se dibuja a 800x600 sin escalar");
+    }
+    SetTargetFPS(GameConstants::FPS_TARGET);    // Solo durante la carga; después manda el ritmo de frames
 
     AudioSystem audio;
     GameState gameState;
     TextureManager textureManager;
     RenderSystem renderSystem(textureManager);
+    renderSystem.setTilemapGPU(tilemapGPU);
     MenuSystem menuSystem(textureManager, audio, renderSystem);
     AudioOverlay audioOverlay;
     
@@ -1543,18 +4882,100 @@ int main() {
     EnhancedConfettiSystem confettiSystem;
     bool confettiActive = false;
     
+    // Posproceso de brillo del gameplay; los shaders se compilan tras la carga
+    CadenaBloom bloom;
+    bloom.setCalidad(calidadBloom);
+    
+    SistemaPistas pistas;
+    
     GameScreen currentScreen = MENU;
     bool shouldClose = false;
     
+    // Carga en paralelo: texturas/fuentes en hilos de trabajo y audio en su propio hilo,
+    // mientras el hilo principal sube a GPU y dibuja la pantalla de carga
+    logger.write("⏱️  Ventana lista en " + std::to_string(msDesde(inicioArranque)) + " ms");
+    
+    std::atomic<bool> audioListo{false};
+    double msAudio = 0.0;
+    std::thread cargaAudio([&audio, &audioListo, &msAudio]() {
+        auto inicio = RelojArranque::now();
+        audio.cargarMusicas();
+        msAudio = msDesde(inicio);
+        audioListo = true;
+    });
+    
+    // Preferir el archivo empaquetado; si no existe, cargar los archivos sueltos
+    if (!textureManager.cargarDesdePaquete("resources/duomaze.pak")) {
+        textureManager.iniciarCargaParalela();
+    }
+    bool texturasListas = false;
+    while (!(texturasListas && audioListo.load()) && !WindowShouldClose()) {
+        texturasListas = textureManager.procesarCargas();
+        
+        // El audio cuenta como un paso más de la barra
+        float progreso = textureManager.getProgresoCarga() * 0.9f + (audioListo.load() ? 0.1f : 0.0f);
+        BeginDrawing();
+        lienzo.comenzar();
+        LoadingScreen::draw(progreso, texturasListas ? "Cargando audio..." : "Cargando recursos...");
+        lienzo.terminar();
+        lienzo.presentar(GetScreenWidth(), GetScreenHeight());
+        EndDrawing();
+    }
+    // Si se cerró la ventana durante la carga, terminar igualmente la carga pendiente
     textureManager.loadAllTextures();
-    audio.cargarMusicas();
+    cargaAudio.join();
+    
+    logger.write("⏱️  Audio: " + std::to_string(msAudio) + " ms");
+    logger.write("⏱️  Arranque completo en " + std::to_string(msDesde(inicioArranque)) + " ms");
+    
+    // La escena del bloom y las cachés del menú se rasterizan a la resolución interna del lienzo
+    if (bloom.cargar(lienzo.getAnchoInterno(), lienzo.getAltoInterno(), lienzo.getEscala())) {
+        logger.write(std::string("✨ Bloom listo, calidad ") + CadenaBloom::nombreCalidad(bloom.getCalidad()));
+    } else {
+        logger.write("⚠️  Advertencia: los shaders del bloom no compilan, el confeti usa su halo");
+    }
+
+    // Ritmo de frames: SetTargetFPS solo duerme; el vsync se comprueba presentando, porque el
+    // driver puede forzarlo o ignorar la petición
+    SetTargetFPS(0);
+    RitmoFrames ritmo;
+    ritmo.setObjetivos(hzJuego, hzMenu, GameConstants::MENU_FPS_REPOSO);
+    ritmo.setModo(modoRitmo);
+    int hzMonitor = GetMonitorRefreshRate(GetCurrentMonitor());
+    bool hayVsync = RitmoFrames::detectarVsync(hzMonitor, []() {
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        EndDrawing();
+    });
+    ritmo.setVsync(hayVsync, hzMonitor);
+    logger.write(std::string("⏱️  Ritmo ") + RitmoFrames::nombreModo(modoRitmo) + ": " + std::to_string(hzJuego) +
+                 " Hz en juego, " + std::to_string(hzMenu) + " en menú; monitor a " + std::to_string(hzMonitor) +
+                 " Hz, vsync " + (hayVsync ? "activo" : "no"));
+    bool verRitmo = false;
+    bool verMemoria = false;
+
+    // --contar-asignaciones: directo al juego, con todo lo que se puede dibujar a la vista
+    std::unique_ptr<ComprobacionAsignaciones> asignaciones;
+    bool arranqueDirecto = false;
+    if (framesContados > 0) {
+        asignaciones.reset(new ComprobacionAsignaciones(framesContados));
+        arranqueDirecto = true;
+        verRitmo = verMemoria = true;
+        pistas.toggle();
+        audioOverlay.showTemporarily(1e9);
+    }
 
     const std::vector<int> masterKeys = {KEY_A, KEY_D, KEY_W, KEY_S};
     const std::vector<int> slaveKeys = {KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN};
     
+    // En red cada jugador puede usar cualquiera de los dos juegos de teclas
+    std::vector<int> teclasRed = masterKeys;
+    teclasRed.insert(teclasRed.end(), slaveKeys.begin(), slaveKeys.end());
+    
     std::thread masterThread;
     std::thread slaveThread;
     std::thread validatorThread;
+    bool menuEnReposo = false;
 
     while (!WindowShouldClose() && !shouldClose) {
     // CONTROLES DE AUDIO GLOBALES (funcionan en cualquier pantalla) - UNA SOLA VEZ
@@ -1591,6 +5012,18 @@ int main() {
         audio.playClick();
     }
     
+    // Calidad del bloom: alta -> baja -> apagado -> alta
+    if (IsKeyPressed(KEY_B) && bloom.listo()) {
+        bloom.setCalidad(static_cast<CalidadBloom>((bloom.getCalidad() + BLOOM_TOTAL - 1) % BLOOM_TOTAL));
+        logger.writef("✨ Bloom: %s", CadenaBloom::nombreCalidad(bloom.getCalidad()));
+    }
+    
+    if (IsKeyPressed(KEY_F3)) verRitmo = !verRitmo;
+    if (IsKeyPressed(KEY_F4)) verMemoria = !verMemoria;
+    if (IsKeyPressed(KEY_F11)) {
+        LienzoVirtual::alternarPantallaCompleta(GameConstants::SCREEN_WIDTH, GameConstants::SCREEN_HEIGHT);
+    }
+    
     // ACTUALIZACIÓN DEL AUDIO OVERLAY Y CONFETI - UNA SOLA VEZ
     audioOverlay.update();
     
@@ -1608,8 +5041,27 @@ int main() {
 
     // LÓGICA DE ACTUALIZACIÓN POR PANTALLA
     switch (currentScreen) {
-        case MENU:
-            if (menuSystem.isPlayButtonPressed()) {
+        case MENU: {
+            bool jugar = menuSystem.isPlayButtonPressed() || arranqueDirecto;
+            arranqueDirecto = false;
+            if (jugar && red.activa) {
+                // En red la simulación va en el hilo principal a paso fijo (sin hilos de física)
+                if (red.iniciar()) {
+                    currentScreen = GAMEPLAY;
+                    gameState.startTime = GetTime();
+                    gameState.gameStarted = true;
+                    LevelSystem::initializeLevel(gameState, 0);
+                    audio.cambiarAMusicaGameplay();
+                }
+            } else if (jugar && jugadoresFiesta > 0) {
+                // Como en red: sin hilos de física, la simulación va en el hilo principal
+                currentScreen = GAMEPLAY;
+                gameState.startTime = GetTime();
+                gameState.gameStarted = true;
+                LevelSystem::initializeLevel(gameState, 0);
+                fiesta.reset(new SesionFiesta(jugadoresFiesta));
+                audio.cambiarAMusicaGameplay();
+            } else if (jugar) {
                 currentScreen = GAMEPLAY;
                 gameState.startTime = GetTime();
                 gameState.gameStarted = true;
@@ -1617,8 +5069,8 @@ int main() {
                 
                 // Iniciar hilos de física y validación
                 gameState.gameRunning = true;
-                masterThread = std::thread(physicsThread, std::ref(gameState), true, std::ref(masterKeys));
-                slaveThread = std::thread(physicsThread, std::ref(gameState), false, std::ref(slaveKeys));
+                masterThread = std::thread(physicsThread, std::ref(gameState), true, std::ref(masterKeys), iaMaster);
+                slaveThread = std::thread(physicsThread, std::ref(gameState), false, std::ref(slaveKeys), iaSlave);
                 validatorThread = std::thread(validationThread, std::ref(gameState), std::ref(audio));
                 
                 audio.cambiarAMusicaGameplay();
@@ -1628,10 +5080,71 @@ int main() {
                 shouldClose = true;
             }
             break;
+        }
             
         case GAMEPLAY:
             // Lógica de confeti - ya se hace arriba, no es necesario aquí
             
+            // Pistas: los campos del nivel se calculan en segundo plano la primera vez
+            pistas.prepararNivel(gameState.currentLevel.load());
+            if (IsKeyPressed(KEY_I)) {
+                pistas.toggle();
+                audio.playClick();
+            }
+            
+            // Modo en red: avanzar la sesión y volcarla en gameState para el render
+            if (red.sesion) {
+                SesionOnline& sesion = *red.sesion;
+                int nivelAnterior = gameState.currentLevel.load();
+                double ahoraMs = GetTime() * 1000.0;
+                
+                sesion.actualizar(ahoraMs, MovementSystem::leerInput(teclasRed));
+                if (sesion.getRol() == SesionRed::HOST && gameState.levelCompleted && IsKeyPressed(KEY_ENTER)) {
+                    sesion.avanzarNivel(ahoraMs);
+                }
+                
+                if (sesion.getFase() == SesionRed::TERMINADA || sesion.getFase() == SesionRed::DESCONECTADA) {
+                    if (sesion.getFase() == SesionRed::TERMINADA) {
+                        gameState.totalGameTime = GetTime() - gameState.startTime.load();
+                    }
+                    red.cerrar();
+                    confettiSystem.reset();
+                    confettiActive = false;
+                    currentScreen = MENU;
+                    audio.cambiarAMusicaMenu();
+                    break;
+                }
+                
+                sesion.aplicarAEstado(gameState, audio);
+                if (gameState.currentLevel.load() != nivelAnterior) {
+                    confettiSystem.reset();
+                    confettiActive = false;
+                    logger.writef("Avanzando al nivel %d", gameState.currentLevel.load());
+                }
+                break;
+            }
+            
+            // Modo fiesta: avanzar la simulación de N jugadores y volcarla en gameState
+            if (fiesta) {
+                fiesta->actualizar(GetTime() * 1000.0, masterKeys, slaveKeys);
+                if (gameState.levelCompleted && IsKeyPressed(KEY_ENTER)) {
+                    confettiSystem.reset();
+                    confettiActive = false;
+                    if (fiesta->avanzarNivel()) {
+                        LevelSystem::initializeLevel(gameState, gameState.currentLevel.load() + 1);
+                        logger.writef("Avanzando al nivel %d", gameState.currentLevel.load());
+                    } else {
+                        gameState.totalGameTime = GetTime() - gameState.startTime.load();
+                        fiesta.reset();
+                        currentScreen = MENU;
+                        audio.cambiarAMusicaMenu();
+                        break;
+                    }
+                }
+                fiesta->aplicarAEstado(gameState, audio);
+                break;
+            }
+            
             // Lógica de transición entre niveles
             if (gameState.levelCompleted && IsKeyPressed(KEY_ENTER)) {
                 int nextLevel = gameState.currentLevel.load() + 1;
@@ -1654,12 +5167,12 @@ int main() {
                     gameState.gameRunning = true;
                     
                     // Crear NUEVOS hilos para el nuevo nivel
-                    masterThread = std::thread(physicsThread, std::ref(gameState), true, std::ref(masterKeys));
-                    slaveThread = std::thread(physicsThread, std::ref(gameState), false, std::ref(slaveKeys));
+                    masterThread = std::thread(physicsThread, std::ref(gameState), true, std::ref(masterKeys), iaMaster);
+                    slaveThread = std::thread(physicsThread, std::ref(gameState), false, std::ref(slaveKeys), iaSlave);
                     validatorThread = std::thread(validationThread, std::ref(gameState), std::ref(audio));
                     
                     audio.cambiarAMusicaGameplay(); 
-                    logger.write("Avanzando al nivel " + std::to_string(nextLevel));
+                    logger.writef("Avanzando al nivel %d", nextLevel);
                 } else {
                     // Volver al menú
                     gameState.totalGameTime = GetTime() - gameState.startTime.load();
@@ -1673,15 +5186,35 @@ int main() {
                     
                     currentScreen = MENU;
                     audio.cambiarAMusicaMenu();
-                    logger.write("Todos los niveles completados - Tiempo total: " + 
-                               std::to_string(gameState.totalGameTime.load()) + " segundos");
+                    logger.writef("Todos los niveles completados - Tiempo total: %f segundos",
+                                  gameState.totalGameTime.load());
                 }
             }
             break;
     }
 
+    // Menú quieto: pocos Hz, o dormir hasta el siguiente evento con --menu-eventos. No con el
+    // overlay de audio ni con confeti, que necesitan frames para ocultarse o animarse.
+    ritmo.setContexto(currentScreen == MENU ? CONTEXTO_MENU : CONTEXTO_JUEGO);
+    bool quieto = menuSystem.enReposo();
+    bool reposo = currentScreen == MENU && quieto && !audioOverlay.isVisible() && !confettiSystem.isActiveEffect();
+    if (reposo != menuEnReposo) {
+        menuEnReposo = reposo;
+        if (reposo && menuEventos) {
+            EnableEventWaiting();
+        } else {
+            DisableEventWaiting();
+        }
+        ritmo.setReposo(reposo);
+        logger.write(reposo ? "💤 Menú en reposo" : "⏰ Menú activo");
+    }
+
     // RENDERIZADO (SOLO UN switch)
+    bloom.ajustar(lienzo.getAnchoInterno(), lienzo.getAltoInterno(), lienzo.getEscala());
+    menuSystem.setResolucion(lienzo.getAnchoInterno(), lienzo.getAltoInterno(), lienzo.getEscala());
+    if (currentScreen == MENU) menuSystem.actualizarCache();
     BeginDrawing();
+    lienzo.comenzar();
     ClearBackground(RAYWHITE);  // Importante: limpiar el fondo cada frame
 
     switch (currentScreen) {
@@ -1689,28 +5222,23 @@ int main() {
             menuSystem.draw();
             if (gameState.totalGameTime.load() > 0) {
                 double totalTime = gameState.totalGameTime.load();
-                int minutes = static_cast<int>(totalTime) / 60;
-                int seconds = static_cast<int>(totalTime) % 60;
-                int milliseconds = static_cast<int>((totalTime - static_cast<int>(totalTime)) * 100);
+                int segundos = static_cast<int>(totalTime);
+                const char* timeText = arenaFrame.formatear("Tiempo total: %d:%02d:%02d", segundos / 60, segundos % 60,
+                                                            static_cast<int>((totalTime - segundos) * 100));
                 
-                std::string timeText = "Tiempo total: " + 
-                                      std::to_string(minutes) + ":" + 
-                                      (seconds < 10 ? "0" : "") + std::to_string(seconds) + ":" +
-                                      (milliseconds < 10 ? "0" : "") + std::to_string(milliseconds);
-                
-                int textWidth = MeasureText(timeText.c_str(), 24);
+                int textWidth = MeasureText(timeText, 24);
                 DrawRectangle(GameConstants::SCREEN_WIDTH/2 - textWidth/2 - 10, 
                              GameConstants::SCREEN_HEIGHT/2 - 150, 
                              textWidth + 20, 40, Fade(BLACK, 0.7f));
                 
-                DrawText(timeText.c_str(), 
+                DrawText(timeText, 
                         GameConstants::SCREEN_WIDTH/2 - textWidth/2, 
                         GameConstants::SCREEN_HEIGHT/2 - 140, 
                         24, GOLD);
                 
-                std::string congratsText = "¡FELICIDADES!";
-                int congratsWidth = MeasureText(congratsText.c_str(), 32);
-                DrawText(congratsText.c_str(), 
+                const char* congratsText = "¡FELICIDADES!";
+                int congratsWidth = MeasureText(congratsText, 32);
+                DrawText(congratsText, 
                         GameConstants::SCREEN_WIDTH/2 - congratsWidth/2, 
                         GameConstants::SCREEN_HEIGHT/2 - 180, 
                         32, GOLD);
@@ -1729,147 +5257,90 @@ int main() {
         logger.write("🎊 Confetti activado para victoria!");
     }
             
+            // Con bloom la escena va a su textura y el brillo del confeti lo pone el posproceso
+            confettiSystem.setHalo(!bloom.activo());
+            if (bloom.activo()) {
+                lienzo.terminar();
+                bloom.comenzar();
+                ClearBackground(RAYWHITE);
+            }
+            
             renderSystem.drawLaberinto(gameState);
-            renderSystem.drawPlayers(gameState);
+            if (fiesta) {
+                renderSystem.drawObjetos(fiesta->getObjetos());
+                renderSystem.drawJugadores(fiesta->getAlmacen());
+            } else {
+                renderSystem.drawPlayers(gameState);
+            }
+            pistas.draw(gameState);
             
             confettiSystem.drawWithGlow();
             
-            // Fondo para mejor legibilidad
-            DrawRectangle(0, 0, GameConstants::SCREEN_WIDTH, 40, Fade(BLACK, 0.4f));
-            
-            // 1. CONTROLES - Usando inversionz.ttf (SIN contorno)
-            renderSystem.drawInversionzText("master: wasd", Vector2{10, 10}, 22, RED);
-
-            // 2. NIVEL - Usando spaceranger.ttf (CON contorno)
-            std::string levelText = TextFormat("NIVEL %d", gameState.currentLevel.load() + 1);
-            float levelTextWidth = MeasureText(levelText.c_str(), 28);
-            renderSystem.drawSpacerangerText(levelText, 
-                Vector2{GameConstants::SCREEN_WIDTH/2 - levelTextWidth/2, 5}, 
-                28, GOLD);
-
-            // 3. SLAVE - Usando inversionz.ttf (SIN contorno) + arrows.ttf (CON contorno)
-            renderSystem.drawInversionzText("slave:", 
-                Vector2{(float)GameConstants::SCREEN_WIDTH - 260, 10}, 22, BLUE);
-            
-            // Flechas CON CONTORNO usando arrows.ttf
-            renderSystem.drawArrowsText("cbda", 
-                Vector2{(float)GameConstants::SCREEN_WIDTH - 110, 10}, 24, BLUE);
-            
-            // Mostrar tiempo actual 
-            if (gameState.gameStarted) {
-                double currentTime = GetTime() - gameState.startTime.load();
-                int minutes = static_cast<int>(currentTime) / 60;
-                int seconds = static_cast<int>(currentTime) % 60;
-                int milliseconds = static_cast<int>((currentTime - static_cast<int>(currentTime)) * 100);
-                
-                char timeBuffer[32];
-                snprintf(timeBuffer, sizeof(timeBuffer), "%02d:%02d:%02d", 
-                        minutes, seconds, milliseconds);
-                
-                std::string timeText = timeBuffer;
-                float fontSize = 20.0f;
-                
-                Font upheavttFont = textureManager.getFont("resources/fonts/upheavtt.ttf", 
-                                                          static_cast<int>(fontSize));
-                float textWidth = 0;
-                
-                if (upheavttFont.texture.id != 0) {
-                    Vector2 textSize = MeasureTextEx(upheavttFont, timeText.c_str(), fontSize, 1);
-                    textWidth = textSize.x;
-                } else {
-                    textWidth = MeasureText(timeText.c_str(), (int)fontSize);
-                }
-                
-                float posX = GameConstants::SCREEN_WIDTH - textWidth - 20.0f;
-                float posY = GameConstants::SCREEN_HEIGHT - 35.0f;
-                
-                DrawRectangleRounded((Rectangle){posX - 15.0f, posY - 5.0f, 
-                                                textWidth + 30.0f, fontSize + 15.0f}, 
-                                    0.3f, 8, Fade(DARKBLUE, 0.7f));
-                
-                renderSystem.drawUpheavttText(timeText, 
-                                             Vector2{posX, posY}, 
-                                             fontSize, 
-                                             GREEN,
-                                             BLACK);
+            // El HUD queda fuera del bloom
+            if (bloom.activo()) {
+                bloom.terminar();
+                bloom.procesar([&]() {
+                    renderSystem.drawResaltados(gameState);
+                    confettiSystem.drawEmisivo();
+                });
+                lienzo.comenzar();
+                bloom.componer({0, 0, static_cast<float>(GameConstants::SCREEN_WIDTH),
+                                static_cast<float>(GameConstants::SCREEN_HEIGHT)});
             }
             
-            // Pantallas de victoria diferenciadas
-            if (gameState.levelCompleted) {
-                DrawRectangle(0, GameConstants::SCREEN_HEIGHT/2 - 60, 
-                              GameConstants::SCREEN_WIDTH, 120, Fade(BLACK, 0.8f));
-                
-                Font spacerangerFont = textureManager.getFont("resources/fonts/spaceranger.ttf", 40);
-                Font spacerangerFontSmall = textureManager.getFont("resources/fonts/spaceranger.ttf", 20);
-                
-                if (gameState.currentLevel < GameConstants::TOTAL_LEVELS - 1) {
-                    std::string levelCompleteText = "¡NIVEL COMPLETADO!";
-                    std::string nextLevelText = "Presiona ENTER para siguiente nivel";
-                    
-                    Vector2 levelCompleteSize;
-                    if (spacerangerFont.texture.id != 0) {
-                        levelCompleteSize = MeasureTextEx(spacerangerFont, levelCompleteText.c_str(), 40, 1);
-                    } else {
-                        levelCompleteSize.x = MeasureText(levelCompleteText.c_str(), 40);
-                    }
-                    
-                    renderSystem.drawSpacerangerText(levelCompleteText, 
-                        Vector2{GameConstants::SCREEN_WIDTH/2 - levelCompleteSize.x/2, 
-                                GameConstants::SCREEN_HEIGHT/2 - 40}, 
-                        40, GREEN);
-                    
-                    Vector2 nextLevelSize;
-                    if (spacerangerFontSmall.texture.id != 0) {
-                        nextLevelSize = MeasureTextEx(spacerangerFontSmall, nextLevelText.c_str(), 20, 1);
-                    } else {
-                        nextLevelSize.x = MeasureText(nextLevelText.c_str(), 20);
-                    }
-                    
-                    renderSystem.drawSpacerangerText(nextLevelText, 
-                        Vector2{GameConstants::SCREEN_WIDTH/2 - nextLevelSize.x/2, 
-                                GameConstants::SCREEN_HEIGHT/2 + 10}, 
-                        20, WHITE);
-                } else {
-                    std::string gameCompleteText = "¡JUEGO COMPLETADO!";
-                    std::string backToMenuText = "Presiona ENTER para volver al menú";
-                    
-                    Vector2 gameCompleteSize;
-                    if (spacerangerFont.texture.id != 0) {
-                        gameCompleteSize = MeasureTextEx(spacerangerFont, gameCompleteText.c_str(), 40, 1);
-                    } else {
-                        gameCompleteSize.x = MeasureText(gameCompleteText.c_str(), 40);
-                    }
-                    
-                    renderSystem.drawSpacerangerText(gameCompleteText, 
-                        Vector2{GameConstants::SCREEN_WIDTH/2 - gameCompleteSize.x/2, 
-                                GameConstants::SCREEN_HEIGHT/2 - 40}, 
-                        40, GOLD);
-                    
-                    Vector2 backToMenuSize;
-                    if (spacerangerFontSmall.texture.id != 0) {
-                        backToMenuSize = MeasureTextEx(spacerangerFontSmall, backToMenuText.c_str(), 20, 1);
-                    } else {
-                        backToMenuSize.x = MeasureText(backToMenuText.c_str(), 20);
-                    }
-                    
-                    renderSystem.drawSpacerangerText(backToMenuText, 
-                        Vector2{GameConstants::SCREEN_WIDTH/2 - backToMenuSize.x/2, 
-                                GameConstants::SCREEN_HEIGHT/2 + 10}, 
-                        20, WHITE);
-                }
+            renderSystem.drawHUD(gameState);
+
+            if (red.sesion && red.sesion->getFase() == SesionRed::ESPERANDO) {
+                const char* espera = red.sesion->getRol() == SesionRed::HOST
+                    ? "Esperando al otro jugador..." : "Conectando con el host...";
+                DrawRectangle(0, GameConstants::SCREEN_HEIGHT/2 - 30, GameConstants::SCREEN_WIDTH, 60, Fade(BLACK, 0.8f));
+                Vector2 esperaSize = renderSystem.measureTextSDF(FUENTE_SPACERANGER, espera, 24, 1);
+                renderSystem.drawSpacerangerText(espera,
+                    Vector2{GameConstants::SCREEN_WIDTH/2 - esperaSize.x/2, GameConstants::SCREEN_HEIGHT/2 - 12},
+                    24, WHITE);
             }
-            
-            DrawText("Controles: WASD (Master), Flechas (Slave)", 
-                     GameConstants::SCREEN_WIDTH/2 - MeasureText("Controles: WASD (Master), Flechas (Slave)", 16)/2, 
-                     GameConstants::SCREEN_HEIGHT - 25, 16, DARKGRAY);
             break;
     }
 
     audioOverlay.draw();
+    if (verRitmo) {
+        const EstadisticasRitmo& e = ritmo.getEstadisticas(ritmo.getModo(), ritmo.getContexto());
+        DrawText(TextFormat("%s %d Hz | %.2f +- %.2f ms | p99 %.2f | perdidos %ld", RitmoFrames::nombreModo(ritmo.getModo()),
+                            ritmo.getHzEfectivo(), e.mediaMs(), e.jitterMs(), ritmo.getP99Ms(), e.perdidos),
+                 10, 10, 16, LIME);
+    }
+    if (verMemoria) InformeMemoria::draw(16, 34);
+    lienzo.terminar();
+    lienzo.presentar(GetScreenWidth(), GetScreenHeight());
+    ritmo.esperarPlazo();
     EndDrawing();
+    ritmo.marcarPresentacion();
+    arenaFrame.reiniciar();
+    
+    // Al pasar a la fase de victoria los dos jugadores van a la meta: el hilo de validación
+    // completa el nivel y el bucle lanza el confeti como en una partida
+    if (asignaciones && asignaciones->getFase() != ComprobacionAsignaciones::TERMINADA) {
+        ComprobacionAsignaciones::Fase anterior = asignaciones->getFase();
+        ComprobacionAsignaciones::Fase fase = asignaciones->frameTerminado();
+        if (fase == ComprobacionAsignaciones::VICTORIA && anterior != fase) {
+            ComprobacionAsignaciones::llevarAMeta(gameState);
+        }
+        if (fase == ComprobacionAsignaciones::TERMINADA) shouldClose = true;
+    }
 }
 
     logger.write("=== Cerrando DuoMaze ===");
+    for (int m = 0; m < RITMO_TOTAL; m++) {
+        for (int c = 0; c < CONTEXTO_TOTAL; c++) {
+            const EstadisticasRitmo& e = ritmo.getEstadisticas(static_cast<ModoRitmo>(m), static_cast<ContextoRitmo>(c));
+            if (e.frames == 0) continue;
+            logger.write(std::string("⏱️  Ritmo ") + RitmoFrames::nombreModo(static_cast<ModoRitmo>(m)) + " (" +
+                         RitmoFrames::nombreContexto(static_cast<ContextoRitmo>(c)) + "): " +
+                         std::to_string(e.frames) + " frames, " + std::to_string(e.mediaMs()) + " ms +- " +
+                         std::to_string(e.jitterMs()) + ", máx " + std::to_string(e.maxMs) + ", trabajo " +
+                         std::to_string(e.trabajoMedioMs()) + " ms, " + std::to_string(e.perdidos) + " perdidos");
+        }
+    }
     
     gameState.gameRunning = false;
     
@@ -1877,10 +5348,20 @@ int main() {
     if (slaveThread.joinable()) slaveThread.join();
     if (validatorThread.joinable()) validatorThread.join();
     
+    InformeMemoria::volcar();
+    logger.write("🖼️  Texturas y fuentes del TextureManager:");
+    textureManager.volcarMemoria();
+    
     audio.cerrarAudio();
+    confettiSystem.descargar();
+    bloom.descargar();
+    menuSystem.descargar();
+    renderSystem.descargar();
+    lienzo.descargar();
     textureManager.unloadAll();
+    InformeMemoria::comprobarFugas();
     CloseWindow();
     
     logger.write("=== DuoMaze Cerrado Correctamente ===");
-    return 0;
+    return asignaciones ? asignaciones->informe() : 0;
 }
@@ -0,0 +1,139 @@
+#ifndef DUOMAZE_MEMORIA_H
+#define DUOMAZE_MEMORIA_H
+
+// Contabilidad de memoria por subsistema: bytes actuales y pico en CPU y en GPU por etiqueta.
+// La CPU se cuenta con AsignadorEtiquetado en los contenedores de cada subsistema y con
+// anotaciones para lo que reserva raylib (fuentes, audio); la GPU, anotando el tamaño de cada
+// textura, textura de render o buffer al crearlo y al liberarlo. Al cerrar, lo que no haya
+// vuelto a cero es una fuga.
+//
+// Atómicos: se anota desde los hilos de carga y de audio además del principal.
+
+#include "raylib.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+enum EtiquetaMemoria {
+    MEM_TEXTURAS = 0,   // Sprites y fondos del TextureManager
+    MEM_FUENTES,        // Atlas SDF (GPU) y glifos (CPU)
+    MEM_PARTICULAS,     // Confeti
+    MEM_AUDIO,          // Buffers de los streams de música y muestras de los SFX
+    MEM_RENDER,         // Texturas de render, atlas y buffers de vértices de los pasos de render
+    MEM_TOTAL
+};
+
+struct CuentaMemoria {
+    std::atomic<int64_t> actual{0};
+    std::atomic<int64_t> pico{0};
+    std::atomic<int64_t> reservas{0};
+
+    void sumar(int64_t bytes) {
+        int64_t nuevo = actual.fetch_add(bytes) + bytes;
+        if (bytes > 0) {
+            reservas++;
+            int64_t anterior = pico.load();
+            while (nuevo > anterior && !pico.compare_exchange_weak(anterior, nuevo)) {}
+        }
+    }
+};
+
+class ContabilidadMemoria {
+private:
+    static inline CuentaMemoria cpu[MEM_TOTAL];
+    static inline CuentaMemoria gpu[MEM_TOTAL];
+
+public:
+    static void reservaCPU(EtiquetaMemoria e, size_t bytes) { cpu[e].sumar(static_cast<int64_t>(bytes)); }
+    static void liberaCPU(EtiquetaMemoria e, size_t bytes) { cpu[e].sumar(-static_cast<int64_t>(bytes)); }
+    static void reservaGPU(EtiquetaMemoria e, size_t bytes) { gpu[e].sumar(static_cast<int64_t>(bytes)); }
+    static void liberaGPU(EtiquetaMemoria e, size_t bytes) { gpu[e].sumar(-static_cast<int64_t>(bytes)); }
+
+    static const CuentaMemoria& getCPU(EtiquetaMemoria e) { return cpu[e]; }
+    static const CuentaMemoria& getGPU(EtiquetaMemoria e) { return gpu[e]; }
+
+    static int64_t totalCPU() {
+        int64_t total = 0;
+        for (const CuentaMemoria& c : cpu) total += c.actual.load();
+        return total;
+    }
+
+    static int64_t totalGPU() {
+        int64_t total = 0;
+        for (const CuentaMemoria& c : gpu) total += c.actual.load();
+        return total;
+    }
+
+    // Píxeles de todos los niveles de mipmap, en el formato de la textura (0 si no existe)
+    static size_t bytesTextura(const Texture2D& t) {
+        if (t.id == 0) return 0;
+        size_t bytes = 0;
+        int w = t.width, h = t.height;
+        for (int nivel = 0; nivel < t.mipmaps; nivel++) {
+            bytes += GetPixelDataSize(w, h, t.format);
+            w = w > 1 ? w / 2 : 1;
+            h = h > 1 ? h / 2 : 1;
+        }
+        return bytes;
+    }
+
+    // Color más el renderbuffer de profundidad de 24 bits (4 bytes por píxel) de raylib
+    static size_t bytesTexturaRender(const RenderTexture2D& rt) {
+        if (rt.id == 0) return 0;
+        return bytesTextura(rt.texture) + static_cast<size_t>(rt.depth.width) * rt.depth.height * 4;
+    }
+
+    // Muestras de un Sound ya convertidas al formato del dispositivo
+    static size_t bytesSonido(const Sound& s) {
+        return static_cast<size_t>(s.frameCount) * s.stream.channels * (s.stream.sampleSize / 8);
+    }
+
+    // Doble buffer del stream de una música (sin el estado del decodificador, que raylib no expone)
+    static size_t bytesMusica(const Music& m, unsigned int framesBuffer) {
+        if (m.frameCount == 0) return 0;
+        return static_cast<size_t>(framesBuffer) * 2 * m.stream.channels * (m.stream.sampleSize / 8);
+    }
+
+    static const char* nombre(EtiquetaMemoria e) {
+        switch (e) {
+            case MEM_TEXTURAS: return "texturas";
+            case MEM_FUENTES: return "fuentes";
+            case MEM_PARTICULAS: return "partículas";
+            case MEM_AUDIO: return "audio";
+            default: return "render";
+        }
+    }
+};
+
+// Asignador STL que anota en su etiqueta lo que reserva el contenedor
+template <typename T, EtiquetaMemoria E>
+struct AsignadorEtiquetado {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AsignadorEtiquetado<U, E>;
+    };
+
+    AsignadorEtiquetado() = default;
+    template <typename U>
+    AsignadorEtiquetado(const AsignadorEtiquetado<U, E>&) {}
+
+    T* allocate(size_t n) {
+        ContabilidadMemoria::reservaCPU(E, n * sizeof(T));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        ContabilidadMemoria::liberaCPU(E, n * sizeof(T));
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const AsignadorEtiquetado<U, E>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AsignadorEtiquetado<U, E>&) const { return false; }
+};
+
+#endif
@@ -0,0 +1,423 @@
+#ifndef DUOMAZE_OBJETOS_DINAMICOS_H
+#define DUOMAZE_OBJETOS_DINAMICOS_H
+
+// Objetos dinámicos de los niveles: peligros que patrullan, cajas que se empujan y puertas
+// correderas ligadas a un canal. Se simulan en el paso fijo con posiciones enteras, como
+// los jugadores, así que dan lo mismo en cualquier máquina.
+//
+// Fase ancha: rejilla espacial uniforme con hash (RejillaEspacial). Se reconstruye una vez
+// por tick en O(n) con un conteo por cubetas y cada consulta solo recorre las celdas que
+// cubre, así que su coste depende de los objetos cercanos y no del total. Cada objeto se
+// inserta con un margen igual a lo máximo que puede moverse en un tick, y con eso una sola
+// construcción vale para todas las fases del tick aunque los objetos se muevan entre medias.
+
+#include "simulacion.h"
+#include <algorithm>
+#include <vector>
+
+namespace ObjetosConstants {
+    constexpr int BITS_CELDA = 7;                   // Celdas de 128 px (3,2 tiles)
+    constexpr int VELOCIDAD_MAXIMA = 4;             // px por tick de peligros y puertas
+    constexpr int MAX_EMPUJONES_POR_TICK = 8;       // Una caja la empuja como mucho un jugador de cada
+    constexpr int MARGEN = std::max(VELOCIDAD_MAXIMA, MAX_EMPUJONES_POR_TICK * GameConstants::PLAYER_SPEED);
+    constexpr int SEMI_PELIGRO = 12;
+    constexpr int SEMI_CAJA = 18;                   // Deja holgura en los pasillos de una tile
+    constexpr int SEMI_PUERTA = GameConstants::TILE_SIZE / 2;
+}
+
+enum TipoObjeto : uint8_t {
+    OBJETO_PELIGRO = 0,             // Patrulla; el jugador que lo toca vuelve a su inicio
+    OBJETO_CAJA = 1,                // Se empuja; la paran paredes, puertas y otras cajas
+    OBJETO_PUERTA_CORREDIZA = 2     // Se desliza a su posición abierta mientras su canal esté activo
+};
+
+// Definición en tiles. Peligro: patrulla entre (x, y) y (x + dx, y + dy). Puerta
+// corredera: cerrada en (x, y) y abierta en (x + dx, y + dy). Caja: dx/dy sin uso.
+struct DefinicionObjeto {
+    TipoObjeto tipo;
+    int16_t x, y;
+    int16_t dx, dy;
+    uint8_t canal;
+    uint8_t velocidad;              // px por tick (peligros y puertas)
+};
+
+// Objetos de cada nivel. Van en zonas que no cortan la ruta obligatoria: el análisis de
+// dependencias y el creador de niveles solo conocen las tiles.
+inline constexpr DefinicionObjeto OBJETOS_NIVEL_1[] = {
+    {OBJETO_PELIGRO, 2, 7, 15, 0, 0, 2},                // Atajo de la fila 7
+    {OBJETO_CAJA, 8, 9, 0, 0, 0, 0},
+    {OBJETO_PUERTA_CORREDIZA, 18, 12, -1, 0, 1, 2},     // Tras la puerta 2, con su mismo canal
+};
+inline constexpr DefinicionObjeto OBJETOS_NIVEL_2[] = {
+    {OBJETO_PELIGRO, 8, 10, 2, 0, 0, 1},                // Fila central de la sala de 3x3: se cruza por el otro lado
+};
+inline constexpr DefinicionObjeto OBJETOS_NIVEL_3[] = {
+    {OBJETO_PUERTA_CORREDIZA, 10, 9, -1, 0, 2, 2},      // Tras las puertas 3 del pasillo central
+};
+
+struct ObjetosNivel {
+    const DefinicionObjeto* definiciones;
+    size_t cantidad;
+};
+
+inline constexpr ObjetosNivel OBJETOS_NIVELES[GameConstants::TOTAL_LEVELS] = {
+    {OBJETOS_NIVEL_1, sizeof(OBJETOS_NIVEL_1) / sizeof(DefinicionObjeto)},
+    {OBJETOS_NIVEL_2, sizeof(OBJETOS_NIVEL_2) / sizeof(DefinicionObjeto)},
+    {OBJETOS_NIVEL_3, sizeof(OBJETOS_NIVEL_3) / sizeof(DefinicionObjeto)},
+    {nullptr, 0},
+};
+
+// Caja alineada entera, semiabierta: [x0, x1) x [y0, y1)
+struct CajaEntera {
+    int32_t x0, y0, x1, y1;
+};
+
+inline bool solapan(const CajaEntera& a, const CajaEntera& b) {
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+// Hash espacial uniforme: celdas cuadradas de 2^BITS_CELDA px repartidas en una tabla de
+// cubetas potencia de dos. La cubeta es el índice de la celda en orden de filas, así que
+// celdas vecinas caen en cubetas contiguas; en mapas grandes varias celdas comparten cubeta.
+// Las entradas se guardan agrupadas por cubeta en un solo array (conteo + suma de
+// prefijos), sin listas enlazadas ni memoria por tick.
+class RejillaEspacial {
+private:
+    std::vector<uint32_t> inicio;       // Cubeta -> primera entrada; inicio[cubetas] = total
+    std::vector<uint32_t> cursor;       // Posición de escritura por cubeta al construir
+    std::vector<uint32_t> entradas;     // Índices de objeto agrupados por cubeta
+    std::vector<uint32_t> marca;        // Objeto -> última consulta que lo devolvió
+    uint32_t consulta = 0;
+    uint32_t mascara = 0;
+    uint32_t anchoCeldas = 1;
+
+    static int32_t celda(int32_t v) { return v >> ObjetosConstants::BITS_CELDA; }
+
+    uint32_t cubeta(int32_t cx, int32_t cy) const {
+        return (static_cast<uint32_t>(cy) * anchoCeldas + static_cast<uint32_t>(cx)) & mascara;
+    }
+
+    // Recorre las cubetas de las celdas que toca la caja
+    template <typename F>
+    void porCubeta(const CajaEntera& c, F&& f) const {
+        for (int32_t cy = celda(c.y0); cy <= celda(c.y1 - 1); cy++) {
+            for (int32_t cx = celda(c.x0); cx <= celda(c.x1 - 1); cx++) f(cubeta(cx, cy));
+        }
+    }
+
+public:
+    // Todo se reserva aquí; construir y consultar no tocan el heap mientras n no crezca.
+    // anchoPx es el ancho del mapa, que fija el paso de fila de las cubetas.
+    void reservar(size_t n, int32_t anchoPx) {
+        anchoCeldas = static_cast<uint32_t>(celda(std::max(anchoPx, 1) - 1) + 1);
+        size_t cubetas = 64;
+        while (cubetas < 2 * n) cubetas *= 2;
+        mascara = static_cast<uint32_t>(cubetas - 1);
+        inicio.assign(cubetas + 1, 0);
+        cursor.assign(cubetas, 0);
+        entradas.reserve(4 * n);        // Con el margen, un objeto cubre como mucho 2x2 celdas
+        marca.assign(n, 0);
+        consulta = 0;
+    }
+
+    void construir(const CajaEntera* cajas, size_t n) {
+        std::fill(inicio.begin(), inicio.end(), 0);
+        for (size_t i = 0; i < n; i++) porCubeta(cajas[i], [this](uint32_t h) { inicio[h + 1]++; });
+        for (size_t h = 1; h < inicio.size(); h++) inicio[h] += inicio[h - 1];
+        std::copy(inicio.begin(), inicio.end() - 1, cursor.begin());
+        entradas.resize(inicio.back());
+        for (size_t i = 0; i < n; i++) {
+            uint32_t objeto = static_cast<uint32_t>(i);
+            porCubeta(cajas[i], [this, objeto](uint32_t h) { entradas[cursor[h]++] = objeto; });
+        }
+    }
+
+    // Llama a f(i) una vez por cada objeto de las celdas que toca la caja. Puede devolver
+    // objetos que no la solapan (vecinos de celda o colisiones del hash): la fase estrecha
+    // es del que llama.
+    template <typename F>
+    void consultar(const CajaEntera& c, F&& f) {
+        if (++consulta == 0) {
+            std::fill(marca.begin(), marca.end(), 0);
+            consulta = 1;
+        }
+        porCubeta(c, [&](uint32_t h) {
+            for (uint32_t e = inicio[h]; e < inicio[h + 1]; e++) {
+                uint32_t i = entradas[e];
+                if (marca[i] == consulta) continue;
+                marca[i] = consulta;
+                f(i);
+            }
+        });
+    }
+};
+
+// Objetos de un nivel en arrays paralelos (struct-of-arrays), como AlmacenComponentes.
+// No se crean ni se destruyen durante el nivel, así que el índice sirve de handle; es el
+// del orden interno (por celdas), no el de las definiciones.
+class MundoObjetos {
+public:
+    std::vector<uint8_t> tipo;                  // TipoObjeto
+    std::vector<int32_t> x, y;                  // Centro en píxeles
+    std::vector<int16_t> semiAncho, semiAlto;
+    std::vector<int32_t> origenX, origenY;      // Peligro: extremo A; puerta: cerrada
+    std::vector<int32_t> destinoX, destinoY;    // Peligro: extremo B; puerta: abierta
+    std::vector<uint8_t> canal, velocidad;
+    std::vector<uint8_t> haciaDestino;          // Peligros: sentido de la patrulla
+
+private:
+    std::vector<CajaEntera> margenes;           // Caja + MARGEN de cada objeto para la rejilla
+    std::vector<uint8_t> empujada;              // Cajas del empujón en curso
+    std::vector<uint32_t> empujadas;
+    std::vector<uint32_t> orden;                // Índice interno -> índice de definición
+    RejillaEspacial rejilla;
+    const int* tiles = nullptr;
+    int ancho = 0, alto = 0;
+    const MetadatosNivel* meta = &METADATOS_BASICOS;
+    Canales canales = 0;
+    bool usarRejilla = true;
+    size_t n = 0;
+
+    static int32_t centroTile(int t) { return t * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE / 2; }
+
+    static int32_t acercar(int32_t v, int32_t objetivo, int32_t paso) {
+        if (v < objetivo) return std::min(v + paso, objetivo);
+        return std::max(v - paso, objetivo);
+    }
+
+    CajaEntera cajaEn(size_t i, int32_t cx, int32_t cy) const {
+        return {cx - semiAncho[i], cy - semiAlto[i], cx + semiAncho[i], cy + semiAlto[i]};
+    }
+
+    static CajaEntera cajaCirculo(Vector2 c, int radio) {
+        int32_t cx = static_cast<int32_t>(c.x), cy = static_cast<int32_t>(c.y);
+        return {cx - radio, cy - radio, cx + radio + 1, cy + radio + 1};
+    }
+
+    Rectangle rectangulo(size_t i) const {
+        return {static_cast<float>(x[i] - semiAncho[i]), static_cast<float>(y[i] - semiAlto[i]),
+                static_cast<float>(2 * semiAncho[i]), static_cast<float>(2 * semiAlto[i])};
+    }
+
+    // Candidatos de la fase ancha; sin rejilla son todos (referencia O(n) por consulta)
+    template <typename F>
+    void candidatos(const CajaEntera& c, F&& f) {
+        if (usarRejilla) {
+            rejilla.consultar(c, f);
+        } else {
+            for (size_t i = 0; i < n; i++) f(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Cajas y puertas (no los peligros) que solapan c, sin contar el propio objeto ni las
+    // cajas que se están empujando
+    bool chocaConSolido(const CajaEntera& c, size_t propio) {
+        bool choca = false;
+        candidatos(c, [&](uint32_t i) {
+            if (i == propio || tipo[i] == OBJETO_PELIGRO || empujada[i]) return;
+            choca = choca || solapan(cajaEn(i, x[i], y[i]), c);
+        });
+        return choca;
+    }
+
+    bool chocaConCaja(const CajaEntera& c, size_t propio) {
+        bool choca = false;
+        candidatos(c, [&](uint32_t i) {
+            if (i == propio || tipo[i] != OBJETO_CAJA) return;
+            choca = choca || solapan(cajaEn(i, x[i], y[i]), c);
+        });
+        return choca;
+    }
+
+public:
+    // Los objetos atraviesan lo que ambos roles pueden atravesar con los canales actuales
+    bool libreDeTiles(const CajaEntera& c) const {
+        const int ts = GameConstants::TILE_SIZE;
+        if (c.x0 < 0 || c.y0 < 0 || c.x1 > ancho * ts || c.y1 > alto * ts) return false;
+        for (int ty = c.y0 / ts; ty <= (c.y1 - 1) / ts; ty++) {
+            for (int tx = c.x0 / ts; tx <= (c.x1 - 1) / ts; tx++) {
+                int t = tiles[ty * ancho + tx];
+                if (!CollisionSystem::canPassTile(t, true, canales, *meta) ||
+                    !CollisionSystem::canPassTile(t, false, canales, *meta)) return false;
+            }
+        }
+        return true;
+    }
+
+    // tilesMapa es una rejilla ancho x alto que tiene que seguir viva mientras se simule
+    void cargar(const DefinicionObjeto* definiciones, size_t cantidad, const int* tilesMapa, int anchoMapa,
+                int altoMapa, const MetadatosNivel& metadatos) {
+        tiles = tilesMapa;
+        ancho = anchoMapa;
+        alto = altoMapa;
+        meta = &metadatos;
+        canales = 0;
+        n = cantidad;
+        for (auto* v : {&tipo, &canal, &velocidad, &haciaDestino, &empujada}) v->assign(n, 0);
+        for (auto* v : {&x, &y, &origenX, &origenY, &destinoX, &destinoY}) v->assign(n, 0);
+        semiAncho.assign(n, 0);
+        semiAlto.assign(n, 0);
+        margenes.resize(n);
+        empujadas.clear();
+        empujadas.reserve(n);
+        rejilla.reservar(n, ancho * GameConstants::TILE_SIZE);
+
+        // Se guardan ordenados por la celda de su origen (filas de celdas, desempate por el
+        // orden de definición): los candidatos de cada consulta quedan juntos en los arrays
+        // y el coste por objeto no crece con el mapa por fallos de caché
+        orden.resize(n);
+        for (size_t i = 0; i < n; i++) orden[i] = static_cast<uint32_t>(i);
+        auto claveCelda = [definiciones](uint32_t i) {
+            const DefinicionObjeto& d = definiciones[i];
+            return (static_cast<int64_t>(centroTile(d.y) >> ObjetosConstants::BITS_CELDA) << 32) +
+                   (centroTile(d.x) >> ObjetosConstants::BITS_CELDA);
+        };
+        std::stable_sort(orden.begin(), orden.end(),
+                         [&](uint32_t a, uint32_t b) { return claveCelda(a) < claveCelda(b); });
+
+        for (size_t i = 0; i < n; i++) {
+            const DefinicionObjeto& d = definiciones[orden[i]];
+            int16_t semi = d.tipo == OBJETO_PELIGRO ? ObjetosConstants::SEMI_PELIGRO
+                         : d.tipo == OBJETO_CAJA ? ObjetosConstants::SEMI_CAJA : ObjetosConstants::SEMI_PUERTA;
+            tipo[i] = d.tipo;
+            semiAncho[i] = semiAlto[i] = semi;
+            x[i] = origenX[i] = centroTile(d.x);
+            y[i] = origenY[i] = centroTile(d.y);
+            destinoX[i] = centroTile(d.x + d.dx);
+            destinoY[i] = centroTile(d.y + d.dy);
+            canal[i] = d.canal;
+            velocidad[i] = std::min<uint8_t>(d.velocidad, ObjetosConstants::VELOCIDAD_MAXIMA);
+            haciaDestino[i] = 1;
+        }
+    }
+
+    void cargarNivel(int nivel, const MapaNivel& mapa) {
+        const ObjetosNivel& o = OBJETOS_NIVELES[(nivel >= 0 && nivel < GameConstants::TOTAL_LEVELS) ? nivel : 0];
+        cargar(o.definiciones, o.cantidad, &mapa[0][0], GameConstants::MAP_WIDTH, GameConstants::MAP_HEIGHT,
+               metadatosNivel(nivel));
+    }
+
+    void vaciar() { cargar(nullptr, 0, tiles, ancho, alto, *meta); }
+
+    // false: fase ancha por fuerza bruta, para comparar resultados y costes
+    void setUsarRejilla(bool usar) { usarRejilla = usar; }
+
+    size_t tamano() const { return n; }
+    CajaEntera caja(size_t i) const { return cajaEn(i, x[i], y[i]); }
+
+    // Primera fase del tick: rejilla, puertas correderas y peligros. Las puertas solo
+    // comprueban cajas y los peligros cajas y puertas ya colocadas, así que el orden de
+    // los objetos no cambia el resultado.
+    void avanzar(Canales canalesTick) {
+        canales = canalesTick;
+        if (usarRejilla) {
+            const int32_t m = ObjetosConstants::MARGEN;
+            for (size_t i = 0; i < n; i++) {
+                CajaEntera c = cajaEn(i, x[i], y[i]);
+                margenes[i] = {c.x0 - m, c.y0 - m, c.x1 + m, c.y1 + m};
+            }
+            rejilla.construir(margenes.data(), n);
+        }
+
+        // Las puertas se deslizan hacia abierta o cerrada y se paran si hay una caja delante
+        for (size_t i = 0; i < n; i++) {
+            if (tipo[i] != OBJETO_PUERTA_CORREDIZA) continue;
+            bool abierta = ((canales >> canal[i]) & 1) != 0;
+            int32_t nx = acercar(x[i], abierta ? destinoX[i] : origenX[i], velocidad[i]);
+            int32_t ny = acercar(y[i], abierta ? destinoY[i] : origenY[i], velocidad[i]);
+            if ((nx != x[i] || ny != y[i]) && !chocaConCaja(cajaEn(i, nx, ny), i)) {
+                x[i] = nx;
+                y[i] = ny;
+            }
+        }
+
+        // Los peligros van y vienen entre sus extremos y se dan la vuelta al chocar
+        for (size_t i = 0; i < n; i++) {
+            if (tipo[i] != OBJETO_PELIGRO) continue;
+            int32_t ox = haciaDestino[i] ? destinoX[i] : origenX[i];
+            int32_t oy = haciaDestino[i] ? destinoY[i] : origenY[i];
+            if (x[i] == ox && y[i] == oy) {
+                haciaDestino[i] ^= 1;
+                continue;
+            }
+            int32_t nx = acercar(x[i], ox, velocidad[i]);
+            int32_t ny = acercar(y[i], oy, velocidad[i]);
+            CajaEntera c = cajaEn(i, nx, ny);
+            if (!libreDeTiles(c) || chocaConSolido(c, i)) {
+                haciaDestino[i] ^= 1;
+            } else {
+                x[i] = nx;
+                y[i] = ny;
+            }
+        }
+    }
+
+    // Segunda fase, jugador a jugador: el movimiento ya validado contra las tiles se
+    // recorta contra puertas y cajas. Las cajas que el jugador empieza a tocar se empujan
+    // lo mismo que él si todas caben; si no, el jugador no se mueve. Lo que ya tocaba en
+    // la posición anterior no le bloquea, para que nunca se quede atrapado dentro.
+    Vector2 moverJugador(Vector2 antes, Vector2 despues) {
+        if (n == 0 || (antes.x == despues.x && antes.y == despues.y)) return despues;
+        const float radio = static_cast<float>(GameConstants::PLAYER_RADIUS);
+        bool bloqueado = false;
+        empujadas.clear();
+        candidatos(cajaCirculo(despues, GameConstants::PLAYER_RADIUS), [&](uint32_t i) {
+            if (tipo[i] == OBJETO_PELIGRO) return;
+            Rectangle r = rectangulo(i);
+            if (!CollisionSystem::circuloTocaRect(despues, radio, r) ||
+                CollisionSystem::circuloTocaRect(antes, radio, r)) return;
+            if (tipo[i] == OBJETO_CAJA) {
+                empujadas.push_back(i);
+            } else {
+                bloqueado = true;
+            }
+        });
+        if (bloqueado) return antes;
+        if (empujadas.empty()) return despues;
+
+        int32_t dx = static_cast<int32_t>(despues.x - antes.x);
+        int32_t dy = static_cast<int32_t>(despues.y - antes.y);
+        for (uint32_t i : empujadas) empujada[i] = 1;
+        bool caben = true;
+        for (uint32_t i : empujadas) {
+            CajaEntera c = cajaEn(i, x[i] + dx, y[i] + dy);
+            caben = caben && libreDeTiles(c) && !chocaConSolido(c, i);
+        }
+        for (uint32_t i : empujadas) {
+            empujada[i] = 0;
+            if (caben) {
+                x[i] += dx;
+                y[i] += dy;
+            }
+        }
+        return caben ? despues : antes;
+    }
+
+    bool tocaPeligro(Vector2 pos) {
+        const float radio = static_cast<float>(GameConstants::PLAYER_RADIUS);
+        bool toca = false;
+        candidatos(cajaCirculo(pos, GameConstants::PLAYER_RADIUS), [&](uint32_t i) {
+            toca = toca || (tipo[i] == OBJETO_PELIGRO && CollisionSystem::circuloTocaRect(pos, radio, rectangulo(i)));
+        });
+        return toca;
+    }
+
+    // FNV-1a de posiciones y sentidos, para comparar simulaciones
+    uint64_t checksum() const {
+        uint64_t h = 1469598103934665603ull;
+        auto mezclar = [&h](uint32_t v) {
+            for (int b = 0; b < 4; b++) {
+                h ^= (v >> (8 * b)) & 0xFF;
+                h *= 1099511628211ull;
+            }
+        };
+        for (size_t i = 0; i < n; i++) {
+            mezclar(static_cast<uint32_t>(x[i]));
+            mezclar(static_cast<uint32_t>(y[i]));
+            mezclar(haciaDestino[i]);
+        }
+        return h;
+    }
+};
+
+#endif
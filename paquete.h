@@ -0,0 +1,55 @@
+#ifndef DUOMAZE_PAQUETE_H
+#define DUOMAZE_PAQUETE_H
+
+// Formato de resources/duomaze.pak, compartido por el empaquetador (que lo escribe) y el juego
+// (que lo mapea en memoria). Cabecera, datos de cada entrada alineados a PAK_ALINEACION e
+// índice al final. Se asume little-endian, como el protocolo de red.
+
+#include <cstdint>
+
+constexpr char PAK_MAGIA[4] = {'D', 'M', 'P', 'K'};
+constexpr uint32_t PAK_VERSION = 2;     // 2: una fuente SDF por archivo TTF
+constexpr uint32_t PAK_ALINEACION = 16;
+
+// Límites para rechazar entradas corruptas antes de reservar o leer nada
+constexpr uint32_t PAK_MAX_LADO = 16384;
+constexpr int32_t PAK_MAX_GLIFOS = 4096;
+
+enum PakTipo : uint32_t { PAK_TEXTURA = 0, PAK_FUENTE = 1 };
+
+struct PakCabecera {
+    char magia[4];
+    uint32_t version;
+    uint32_t numEntradas;
+    uint32_t reservado;
+    uint64_t offsetIndice;
+};
+
+// Textura: píxeles. Fuente: píxeles del atlas, glyphCount Rectangle y glyphCount PakGlifo.
+struct PakEntrada {
+    char nombre[64];
+    uint32_t tipo;
+    uint32_t formato;       // PixelFormat de raylib
+    uint32_t ancho;
+    uint32_t alto;
+    uint64_t offset;
+    uint64_t tamano;
+    int32_t fontSize;
+    int32_t glyphCount;
+    int32_t glyphPadding;
+    int32_t reservado;
+};
+
+// Datos por glifo que necesita DrawTextEx (la imagen de cada glifo no se guarda)
+struct PakGlifo {
+    int32_t value;
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t advanceX;
+};
+
+static_assert(sizeof(PakCabecera) == 24, "PakCabecera debe ocupar 24 bytes");
+static_assert(sizeof(PakEntrada) == 112, "PakEntrada debe ocupar 112 bytes");
+static_assert(sizeof(PakGlifo) == 16, "PakGlifo debe ocupar 16 bytes");
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef DUOMAZE_PROTOCOLO_RED_H
+#define DUOMAZE_PROTOCOLO_RED_H
+
+// Protocolo UDP de DuoMaze, compartido por el juego y el servidor dedicado.
+// Ambos extremos se asumen little-endian (x86/ARM), los paquetes van tal cual.
+
+#include <cstdint>
+
+namespace RedConstants {
+    constexpr uint16_t PUERTO_DEFECTO = 27960;
+    constexpr int INPUTS_POR_PAQUETE = 12;
+    constexpr int TICKS_ENTRE_INPUTS = 3;       // 33 paquetes/s de subida
+    constexpr int TICKS_ENTRE_SNAPSHOTS = 5;    // 20 paquetes/s de bajada
+    constexpr int HISTORIAL_INPUTS = 256;       // Potencia de 2 (índice por máscara)
+    constexpr int SNAPSHOTS_INTERPOLACION = 16;
+    constexpr double RETARDO_INTERPOLACION_MS = 100.0;
+    constexpr double SUAVIZADO_ERROR_MS = 60.0;
+    constexpr double INTERVALO_HOLA_MS = 250.0;
+    constexpr double TIMEOUT_MS = 5000.0;
+    constexpr int MAX_TICKS_POR_FRAME = 10;     // Evita la espiral de la muerte tras un parón
+    constexpr int CABECERA_UDP_IP = 28;         // Para contar el ancho de banda real
+    
+    // Rollback
+    constexpr int HISTORIAL_ROLLBACK = 128;     // Ticks de snapshots/inputs guardados (potencia de 2)
+    constexpr int MAX_ROLLBACK = 20;            // Ticks que se puede predecir por delante del input remoto (200 ms)
+    constexpr int INPUTS_POR_PAQUETE_ROLLBACK = 32;  // Inputs sin confirmar que caben: cubre ~300 ms de RTT
+}
+
+enum MensajeRed : uint8_t { MSG_HOLA = 1, MSG_BIENVENIDA = 2, MSG_INPUT = 3, MSG_ESTADO = 4, MSG_ROLLBACK = 5 };
+
+// Inputs [ultimaSecuencia - cantidad + 1, ultimaSecuencia] del cliente
+struct PaqueteInput {
+    uint8_t tipo;
+    uint8_t cantidad;
+    uint16_t reservado;
+    uint32_t ultimaSecuencia;
+    uint8_t inputs[RedConstants::INPUTS_POR_PAQUETE];
+};
+
+// Snapshot autoritativo. Las posiciones siempre son enteras (spawn en el centro
+// del tile, PLAYER_SPEED entero), así que int16 las representa sin pérdida.
+struct PaqueteEstado {
+    uint8_t tipo;
+    uint8_t nivel;
+    uint8_t metas;          // bit 7: nivel completado
+    uint8_t reservado;
+    uint32_t tick;
+    uint32_t ultimoInputCliente;
+    int16_t masterX, masterY;
+    int16_t slaveX, slaveY;
+    uint32_t reservado2;    // Alinea canales a 8 bytes sin relleno implícito
+    uint64_t canales;       // Canales de disparadores activos (bit i = canal i)
+};
+
+// HOLA/BIENVENIDA. En la bienvenida, rol indica a quién controla quien se une
+// (0 = slave, 1 = master): el host del juego siempre da el slave, el servidor dedicado
+// reparte los dos en orden de llegada.
+struct PaqueteControl {
+    uint8_t tipo;
+    uint8_t nivel;
+    uint8_t rol;
+    uint8_t reservado;
+};
+
+// Sesión con rollback: inputs propios desde el primero que el otro no confirmó,
+// más el checksum del último tick confirmado por este extremo
+struct PaqueteRollback {
+    uint8_t tipo;
+    uint8_t cantidad;
+    int16_t ventaja;            // Ticks que el emisor va por delante del último input que recibió
+    uint32_t primerTick;        // inputs[i] es el del tick primerTick + i
+    uint32_t ackTick;           // Inputs remotos recibidos: [0, ackTick)
+    uint32_t tickChecksum;      // 0 = sin checksum; si no, checksum tras el tick tickChecksum - 1
+    uint64_t checksum;
+    uint8_t inputs[RedConstants::INPUTS_POR_PAQUETE_ROLLBACK];
+};
+
+static_assert(sizeof(PaqueteRollback) == 56, "PaqueteRollback debe ocupar 56 bytes");
+static_assert(sizeof(PaqueteInput) == 20, "PaqueteInput debe ocupar 20 bytes");
+static_assert(sizeof(PaqueteEstado) == 32, "PaqueteEstado debe ocupar 32 bytes");
+static_assert(sizeof(PaqueteControl) == 4, "PaqueteControl debe ocupar 4 bytes");
+
+#endif
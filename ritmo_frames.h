@@ -0,0 +1,290 @@
+#ifndef DUOMAZE_RITMO_FRAMES_H
+#define DUOMAZE_RITMO_FRAMES_H
+
+// Ritmo de frames: sustituye a SetTargetFPS, que solo duerme y se pasa del plazo lo que le
+// dé la granularidad del sistema. Los plazos son absolutos (no acumulan deriva) y la espera
+// es híbrida: duerme hasta un margen antes del plazo y el resto lo hace girando; el margen se
+// aprende del exceso real del sueño. Solo se gira en juego: en el menú (30 Hz, 10 en reposo)
+// unos ms de más no se notan y girar gastaría un núcleo cada frame para nada. Se espera justo antes de EndDrawing, así que lo que se
+// clava al plazo es la presentación.
+//
+// Modos: libre (sin espera), fijo (los Hz pedidos) y adaptativo (baja a un divisor de la
+// frecuencia base si el trabajo del frame no cabe, y sube cuando vuelve a caber). Con vsync
+// la base es el refresco del monitor y se deja que el swap haga la última parte de la espera.
+// Estadísticas de presentación a presentación por modo y por contexto (menú o juego).
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+enum ModoRitmo { RITMO_LIBRE = 0, RITMO_FIJO, RITMO_ADAPTATIVO, RITMO_TOTAL };
+enum ContextoRitmo { CONTEXTO_MENU = 0, CONTEXTO_JUEGO, CONTEXTO_TOTAL };
+
+namespace RitmoConstants {
+    constexpr int HZ_MINIMO = 10;
+    constexpr int HZ_MAXIMO = 480;
+    constexpr double MARGEN_GIRO_MIN_MS = 0.25;
+    constexpr double MARGEN_GIRO_MAX_MS = 4.0;
+    constexpr double MARGEN_GIRO_INICIAL_MS = 2.0;
+    constexpr double OLVIDO_MARGEN = 0.999;         // El margen vuelve despacio hacia el mínimo
+    constexpr int VENTANA_ADAPTACION = 60;          // Frames entre decisiones del modo adaptativo
+    constexpr double CARGA_BAJAR = 0.9;             // p90 del trabajo / periodo para bajar de Hz
+    constexpr double CARGA_SUBIR = 0.6;             // ... y para volver a subir
+    constexpr double FACTOR_PERDIDO = 1.5;          // Intervalo > 1.5 periodos = frame perdido
+    constexpr int HISTORIAL = 512;                  // Intervalos recientes para el p99
+    constexpr int FRAMES_DETECCION_VSYNC = 30;
+    constexpr double TOLERANCIA_VSYNC = 0.15;
+}
+
+struct EstadisticasRitmo {
+    long frames = 0;
+    long perdidos = 0;
+    double sumaMs = 0.0;
+    double sumaCuadrados = 0.0;
+    double maxMs = 0.0;
+    double sumaTrabajoMs = 0.0;
+
+    double mediaMs() const { return frames ? sumaMs / frames : 0.0; }
+    // Jitter: desviación típica del intervalo entre presentaciones
+    double jitterMs() const {
+        if (frames < 2) return 0.0;
+        double media = mediaMs();
+        return std::sqrt(std::max(0.0, sumaCuadrados / frames - media * media));
+    }
+    double trabajoMedioMs() const { return frames ? sumaTrabajoMs / frames : 0.0; }
+};
+
+class RitmoFrames {
+public:
+    using Reloj = std::chrono::steady_clock;
+
+private:
+    ModoRitmo modo = RITMO_ADAPTATIVO;
+    ContextoRitmo contexto = CONTEXTO_MENU;
+    int hzJuego = 60;
+    int hzMenu = 30;
+    int hzReposo = 10;
+    bool reposo = false;
+    bool vsync = false;
+    int hzMonitor = 60;
+    bool giro = true;                   // false: solo dormir (para comparar en --bench-ritmo)
+
+    int divisor = 1;                    // Hz efectivos = base / divisor
+    double margenGiroMs = RitmoConstants::MARGEN_GIRO_INICIAL_MS;
+    Reloj::time_point ultimaPresentacion{};
+    Reloj::time_point plazo{};
+    bool primerFrame = true;
+    bool descartarSiguiente = true;     // El intervalo tras un cambio de ritmo no cuenta
+    double trabajoMs = 0.0;
+
+    std::array<float, RitmoConstants::VENTANA_ADAPTACION> ventanaTrabajo{};
+    int enVentana = 0;
+    std::array<float, RitmoConstants::HISTORIAL> historial{};
+    int enHistorial = 0;
+    int posHistorial = 0;
+    EstadisticasRitmo estadisticas[RITMO_TOTAL][CONTEXTO_TOTAL];
+
+    static double ms(Reloj::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+    static Reloj::duration duracion(double milis) {
+        return std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double, std::milli>(milis));
+    }
+
+    int hzObjetivo() const {
+        int hz = contexto == CONTEXTO_JUEGO ? hzJuego : (reposo ? hzReposo : hzMenu);
+        return std::clamp(hz, RitmoConstants::HZ_MINIMO, RitmoConstants::HZ_MAXIMO);
+    }
+
+    // Con vsync los periodos posibles son múltiplos del refresco; sin él, divisores del objetivo
+    int hzBase() const { return vsync ? hzMonitor : hzObjetivo(); }
+
+    int divisorMinimo() const {
+        int base = hzBase(), objetivo = hzObjetivo();
+        return std::max(1, (base + objetivo - 1) / objetivo);
+    }
+
+    void cambioDeRitmo() {
+        divisor = divisorMinimo();
+        enVentana = 0;
+        descartarSiguiente = true;
+    }
+
+    // Cada VENTANA_ADAPTACION frames: un divisor más si el p90 del trabajo no cabe, uno menos
+    // si cabría con holgura en el periodo más corto
+    void adaptar() {
+        ventanaTrabajo[enVentana++] = static_cast<float>(trabajoMs);
+        if (enVentana < RitmoConstants::VENTANA_ADAPTACION) return;
+        enVentana = 0;
+        size_t p90 = ventanaTrabajo.size() * 9 / 10;
+        std::nth_element(ventanaTrabajo.begin(), ventanaTrabajo.begin() + p90, ventanaTrabajo.end());
+        double trabajo = ventanaTrabajo[p90];
+        double base = hzBase();
+        if (trabajo > RitmoConstants::CARGA_BAJAR * 1000.0 * divisor / base &&
+            base / (divisor + 1) >= RitmoConstants::HZ_MINIMO) {
+            divisor++;
+        } else if (divisor > divisorMinimo() && trabajo < RitmoConstants::CARGA_SUBIR * 1000.0 * (divisor - 1) / base) {
+            divisor--;
+        }
+    }
+
+    void esperarHasta(Reloj::time_point objetivo) {
+        Reloj::time_point ahora = Reloj::now();
+        if (!giro || contexto != CONTEXTO_JUEGO) {
+            if (objetivo > ahora) std::this_thread::sleep_until(objetivo);
+            return;
+        }
+        Reloj::duration margen = duracion(margenGiroMs);
+        if (objetivo - ahora > margen) {
+            Reloj::time_point despertar = objetivo - margen;
+            std::this_thread::sleep_until(despertar);
+            double exceso = ms(Reloj::now() - despertar);
+            margenGiroMs = std::clamp(std::max(margenGiroMs * RitmoConstants::OLVIDO_MARGEN, exceso * 1.5 + 0.1),
+                                      RitmoConstants::MARGEN_GIRO_MIN_MS, RitmoConstants::MARGEN_GIRO_MAX_MS);
+        }
+        while (Reloj::now() < objetivo) {}     // Sin yield: cedería el núcleo una rodaja entera
+    }
+
+public:
+    void setModo(ModoRitmo m) {
+        if (m == modo) return;
+        modo = m;
+        cambioDeRitmo();
+    }
+
+    void setObjetivos(int juego, int menu, int enReposo) {
+        hzJuego = juego;
+        hzMenu = menu;
+        hzReposo = enReposo;
+        cambioDeRitmo();
+    }
+
+    void setContexto(ContextoRitmo c) {
+        if (c == contexto) return;
+        contexto = c;
+        cambioDeRitmo();
+    }
+
+    void setReposo(bool activo) {
+        if (activo == reposo) return;
+        reposo = activo;
+        cambioDeRitmo();
+    }
+
+    void setVsync(bool activo, int hz) {
+        vsync = activo;
+        hzMonitor = std::clamp(hz, RitmoConstants::HZ_MINIMO, RitmoConstants::HZ_MAXIMO);
+        cambioDeRitmo();
+    }
+
+    void setGiro(bool activo) { giro = activo; }
+
+    // Justo antes de EndDrawing. Devuelve cuánto se pasó del plazo (ms; 0 si no hubo espera).
+    double esperarPlazo() {
+        Reloj::time_point ahora = Reloj::now();
+        trabajoMs = primerFrame ? 0.0 : ms(ahora - ultimaPresentacion);
+        if (modo == RITMO_LIBRE || primerFrame) return 0.0;
+
+        int div = modo == RITMO_ADAPTATIVO ? divisor : divisorMinimo();
+        double periodoMs = 1000.0 * div / hzBase();
+        plazo += duracion(periodoMs);
+        if (plazo < ahora) plazo = ahora;   // Atrasados: se pierde el hueco en vez de encadenar frames rápidos
+
+        // Con vsync y un periodo de un solo refresco el swap ya espera; con más, se deja al swap
+        // el último medio refresco para no saltarse el vblank bueno
+        if (vsync) {
+            if (div == 1) return 0.0;
+            esperarHasta(plazo - duracion(500.0 / hzMonitor));
+            return 0.0;
+        }
+        esperarHasta(plazo);
+        return ms(Reloj::now() - plazo);
+    }
+
+    // Justo después de EndDrawing
+    void marcarPresentacion() {
+        Reloj::time_point ahora = Reloj::now();
+        if (primerFrame) {
+            primerFrame = false;
+            plazo = ahora;
+            ultimaPresentacion = ahora;
+            return;
+        }
+        double intervalo = ms(ahora - ultimaPresentacion);
+        ultimaPresentacion = ahora;
+        if (modo == RITMO_LIBRE || vsync) plazo = ahora;
+
+        if (descartarSiguiente) {
+            descartarSiguiente = false;
+        } else {
+            EstadisticasRitmo& e = estadisticas[modo][contexto];
+            e.frames++;
+            e.sumaMs += intervalo;
+            e.sumaCuadrados += intervalo * intervalo;
+            e.maxMs = std::max(e.maxMs, intervalo);
+            e.sumaTrabajoMs += trabajoMs;
+            if (modo != RITMO_LIBRE && intervalo > RitmoConstants::FACTOR_PERDIDO * getPeriodoMs()) e.perdidos++;
+            historial[posHistorial] = static_cast<float>(intervalo);
+            posHistorial = (posHistorial + 1) % RitmoConstants::HISTORIAL;
+            enHistorial = std::min(enHistorial + 1, RitmoConstants::HISTORIAL);
+        }
+        if (modo == RITMO_ADAPTATIVO) adaptar();
+    }
+
+    // Presenta frames sin esperar: si el intervalo mediano se pega al periodo del monitor, el
+    // driver sincroniza con el refresco aunque no se haya pedido
+    template <typename F>
+    static bool detectarVsync(int hzMonitorDetectado, F&& presentar) {
+        if (hzMonitorDetectado <= 0) return false;
+        std::array<double, RitmoConstants::FRAMES_DETECCION_VSYNC> intervalos{};
+        presentar();
+        Reloj::time_point anterior = Reloj::now();
+        for (double& intervalo : intervalos) {
+            presentar();
+            Reloj::time_point ahora = Reloj::now();
+            intervalo = ms(ahora - anterior);
+            anterior = ahora;
+        }
+        std::nth_element(intervalos.begin(), intervalos.begin() + intervalos.size() / 2, intervalos.end());
+        double periodo = 1000.0 / hzMonitorDetectado;
+        return std::abs(intervalos[intervalos.size() / 2] - periodo) < RitmoConstants::TOLERANCIA_VSYNC * periodo;
+    }
+
+    ModoRitmo getModo() const { return modo; }
+    ContextoRitmo getContexto() const { return contexto; }
+    bool hayVsync() const { return vsync; }
+    double getMargenGiroMs() const { return margenGiroMs; }
+
+    int getHzEfectivo() const {
+        if (modo == RITMO_LIBRE) return 0;
+        return hzBase() / (modo == RITMO_ADAPTATIVO ? divisor : divisorMinimo());
+    }
+
+    double getPeriodoMs() const {
+        int hz = getHzEfectivo();
+        return hz > 0 ? 1000.0 / hz : 0.0;
+    }
+
+    const EstadisticasRitmo& getEstadisticas(ModoRitmo m, ContextoRitmo c) const { return estadisticas[m][c]; }
+
+    // p99 de los últimos HISTORIAL intervalos, de cualquier modo
+    double getP99Ms() const {
+        if (enHistorial == 0) return 0.0;
+        std::array<float, RitmoConstants::HISTORIAL> copia = historial;
+        size_t p99 = static_cast<size_t>(enHistorial) * 99 / 100;
+        std::nth_element(copia.begin(), copia.begin() + p99, copia.begin() + enHistorial);
+        return copia[p99];
+    }
+
+    static const char* nombreModo(ModoRitmo m) {
+        switch (m) {
+            case RITMO_LIBRE: return "libre";
+            case RITMO_FIJO: return "fijo";
+            default: return "adaptativo";
+        }
+    }
+
+    static const char* nombreContexto(ContextoRitmo c) { return c == CONTEXTO_JUEGO ? "juego" : "menú"; }
+};
+
+#endif
@@ -0,0 +1,15 @@
+#!/bin/bash
+echo "🖥️  Compilando Servidor Dedicado - DuoMaze..."
+
+# Solo Linux (recvmmsg/sendmmsg). Usa las cabeceras de raylib pero no enlaza la librería
+g++ -o servidor servidor.cpp -lpthread -std=c++17 -O2
+
+if [ $? -eq 0 ]; then
+    echo "✅ ¡Compilación exitosa!"
+    echo "🚀 Servidor: ./servidor [puerto] [--hilos N] [--max-partidas N]"
+    echo "🤖 Carga:    ./servidor --bots 2000 [ip] [puerto]"
+    echo "🎮 Jugar:    ./DuoMaze --unir ip [puerto]"
+else
+    echo "❌ Error en la compilación"
+    exit 1
+fi
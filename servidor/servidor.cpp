@@ -0,0 +1,972 @@
+#include "../simulacion.h"
+#include "../protocolo_red.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Servidor dedicado de DuoMaze - sin ventana ni audio
+// Aloja miles de partidas cooperativas a la vez. Los clientes son el juego normal con
+// --unir ip puerto: el primero que llega controla al master y el segundo al slave.
+//  - Cada partida es un struct compacto (sin punteros ni memoria dinámica) dentro de un
+//    shard. Un shard es un bloque contiguo de partidas que solo toca un hilo a la vez.
+//  - Un hilo de recepción lee el socket por lotes (recvmmsg) y deja cada paquete en el
+//    buzón del shard de su partida.
+//  - Un reloj reparte cada 10 ms una tarea por shard a un pool con robo de trabajo:
+//    cada hilo tiene su cola y, si se queda sin tareas, roba de la de otro.
+//  - Cada tarea avanza los ticks pendientes del shard y envía sus snapshots con sendmmsg.
+// Modo --bots: genera carga con clientes falsos que hablan el mismo protocolo.
+
+namespace ServidorConstants {
+    constexpr int MAX_PARTIDAS_DEFECTO = 4096;
+    constexpr int SHARDS_POR_HILO = 4;          // Margen para que el robo reparta bien
+    constexpr int HISTORIAL_JUGADOR = 64;       // Inputs pendientes por jugador (potencia de 2)
+    constexpr int TICKS_CAMBIO_NIVEL = 200;     // Pausa tras completar un nivel (no hay host que pulse ENTER)
+    constexpr int TICKS_TIMEOUT = static_cast<int>(RedConstants::TIMEOUT_MS) / GameConstants::PHYSICS_UPDATE_RATE;
+    constexpr int LOTE_RECEPCION = 64;
+    constexpr int BUFFER_SOCKET = 8 * 1024 * 1024;
+    constexpr int INTERVALO_METRICAS_MS = 5000;
+    constexpr int CUBETAS_HISTOGRAMA = 2000;    // 5 µs por cubeta: hasta 10 ms
+    constexpr int US_POR_CUBETA = 5;
+}
+
+static std::atomic<bool> ejecutando{true};
+
+static void alRecibirSenal(int) {
+    ejecutando = false;
+}
+
+static double ahoraMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// Niveles compartidos: el mapa no cambia dentro de un nivel, así que las partidas
+// solo guardan el número de nivel y todas leen la misma copia.
+// ============================================================================
+struct NivelCompartido {
+    MapaNivel mapa{};
+    SimEstado inicio;
+};
+
+static std::array<NivelCompartido, GameConstants::TOTAL_LEVELS> niveles;
+
+static void cargarNiveles() {
+    for (int n = 0; n < GameConstants::TOTAL_LEVELS; n++) {
+        SimulacionFija::cargarNivel(n, niveles[n].mapa, niveles[n].inicio);
+    }
+}
+
+// ============================================================================
+// Partida
+// ============================================================================
+struct Jugador {
+    sockaddr_in direccion;
+    uint32_t recibidosHasta;        // Última secuencia de input recibida
+    uint32_t procesadosHasta;       // Última aplicada a la simulación
+    uint32_t ultimoPaqueteTick;     // Tick del shard en que llegó su último paquete
+    std::array<uint8_t, ServidorConstants::HISTORIAL_JUGADOR> inputs;
+};
+
+struct Partida {
+    SimEstado sim;
+    Jugador jugadores[2];           // 0 = master, 1 = slave
+    uint16_t generacion;            // Cambia cada vez que el slot se reasigna
+    uint16_t ticksCompletado;
+    uint8_t conectados;             // Bit 0 master, bit 1 slave
+    bool activa;
+};
+
+static_assert(sizeof(Partida) <= 256, "Partida debe ocupar como mucho 256 bytes");
+
+// Mensajes del hilo de recepción a un shard
+struct Evento {
+    uint32_t partida;
+    uint16_t generacion;
+    uint8_t jugador;
+    uint8_t tipo;                   // MSG_HOLA o MSG_INPUT
+    sockaddr_in direccion;
+    PaqueteInput input;
+};
+
+struct Liberada {
+    uint32_t partida;
+    uint16_t generacion;
+};
+
+// ============================================================================
+// Métricas (contadores relajados: solo se leen para el informe)
+// ============================================================================
+struct Metricas {
+    std::atomic<uint64_t> ticksShard{0};
+    std::atomic<uint64_t> ticksPartida{0};
+    std::atomic<uint64_t> ticksAtrasados{0};
+    std::atomic<uint64_t> nsOcupado{0};
+    std::atomic<uint64_t> robos{0};
+    std::atomic<uint64_t> paquetesRecibidos{0};
+    std::atomic<uint64_t> paquetesEnviados{0};
+    std::atomic<uint32_t> partidasJugando{0};
+    std::array<std::atomic<uint32_t>, ServidorConstants::CUBETAS_HISTOGRAMA> histograma{};
+
+    void registrarTick(uint64_t ns) {
+        size_t cubeta = std::min<uint64_t>(ns / (1000 * ServidorConstants::US_POR_CUBETA),
+                                           ServidorConstants::CUBETAS_HISTOGRAMA - 1);
+        histograma[cubeta].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Percentil del histograma en µs, vaciándolo para el siguiente intervalo
+    double percentilYReiniciar(double p) {
+        std::array<uint32_t, ServidorConstants::CUBETAS_HISTOGRAMA> copia;
+        uint64_t total = 0;
+        for (int i = 0; i < ServidorConstants::CUBETAS_HISTOGRAMA; i++) {
+            copia[i] = histograma[i].exchange(0, std::memory_order_relaxed);
+            total += copia[i];
+        }
+        if (total == 0) return 0.0;
+        uint64_t objetivo = static_cast<uint64_t>(total * p);
+        uint64_t acumulado = 0;
+        for (int i = 0; i < ServidorConstants::CUBETAS_HISTOGRAMA; i++) {
+            acumulado += copia[i];
+            if (acumulado > objetivo) return (i + 1) * ServidorConstants::US_POR_CUBETA;
+        }
+        return ServidorConstants::CUBETAS_HISTOGRAMA * ServidorConstants::US_POR_CUBETA;
+    }
+};
+
+// ============================================================================
+// Shard: bloque contiguo de partidas con su buzón y su cola de salida
+// ============================================================================
+class Shard {
+private:
+    static constexpr uint32_t MASCARA = ServidorConstants::HISTORIAL_JUGADOR - 1;
+    static constexpr uint8_t BIT_COMPLETADO = 0x80;
+
+    struct Salida {
+        sockaddr_in direccion;
+        PaqueteEstado paquete;      // El mayor que se envía; BIENVENIDA cabe en él
+        uint32_t bytes;
+    };
+
+    Partida* partidas;
+    uint32_t primera;
+    uint32_t cantidad;
+    int socketFd;
+    Metricas& metricas;
+
+    std::mutex mtxBuzon;
+    std::vector<Evento> buzon;
+    std::vector<Evento> procesando;
+
+    std::vector<Salida> salida;
+    std::vector<mmsghdr> mensajes;
+    std::vector<iovec> vectores;
+
+    uint32_t tickShard = 0;
+
+    void encolarEnvio(const sockaddr_in& direccion, const void* datos, uint32_t bytes) {
+        Salida s;
+        s.direccion = direccion;
+        std::memcpy(&s.paquete, datos, bytes);
+        s.bytes = bytes;
+        salida.push_back(s);
+    }
+
+    void vaciarSalida() {
+        if (salida.empty()) return;
+        mensajes.resize(salida.size());
+        vectores.resize(salida.size());
+        for (size_t i = 0; i < salida.size(); i++) {
+            vectores[i] = {&salida[i].paquete, salida[i].bytes};
+            mensajes[i] = {};
+            mensajes[i].msg_hdr.msg_name = &salida[i].direccion;
+            mensajes[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            mensajes[i].msg_hdr.msg_iov = &vectores[i];
+            mensajes[i].msg_hdr.msg_iovlen = 1;
+        }
+        size_t enviados = 0;
+        while (enviados < salida.size()) {
+            int n = sendmmsg(socketFd, &mensajes[enviados], salida.size() - enviados, 0);
+            if (n <= 0) break;     // Buffer lleno: esos snapshots se pierden, como en la red
+            enviados += n;
+        }
+        metricas.paquetesEnviados.fetch_add(enviados, std::memory_order_relaxed);
+        salida.clear();
+    }
+
+    void procesarEvento(const Evento& e) {
+        Partida& p = partidas[e.partida];
+        if (e.tipo == MSG_HOLA) {
+            if (e.generacion != p.generacion) {
+                // Slot reasignado: partida nueva
+                p = Partida{};
+                p.generacion = e.generacion;
+                p.activa = true;
+                p.sim = niveles[0].inicio;
+            } else if (!p.activa) {
+                return;
+            }
+            Jugador& j = p.jugadores[e.jugador];
+            uint8_t bit = static_cast<uint8_t>(1 << e.jugador);
+            if ((p.conectados & bit) == 0) {
+                j.direccion = e.direccion;
+                p.conectados |= bit;
+                if (p.conectados == 3) metricas.partidasJugando.fetch_add(1, std::memory_order_relaxed);
+            }
+            j.ultimoPaqueteTick = tickShard;
+            PaqueteControl bienvenida{MSG_BIENVENIDA, p.sim.nivel, static_cast<uint8_t>(e.jugador == 0 ? 1 : 0), 0};
+            encolarEnvio(j.direccion, &bienvenida, sizeof(bienvenida));
+        } else if (p.activa && e.generacion == p.generacion) {
+            recibirInputs(p.jugadores[e.jugador], e.input);
+            p.jugadores[e.jugador].ultimoPaqueteTick = tickShard;
+        }
+    }
+
+    // Mismo tratamiento que el host de SesionRed: redundancia y huecos dados por perdidos
+    static void recibirInputs(Jugador& j, const PaqueteInput& p) {
+        int cantidad = std::min<int>(p.cantidad, RedConstants::INPUTS_POR_PAQUETE);
+        uint32_t primeraSeq = p.ultimaSecuencia - cantidad + 1;
+        for (int i = 0; i < cantidad; i++) {
+            uint32_t seq = primeraSeq + i;
+            if (seq > j.procesadosHasta && seq <= j.procesadosHasta + ServidorConstants::HISTORIAL_JUGADOR) {
+                j.inputs[seq & MASCARA] = p.inputs[i];
+            }
+        }
+        if (p.ultimaSecuencia > j.recibidosHasta) {
+            if (primeraSeq > j.recibidosHasta + 1) {
+                j.procesadosHasta = std::max(j.procesadosHasta, primeraSeq - 1);
+            }
+            j.recibidosHasta = std::min(p.ultimaSecuencia, j.procesadosHasta + ServidorConstants::HISTORIAL_JUGADOR);
+        }
+    }
+
+    static Vector2 consumirInputs(Jugador& j, Vector2 pos, bool isMaster, const MapaNivel& mapa,
+                                  Canales canales, const MetadatosNivel& meta) {
+        uint32_t pendientes = j.recibidosHasta - j.procesadosHasta;
+        int aConsumir = pendientes == 0 ? 0 : (pendientes > 2 * RedConstants::TICKS_ENTRE_INPUTS ? 2 : 1);
+        for (int i = 0; i < aConsumir; i++) {
+            j.procesadosHasta++;
+            pos = SimulacionFija::moverJugador(pos, j.inputs[j.procesadosHasta & MASCARA], isMaster, mapa, canales, meta);
+        }
+        return pos;
+    }
+
+    void enviarEstado(const Partida& p) {
+        PaqueteEstado e{};
+        e.tipo = MSG_ESTADO;
+        e.nivel = p.sim.nivel;
+        e.canales = p.sim.canales;
+        e.metas = p.sim.metas | (p.sim.completado ? BIT_COMPLETADO : 0);
+        e.tick = p.sim.tick;
+        e.masterX = static_cast<int16_t>(std::lround(p.sim.masterPos.x));
+        e.masterY = static_cast<int16_t>(std::lround(p.sim.masterPos.y));
+        e.slaveX = static_cast<int16_t>(std::lround(p.sim.slavePos.x));
+        e.slaveY = static_cast<int16_t>(std::lround(p.sim.slavePos.y));
+        for (int i = 0; i < 2; i++) {
+            if ((p.conectados & (1 << i)) == 0) continue;
+            e.ultimoInputCliente = p.jugadores[i].procesadosHasta;
+            encolarEnvio(p.jugadores[i].direccion, &e, sizeof(e));
+        }
+    }
+
+    void descartarPendientes(Partida& p) {
+        for (Jugador& j : p.jugadores) j.procesadosHasta = j.recibidosHasta;
+    }
+
+    // Devuelve false si la partida terminó o se abandonó
+    bool tickPartida(Partida& p) {
+        for (int i = 0; i < 2; i++) {
+            if ((p.conectados & (1 << i)) && tickShard - p.jugadores[i].ultimoPaqueteTick > ServidorConstants::TICKS_TIMEOUT) {
+                return false;
+            }
+        }
+
+        if (p.conectados != 3) {
+            // Esperando compañero: nadie se mueve, los snapshots mantienen vivo al que ya está
+            descartarPendientes(p);
+        } else if (p.sim.completado) {
+            descartarPendientes(p);
+            if (++p.ticksCompletado >= ServidorConstants::TICKS_CAMBIO_NIVEL) {
+                int siguiente = p.sim.nivel + 1;
+                uint32_t tick = p.sim.tick;
+                if (siguiente >= GameConstants::TOTAL_LEVELS) {
+                    // El cliente termina al ver un nivel fuera de rango
+                    p.sim.nivel = static_cast<uint8_t>(siguiente);
+                    p.sim.tick++;
+                    enviarEstado(p);
+                    return false;
+                }
+                p.sim = niveles[siguiente].inicio;
+                p.sim.tick = tick;
+                p.ticksCompletado = 0;
+            }
+        } else {
+            const MapaNivel& mapa = niveles[p.sim.nivel].mapa;
+            SimEstado& s = p.sim;
+            const MetadatosNivel& meta = metadatosNivel(s.nivel);
+            s.masterPos = consumirInputs(p.jugadores[0], s.masterPos, true, mapa, s.canales, meta);
+            s.slavePos = consumirInputs(p.jugadores[1], s.slavePos, false, mapa, s.canales, meta);
+            ReglasJuego::evaluar(mapa, s.masterPos, s.slavePos, s.canales, s.metas, meta);
+            if (s.metas == (BIT_META_MASTER | BIT_META_SLAVE)) s.completado = true;
+        }
+        p.sim.tick++;
+        if (p.sim.tick % RedConstants::TICKS_ENTRE_SNAPSHOTS == 0) {
+            enviarEstado(p);
+        }
+        return true;
+    }
+
+public:
+    std::atomic<bool> enCola{false};
+    uint64_t ticksHechos = 0;       // Solo lo toca la tarea en curso
+
+    Shard(Partida* partidas, uint32_t primera, uint32_t cantidad, int socketFd, Metricas& metricas)
+        : partidas(partidas), primera(primera), cantidad(cantidad), socketFd(socketFd), metricas(metricas) {
+        salida.reserve(cantidad * 2);
+    }
+
+    void depositar(const Evento& e) {
+        std::lock_guard<std::mutex> lock(mtxBuzon);
+        buzon.push_back(e);
+    }
+
+    // Tarea del pool: eventos pendientes y ticks hasta tickObjetivo
+    void ejecutar(uint64_t tickObjetivo, std::vector<Liberada>& liberadas) {
+        {
+            std::lock_guard<std::mutex> lock(mtxBuzon);
+            procesando.swap(buzon);
+        }
+        for (const Evento& e : procesando) procesarEvento(e);
+        procesando.clear();
+
+        // Tras un parón no se intenta recuperar todo (misma regla que MAX_TICKS_POR_FRAME)
+        if (tickObjetivo - ticksHechos > static_cast<uint64_t>(RedConstants::MAX_TICKS_POR_FRAME)) {
+            metricas.ticksAtrasados.fetch_add(tickObjetivo - ticksHechos - RedConstants::MAX_TICKS_POR_FRAME,
+                                              std::memory_order_relaxed);
+            ticksHechos = tickObjetivo - RedConstants::MAX_TICKS_POR_FRAME;
+        }
+
+        uint64_t partidasTick = 0;
+        while (ticksHechos < tickObjetivo) {
+            auto inicio = std::chrono::steady_clock::now();
+            tickShard++;
+            for (uint32_t i = primera; i < primera + cantidad; i++) {
+                Partida& p = partidas[i];
+                if (!p.activa) continue;
+                partidasTick++;
+                if (!tickPartida(p)) {
+                    if (p.conectados == 3) metricas.partidasJugando.fetch_sub(1, std::memory_order_relaxed);
+                    p.activa = false;
+                    liberadas.push_back({i, p.generacion});
+                }
+            }
+            vaciarSalida();
+            ticksHechos++;
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count();
+            metricas.registrarTick(ns);
+            metricas.nsOcupado.fetch_add(ns, std::memory_order_relaxed);
+        }
+        metricas.ticksPartida.fetch_add(partidasTick, std::memory_order_relaxed);
+        metricas.ticksShard.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// ============================================================================
+// Pool con robo de trabajo: cada hilo saca de su cola por detrás (lo último que se
+// le encoló, aún caliente en caché) y roba de las demás por delante
+// ============================================================================
+class PoolRobo {
+public:
+    using Tarea = uint32_t;         // Índice de shard
+
+private:
+    struct Cola {
+        std::mutex mtx;
+        std::deque<Tarea> tareas;
+    };
+
+    std::vector<std::unique_ptr<Cola>> colas;
+    std::vector<std::thread> hilos;
+    std::mutex mtxDormir;
+    std::condition_variable despertar;
+    std::atomic<int> pendientes{0};
+    std::atomic<bool> parar{false};
+    Metricas& metricas;
+
+    bool tomar(int yo, Tarea& tarea) {
+        {
+            Cola& propia = *colas[yo];
+            std::lock_guard<std::mutex> lock(propia.mtx);
+            if (!propia.tareas.empty()) {
+                tarea = propia.tareas.back();
+                propia.tareas.pop_back();
+                return true;
+            }
+        }
+        int n = static_cast<int>(colas.size());
+        for (int k = 1; k < n; k++) {
+            Cola& otra = *colas[(yo + k) % n];
+            std::lock_guard<std::mutex> lock(otra.mtx);
+            if (!otra.tareas.empty()) {
+                tarea = otra.tareas.front();
+                otra.tareas.pop_front();
+                metricas.robos.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename F>
+    void bucle(int yo, F& trabajo) {
+        while (!parar) {
+            Tarea tarea;
+            if (tomar(yo, tarea)) {
+                pendientes.fetch_sub(1);
+                trabajo(tarea, yo);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtxDormir);
+            despertar.wait(lock, [this] { return parar || pendientes.load() > 0; });
+        }
+    }
+
+public:
+    explicit PoolRobo(Metricas& metricas) : metricas(metricas) {}
+
+    ~PoolRobo() {
+        detener();
+    }
+
+    template <typename F>
+    void iniciar(int numHilos, F& trabajo) {
+        for (int i = 0; i < numHilos; i++) colas.push_back(std::make_unique<Cola>());
+        for (int i = 0; i < numHilos; i++) {
+            hilos.emplace_back([this, i, &trabajo] { bucle(i, trabajo); });
+        }
+    }
+
+    void encolar(Tarea tarea, int hilo) {
+        {
+            Cola& c = *colas[hilo % colas.size()];
+            std::lock_guard<std::mutex> lock(c.mtx);
+            c.tareas.push_back(tarea);
+        }
+        pendientes.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(mtxDormir);
+        }
+        despertar.notify_one();
+    }
+
+    void detener() {
+        if (parar.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(mtxDormir);
+        }
+        despertar.notify_all();
+        for (auto& h : hilos) h.join();
+        hilos.clear();
+    }
+
+    int getNumHilos() const { return static_cast<int>(colas.size()); }
+};
+
+// ============================================================================
+// Servidor
+// ============================================================================
+class Servidor {
+private:
+    int socketFd = -1;
+    int numHilos;
+    uint32_t maxPartidas;
+    Metricas metricas;
+
+    std::vector<Partida> partidas;
+    std::vector<std::unique_ptr<Shard>> shards;
+    uint32_t partidasPorShard = 0;
+
+    // Solo los usa el hilo de recepción
+    std::unordered_map<uint64_t, uint32_t> jugadorPorDireccion;   // Clave -> partida*2 + jugador
+    std::vector<std::array<uint64_t, 2>> clavesPartida;
+    std::vector<uint16_t> generaciones;
+    std::vector<uint32_t> libres;
+    int64_t partidaEsperando = -1;  // Con master y sin slave
+
+    // Partidas que los shards dan por terminadas (de los hilos del pool al de recepción)
+    std::mutex mtxLiberadas;
+    std::vector<Liberada> liberadas;
+
+    std::atomic<uint64_t> tickGlobal{0};
+    PoolRobo pool{metricas};
+    std::vector<std::vector<Liberada>> liberadasPorHilo;
+
+    static uint64_t clave(const sockaddr_in& d) {
+        return (static_cast<uint64_t>(d.sin_addr.s_addr) << 16) | d.sin_port;
+    }
+
+    void recogerLiberadas() {
+        std::vector<Liberada> pendientes;
+        {
+            std::lock_guard<std::mutex> lock(mtxLiberadas);
+            pendientes.swap(liberadas);
+        }
+        for (const Liberada& l : pendientes) {
+            // Si el slot ya se reasignó, el aviso es de la partida anterior
+            if (generaciones[l.partida] != l.generacion) continue;
+            for (uint64_t& c : clavesPartida[l.partida]) {
+                if (c != 0) jugadorPorDireccion.erase(c);
+                c = 0;
+            }
+            generaciones[l.partida]++;
+            if (partidaEsperando == l.partida) partidaEsperando = -1;
+            libres.push_back(l.partida);
+        }
+    }
+
+    // Partida y jugador de un HOLA nuevo: completa la que espera o abre otra
+    bool asignar(const sockaddr_in& d, uint32_t& partida, uint8_t& jugador) {
+        if (partidaEsperando >= 0) {
+            partida = static_cast<uint32_t>(partidaEsperando);
+            jugador = 1;
+            partidaEsperando = -1;
+        } else {
+            if (libres.empty()) return false;
+            partida = libres.back();
+            libres.pop_back();
+            jugador = 0;
+            partidaEsperando = partida;
+        }
+        uint64_t c = clave(d);
+        clavesPartida[partida][jugador] = c;
+        jugadorPorDireccion[c] = partida * 2 + jugador;
+        return true;
+    }
+
+    void enrutar(const uint8_t* datos, int bytes, const sockaddr_in& d) {
+        if (bytes < static_cast<int>(sizeof(PaqueteControl))) return;
+        Evento e{};
+        e.tipo = datos[0];
+        auto it = jugadorPorDireccion.find(clave(d));
+
+        if (e.tipo == MSG_HOLA) {
+            uint32_t partida;
+            uint8_t jugador;
+            if (it != jugadorPorDireccion.end()) {
+                partida = it->second / 2;
+                jugador = it->second % 2;
+            } else if (!asignar(d, partida, jugador)) {
+                return;     // Servidor lleno: el cliente seguirá intentándolo
+            }
+            e.partida = partida;
+            e.jugador = jugador;
+            e.direccion = d;
+        } else if (e.tipo == MSG_INPUT && bytes == static_cast<int>(sizeof(PaqueteInput)) &&
+                   it != jugadorPorDireccion.end()) {
+            e.partida = it->second / 2;
+            e.jugador = it->second % 2;
+            std::memcpy(&e.input, datos, sizeof(PaqueteInput));
+        } else {
+            return;
+        }
+        e.generacion = generaciones[e.partida];
+        shards[e.partida / partidasPorShard]->depositar(e);
+    }
+
+    void hiloRecepcion() {
+        constexpr int LOTE = ServidorConstants::LOTE_RECEPCION;
+        std::vector<std::array<uint8_t, 64>> buffers(LOTE);
+        std::vector<sockaddr_in> origenes(LOTE);
+        std::vector<iovec> vectores(LOTE);
+        std::vector<mmsghdr> mensajes(LOTE);
+
+        while (ejecutando) {
+            recogerLiberadas();
+            pollfd pfd{socketFd, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0) continue;
+
+            for (int i = 0; i < LOTE; i++) {
+                vectores[i] = {buffers[i].data(), buffers[i].size()};
+                mensajes[i] = {};
+                mensajes[i].msg_hdr.msg_name = &origenes[i];
+                mensajes[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                mensajes[i].msg_hdr.msg_iov = &vectores[i];
+                mensajes[i].msg_hdr.msg_iovlen = 1;
+            }
+            int n = recvmmsg(socketFd, mensajes.data(), LOTE, MSG_DONTWAIT, nullptr);
+            if (n <= 0) continue;
+            metricas.paquetesRecibidos.fetch_add(n, std::memory_order_relaxed);
+            for (int i = 0; i < n; i++) {
+                enrutar(buffers[i].data(), static_cast<int>(mensajes[i].msg_len), origenes[i]);
+            }
+        }
+    }
+
+    // Reloj de ticks: cada 10 ms encola los shards que no tengan ya una tarea pendiente
+    void hiloReloj() {
+        const double paso = GameConstants::PHYSICS_UPDATE_RATE;
+        double siguiente = ahoraMs() + paso;
+        uint32_t reparto = 0;
+        while (ejecutando) {
+            double espera = siguiente - ahoraMs();
+            if (espera > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(espera * 1000.0)));
+            }
+            // Se cuentan todos los ticks vencidos; los shards los recuperan en su siguiente tarea
+            while (ahoraMs() >= siguiente) {
+                tickGlobal.fetch_add(1);
+                siguiente += paso;
+            }
+            for (uint32_t s = 0; s < shards.size(); s++) {
+                if (shards[s]->enCola.exchange(true)) continue;
+                pool.encolar(s, static_cast<int>(reparto++ % numHilos));
+            }
+        }
+    }
+
+public:
+    Servidor(int numHilos, uint32_t maxPartidas) : numHilos(numHilos), maxPartidas(maxPartidas) {}
+
+    ~Servidor() {
+        if (socketFd >= 0) close(socketFd);
+    }
+
+    bool abrir(uint16_t puerto) {
+        socketFd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socketFd < 0) return false;
+        int tam = ServidorConstants::BUFFER_SOCKET;
+        setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &tam, sizeof(tam));
+        setsockopt(socketFd, SOL_SOCKET, SO_SNDBUF, &tam, sizeof(tam));
+        sockaddr_in dir{};
+        dir.sin_family = AF_INET;
+        dir.sin_addr.s_addr = htonl(INADDR_ANY);
+        dir.sin_port = htons(puerto);
+        if (bind(socketFd, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) != 0) return false;
+
+        // Reserva única: después el servidor no pide memoria por partida
+        int numShards = numHilos * ServidorConstants::SHARDS_POR_HILO;
+        partidasPorShard = (maxPartidas + numShards - 1) / numShards;
+        maxPartidas = partidasPorShard * numShards;
+        partidas.assign(maxPartidas, Partida{});
+        clavesPartida.assign(maxPartidas, {0, 0});
+        generaciones.assign(maxPartidas, 1);
+        for (int s = 0; s < numShards; s++) {
+            shards.push_back(std::make_unique<Shard>(partidas.data(), s * partidasPorShard,
+                                                     partidasPorShard, socketFd, metricas));
+        }
+        // Pila de libres intercalada: las partidas consecutivas caen en shards distintos
+        for (int k = static_cast<int>(partidasPorShard) - 1; k >= 0; k--) {
+            for (int s = numShards - 1; s >= 0; s--) {
+                libres.push_back(s * partidasPorShard + k);
+            }
+        }
+        return true;
+    }
+
+    void ejecutar(double segundos) {
+        liberadasPorHilo.resize(numHilos);
+        auto trabajo = [this](PoolRobo::Tarea s, int hilo) {
+            std::vector<Liberada>& propias = liberadasPorHilo[hilo];
+            Shard& shard = *shards[s];
+            shard.ejecutar(tickGlobal.load(), propias);
+            shard.enCola = false;
+            if (!propias.empty()) {
+                std::lock_guard<std::mutex> lock(mtxLiberadas);
+                liberadas.insert(liberadas.end(), propias.begin(), propias.end());
+                propias.clear();
+            }
+        };
+        pool.iniciar(numHilos, trabajo);
+        std::thread recepcion(&Servidor::hiloRecepcion, this);
+        std::thread reloj(&Servidor::hiloReloj, this);
+
+        printf("🖥️  Servidor DuoMaze: %d hilos, %zu shards, %u partidas máx. (%zu bytes por partida, %.1f MB en total)\n",
+               numHilos, shards.size(), maxPartidas, sizeof(Partida),
+               sizeof(Partida) * maxPartidas / (1024.0 * 1024.0));
+
+        double inicio = ahoraMs();
+        double ultimoInforme = inicio;
+        uint64_t ticksPartidaAntes = 0, ticksAntes = 0, nsAntes = 0, robosAntes = 0;
+        uint64_t recibidosAntes = 0, enviadosAntes = 0, atrasadosAntes = 0;
+        while (ejecutando && (segundos <= 0 || ahoraMs() - inicio < segundos * 1000.0)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            double ahora = ahoraMs();
+            if (ahora - ultimoInforme < ServidorConstants::INTERVALO_METRICAS_MS) continue;
+            double dt = (ahora - ultimoInforme) / 1000.0;
+            ultimoInforme = ahora;
+
+            uint64_t ticksPartida = metricas.ticksPartida.load();
+            uint64_t ticks = tickGlobal.load();
+            uint64_t ns = metricas.nsOcupado.load();
+            uint64_t robos = metricas.robos.load();
+            uint64_t recibidos = metricas.paquetesRecibidos.load();
+            uint64_t enviados = metricas.paquetesEnviados.load();
+            uint64_t atrasados = metricas.ticksAtrasados.load();
+            double p99 = metricas.percentilYReiniciar(0.99);
+            double segundosCpu = (ns - nsAntes) / 1e9;
+
+            printf("📊 partidas %u jugando | %.0f ticks/s | %.0f ticks de partida/s (%.0f por núcleo ocupado, "
+                   "ocupación %.0f%%) | tick de shard p99 %.0f µs | robos %llu | atrasados %llu | "
+                   "paquetes %.0f/s entrada, %.0f/s salida\n",
+                   metricas.partidasJugando.load(), (ticks - ticksAntes) / dt,
+                   (ticksPartida - ticksPartidaAntes) / dt,
+                   segundosCpu > 0 ? (ticksPartida - ticksPartidaAntes) / segundosCpu : 0.0,
+                   100.0 * segundosCpu / (dt * numHilos), p99,
+                   static_cast<unsigned long long>(robos - robosAntes),
+                   static_cast<unsigned long long>(atrasados - atrasadosAntes),
+                   (recibidos - recibidosAntes) / dt, (enviados - enviadosAntes) / dt);
+            fflush(stdout);
+
+            ticksPartidaAntes = ticksPartida;
+            ticksAntes = ticks;
+            nsAntes = ns;
+            robosAntes = robos;
+            recibidosAntes = recibidos;
+            enviadosAntes = enviados;
+            atrasadosAntes = atrasados;
+        }
+
+        ejecutando = false;
+        reloj.join();
+        recepcion.join();
+        pool.detener();
+        printf("👋 Servidor detenido\n");
+    }
+};
+
+// ============================================================================
+// Generador de carga: bots que se comportan como el cliente del juego
+// (HOLA hasta la bienvenida, inputs redundantes cada 3 ticks, leen los snapshots)
+// ============================================================================
+class GeneradorBots {
+private:
+    struct Bot {
+        int fd = -1;
+        bool conectado = false;
+        uint32_t secuencia = 0;
+        uint32_t ultimoAck = 0;
+        uint8_t input = 0;
+        uint32_t semilla = 1;
+        double ultimoHolaMs = -1e9;
+        std::array<uint8_t, RedConstants::HISTORIAL_INPUTS> historial{};
+        std::array<double, RedConstants::HISTORIAL_INPUTS> enviadoMs{};
+    };
+
+    sockaddr_in servidor{};
+    std::atomic<uint64_t> snapshots{0};
+    std::atomic<uint64_t> muestrasLatencia{0};
+    std::atomic<uint64_t> latenciaTotalUs{0};
+    std::atomic<uint32_t> conectados{0};
+
+    static uint32_t aleatorio(uint32_t& s) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+
+    void enviar(Bot& b, const void* datos, size_t bytes) {
+        sendto(b.fd, datos, bytes, 0, reinterpret_cast<const sockaddr*>(&servidor), sizeof(servidor));
+    }
+
+    void recibir(Bot& b, double ahora) {
+        uint8_t buffer[64];
+        ssize_t n;
+        while ((n = recv(b.fd, buffer, sizeof(buffer), 0)) > 0) {
+            if (buffer[0] == MSG_BIENVENIDA && !b.conectado) {
+                b.conectado = true;
+                conectados.fetch_add(1, std::memory_order_relaxed);
+            } else if (buffer[0] == MSG_ESTADO && n == static_cast<ssize_t>(sizeof(PaqueteEstado))) {
+                PaqueteEstado p;
+                std::memcpy(&p, buffer, sizeof(p));
+                snapshots.fetch_add(1, std::memory_order_relaxed);
+                // Latencia input -> confirmación en un snapshot (incluye el lote y la cadencia de snapshots)
+                if (p.ultimoInputCliente > b.ultimoAck && p.ultimoInputCliente <= b.secuencia &&
+                    b.secuencia - p.ultimoInputCliente < RedConstants::HISTORIAL_INPUTS) {
+                    double ms = ahora - b.enviadoMs[p.ultimoInputCliente & (RedConstants::HISTORIAL_INPUTS - 1)];
+                    latenciaTotalUs.fetch_add(static_cast<uint64_t>(ms * 1000.0), std::memory_order_relaxed);
+                    muestrasLatencia.fetch_add(1, std::memory_order_relaxed);
+                    b.ultimoAck = p.ultimoInputCliente;
+                }
+            }
+        }
+    }
+
+    void tick(Bot& b, double ahora) {
+        if (!b.conectado) {
+            if (ahora - b.ultimoHolaMs >= RedConstants::INTERVALO_HOLA_MS) {
+                PaqueteControl hola{MSG_HOLA, 0, 0, 0};
+                enviar(b, &hola, sizeof(hola));
+                b.ultimoHolaMs = ahora;
+            }
+            return;
+        }
+        // Paseo aleatorio: cambia de dirección cada ~0.5 s
+        if (aleatorio(b.semilla) % 50 == 0) {
+            static const uint8_t direcciones[] = {INPUT_IZQ, INPUT_DER, INPUT_ARR, INPUT_ABA,
+                                                  INPUT_IZQ | INPUT_ARR, INPUT_DER | INPUT_ABA, 0};
+            b.input = direcciones[aleatorio(b.semilla) % 7];
+        }
+        constexpr uint32_t MASCARA = RedConstants::HISTORIAL_INPUTS - 1;
+        b.secuencia++;
+        b.historial[b.secuencia & MASCARA] = b.input;
+        b.enviadoMs[b.secuencia & MASCARA] = ahora;
+        if (b.secuencia % RedConstants::TICKS_ENTRE_INPUTS == 0) {
+            PaqueteInput p{};
+            p.tipo = MSG_INPUT;
+            p.cantidad = static_cast<uint8_t>(std::min<uint32_t>(b.secuencia, RedConstants::INPUTS_POR_PAQUETE));
+            p.ultimaSecuencia = b.secuencia;
+            for (int i = 0; i < p.cantidad; i++) {
+                p.inputs[i] = b.historial[(b.secuencia - p.cantidad + 1 + i) & MASCARA];
+            }
+            enviar(b, &p, sizeof(p));
+        }
+    }
+
+    void hiloBots(std::vector<Bot>& bots) {
+        const double paso = GameConstants::PHYSICS_UPDATE_RATE;
+        double siguiente = ahoraMs();
+        while (ejecutando) {
+            double ahora = ahoraMs();
+            for (Bot& b : bots) recibir(b, ahora);
+            while (ahora >= siguiente) {
+                for (Bot& b : bots) tick(b, ahora);
+                siguiente += paso;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    static void subirLimiteDescriptores(int necesarios) {
+        rlimit lim{};
+        if (getrlimit(RLIMIT_NOFILE, &lim) != 0) return;
+        if (lim.rlim_cur < static_cast<rlim_t>(necesarios)) {
+            lim.rlim_cur = std::min<rlim_t>(lim.rlim_max, necesarios);
+            setrlimit(RLIMIT_NOFILE, &lim);
+        }
+    }
+
+public:
+    int ejecutar(int numBots, const char* ip, uint16_t puerto, int numHilos, double segundos) {
+        servidor.sin_family = AF_INET;
+        servidor.sin_port = htons(puerto);
+        if (inet_pton(AF_INET, ip, &servidor.sin_addr) != 1) {
+            printf("❌ Dirección inválida: %s\n", ip);
+            return 1;
+        }
+        subirLimiteDescriptores(numBots + 64);
+
+        std::vector<std::vector<Bot>> grupos(numHilos);
+        for (int i = 0; i < numBots; i++) {
+            Bot b;
+            b.fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (b.fd < 0) {
+                printf("❌ Solo se pudieron abrir %d sockets\n", i);
+                numBots = i;
+                break;
+            }
+            fcntl(b.fd, F_SETFL, fcntl(b.fd, F_GETFL, 0) | O_NONBLOCK);
+            b.semilla = 0x9E3779B9u ^ static_cast<uint32_t>(i * 2654435761u);
+            if (b.semilla == 0) b.semilla = 1;
+            grupos[i % numHilos].push_back(b);
+        }
+
+        printf("🤖 %d bots contra %s:%u en %d hilos\n", numBots, ip, puerto, numHilos);
+        std::vector<std::thread> hilos;
+        for (auto& g : grupos) hilos.emplace_back(&GeneradorBots::hiloBots, this, std::ref(g));
+
+        double inicio = ahoraMs();
+        double ultimoInforme = inicio;
+        uint64_t snapshotsAntes = 0, muestrasAntes = 0, latenciaAntes = 0;
+        while (ejecutando && (segundos <= 0 || ahoraMs() - inicio < segundos * 1000.0)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            double ahora = ahoraMs();
+            if (ahora - ultimoInforme < ServidorConstants::INTERVALO_METRICAS_MS) continue;
+            double dt = (ahora - ultimoInforme) / 1000.0;
+            ultimoInforme = ahora;
+            uint64_t s = snapshots.load(), m = muestrasLatencia.load(), l = latenciaTotalUs.load();
+            printf("🤖 conectados %u/%d | snapshots %.0f/s (esperados %.0f/s) | input confirmado en %.1f ms de media\n",
+                   conectados.load(), numBots, (s - snapshotsAntes) / dt,
+                   conectados.load() * 1000.0 / (GameConstants::PHYSICS_UPDATE_RATE * RedConstants::TICKS_ENTRE_SNAPSHOTS),
+                   m > muestrasAntes ? (l - latenciaAntes) / 1000.0 / (m - muestrasAntes) : 0.0);
+            fflush(stdout);
+            snapshotsAntes = s;
+            muestrasAntes = m;
+            latenciaAntes = l;
+        }
+
+        ejecutando = false;
+        for (auto& h : hilos) h.join();
+        for (auto& g : grupos) for (Bot& b : g) close(b.fd);
+        return 0;
+    }
+};
+
+int main(int argc, char** argv) {
+    std::signal(SIGINT, alRecibirSenal);
+    std::signal(SIGTERM, alRecibirSenal);
+    cargarNiveles();
+
+    int numHilos = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t maxPartidas = ServidorConstants::MAX_PARTIDAS_DEFECTO;
+    uint16_t puerto = RedConstants::PUERTO_DEFECTO;
+    double segundos = 0.0;
+    int numBots = 0;
+    std::string ip = "127.0.0.1";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (arg == "--hilos" && hayValor) {
+            numHilos = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--max-partidas" && hayValor) {
+            maxPartidas = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--segundos" && hayValor) {
+            segundos = std::atof(argv[++i]);
+        } else if (arg == "--bots" && hayValor) {
+            numBots = std::max(1, std::atoi(argv[++i]));
+            if (i + 1 < argc && argv[i + 1][0] != '-') ip = argv[++i];
+        } else if (arg[0] != '-') {
+            puerto = static_cast<uint16_t>(std::atoi(arg.c_str()));
+        } else {
+            printf("Uso: %s [puerto] [--hilos N] [--max-partidas N] [--segundos S]\n", argv[0]);
+            printf("     %s --bots N [ip] [puerto] [--hilos N] [--segundos S]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (numBots > 0) {
+        GeneradorBots bots;
+        return bots.ejecutar(numBots, ip.c_str(), puerto, std::min(numHilos, 4), segundos);
+    }
+
+    Servidor servidor(numHilos, maxPartidas);
+    if (!servidor.abrir(puerto)) {
+        printf("❌ No se pudo abrir el puerto UDP %u\n", puerto);
+        return 1;
+    }
+    servidor.ejecutar(segundos);
+    return 0;
+}
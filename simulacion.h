@@ -0,0 +1,558 @@
+#ifndef DUOMAZE_SIMULACION_H
+#define DUOMAZE_SIMULACION_H
+
+// Simulación de DuoMaze sin ventana, audio ni hilos: mapas, movimiento, colisión y reglas.
+// La comparten el juego y el servidor dedicado. Solo usa los tipos de raylib (Vector2,
+// Rectangle), así que quien la incluya no necesita enlazar raylib.
+
+#include "raylib.h"
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Constantes de la simulación (el juego añade las de pantalla y audio al mismo namespace)
+namespace GameConstants {
+    constexpr int MAP_WIDTH = 20;
+    constexpr int MAP_HEIGHT = 15;
+    constexpr int TILE_SIZE = 40;
+    constexpr int PLAYER_RADIUS = 15;
+    constexpr int PLAYER_SPEED = 3;
+    
+    // Paso fijo de la simulación (en ms)
+    constexpr int PHYSICS_UPDATE_RATE = 10;
+    
+    // NUEVO: Sistema de niveles
+    constexpr int TOTAL_LEVELS = 4;
+}
+
+enum TileType {
+    VACIO = 0,
+    PARED = 1,
+    START_MASTER = 2,
+    START_SLAVE = 3,
+    BOTON_1 = 4,
+    BOTON_2 = 5,
+    BOTON_3 = 6,
+    PUERTA_1 = 7,
+    PUERTA_2 = 8,
+    PUERTA_3 = 9,
+    OBSTACULO_ROJO = 10,
+    OBSTACULO_AZUL = 11,
+    META = 12,
+    NUM_TIPOS_TILE      // Rasgos de cada uno en TIPOS_TILE
+};
+
+using MapaNivel = std::array<std::array<int, GameConstants::MAP_WIDTH>, GameConstants::MAP_HEIGHT>;
+
+// Mapas de los niveles
+inline constexpr int DATOS_NIVELES[GameConstants::TOTAL_LEVELS][GameConstants::MAP_HEIGHT][GameConstants::MAP_WIDTH] = {
+    // Nivel 1
+    {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 2, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 4, 0, 0, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 1, 0, 1},
+        {1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1},
+        {1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 8, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 3, 0, 0, 0, 0, 0, 0, 7, 0, 5, 0, 0, 0, 0, 0, 0, 0, 12, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
+    },
+    // Nivel 2
+    {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 4, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1},
+        {1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1},
+        {1, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 1, 11, 1},
+        {1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 1, 1, 5, 1, 0, 1, 0, 1},
+        {1, 1, 0, 0, 1, 1, 1, 0, 1, 6, 1, 0, 0, 0, 0, 10, 0, 1, 0, 1},
+        {1, 0, 0, 0, 1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 1, 0, 1, 1, 1, 7, 8, 0, 1, 1, 0, 11, 0, 0, 0, 0, 0, 1},
+        {1, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1},
+        {1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 9, 1, 1, 1, 0, 1},
+        {1, 10, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 1, 1, 1, 12, 1, 1, 1, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
+    },
+    // Nivel 3
+    {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 0, 0, 0, 11, 0, 0, 0, 0, 0, 6, 1, 0, 0, 0, 0, 4, 7, 0, 1},
+        {1, 0, 1, 0, 1, 8, 1, 1, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1},
+        {1, 0, 1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 0, 0, 0, 10, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1},
+        {1, 1, 0, 1, 1, 1, 0, 0, 1, 1, 9, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 5, 0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 10, 0, 0, 0, 0, 1},
+        {1, 0, 1, 0, 1, 0, 1, 1, 1, 1, 9, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 0, 1, 0, 1, 1, 1, 0, 1, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 12, 0, 0, 1, 0, 1},
+        {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
+    },
+    // Nivel 4
+    {
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 0, 4, 1, 6, 0, 0, 8, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 1},
+        {1, 10, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 0, 11, 0, 1, 0, 1, 0, 1},
+        {1, 0, 0, 11, 0, 10, 0, 1, 0, 1, 0, 1, 0, 1, 0, 10, 0, 1, 0, 1},
+        {1, 11, 10, 1, 0, 1, 0, 1, 0, 1, 0, 10, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 10, 11, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 0, 0, 1, 0, 11, 0, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 11, 10, 1, 10, 1, 1, 0, 0, 10, 0, 11, 0, 1, 0, 1, 0, 1, 0, 1},
+        {1, 0, 0, 0, 0, 11, 5, 1, 0, 7, 0, 1, 0, 10, 0, 11, 0, 1, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1},
+        {1, 0, 9, 3, 0, 10, 0, 11, 0, 1, 0, 11, 0, 1, 0, 11, 0, 1, 0, 1},
+        {1, 12, 1, 0, 0, 11, 0, 1, 0, 10, 0, 1, 0, 10, 0, 1, 0, 10, 0, 1},
+        {1, 0, 9, 2, 0, 1, 0, 10, 0, 11, 0, 10, 0, 11, 0, 10, 0, 11, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
+    }
+};
+
+// Bits de input por tick (un byte por jugador y tick)
+enum InputBits : uint8_t {
+    INPUT_IZQ = 1, INPUT_DER = 2, INPUT_ARR = 4, INPUT_ABA = 8,
+    INPUT_SIGUIENTE = 16    // Master: pasar de nivel (solo lo usa la sesión con rollback)
+};
+
+// Bits de botones activos y de jugadores en la meta. Los tres botones básicos son los
+// canales 0, 1 y 2 del sistema de disparadores.
+enum EstadoBits : uint8_t {
+    BIT_BOTON_1 = 1, BIT_BOTON_2 = 2, BIT_BOTON_3 = 4,
+    BIT_META_MASTER = 1, BIT_META_SLAVE = 2
+};
+
+// ============================================================================
+// Rasgos de los tipos de tile y disparadores por canales
+// ============================================================================
+// Todo lo que los subsistemas saben de una tile (colisión, botones y puertas, meta,
+// inicios y sprite) sale de una tabla de rasgos indexada por id, generada en tiempo de
+// compilación a partir de una sola declaración (TIPOS_TILE). Colisión, reglas y dibujo
+// consultan la tabla en vez de tener cada uno su switch.
+//
+// Cada botón activa un canal y cada puerta se abre con el suyo; el estado de todas las
+// puertas es una sola máscara de 64 bits. Cada nivel tiene su tabla (MetadatosNivel):
+// la básica más los botones y puertas propios que defina.
+using Canales = uint64_t;
+
+namespace TriggerConstants {
+    constexpr int MAX_CANALES = 64;
+    constexpr int IDS_TILE = 64;            // Ids de tile con rasgos
+    constexpr int PRIMER_ID_PROPIO = 16;    // Ids libres para botones/puertas propios de un nivel
+}
+
+enum TipoTrigger : uint8_t { TRIGGER_NINGUNO = 0, TRIGGER_BOTON = 1, TRIGGER_PUERTA = 2 };
+enum RolJugador : uint8_t { ROL_MASTER = 1, ROL_SLAVE = 2, ROL_AMBOS = 3 };
+enum ModoTrigger : uint8_t {
+    MODO_AMBOS = 1,         // Solo cuenta con los dos jugadores sobre botones de su canal
+    MODO_ENCLAVADO = 2      // Se queda activo al soltarlo (si no, solo mientras se pisa)
+};
+
+// Sprites de las tiles. Cada puerta abierta va justo detrás de la cerrada.
+enum TexturaTile : uint8_t {
+    TEX_NINGUNA,
+    TEX_PARED,
+    TEX_INICIO_MASTER,
+    TEX_INICIO_SLAVE,
+    TEX_BOTON_1, TEX_BOTON_2, TEX_BOTON_3,
+    TEX_PUERTA_1, TEX_PUERTA_1_ABIERTA,
+    TEX_PUERTA_2, TEX_PUERTA_2_ABIERTA,
+    TEX_PUERTA_3, TEX_PUERTA_3_ABIERTA,
+    TEX_OBSTACULO_ROJO,
+    TEX_OBSTACULO_AZUL,
+    TEX_META,
+    NUM_TEXTURAS_TILE
+};
+
+constexpr Canales bitCanal(int canal) { return Canales{1} << canal; }
+
+struct RasgosTile {
+    uint8_t paso = 0;                   // RolJugador que la atraviesan (las puertas, con su canal activo)
+    uint8_t tipo = TRIGGER_NINGUNO;     // TipoTrigger
+    uint8_t canal = 0;
+    uint8_t roles = 0;                  // Botones: RolJugador que pueden pulsarlo
+    uint8_t modo = 0;                   // Botones: ModoTrigger
+    uint8_t textura = TEX_NINGUNA;      // Puertas: la cerrada (la abierta es textura + 1)
+    uint8_t inicio = 0;                 // RolJugador que empieza en esta tile
+    uint8_t meta = 0;                   // 1 si cuenta como meta
+};
+
+namespace Rasgos {
+    constexpr RasgosTile suelo(uint8_t paso, uint8_t textura) {
+        RasgosTile r;
+        r.paso = paso;
+        r.textura = textura;
+        return r;
+    }
+
+    constexpr RasgosTile inicio(uint8_t rol, uint8_t textura) {
+        RasgosTile r = suelo(ROL_AMBOS, textura);
+        r.inicio = rol;
+        return r;
+    }
+
+    constexpr RasgosTile meta(uint8_t textura) {
+        RasgosTile r = suelo(ROL_AMBOS, textura);
+        r.meta = 1;
+        return r;
+    }
+
+    // Los canales por encima del 2 reutilizan los sprites de los básicos
+    constexpr RasgosTile boton(int canal, uint8_t roles, uint8_t modo) {
+        RasgosTile r = suelo(ROL_AMBOS, static_cast<uint8_t>(TEX_BOTON_1 + canal % 3));
+        r.tipo = TRIGGER_BOTON;
+        r.canal = static_cast<uint8_t>(canal);
+        r.roles = roles;
+        r.modo = modo;
+        return r;
+    }
+
+    constexpr RasgosTile puerta(int canal) {
+        RasgosTile r = suelo(0, static_cast<uint8_t>(TEX_PUERTA_1 + 2 * (canal % 3)));
+        r.tipo = TRIGGER_PUERTA;
+        r.canal = static_cast<uint8_t>(canal);
+        return r;
+    }
+}
+
+struct DeclaracionTile {
+    TileType id;
+    RasgosTile rasgos;
+};
+
+// La declaración de los tipos de tile: añadir uno es añadir su valor a TileType y su línea aquí.
+// Botones 1 y 2 individuales (master y slave), botón 3 con los dos jugadores; todos enclavados.
+inline constexpr DeclaracionTile TIPOS_TILE[] = {
+    {VACIO,          Rasgos::suelo(ROL_AMBOS, TEX_NINGUNA)},
+    {PARED,          Rasgos::suelo(0, TEX_PARED)},
+    {START_MASTER,   Rasgos::inicio(ROL_MASTER, TEX_INICIO_MASTER)},
+    {START_SLAVE,    Rasgos::inicio(ROL_SLAVE, TEX_INICIO_SLAVE)},
+    {BOTON_1,        Rasgos::boton(0, ROL_MASTER, MODO_ENCLAVADO)},
+    {BOTON_2,        Rasgos::boton(1, ROL_SLAVE, MODO_ENCLAVADO)},
+    {BOTON_3,        Rasgos::boton(2, ROL_AMBOS, MODO_AMBOS | MODO_ENCLAVADO)},
+    {PUERTA_1,       Rasgos::puerta(0)},
+    {PUERTA_2,       Rasgos::puerta(1)},
+    {PUERTA_3,       Rasgos::puerta(2)},
+    {OBSTACULO_ROJO, Rasgos::suelo(ROL_MASTER, TEX_OBSTACULO_ROJO)},
+    {OBSTACULO_AZUL, Rasgos::suelo(ROL_SLAVE, TEX_OBSTACULO_AZUL)},
+    {META,           Rasgos::meta(TEX_META)},
+};
+
+// Comprobaciones de la declaración en tiempo de compilación
+namespace ValidacionTiles {
+    constexpr int declarados = static_cast<int>(sizeof(TIPOS_TILE) / sizeof(TIPOS_TILE[0]));
+
+    constexpr bool enOrden() {
+        for (int i = 0; i < declarados; i++) {
+            if (TIPOS_TILE[i].id != i) return false;
+        }
+        return true;
+    }
+
+    constexpr bool rasgosValidos() {
+        for (const DeclaracionTile& d : TIPOS_TILE) {
+            const RasgosTile& r = d.rasgos;
+            if (r.textura >= NUM_TEXTURAS_TILE || r.canal >= TriggerConstants::MAX_CANALES) return false;
+            if (r.tipo == TRIGGER_BOTON && r.roles == 0) return false;
+            if (r.tipo == TRIGGER_PUERTA && r.paso != 0) return false;
+            if (r.tipo != TRIGGER_NINGUNO && (r.inicio != 0 || r.meta != 0)) return false;
+        }
+        return true;
+    }
+
+    constexpr int contar(uint8_t RasgosTile::*campo, uint8_t valor) {
+        int n = 0;
+        for (const DeclaracionTile& d : TIPOS_TILE) n += (d.rasgos.*campo & valor) ? 1 : 0;
+        return n;
+    }
+}
+
+static_assert(ValidacionTiles::declarados == NUM_TIPOS_TILE, "Cada TileType necesita su línea en TIPOS_TILE");
+static_assert(ValidacionTiles::enOrden(), "TIPOS_TILE debe seguir el orden de TileType");
+static_assert(ValidacionTiles::rasgosValidos(), "Rasgos de tile incoherentes en TIPOS_TILE");
+static_assert(ValidacionTiles::contar(&RasgosTile::inicio, ROL_MASTER) == 1 &&
+              ValidacionTiles::contar(&RasgosTile::inicio, ROL_SLAVE) == 1,
+              "Hace falta exactamente un tipo de inicio por rol");
+static_assert(ValidacionTiles::contar(&RasgosTile::meta, 1) >= 1, "Hace falta un tipo de tile meta");
+static_assert(NUM_TIPOS_TILE <= TriggerConstants::PRIMER_ID_PROPIO, "Los ids propios no pueden pisar los básicos");
+
+struct MetadatosNivel {
+    // Una entrada más al final para los ids desconocidos (incluido -1, fuera del mapa):
+    // no se atraviesa, no dispara nada y no se dibuja
+    std::array<RasgosTile, TriggerConstants::IDS_TILE + 1> tiles{};
+    Canales enclavados = 0;             // Canales con algún botón enclavado
+
+    constexpr const RasgosTile& rasgos(int tile) const {
+        return tiles[static_cast<unsigned>(tile) < TriggerConstants::IDS_TILE ? tile : TriggerConstants::IDS_TILE];
+    }
+
+    constexpr MetadatosNivel& definir(int tile, const RasgosTile& r) {
+        tiles[tile] = r;
+        if (r.tipo == TRIGGER_BOTON && (r.modo & MODO_ENCLAVADO)) enclavados |= bitCanal(r.canal);
+        return *this;
+    }
+
+    constexpr MetadatosNivel& boton(int tile, int canal, uint8_t roles, uint8_t modo) {
+        return definir(tile, Rasgos::boton(canal, roles, modo));
+    }
+
+    constexpr MetadatosNivel& puerta(int tile, int canal) {
+        return definir(tile, Rasgos::puerta(canal));
+    }
+};
+
+// Tabla de los tipos básicos. Un nivel con disparadores propios parte de aquí y añade ids
+// desde PRIMER_ID_PROPIO, p. ej. metadatosBasicos().boton(16, 3, ROL_SLAVE, 0).puerta(17, 3)
+// para un botón momentáneo.
+constexpr MetadatosNivel metadatosBasicos() {
+    MetadatosNivel m;
+    for (const DeclaracionTile& d : TIPOS_TILE) m.definir(d.id, d.rasgos);
+    return m;
+}
+
+inline constexpr MetadatosNivel METADATOS_BASICOS = metadatosBasicos();
+
+// Metadatos de cada nivel, en el mismo orden que DATOS_NIVELES
+inline constexpr MetadatosNivel METADATOS_NIVELES[GameConstants::TOTAL_LEVELS] = {
+    metadatosBasicos(), metadatosBasicos(), metadatosBasicos(), metadatosBasicos()
+};
+
+inline const MetadatosNivel& metadatosNivel(int nivel) {
+    return (nivel >= 0 && nivel < GameConstants::TOTAL_LEVELS) ? METADATOS_NIVELES[nivel] : METADATOS_BASICOS;
+}
+
+static_assert(bitCanal(METADATOS_BASICOS.rasgos(BOTON_1).canal) == BIT_BOTON_1 &&
+              bitCanal(METADATOS_BASICOS.rasgos(BOTON_2).canal) == BIT_BOTON_2 &&
+              bitCanal(METADATOS_BASICOS.rasgos(BOTON_3).canal) == BIT_BOTON_3,
+              "Los botones básicos deben ser los canales de BIT_BOTON_*");
+static_assert(METADATOS_BASICOS.rasgos(-1).paso == 0 && METADATOS_BASICOS.rasgos(NUM_TIPOS_TILE).paso == 0,
+              "Los ids desconocidos no se atraviesan");
+
+// Estado de simulación copiable (sin mutex ni atómicos): lo usan la simulación
+// de paso fijo, el modo en red y el servidor. El mapa vive aparte porque no cambia en el nivel.
+struct SimEstado {
+    Vector2 masterPos{0, 0};
+    Vector2 slavePos{0, 0};
+    Canales canales = 0;        // Bit i = canal i activo (puertas de ese canal abiertas)
+    uint8_t metas = 0;          // EstadoBits BIT_META_*
+    uint8_t nivel = 0;
+    bool completado = false;
+    uint32_t tick = 0;
+};
+
+// Checksum de 64 bits (FNV-1a) del estado, campo a campo para no depender del relleno
+inline uint64_t checksumEstado(const SimEstado& s) {
+    uint64_t h = 1469598103934665603ull;
+    auto mezclar = [&h](const void* datos, size_t bytes) {
+        const uint8_t* p = static_cast<const uint8_t*>(datos);
+        for (size_t i = 0; i < bytes; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mezclar(&s.masterPos, sizeof(s.masterPos));
+    mezclar(&s.slavePos, sizeof(s.slavePos));
+    mezclar(&s.canales, sizeof(s.canales));
+    mezclar(&s.metas, sizeof(s.metas));
+    mezclar(&s.nivel, sizeof(s.nivel));
+    uint8_t completado = s.completado ? 1 : 0;
+    mezclar(&completado, sizeof(completado));
+    mezclar(&s.tick, sizeof(s.tick));
+    return h;
+}
+
+// Sistema de colisiones optimizado
+class CollisionSystem {
+private:
+    static constexpr int COLLISION_CHECK_RADIUS = 1;
+    
+public:
+    // Mismo algoritmo que CheckCollisionCircleRec de raylib (rshapes.c), copiado para
+    // no enlazar raylib en el servidor y para que ambos lados calculen exactamente igual
+    static bool circuloTocaRect(Vector2 centro, float radio, Rectangle rec) {
+        int recCentroX = static_cast<int>(rec.x + rec.width / 2.0f);
+        int recCentroY = static_cast<int>(rec.y + rec.height / 2.0f);
+        float dx = std::fabs(centro.x - static_cast<float>(recCentroX));
+        float dy = std::fabs(centro.y - static_cast<float>(recCentroY));
+        
+        if (dx > (rec.width / 2.0f + radio)) return false;
+        if (dy > (rec.height / 2.0f + radio)) return false;
+        if (dx <= (rec.width / 2.0f)) return true;
+        if (dy <= (rec.height / 2.0f)) return true;
+        
+        float esquinaX = dx - rec.width / 2.0f;
+        float esquinaY = dy - rec.height / 2.0f;
+        return (esquinaX * esquinaX + esquinaY * esquinaY) <= (radio * radio);
+    }
+    
+    // Consulta sin saltos a la tabla de rasgos del nivel: pasa si su rol puede o si es una
+    // puerta con el canal activo
+    static bool canPassTile(int tileType, bool isMaster, Canales canales,
+                            const MetadatosNivel& meta = METADATOS_BASICOS) {
+        const RasgosTile& r = meta.rasgos(tileType);
+        unsigned porRol = static_cast<unsigned>(r.paso) >> (isMaster ? 0 : 1);     // Bit de ROL_MASTER / ROL_SLAVE
+        unsigned porCanal = static_cast<unsigned>(r.tipo == TRIGGER_PUERTA) & static_cast<unsigned>(canales >> r.canal);
+        return ((porRol | porCanal) & 1u) != 0;
+    }
+    
+    static bool checkCollisionWithLaberinto(Vector2 position, float radius, bool isMaster,
+                                            const MapaNivel& laberinto, Canales canales,
+                                            const MetadatosNivel& meta = METADATOS_BASICOS) {
+        using namespace GameConstants;
+        
+        if (position.x < radius || position.y < radius || 
+            position.x >= MAP_WIDTH * TILE_SIZE - radius || 
+            position.y >= MAP_HEIGHT * TILE_SIZE - radius) {
+            return true;
+        }
+        
+        int centerTileX = static_cast<int>(position.x / TILE_SIZE);
+        int centerTileY = static_cast<int>(position.y / TILE_SIZE);
+        
+        for (int y = centerTileY - COLLISION_CHECK_RADIUS; y <= centerTileY + COLLISION_CHECK_RADIUS; y++) {
+            for (int x = centerTileX - COLLISION_CHECK_RADIUS; x <= centerTileX + COLLISION_CHECK_RADIUS; x++) {
+                if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
+                    int tileType = laberinto[y][x];
+                    
+                    if (!canPassTile(tileType, isMaster, canales, meta)) {
+                        Rectangle tileRect = {
+                            static_cast<float>(x * TILE_SIZE), 
+                            static_cast<float>(y * TILE_SIZE), 
+                            static_cast<float>(TILE_SIZE), 
+                            static_cast<float>(TILE_SIZE)
+                        };
+                        if (circuloTocaRect(position, radius, tileRect)) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+// Reglas de botones y meta (compartidas por validationThread y la simulación de paso fijo)
+class ReglasJuego {
+public:
+    // Tile bajo una posición en píxeles (-1 fuera del mapa)
+    static int tileEn(const MapaNivel& laberinto, Vector2 pos) {
+        int x = static_cast<int>(pos.x / GameConstants::TILE_SIZE);
+        int y = static_cast<int>(pos.y / GameConstants::TILE_SIZE);
+        if (x < 0 || x >= GameConstants::MAP_WIDTH || y < 0 || y >= GameConstants::MAP_HEIGHT) return -1;
+        return laberinto[y][x];
+    }
+    
+    // Canal que pulsa un rol sobre una tile (0 si no es un botón que ese rol pueda pulsar)
+    static Canales pulsa(const MetadatosNivel& meta, int tile, uint8_t rol) {
+        const RasgosTile& r = meta.rasgos(tile);
+        return (r.tipo == TRIGGER_BOTON && (r.roles & rol)) ? bitCanal(r.canal) : 0;
+    }
+    
+    // Canal que un rol activa él solo desde una tile (para predecirlo sin esperar al otro)
+    static Canales pulsaSolo(const MetadatosNivel& meta, int tile, uint8_t rol) {
+        return (meta.rasgos(tile).modo & MODO_AMBOS) ? 0 : pulsa(meta, tile, rol);
+    }
+    
+    // Actualiza canales y metas. Los canales enclavados siguen activos al soltar el botón;
+    // los de MODO_AMBOS solo se activan si los dos jugadores pisan botones de ese canal.
+    static void evaluar(const MapaNivel& laberinto, Vector2 masterPos, Vector2 slavePos,
+                        Canales& canales, uint8_t& metas, const MetadatosNivel& meta = METADATOS_BASICOS) {
+        int tileMaster = tileEn(laberinto, masterPos);
+        int tileSlave = tileEn(laberinto, slavePos);
+        
+        Canales soloMaster = pulsaSolo(meta, tileMaster, ROL_MASTER);
+        Canales soloSlave = pulsaSolo(meta, tileSlave, ROL_SLAVE);
+        Canales juntos = (pulsa(meta, tileMaster, ROL_MASTER) & ~soloMaster) &
+                         (pulsa(meta, tileSlave, ROL_SLAVE) & ~soloSlave);
+        canales = (canales & meta.enclavados) | soloMaster | soloSlave | juntos;
+        
+        metas = static_cast<uint8_t>(meta.rasgos(tileMaster).meta * BIT_META_MASTER |
+                                     meta.rasgos(tileSlave).meta * BIT_META_SLAVE);
+    }
+};
+
+// Simulación determinista de paso fijo: mismo movimiento y colisión que physicsThread
+// y mismas reglas que validationThread, pero a partir de inputs en vez del teclado
+class SimulacionFija {
+private:
+    static constexpr float BORDER_MARGIN = 1.0f;
+    
+    static float clamp(float value, float min, float max) {
+        if (value < min) return min;
+        if (value > max) return max;
+        return value;
+    }
+    
+public:
+    // Misma regla que MovementSystem::calculateNewPosition pero a partir de un input ya muestreado
+    static Vector2 aplicarInput(Vector2 currentPos, uint8_t input) {
+        Vector2 newPos = currentPos;
+        if (input & INPUT_IZQ) newPos.x -= GameConstants::PLAYER_SPEED;
+        if (input & INPUT_DER) newPos.x += GameConstants::PLAYER_SPEED;
+        if (input & INPUT_ARR) newPos.y -= GameConstants::PLAYER_SPEED;
+        if (input & INPUT_ABA) newPos.y += GameConstants::PLAYER_SPEED;
+        
+        const float maxX = GameConstants::MAP_WIDTH * GameConstants::TILE_SIZE - BORDER_MARGIN;
+        const float maxY = GameConstants::MAP_HEIGHT * GameConstants::TILE_SIZE - BORDER_MARGIN;
+        
+        newPos.x = clamp(newPos.x, BORDER_MARGIN, maxX);
+        newPos.y = clamp(newPos.y, BORDER_MARGIN, maxY);
+        
+        return newPos;
+    }
+    
+    // Mapa y posiciones iniciales de un nivel (fuera de rango carga el primero)
+    static void cargarNivel(int nivel, MapaNivel& laberinto, SimEstado& sim) {
+        if (nivel < 0 || nivel >= GameConstants::TOTAL_LEVELS) nivel = 0;
+        const MetadatosNivel& meta = metadatosNivel(nivel);
+        sim = SimEstado{};
+        sim.nivel = static_cast<uint8_t>(nivel);
+        for (int y = 0; y < GameConstants::MAP_HEIGHT; y++) {
+            for (int x = 0; x < GameConstants::MAP_WIDTH; x++) {
+                int tile = DATOS_NIVELES[nivel][y][x];
+                laberinto[y][x] = tile;
+                Vector2 centro = {
+                    static_cast<float>(x * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2),
+                    static_cast<float>(y * GameConstants::TILE_SIZE + GameConstants::TILE_SIZE/2)
+                };
+                if (meta.rasgos(tile).inicio & ROL_MASTER) sim.masterPos = centro;
+                if (meta.rasgos(tile).inicio & ROL_SLAVE) sim.slavePos = centro;
+            }
+        }
+    }
+    
+    static Vector2 moverJugador(Vector2 pos, uint8_t input, bool isMaster,
+                                const MapaNivel& laberinto, Canales canales,
+                                const MetadatosNivel& meta = METADATOS_BASICOS) {
+        Vector2 newPos = aplicarInput(pos, input);
+        if (!CollisionSystem::checkCollisionWithLaberinto(newPos, GameConstants::PLAYER_RADIUS,
+                                                          isMaster, laberinto, canales, meta)) {
+            return newPos;
+        }
+        return pos;
+    }
+    
+    static void paso(SimEstado& s, const MapaNivel& laberinto, uint8_t inputMaster, uint8_t inputSlave) {
+        const MetadatosNivel& meta = metadatosNivel(s.nivel);
+        s.masterPos = moverJugador(s.masterPos, inputMaster, true, laberinto, s.canales, meta);
+        s.slavePos = moverJugador(s.slavePos, inputSlave, false, laberinto, s.canales, meta);
+        ReglasJuego::evaluar(laberinto, s.masterPos, s.slavePos, s.canales, s.metas, meta);
+        if (s.metas == (BIT_META_MASTER | BIT_META_SLAVE)) s.completado = true;
+        s.tick++;
+    }
+};
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef DUOMAZE_TILEMAP_GPU_H
+#define DUOMAZE_TILEMAP_GPU_H
+
+// Render del mapa en una sola pasada: el mapa se sube como una textura pequeña con un texel
+// por tile (sprite, canal y tipo de trigger) y se dibuja con un único quad. El shader busca
+// el sprite en un atlas, abre las puertas y resalta los botones a partir de una máscara de
+// canales en un uniform, así que abrir una puerta no sube nada. Si el mapa cambia solo se
+// suben las tiles cambiadas.
+//
+// GLSL 330 sin extensiones: funciona con el OpenGL 3.3 por defecto de raylib, también en
+// un rasterizador por software (llvmpipe).
+
+#include "raylib.h"
+#include "simulacion.h"
+#include "memoria.h"
+#include <algorithm>
+#include <vector>
+
+namespace TilemapGPU {
+    // Bits del canal azul de cada texel
+    constexpr uint8_t FLAG_PUERTA = 1;
+    constexpr uint8_t FLAG_BOTON = 2;
+    constexpr uint8_t FLAG_META = 4;
+
+    // Con más tiles cambiadas se sube su rectángulo envolvente en una sola llamada
+    constexpr int MAX_SUBIDAS_SUELTAS = 32;
+
+    // Mismo resultado que RenderSystem::drawTileContent sobre el piso: el sprite (celda
+    // TexturaTile del atlas, + 1 si es una puerta abierta) teñido en verde si está activo o
+    // con el tono de su canal, mezclado por alfa sobre el piso (celda 0)
+    constexpr const char* SHADER_FS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;     // Un texel por tile: r = sprite, g = canal, b = flags
+uniform sampler2D atlas;        // Celdas de ladoTile x ladoTile en una fila; la 0 es el piso
+uniform vec4 colDiffuse;
+uniform ivec2 canales;          // Canales 0-31 y 32-63
+uniform int metaResaltada;
+uniform int ladoTile;
+out vec4 finalColor;
+
+// ColorFromHSV de raylib, truncado a 8 bits igual que allí
+vec3 desdeHSV(float h, float s, float v) {
+    vec3 k = mod(vec3(5.0, 3.0, 1.0) + h / 60.0, 6.0);
+    vec3 c = v - v * s * max(vec3(0.0), min(k, min(4.0 - k, vec3(1.0))));
+    return floor(c * 255.0) / 255.0;
+}
+
+void main() {
+    ivec2 tam = textureSize(texture0, 0);
+    vec2 pos = fragTexCoord * vec2(tam);
+    ivec2 tile = clamp(ivec2(floor(pos)), ivec2(0), tam - 1);
+    ivec4 d = ivec4(texelFetch(texture0, tile, 0) * 255.0 + 0.5);
+
+    int palabra = d.g < 32 ? canales.x : canales.y;
+    bool activo = ((palabra >> (d.g & 31)) & 1) != 0;
+    bool puerta = (d.b & 1) != 0;
+    bool resaltado = ((d.b & 2) != 0 && activo) || ((d.b & 4) != 0 && metaResaltada != 0);
+    int sprite = d.r + ((puerta && activo) ? 1 : 0);
+
+    ivec2 local = clamp(ivec2(fract(pos) * float(ladoTile)), ivec2(0), ivec2(ladoTile - 1));
+    vec4 piso = texelFetch(atlas, local, 0);
+    vec4 color = d.r != 0 ? texelFetch(atlas, ivec2(sprite * ladoTile, 0) + local, 0) : vec4(0.0);
+    vec3 tinta = resaltado ? vec3(0.0, 228.0, 48.0) / 255.0
+               : (d.g < 3 ? vec3(1.0) : desdeHSV(mod(float(d.g * 47), 360.0), 0.45, 1.0));
+    color.rgb *= tinta;
+
+    vec3 rgb = mix(piso.rgb, color.rgb, color.a);
+    finalColor = vec4(rgb, max(piso.a, color.a)) * colDiffuse * fragColor;
+}
+)";
+
+    // Texel RGBA8 de una tile a partir de sus rasgos
+    inline void codificar(const RasgosTile& r, unsigned char* texel) {
+        texel[0] = r.textura;
+        texel[1] = r.canal;
+        texel[2] = static_cast<unsigned char>((r.tipo == TRIGGER_PUERTA ? FLAG_PUERTA : 0) |
+                                              (r.tipo == TRIGGER_BOTON ? FLAG_BOTON : 0) |
+                                              (r.meta ? FLAG_META : 0));
+        texel[3] = 255;
+    }
+}
+
+class RenderTilemapGPU {
+public:
+    struct Estadisticas {
+        int subidasCompletas = 0;       // Texturas de índices creadas (mapa nuevo o de otro tamaño)
+        int subidasParciales = 0;       // Llamadas a UpdateTextureRec
+        long tilesSubidas = 0;
+    };
+
+private:
+    Shader shader{};
+    Texture2D atlas{};
+    Texture2D indices{};
+    int locAtlas = -1;
+    int locCanales = -1;
+    int locMetaResaltada = -1;
+    int locLadoTile = -1;
+    int ladoTile = GameConstants::TILE_SIZE;
+    int ancho = 0, alto = 0;
+    std::vector<unsigned char> texels;          // Copia en CPU de la textura de índices
+    std::vector<unsigned char> rectangulo;      // Texels del rectángulo a subir
+    std::vector<int> cambiadas;
+    Estadisticas estadisticas;
+
+    static void liberar(Texture2D& t) {
+        if (t.id == 0) return;
+        ContabilidadMemoria::liberaGPU(MEM_RENDER, ContabilidadMemoria::bytesTextura(t));
+        UnloadTexture(t);
+        t = Texture2D{};
+    }
+
+    void crearIndices() {
+        liberar(indices);
+        Image imagen{};
+        imagen.data = texels.data();
+        imagen.width = ancho;
+        imagen.height = alto;
+        imagen.mipmaps = 1;
+        imagen.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        indices = LoadTextureFromImage(imagen);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, ContabilidadMemoria::bytesTextura(indices));
+        SetTextureFilter(indices, TEXTURE_FILTER_POINT);
+        estadisticas.subidasCompletas++;
+        estadisticas.tilesSubidas += static_cast<long>(ancho) * alto;
+    }
+
+public:
+    // sprites[i] es el sprite de la TexturaTile i; sprites[TEX_NINGUNA] tiene que ser el piso.
+    // Lee los sprites de la GPU una sola vez para montar el atlas.
+    bool cargar(const Texture2D* sprites, int numSprites) {
+        descargar();
+        shader = LoadShaderFromMemory(nullptr, TilemapGPU::SHADER_FS);
+        if (shader.id == 0) return false;
+        locAtlas = GetShaderLocation(shader, "atlas");
+        locCanales = GetShaderLocation(shader, "canales");
+        locMetaResaltada = GetShaderLocation(shader, "metaResaltada");
+        locLadoTile = GetShaderLocation(shader, "ladoTile");
+
+        Image imagenAtlas = GenImageColor(ladoTile * numSprites, ladoTile, BLANK);
+        for (int i = 0; i < numSprites; i++) {
+            if (sprites[i].id == 0) continue;
+            Image sprite = LoadImageFromTexture(sprites[i]);
+            ImageDraw(&imagenAtlas, sprite, {0, 0, static_cast<float>(sprite.width), static_cast<float>(sprite.height)},
+                      {static_cast<float>(i * ladoTile), 0, static_cast<float>(ladoTile), static_cast<float>(ladoTile)},
+                      WHITE);
+            UnloadImage(sprite);
+        }
+        atlas = LoadTextureFromImage(imagenAtlas);
+        ContabilidadMemoria::reservaGPU(MEM_RENDER, ContabilidadMemoria::bytesTextura(atlas));
+        UnloadImage(imagenAtlas);
+        SetTextureFilter(atlas, TEXTURE_FILTER_POINT);
+        return atlas.id != 0;
+    }
+
+    bool listo() const { return shader.id != 0 && atlas.id != 0; }
+
+    // Compara con lo ya subido y sube solo las tiles que han cambiado
+    void actualizarMapa(const int* tiles, int anchoMapa, int altoMapa, const MetadatosNivel& meta) {
+        bool nueva = anchoMapa != ancho || altoMapa != alto || indices.id == 0;
+        ancho = anchoMapa;
+        alto = altoMapa;
+        size_t total = static_cast<size_t>(ancho) * alto;
+        if (nueva) {
+            texels.assign(total * 4, 0);
+            for (size_t i = 0; i < total; i++) TilemapGPU::codificar(meta.rasgos(tiles[i]), &texels[i * 4]);
+            crearIndices();
+            return;
+        }
+
+        cambiadas.clear();
+        int x0 = ancho, y0 = alto, x1 = -1, y1 = -1;
+        for (size_t i = 0; i < total; i++) {
+            unsigned char texel[4];
+            TilemapGPU::codificar(meta.rasgos(tiles[i]), texel);
+            unsigned char* actual = &texels[i * 4];
+            if (actual[0] == texel[0] && actual[1] == texel[1] && actual[2] == texel[2]) continue;
+            std::copy(texel, texel + 4, actual);
+            int x = static_cast<int>(i % ancho), y = static_cast<int>(i / ancho);
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x);
+            y1 = std::max(y1, y);
+            cambiadas.push_back(static_cast<int>(i));
+        }
+        if (cambiadas.empty()) return;
+
+        if (static_cast<int>(cambiadas.size()) <= TilemapGPU::MAX_SUBIDAS_SUELTAS) {
+            for (int i : cambiadas) {
+                Rectangle rec = {static_cast<float>(i % ancho), static_cast<float>(i / ancho), 1, 1};
+                UpdateTextureRec(indices, rec, &texels[static_cast<size_t>(i) * 4]);
+                estadisticas.subidasParciales++;
+                estadisticas.tilesSubidas++;
+            }
+            return;
+        }
+        int w = x1 - x0 + 1, h = y1 - y0 + 1;
+        rectangulo.resize(static_cast<size_t>(w) * h * 4);
+        for (int y = 0; y < h; y++) {
+            const unsigned char* fila = &texels[(static_cast<size_t>(y0 + y) * ancho + x0) * 4];
+            std::copy(fila, fila + w * 4, &rectangulo[static_cast<size_t>(y) * w * 4]);
+        }
+        UpdateTextureRec(indices, {static_cast<float>(x0), static_cast<float>(y0), static_cast<float>(w),
+                                   static_cast<float>(h)}, rectangulo.data());
+        estadisticas.subidasParciales++;
+        estadisticas.tilesSubidas += static_cast<long>(w) * h;
+    }
+
+    // vista en tiles (puede ser una parte del mapa), destino en píxeles de pantalla
+    void dibujar(Rectangle vista, Rectangle destino, Canales canales, bool metaResaltada) {
+        if (!listo() || indices.id == 0) return;
+        int palabras[2] = {static_cast<int>(canales & 0xFFFFFFFFu), static_cast<int>(canales >> 32)};
+        int resaltada = metaResaltada ? 1 : 0;
+        BeginShaderMode(shader);
+        SetShaderValueTexture(shader, locAtlas, atlas);
+        SetShaderValue(shader, locCanales, palabras, SHADER_UNIFORM_IVEC2);
+        SetShaderValue(shader, locMetaResaltada, &resaltada, SHADER_UNIFORM_INT);
+        SetShaderValue(shader, locLadoTile, &ladoTile, SHADER_UNIFORM_INT);
+        DrawTexturePro(indices, vista, destino, {0, 0}, 0, WHITE);
+        EndShaderMode();
+    }
+
+    const Estadisticas& getEstadisticas() const { return estadisticas; }
+
+    void descargar() {
+        liberar(indices);
+        liberar(atlas);
+        if (shader.id != 0) UnloadShader(shader);
+        shader = Shader{};
+        ancho = alto = 0;
+        texels.clear();
+    }
+};
+
+#endif